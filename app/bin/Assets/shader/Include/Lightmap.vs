@@ -15,10 +15,12 @@
 * limitations under the License.
 */
 
+#ifndef VR_INSTANCING
 UniformBuffer(1, 0) uniform buf_vs_obj {
 	mat4 _World;
 	vec4 _LightmapScaleOffset;
 } u_buf_obj;
+#endif
 
 UniformBuffer(0, 2) uniform buf_vs {
 	mat4 _ViewProjection;
@@ -0,0 +1,66 @@
+/*
+* Viry3D
+* Copyright 2014-2017 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+UniformBuffer(0, 2) uniform buf_vs {
+	mat4 _ViewProjection;
+	vec4 _TintColor;
+	vec4 _CameraRight;
+	vec4 _CameraUp;
+	vec4 _CameraForward;
+} u_buf;
+
+layout (location = 0) in vec4 a_pos;
+layout (location = 2) in vec2 a_uv;
+layout (location = 3) in vec4 a_particle_pos;
+layout (location = 4) in vec4 a_particle_dir;
+layout (location = 5) in vec2 a_particle_size;
+layout (location = 6) in vec4 a_particle_color;
+layout (location = 7) in vec4 a_particle_uv;
+
+Varying(0) out vec2 v_uv;
+Varying(1) out vec4 v_color;
+
+void main() {
+	vec2 corner = a_pos.xy * a_particle_size;
+	vec3 pos;
+	vec2 uv;
+
+	if (a_particle_dir.w > 0.0) {
+		// stretched along velocity, quad top edge at particle position
+		vec3 right = cross(a_particle_dir.xyz, u_buf._CameraForward.xyz);
+		if (dot(right, right) > 0.0) {
+			right = normalize(right);
+		} else {
+			right = u_buf._CameraRight.xyz;
+		}
+		pos = a_particle_pos.xyz + right * corner.x + a_particle_dir.xyz * ((a_pos.y - 0.5) * a_particle_dir.w);
+		uv = vec2(a_uv.y, 1.0 - a_uv.x);
+	} else {
+		// billboard facing camera, rotated around view axis
+		float s = sin(a_particle_pos.w);
+		float c = cos(a_particle_pos.w);
+		vec2 r = vec2(c * corner.x - s * corner.y, s * corner.x + c * corner.y);
+		pos = a_particle_pos.xyz + u_buf._CameraRight.xyz * r.x + u_buf._CameraUp.xyz * r.y;
+		uv = a_uv;
+	}
+
+	gl_Position = vec4(pos, 1.0) * u_buf._ViewProjection;
+	v_uv = uv * a_particle_uv.xy + a_particle_uv.zw;
+	v_color = a_particle_color * u_buf._TintColor * 2.0;
+
+	vulkan_convert();
+}
@@ -0,0 +1,825 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "Main.h"
+#include "Application.h"
+#include "GameObject.h"
+#include "Debug.h"
+#include "Resource.h"
+#include "ObjectCache.h"
+#include "animation/Animation.h"
+#include "graphics/Camera.h"
+#include "graphics/Image.h"
+#include "graphics/ImageDecoder.h"
+#include "graphics/KTX2.h"
+#include "graphics/Material.h"
+#include "graphics/Mesh.h"
+#include "graphics/TextureStreaming.h"
+#include "io/AsyncFile.h"
+#include "io/Directory.h"
+#include "io/File.h"
+#include "math/Frustum.h"
+#include "math/Mathf.h"
+#include "memory/Memory.h"
+#include "renderer/MeshRenderer.h"
+#include "renderer/ParticleSystem.h"
+#include "time/Time.h"
+#include <algorithm>
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Viry3D;
+
+// counted by operator new below when this app is main
+static std::atomic<long long> g_alloc_count(0);
+
+//
+//	key search before cursors, linear scan from first key, kept as reference for animation sample
+//
+static float evaluate_keys_linear(const AnimationCurve& curve, float time)
+{
+	const auto& keys = curve.GetKeys();
+	if (keys.Empty())
+	{
+		return 0;
+	}
+
+	const auto& back = keys[keys.Size() - 1];
+	if (time >= back.time)
+	{
+		return back.value;
+	}
+
+	for (int i = 0; i < keys.Size(); i++)
+	{
+		const auto& k1 = keys[i];
+		if (time < k1.time)
+		{
+			if (i == 0)
+			{
+				return k1.value;
+			}
+
+			const auto& k0 = keys[i - 1];
+			float dt = k1.time - k0.time;
+			if (fabs(dt) < Mathf::Epsilon)
+			{
+				return k0.value;
+			}
+
+			float t = (time - k0.time) / dt;
+			float t2 = t * t;
+			float t3 = t2 * t;
+			float _t = 1 - t;
+			float _t2 = _t * _t;
+			float _t3 = _t2 * _t;
+
+			float c = 1 / 3.0f;
+			float c0 = dt * c * k0.out_tangent + k0.value;
+			float c1 = -dt * c * k1.in_tangent + k1.value;
+			return k0.value * _t3 + 3 * c0 * t * _t2 + 3 * c1 * t2 * _t + k1.value * t3;
+		}
+	}
+
+	return 0;
+}
+
+//
+//	loader micro benchmarks over the files under data path, results go to log
+//
+class AppBenchmark : public Application
+{
+public:
+	AppBenchmark()
+	{
+		this->SetName("Viry3D::AppBenchmark");
+		this->SetInitSize(1280, 720);
+
+		m_stream_phase = StreamDone;
+		m_stream_frames = 0;
+	}
+
+	virtual void Start()
+	{
+		auto camera = GameObject::Create("camera")->AddComponent<Camera>();
+		camera->SetClearColor(Color(0, 0, 0, 1));
+
+		this->CheckCullBounds();
+		this->CheckPNGFilters();
+		this->BenchImageDecode();
+		this->BenchFileRead();
+		this->BenchPrefabLoad();
+		this->BenchCurve();
+		this->BenchAnimationSample();
+		this->StartCheckTextureStreaming();
+	}
+
+	virtual void Update()
+	{
+		this->UpdateCheckTextureStreaming();
+	}
+
+	//
+	//	every png under data path decoded with simd filters and with libpng filters,
+	//	outputs must be byte identical, run on each target before its simd path is enabled
+	//
+	void CheckPNGFilters()
+	{
+		if (!Image::HasPNGSimdFilters())
+		{
+			Log("png filter check: no simd filters in this build, skipped");
+			return;
+		}
+
+		int file_count = 0;
+		int mismatch_count = 0;
+		auto files = Directory::GetFiles(Application::DataPath(), true);
+		for (const auto& i : files)
+		{
+			if (!i.EndsWith(".png"))
+			{
+				continue;
+			}
+
+			auto file = File::ReadAllBytes(i);
+			int width[2];
+			int height[2];
+			int bpp[2];
+			ByteBuffer colors[2];
+			bool ok[2];
+
+			for (int j = 0; j < 2; j++)
+			{
+				Image::SetPNGSimdFilters(j == 0);
+				ok[j] = Image::Decode(file, colors[j], width[j], height[j], bpp[j]);
+			}
+			Image::SetPNGSimdFilters(true);
+
+			if (!ok[0] && !ok[1])
+			{
+				continue;
+			}
+
+			file_count++;
+
+			int size = ok[0] ? width[0] * height[0] * bpp[0] / 8 : 0;
+			if (ok[0] != ok[1] || width[0] != width[1] || height[0] != height[1] || bpp[0] != bpp[1] ||
+				memcmp(colors[0].Bytes(), colors[1].Bytes(), size) != 0)
+			{
+				Log("png filter mismatch: %s", i.CString());
+				mismatch_count++;
+			}
+		}
+
+		Log("png filter check: %d files, %d mismatches %s",
+			file_count, mismatch_count, mismatch_count == 0 ? "passed" : "FAILED");
+	}
+
+	void BenchImageDecode()
+	{
+		const int loop = 3;
+
+		Vector<ImageDecoder::Request> requests;
+		auto files = Directory::GetFiles(Application::DataPath(), true);
+		for (const auto& i : files)
+		{
+			if (i.EndsWith(".png") || i.EndsWith(".jpg"))
+			{
+				ImageDecoder::Request request;
+				request.file = File::ReadAllBytes(i);
+				requests.Add(request);
+			}
+		}
+
+		long long out_bytes = 0;
+		long long t = Time::GetTimeMS();
+		for (int i = 0; i < loop; i++)
+		{
+			for (const auto& j : requests)
+			{
+				int width;
+				int height;
+				int bpp;
+				ByteBuffer colors;
+				if (Image::Decode(j.file, colors, width, height, bpp))
+				{
+					out_bytes += width * height * bpp / 8;
+				}
+			}
+		}
+		this->LogResult("image decode serial", out_bytes, Time::GetTimeMS() - t);
+
+		out_bytes = 0;
+		t = Time::GetTimeMS();
+		for (int i = 0; i < loop; i++)
+		{
+			for (auto& j : requests)
+			{
+				j.colors = ByteBuffer();
+			}
+
+			ImageDecoder::DecodeAll(requests);
+
+			for (const auto& j : requests)
+			{
+				if (j.ok)
+				{
+					out_bytes += j.width * j.height * j.bpp / 8;
+				}
+			}
+		}
+		this->LogResult(String::Format("image decode batch %d threads", ImageDecoder::GetThreadCount() + 1), out_bytes, Time::GetTimeMS() - t);
+	}
+
+	//
+	//	many small files in nested dirs like a cooked asset tree,
+	//	tree is kept under save path, runs after the first one read from page cache
+	//
+	void BenchFileRead()
+	{
+		const int dir_count = 40;
+		const int file_count = 2000;
+
+		String root = Application::SavePath() + "/bench_files";
+		Vector<String> paths;
+		for (int i = 0; i < file_count; i++)
+		{
+			String dir = String::Format("%s/%d/%d", root.CString(), i % dir_count / 8, i % dir_count);
+			paths.Add(String::Format("%s/%d.bin", dir.CString(), i));
+
+			if (!File::Exist(paths[i]))
+			{
+				if (!Directory::Exist(dir))
+				{
+					Directory::Create(dir);
+				}
+
+				ByteBuffer buffer(Mathf::RandomRange(1, 65) * 1024);
+				for (int j = 0; j < buffer.Size(); j++)
+				{
+					buffer[j] = (byte) (i + j);
+				}
+				File::WriteAllBytes(paths[i], buffer);
+			}
+		}
+
+		long long in_bytes = 0;
+		long long t = Time::GetTimeMS();
+		for (const auto& i : paths)
+		{
+			in_bytes += File::ReadAllBytes(i).Size();
+		}
+		this->LogResult("file read serial", in_bytes, Time::GetTimeMS() - t);
+
+		const AsyncFile::Backend backends[] = { AsyncFile::Backend::IOUring, AsyncFile::Backend::ThreadPool };
+		const char* names[] = { "", "io_uring", "thread pool" };
+		for (auto i : backends)
+		{
+			// resource holds the default backend, swap it for the run
+			AsyncFile::Deinit();
+			AsyncFile::Init(i);
+			if (AsyncFile::GetBackend() != i)
+			{
+				continue;
+			}
+
+			Vector<AsyncFile::Request> requests(paths.Size());
+			for (int j = 0; j < paths.Size(); j++)
+			{
+				requests[j].path = paths[j];
+			}
+
+			in_bytes = 0;
+			t = Time::GetTimeMS();
+			AsyncFile::ReadAll(requests);
+			for (const auto& j : requests)
+			{
+				if (j.ok)
+				{
+					in_bytes += j.size;
+				}
+			}
+			this->LogResult(String::Format("file read batch %s", names[(int) i]), in_bytes, Time::GetTimeMS() - t);
+		}
+
+		AsyncFile::Deinit();
+		AsyncFile::Init();
+	}
+
+	//
+	//	real prefabs loaded cold with asset cache cleared, then loaded again from cache,
+	//	allocations of cold load are mostly names and paths read from prefab and its dependencies
+	//
+	void BenchPrefabLoad()
+	{
+		const char* paths[] = {
+			"Assets/AppAnim/unitychan.prefab",
+			"Assets/AppParticle/particles.prefab",
+		};
+		const int loop_count = 5;
+
+		for (const char* path : paths)
+		{
+			long long cold_ms = 0;
+			long long cold_allocs = 0;
+			long long warm_ms = 0;
+			long long warm_allocs = 0;
+
+			for (int i = 0; i < loop_count; i++)
+			{
+				ObjectCache::Clear();
+
+				long long allocs = g_alloc_count;
+				long long t = Time::GetTimeMS();
+				auto obj = Resource::LoadGameObject(path);
+				cold_ms += Time::GetTimeMS() - t;
+				cold_allocs += g_alloc_count - allocs;
+
+				allocs = g_alloc_count;
+				t = Time::GetTimeMS();
+				auto copy = Resource::LoadGameObject(path);
+				warm_ms += Time::GetTimeMS() - t;
+				warm_allocs += g_alloc_count - allocs;
+
+				if (!obj || !copy)
+				{
+					Log("prefab load %s: FAILED, not loaded", path);
+					return;
+				}
+
+				GameObject::Destroy(obj);
+				GameObject::Destroy(copy);
+			}
+
+			Log("prefab load %s: cold %d ms, %lld allocations, cached %d ms, %lld allocations",
+				path,
+				(int) (cold_ms / loop_count), cold_allocs / loop_count,
+				(int) (warm_ms / loop_count), warm_allocs / loop_count);
+		}
+
+		ObjectCache::Clear();
+	}
+
+	//
+	//	batch frustum culling against ContainsBounds, results must match bit for bit,
+	//	half of the bounds have a corner on near or far plane where rounding decides
+	//
+	void CheckCullBounds()
+	{
+		const int frustum_count = 1000;
+		const int bounds_count = 1027;
+
+		Vector<Vector3> mins(bounds_count);
+		Vector<Vector3> maxs(bounds_count);
+		Vector<byte> results(bounds_count);
+		int mismatch_count = 0;
+		int cross_count = 0;
+
+		for (int i = 0; i < frustum_count; i++)
+		{
+			Vector3 eye(Mathf::RandomRange(-100.0f, 100.0f), Mathf::RandomRange(-100.0f, 100.0f), Mathf::RandomRange(-100.0f, 100.0f));
+			auto rot = Quaternion::Euler(Mathf::RandomRange(-90.0f, 90.0f), Mathf::RandomRange(0.0f, 360.0f), 0);
+			Vector3 forward = rot * Vector3(0, 0, 1);
+			Vector3 right = rot * Vector3(1, 0, 0);
+			Vector3 up = rot * Vector3(0, 1, 0);
+			float near = Mathf::RandomRange(0.1f, 1.0f);
+			float far = Mathf::RandomRange(100.0f, 1000.0f);
+
+			auto view = Matrix4x4::LookTo(eye, forward, up);
+			auto proj = Matrix4x4::Perspective(60, 16 / 9.0f, near, far);
+			Frustum frustum(proj * view);
+
+			for (int j = 0; j < bounds_count; j++)
+			{
+				Vector3 ext(Mathf::RandomRange(0.01f, 10.0f), Mathf::RandomRange(0.01f, 10.0f), Mathf::RandomRange(0.01f, 10.0f));
+
+				if (j % 2 == 0)
+				{
+					Vector3 center = eye + forward * Mathf::RandomRange(-50.0f, far + 50.0f) + right * Mathf::RandomRange(-far, far) + up * Mathf::RandomRange(-far, far);
+					mins[j] = center - ext;
+					maxs[j] = center + ext;
+				}
+				else
+				{
+					// corner nearest along plane normal put on the plane
+					bool on_near = j % 4 == 1;
+					Vector3 normal = on_near ? forward : forward * -1.0f;
+					float w = Mathf::RandomRange(-0.5f, 0.5f) * (on_near ? near : far);
+					Vector3 q = eye + forward * (on_near ? near : far) + right * w + up * w;
+					Vector3 min;
+					Vector3 max;
+					min.x = normal.x >= 0 ? q.x - ext.x : q.x;
+					max.x = normal.x >= 0 ? q.x : q.x + ext.x;
+					min.y = normal.y >= 0 ? q.y - ext.y : q.y;
+					max.y = normal.y >= 0 ? q.y : q.y + ext.y;
+					min.z = normal.z >= 0 ? q.z - ext.z : q.z;
+					max.z = normal.z >= 0 ? q.z : q.z + ext.z;
+					mins[j] = min;
+					maxs[j] = max;
+				}
+			}
+
+			frustum.CullBounds(&mins[0].x, &maxs[0].x, bounds_count, &results[0]);
+
+			for (int j = 0; j < bounds_count; j++)
+			{
+				auto expected = frustum.ContainsBounds(mins[j], maxs[j]);
+				if ((byte) expected != results[j])
+				{
+					mismatch_count++;
+				}
+				if (expected == ContainsResult::Cross)
+				{
+					cross_count++;
+				}
+			}
+		}
+
+		Log("cull bounds check: %d bounds, %d cross, %d mismatches %s",
+			frustum_count * bounds_count, cross_count, mismatch_count, mismatch_count == 0 ? "passed" : "FAILED");
+	}
+
+	//
+	//	random two curves and two gradients evaluated by key search and by baked tables,
+	//	logs max error of baked result and time of both
+	//
+	void BenchCurve()
+	{
+		const int key_count = 8;
+		const int sample_count = 1000000;
+
+		ParticleSystem::MinMaxCurve curve;
+		curve.mode = ParticleSystemCurveMode::TwoCurves;
+		curve.curve_multiplier = 5;
+		ParticleSystem::MinMaxGradient gradient;
+		gradient.mode = ParticleSystemGradientMode::TwoGradients;
+		gradient.gradient_min.mode = GradientMode::Blend;
+		gradient.gradient_max.mode = GradientMode::Blend;
+
+		AnimationCurve* curves[] = {
+			&curve.curve_min, &curve.curve_max,
+			&gradient.gradient_min.r, &gradient.gradient_min.g, &gradient.gradient_min.b, &gradient.gradient_min.a,
+			&gradient.gradient_max.r, &gradient.gradient_max.g, &gradient.gradient_max.b, &gradient.gradient_max.a,
+		};
+		for (auto c : curves)
+		{
+			for (int i = 0; i < key_count; i++)
+			{
+				c->AddKey(Keyframe(i / (float) (key_count - 1), Mathf::RandomRange(0.0f, 1.0f), Mathf::RandomRange(-2.0f, 2.0f), Mathf::RandomRange(-2.0f, 2.0f)));
+			}
+		}
+
+		Vector<float> times(sample_count);
+		Vector<float> lerps(sample_count);
+		for (int i = 0; i < sample_count; i++)
+		{
+			times[i] = Mathf::RandomRange(0.0f, 1.0f);
+			lerps[i] = Mathf::RandomRange(0.0f, 1.0f);
+		}
+
+		Vector<float> values(sample_count);
+		Vector<Color> colors(sample_count);
+		long long t = Time::GetTimeMS();
+		for (int i = 0; i < sample_count; i++)
+		{
+			values[i] = curve.Evaluate(times[i], lerps[i]);
+			colors[i] = gradient.Evaluate(times[i], lerps[i]);
+		}
+		long long analytic_ms = Time::GetTimeMS() - t;
+
+		curve.Bake();
+		gradient.Bake();
+
+		float curve_error = 0;
+		float color_error = 0;
+		t = Time::GetTimeMS();
+		for (int i = 0; i < sample_count; i++)
+		{
+			float value = curve.Evaluate(times[i], lerps[i]);
+			Color color = gradient.Evaluate(times[i], lerps[i]);
+			curve_error = Mathf::Max(curve_error, fabs(value - values[i]) / curve.curve_multiplier);
+			color_error = Mathf::Max(color_error, fabs(color.r - colors[i].r));
+			color_error = Mathf::Max(color_error, fabs(color.a - colors[i].a));
+		}
+		long long baked_ms = Time::GetTimeMS() - t;
+
+		Log("curve keys: %d ms, baked: %d ms, max error curve %f color %f", (int) analytic_ms, (int) baked_ms, curve_error, color_error);
+	}
+
+	//
+	//	longest clips of unitychan played forward frame by frame,
+	//	each curve searched by linear scan as before cursors against clip sampled with cursors
+	//
+	void BenchAnimationSample()
+	{
+		const int clip_count = 3;
+		const int loop_count = 20;
+
+		auto obj = Resource::LoadGameObject("Assets/AppAnim/unitychan.prefab");
+		obj->SetActive(false);
+
+		Vector<AnimationClip*> clips;
+		Map<AnimationClip*, int> key_counts;
+		for (const auto& i : obj->GetComponent<Animation>()->GetAnimationStates())
+		{
+			auto clip = i.second.clip.get();
+			int key_count = 0;
+			for (const auto& j : clip->curves)
+			{
+				for (const auto& k : j.second.transform_curves)
+				{
+					key_count += k.GetKeyCount();
+				}
+				for (const auto& k : j.second.blend_shape_curves)
+				{
+					key_count += k.GetKeyCount();
+				}
+			}
+
+			clips.Add(clip);
+			key_counts.Add(clip, key_count);
+		}
+		std::sort(clips.begin(), clips.end(), [&](AnimationClip* a, AnimationClip* b) {
+			return key_counts[a] > key_counts[b];
+		});
+
+		for (int i = 0; i < clips.Size() && i < clip_count; i++)
+		{
+			auto clip = clips[i];
+			int curve_count = clip->GetCurveCount();
+			if (curve_count == 0)
+			{
+				continue;
+			}
+			int frame_count = (int) (clip->length * clip->frame_rate) + 1;
+			Vector<float> values(curve_count);
+			Vector<float> samples(curve_count);
+			Vector<int> cursors(curve_count, 0);
+			float sum = 0;
+			float error = 0;
+
+			long long t = Time::GetTimeMS();
+			for (int j = 0; j < loop_count; j++)
+			{
+				for (int k = 0; k < frame_count; k++)
+				{
+					float time = k / clip->frame_rate;
+					for (const auto& binding : clip->curves)
+					{
+						for (const auto& curve : binding.second.transform_curves)
+						{
+							sum += evaluate_keys_linear(curve, time);
+						}
+						for (const auto& curve : binding.second.blend_shape_curves)
+						{
+							sum += evaluate_keys_linear(curve, time);
+						}
+					}
+				}
+			}
+			long long keys_ms = Time::GetTimeMS() - t;
+
+			t = Time::GetTimeMS();
+			for (int j = 0; j < loop_count; j++)
+			{
+				for (int k = 0; k < frame_count; k++)
+				{
+					clip->Sample(k / clip->frame_rate, &samples[0], &cursors[0]);
+					sum += samples[0];
+				}
+			}
+			long long sample_ms = Time::GetTimeMS() - t;
+
+			float time = clip->length * 0.5f;
+			for (const auto& binding : clip->curves)
+			{
+				for (int k = 0; k < binding.second.transform_curves.Size(); k++)
+				{
+					values[binding.second.transform_curve_index + k] = evaluate_keys_linear(binding.second.transform_curves[k], time);
+				}
+				for (int k = 0; k < binding.second.blend_shape_curves.Size(); k++)
+				{
+					values[binding.second.blend_shape_curve_index + k] = evaluate_keys_linear(binding.second.blend_shape_curves[k], time);
+				}
+			}
+			clip->Sample(time, &samples[0], &cursors[0]);
+			for (int j = 0; j < curve_count; j++)
+			{
+				error = Mathf::Max(error, fabs(values[j] - samples[j]));
+			}
+
+			Log("clip %s: %d curves %d keys %d frames, linear keys: %d ms, sample: %d ms, max error %f (%f)",
+				clip->GetName().CString(), curve_count, key_counts[clip], frame_count * loop_count, (int) keys_ms, (int) sample_ms, error, sum);
+		}
+
+		GameObject::Destroy(obj);
+	}
+
+	//
+	//	streams a cooked texture in front of the camera over frames: load at start level,
+	//	upgrade to level 0, evict when hidden, stay evicted without new loads, upgrade again,
+	//	start level is the last level, so evicting loads the smallest level alone
+	//
+	void StartCheckTextureStreaming()
+	{
+		const int size = 256;
+		const int level_count = StreamLevelCount;
+
+		KTX2::Image image;
+		image.width = size;
+		image.height = size;
+		image.format = TextureFormat::RGBA32;
+		for (int i = 0; i < level_count; i++)
+		{
+			int s = size >> i;
+			ByteBuffer level(s * s * 4);
+			Memory::Set(level.Bytes(), 0x40 * (i + 1), level.Size());
+			image.levels.Add(level);
+		}
+
+		m_stream_path = Application::SavePath() + "/bench_stream.ktx2";
+		File::WriteAllBytes(m_stream_path, KTX2::Save(image));
+
+		int start_size = TextureStreaming::GetStartSize();
+		TextureStreaming::SetStartSize(size >> (level_count - 1));
+		m_stream_texture = TextureStreaming::Load(m_stream_path, TextureWrapMode::Clamp, FilterMode::Bilinear);
+		TextureStreaming::SetStartSize(start_size);
+
+		if (!m_stream_texture || m_stream_texture->GetResidentLevel() != level_count - 1)
+		{
+			Log("texture streaming check: load FAILED");
+			this->EndCheckTextureStreaming();
+			return;
+		}
+
+		auto mesh = Mesh::Create();
+		mesh->vertices.Add(Vector3(-1, 1, 0));
+		mesh->vertices.Add(Vector3(-1, -1, 0));
+		mesh->vertices.Add(Vector3(1, -1, 0));
+		mesh->vertices.Add(Vector3(1, 1, 0));
+		mesh->uv.Add(Vector2(0, 0));
+		mesh->uv.Add(Vector2(0, 1));
+		mesh->uv.Add(Vector2(1, 1));
+		mesh->uv.Add(Vector2(1, 0));
+		unsigned int triangles[] = {
+			0, 1, 2, 0, 2, 3
+		};
+		mesh->triangles.AddRange(triangles, 6);
+		mesh->Apply();
+
+		auto mat = Material::Create("Diffuse");
+		mat->SetMainTexture(m_stream_texture);
+
+		// covers the screen, requests level 0
+		auto obj = GameObject::Create("stream_check");
+		auto renderer = obj->AddComponent<MeshRenderer>();
+		renderer->SetSharedMesh(mesh);
+		renderer->SetSharedMaterial(mat);
+		obj->GetTransform()->SetPosition(Vector3(0, 0, 2));
+
+		m_stream_obj = obj;
+		m_stream_phase = StreamUpgrade;
+		m_stream_frames = 0;
+	}
+
+	void UpdateCheckTextureStreaming()
+	{
+		if (m_stream_phase == StreamDone)
+		{
+			return;
+		}
+
+		const int idle_frames = 10;
+		const int timeout_frames = TextureStreaming::EvictFrames * 4;
+		int start_level = StreamLevelCount - 1;
+		int level = m_stream_texture->GetResidentLevel();
+		int pending = TextureStreaming::GetStats().pending_count;
+
+		m_stream_frames++;
+
+		switch (m_stream_phase)
+		{
+			case StreamUpgrade:
+				if (level == 0)
+				{
+					Log("texture streaming check: upgraded in %d frames", m_stream_frames);
+					m_stream_obj->SetActive(false);
+					m_stream_phase = StreamEvict;
+					m_stream_frames = 0;
+				}
+				break;
+
+			case StreamEvict:
+				if (level == start_level && pending == 0)
+				{
+					Log("texture streaming check: evicted in %d frames", m_stream_frames);
+					m_stream_phase = StreamIdle;
+					m_stream_frames = 0;
+				}
+				break;
+
+			case StreamIdle:
+				if (level != start_level || pending != 0)
+				{
+					Log("texture streaming check: evicted texture loading again FAILED");
+					this->EndCheckTextureStreaming();
+					return;
+				}
+				if (m_stream_frames >= idle_frames)
+				{
+					m_stream_obj->SetActive(true);
+					m_stream_phase = StreamUpgradeAgain;
+					m_stream_frames = 0;
+				}
+				break;
+
+			case StreamUpgradeAgain:
+				if (level == 0)
+				{
+					Log("texture streaming check: upgraded again in %d frames, passed", m_stream_frames);
+					this->EndCheckTextureStreaming();
+					return;
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		if (m_stream_frames > timeout_frames)
+		{
+			Log("texture streaming check: phase %d timeout at level %d FAILED", (int) m_stream_phase, level);
+			this->EndCheckTextureStreaming();
+		}
+	}
+
+	void EndCheckTextureStreaming()
+	{
+		if (m_stream_obj)
+		{
+			GameObject::Destroy(m_stream_obj);
+			m_stream_obj.reset();
+		}
+		m_stream_texture.reset();
+		File::Delete(m_stream_path);
+
+		m_stream_phase = StreamDone;
+	}
+
+	void LogResult(const String& name, long long bytes, long long ms)
+	{
+		Log("%s: %.1f MB in %d ms, %.1f MB/s", name.CString(), bytes / 1048576.0, (int) ms, bytes / 1048576.0 / Mathf::Max(ms, 1LL) * 1000);
+	}
+
+	static const int StreamLevelCount = 3;
+
+	enum StreamPhase
+	{
+		StreamUpgrade,
+		StreamEvict,
+		StreamIdle,
+		StreamUpgradeAgain,
+		StreamDone,
+	};
+
+	StreamPhase m_stream_phase;
+	int m_stream_frames;
+	String m_stream_path;
+	Ref<Texture2D> m_stream_texture;
+	Ref<GameObject> m_stream_obj;
+};
+
+#if 0
+void* operator new(size_t size)
+{
+	g_alloc_count++;
+	void* p = malloc(size > 0 ? size : 1);
+	if (p == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+VR_MAIN(AppBenchmark);
+#endif
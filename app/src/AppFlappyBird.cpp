@@ -764,10 +764,10 @@ void AppFlappyBird::GameOver()
 			tp->duration = 0.2f;
 			tp->from = tp->GetTransform()->GetLocalPosition();
 			tp->to = tp->from + Vector3(0, 10, 0);
-			tp->curve.keys.Clear();
-			tp->curve.keys.Add(Keyframe(0, 0, 1, 1));
-			tp->curve.keys.Add(Keyframe(0.5f, 1, 1, -1));
-			tp->curve.keys.Add(Keyframe(1, 0, -1, -1));
+			tp->curve.ClearKeys();
+			tp->curve.AddKey(Keyframe(0, 0, 1, 1));
+			tp->curve.AddKey(Keyframe(0.5f, 1, 1, -1));
+			tp->curve.AddKey(Keyframe(1, 0, -1, -1));
 
 			auto tc = over_obj->GetTransform()->Find("Image Title")->GetGameObject()->AddComponent<TweenUIColor>();
 			tc->mode = TweenUIColorMode::View;
@@ -783,9 +783,9 @@ void AppFlappyBird::GameOver()
 			tp->delay = 0.7f;
 			tp->from = tp->GetTransform()->GetLocalPosition();
 			tp->to = Vector3(0, 0, 0);
-			tp->curve.keys.Clear();
-			tp->curve.keys.Add(Keyframe(0, 0, 2, 2));
-			tp->curve.keys.Add(Keyframe(1, 1, 0, 0));
+			tp->curve.ClearKeys();
+			tp->curve.AddKey(Keyframe(0, 0, 2, 2));
+			tp->curve.AddKey(Keyframe(1, 1, 0, 0));
 
 			Timer::Start(0.7f)->on_tick = [this](Timer*) {
 				m_audio_source_swooshing.lock()->Play();
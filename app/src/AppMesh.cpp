@@ -61,7 +61,7 @@ public:
         mesh->uv.Add(Vector2(1, 1));
         mesh->uv.Add(Vector2(0, 1));
         mesh->uv.Add(Vector2(0, 0));
-        unsigned short triangles[] = {
+        unsigned int triangles[] = {
             0, 1, 2, 0, 2, 3,
             3, 2, 6, 3, 6, 7,
             7, 6, 5, 7, 5, 4,
@@ -19,13 +19,22 @@
 #include "Application.h"
 #include "GameObject.h"
 #include "Resource.h"
+#include "Debug.h"
 #include "graphics/Camera.h"
+#include "renderer/ParticleSystem.h"
 
 using namespace Viry3D;
 
+//
+//	copies of the effect on a grid as particle benchmark,
+//	average simulation time per frame goes to log
+//
 class AppParticle : public Application
 {
 public:
+	static const int CopyCount = 32;
+	static const int LogFrames = 300;
+
 	AppParticle()
     {
         this->SetName("Viry3D::AppParticle");
@@ -37,8 +46,36 @@ public:
         auto camera = GameObject::Create("camera")->AddComponent<Camera>();
 		camera->GetTransform()->SetPosition(Vector3(0, 0, -20));
 
-		Resource::LoadGameObject("Assets/AppParticle/particles.prefab");
+		auto obj = Resource::LoadGameObject("Assets/AppParticle/particles.prefab");
+		for (int i = 1; i < CopyCount; i++)
+		{
+			auto copy = GameObject::Instantiate(obj);
+			copy->GetTransform()->SetPosition(Vector3((float) (i % 8 - 4) * 2, (float) (i / 8 - 2) * 2, 0));
+		}
+
+		m_stats_last = ParticleSystem::GetStats();
+		m_frame = 0;
     }
+
+	virtual void Update()
+	{
+		if (++m_frame % LogFrames != 0)
+		{
+			return;
+		}
+
+		const auto& stats = ParticleSystem::GetStats();
+		double update_time = stats.update_time - m_stats_last.update_time;
+		long long particle_count = stats.particle_count - m_stats_last.particle_count;
+		Log("particle update: %.3f ms per frame, %d particles",
+			update_time * 1000 / LogFrames,
+			(int) (particle_count / LogFrames));
+
+		m_stats_last = stats;
+	}
+
+	ParticleSystem::Stats m_stats_last;
+	int m_frame;
 };
 
 #if 0
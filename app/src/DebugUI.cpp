@@ -26,6 +26,7 @@
 #include "tweener/TweenUIColor.h"
 #include "tweener/TweenPosition.h"
 #include "time/Time.h"
+#include "Application.h"
 
 namespace Viry3D
 {
@@ -142,10 +143,12 @@ namespace Viry3D
 	{
 		if (m_fps_text->GetGameObject()->IsActiveInHierarchy())
 		{
-			auto text = String::Format("W:%d H:%d DC:%d FPS:%d",
+			auto text = String::Format("W:%d H:%d DC:%d BDC:%d Q:%d FPS:%d",
 				Graphics::GetDisplay()->GetWidth(),
 				Graphics::GetDisplay()->GetHeight(),
 				Graphics::draw_call,
+				Graphics::dynamic_batched_draw_call,
+				Application::GetPreLoop()->GetStats().queue_depth,
 				Time::GetFPS());
 			m_fps_text->SetText(text);
 		}
@@ -20,7 +20,11 @@
 #include "Input.h"
 #include "time/Time.h"
 #include "graphics/Graphics.h"
+#include "graphics/TextureStreaming.h"
 #include "renderer/Renderer.h"
+#include "ObjectCache.h"
+#include "io/File.h"
+#include "io/Archive.h"
 
 #if VR_WINDOWS
 #include <Windows.h>
@@ -91,6 +95,7 @@ namespace Viry3D
 	{
 		m_instance = this;
 		m_start = false;
+		Profiler::SetThreadName("Main");
 		m_quit = false;
         m_paused = false;
 		m_name = "Viry3D::Application";
@@ -98,6 +103,7 @@ namespace Viry3D
 		m_init_height = 720;
 		m_init_fps = -1;
 		m_pre_runloop = RefMake<RunLoop>();
+		m_pre_runloop->SetFrameBudget(PreLoopFrameBudget);
 		m_post_runloop = RefMake<RunLoop>();
 		m_thread_pool_update = RefMake<ThreadPool>(4);
 	}
@@ -110,6 +116,7 @@ namespace Viry3D
 
 		World::Deinit();
 		Graphics::Deinit();
+		Archive::UnmountAll();
 
 		m_instance = NULL;
 	}
@@ -155,6 +162,14 @@ namespace Viry3D
 	void Application::OnInit()
 	{
 		m_start = true;
+
+		// packed assets next to data folder, made by pack_assets.py
+		auto pack_path = DataPath() + ".vpak";
+		if (File::Exist(pack_path))
+		{
+			Archive::Mount(pack_path, DataPath());
+		}
+
 		Graphics::Init(m_init_width, m_init_height, m_init_fps);
 		World::Init();
 		this->Start();
@@ -185,6 +200,7 @@ namespace Viry3D
 	void Application::OnUpdate()
 	{
 		Profiler::Reset();
+		Profiler::NewFrame();
 
 		Profiler::SampleBegin("Application::OnUpdate");
 
@@ -196,6 +212,8 @@ namespace Viry3D
 		World::Update();
 		m_post_runloop->Run();
 		m_thread_pool_update->Wait();
+		ObjectCache::Update();
+		TextureStreaming::Update();
 
 #if VR_ANDROID
 		if (Input::GetKeyDown(KeyCode::Backspace))
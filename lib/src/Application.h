@@ -35,6 +35,8 @@ namespace Viry3D
 		static void Quit();
 		static void RunTaskInPreLoop(const RunLoop::Task& task);
 		static void RunTaskInPostLoop(const RunLoop::Task& task);
+		static RunLoop* GetPreLoop() { return m_instance->m_pre_runloop.get(); }
+		static RunLoop* GetPostLoop() { return m_instance->m_post_runloop.get(); }
 		static const String& DataPath();
 		static const String& SavePath();
 		static void SetDataPath(const String& path);
@@ -63,6 +65,11 @@ namespace Viry3D
 	protected:
 		Application();
 
+		//
+		//	ms per frame for async done callbacks and other once tasks in pre loop
+		//
+		static const int PreLoopFrameBudget = 4;
+
 	private:
 		static Application* m_instance;
 		static String m_data_path;
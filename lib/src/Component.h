@@ -31,6 +31,7 @@ namespace Viry3D
 
 	private:
 		friend class GameObject;
+		friend class World;
 
 	public:
 		//
@@ -63,6 +64,11 @@ namespace Viry3D
 		virtual void OnTranformHierarchyChanged() { }
 		virtual void OnLayerChanged() { }
 		virtual void OnPostRender() { }
+		//
+		//	return true if Update and LateUpdate only touch this component's own state,
+		//	then they can run on update threads when World parallel update is enabled
+		//
+		virtual bool IsThreadSafeUpdate() const { return false; }
 
 		WeakRef<GameObject> m_gameobject;
 		WeakRef<Transform> m_transform;
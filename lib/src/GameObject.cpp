@@ -163,6 +163,21 @@ namespace Viry3D
 		}
 	}
 
+	void GameObject::SetStatic(bool value)
+	{
+		if (m_static != value)
+		{
+			m_static = value;
+
+			// static flag is in pass sort key
+			auto renderers = GetComponents<Renderer>();
+			for (auto& i : renderers)
+			{
+				Renderer::SetRendererDirty(i.get());
+			}
+		}
+	}
+
 	void GameObject::SetLayerRecursively(int layer)
 	{
 		this->SetLayer(layer);
@@ -202,7 +217,7 @@ namespace Viry3D
 		} while (!starts.Empty());
 	}
 
-	void GameObject::Update()
+	void GameObject::Update(Vector<Ref<Component>>* parallel)
 	{
 		for (const auto& i : m_components)
 		{
@@ -213,12 +228,19 @@ namespace Viry3D
 
 			if (i->IsEnable())
 			{
-				i->Update();
+				if (parallel != NULL && i->IsThreadSafeUpdate())
+				{
+					parallel->Add(i);
+				}
+				else
+				{
+					i->Update();
+				}
 			}
 		}
 	}
 
-	void GameObject::LateUpdate()
+	void GameObject::LateUpdate(Vector<Ref<Component>>* parallel)
 	{
 		for (const auto& i : m_components)
 		{
@@ -229,7 +251,14 @@ namespace Viry3D
 
 			if (i->IsEnable())
 			{
-				i->LateUpdate();
+				if (parallel != NULL && i->IsThreadSafeUpdate())
+				{
+					parallel->Add(i);
+				}
+				else
+				{
+					i->LateUpdate();
+				}
 			}
 		}
 
@@ -58,7 +58,7 @@ namespace Viry3D
 		bool IsActiveSelf() const { return m_active_self; }
 		void SetActive(bool active);
 		bool IsStatic() const { return m_static; }
-		void SetStatic(bool value) { m_static = value; }
+		void SetStatic(bool value);
 		void SetName(const String& name);
 		int GetLayer() const { return m_layer; }
 		void SetLayer(int layer);
@@ -68,8 +68,8 @@ namespace Viry3D
 		GameObject(const String& name);
 		void Delete();
 		void Start();
-		void Update();
-		void LateUpdate();
+		void Update(Vector<Ref<Component>>* parallel = NULL);
+		void LateUpdate(Vector<Ref<Component>>* parallel = NULL);
 		void AddComponent(const Ref<Component>& com);
 		void SetActiveInHierarchy(bool active);
 		void CopyComponent(const Ref<Component>& com);
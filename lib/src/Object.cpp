@@ -19,42 +19,23 @@
 
 namespace Viry3D
 {
-	Map<String, Ref<Object>> Object::m_cache;
-	Mutex Object::m_mutex;
-
 	void Object::Init()
 	{
 	}
 
 	void Object::Deinit()
 	{
-		m_mutex.lock();
-		m_cache.Clear();
-		m_mutex.unlock();
+		ObjectCache::Clear();
 	}
 
 	Ref<Object> Object::GetCache(const String& path)
 	{
-		Ref<Object> obj;
-
-		m_mutex.lock();
-
-		Ref<Object>* ptr;
-		if (m_cache.TryGet(path, &ptr))
-		{
-			obj = *ptr;
-		}
-
-		m_mutex.unlock();
-
-		return obj;
+		return ObjectCache::Get(path);
 	}
 
-	void Object::AddCache(const String& path, const Ref<Object>& obj)
+	void Object::AddCache(const String& path, const Ref<Object>& obj, ObjectCache::Type type, int bytes)
 	{
-		m_mutex.lock();
-		m_cache.Add(path, obj);
-		m_mutex.unlock();
+		ObjectCache::Add(path, obj, type, bytes);
 	}
 
 	Object::Object():
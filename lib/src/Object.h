@@ -23,6 +23,7 @@
 #include "thread/Thread.h"
 #include "Debug.h"
 #include "Profiler.h"
+#include "ObjectCache.h"
 #include <assert.h>
 
 namespace Viry3D
@@ -48,7 +49,7 @@ namespace Viry3D
 		//
 		//	̰߳ȫ
 		//
-		static void AddCache(const String& path, const Ref<Object>& obj);
+		static void AddCache(const String& path, const Ref<Object>& obj, ObjectCache::Type type = ObjectCache::Type::Other, int bytes = 0);
 
 		Object();
 		virtual ~Object();
@@ -64,8 +65,5 @@ namespace Viry3D
 	private:
 		Object(const Object& obj) { }
 		Object& operator =(const Object& obj) { return *this; }
-
-		static Map<String, Ref<Object>> m_cache;
-		static Mutex m_mutex;
 	};
 }
@@ -0,0 +1,234 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ObjectCache.h"
+#include "Object.h"
+#include <functional>
+
+namespace Viry3D
+{
+	ObjectCache::Shard ObjectCache::m_shards[ShardCount];
+	int ObjectCache::m_evict_shard = 0;
+	std::atomic<long long> ObjectCache::m_budget(256 * 1024 * 1024);
+	std::atomic<long long> ObjectCache::m_bytes(0);
+	std::atomic<long long> ObjectCache::m_type_bytes[(int) Type::Count];
+	std::atomic<long long> ObjectCache::m_hit_count(0);
+	std::atomic<long long> ObjectCache::m_miss_count(0);
+	std::atomic<long long> ObjectCache::m_evict_count(0);
+	std::atomic<long long> ObjectCache::m_evict_bytes(0);
+	std::atomic<int> ObjectCache::m_entry_count(0);
+
+	ObjectCache::Shard& ObjectCache::GetShard(const String& path)
+	{
+		size_t hash = std::hash<std::string>()(path.CString());
+		return m_shards[hash % ShardCount];
+	}
+
+	Ref<Object> ObjectCache::Get(const String& path)
+	{
+		Ref<Object> obj;
+		auto& shard = GetShard(path);
+
+		shard.mutex.lock();
+
+		int* index;
+		if (shard.index.TryGet(path, &index))
+		{
+			auto& entry = shard.entries[*index];
+			entry.referenced = true;
+			obj = entry.obj;
+		}
+
+		shard.mutex.unlock();
+
+		if (obj)
+		{
+			m_hit_count++;
+		}
+		else
+		{
+			m_miss_count++;
+		}
+
+		return obj;
+	}
+
+	void ObjectCache::Add(const String& path, const Ref<Object>& obj, Type type, int bytes)
+	{
+		auto& shard = GetShard(path);
+
+		shard.mutex.lock();
+
+		int* index;
+		if (shard.index.TryGet(path, &index))
+		{
+			auto& entry = shard.entries[*index];
+			m_bytes -= entry.bytes;
+			m_type_bytes[(int) entry.type] -= entry.bytes;
+
+			entry.obj = obj;
+			entry.type = type;
+			entry.bytes = bytes;
+			entry.referenced = true;
+		}
+		else
+		{
+			int i;
+			if (shard.free.Size() > 0)
+			{
+				i = shard.free[shard.free.Size() - 1];
+				shard.free.Remove(shard.free.Size() - 1);
+			}
+			else
+			{
+				i = shard.entries.Size();
+				shard.entries.Add(Entry());
+			}
+
+			auto& entry = shard.entries[i];
+			entry.path = path;
+			entry.obj = obj;
+			entry.type = type;
+			entry.bytes = bytes;
+			entry.referenced = true;
+
+			shard.index.Add(path, i);
+			m_entry_count++;
+		}
+
+		m_bytes += bytes;
+		m_type_bytes[(int) type] += bytes;
+
+		shard.mutex.unlock();
+	}
+
+	void ObjectCache::Clear()
+	{
+		for (int i = 0; i < ShardCount; i++)
+		{
+			auto& shard = m_shards[i];
+
+			shard.mutex.lock();
+			shard.index.Clear();
+			shard.entries.Clear();
+			shard.free.Clear();
+			shard.hand = 0;
+			shard.mutex.unlock();
+		}
+
+		m_bytes = 0;
+		for (int i = 0; i < (int) Type::Count; i++)
+		{
+			m_type_bytes[i] = 0;
+		}
+		m_entry_count = 0;
+	}
+
+	bool ObjectCache::EvictOne(Shard& shard, Vector<Ref<Object>>& evicted)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		int count = shard.entries.Size();
+
+		// second sweep sees entries whose referenced bit was cleared in first sweep
+		for (int step = 0; step < count * 2; step++)
+		{
+			int i = shard.hand;
+			shard.hand = (shard.hand + 1) % count;
+
+			auto& entry = shard.entries[i];
+			if (!entry.obj)
+			{
+				continue;
+			}
+
+			if (entry.referenced)
+			{
+				entry.referenced = false;
+				continue;
+			}
+
+			// in use outside cache
+			if (entry.obj.use_count() > 1)
+			{
+				continue;
+			}
+
+			evicted.Add(entry.obj);
+			shard.index.Remove(entry.path);
+			shard.free.Add(i);
+
+			m_bytes -= entry.bytes;
+			m_type_bytes[(int) entry.type] -= entry.bytes;
+			m_evict_bytes += entry.bytes;
+			m_evict_count++;
+			m_entry_count--;
+
+			entry.obj.reset();
+			entry.path = String();
+			entry.bytes = 0;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void ObjectCache::Update()
+	{
+		if (m_budget <= 0 || m_bytes <= m_budget)
+		{
+			return;
+		}
+
+		// objects released after shard locks, destructors may touch cache
+		Vector<Ref<Object>> evicted;
+		int fail_count = 0;
+
+		while (m_bytes > m_budget && fail_count < ShardCount)
+		{
+			auto& shard = m_shards[m_evict_shard];
+			m_evict_shard = (m_evict_shard + 1) % ShardCount;
+
+			if (EvictOne(shard, evicted))
+			{
+				fail_count = 0;
+			}
+			else
+			{
+				fail_count++;
+			}
+		}
+	}
+
+	ObjectCache::Stats ObjectCache::GetStats()
+	{
+		Stats stats;
+		stats.hit_count = m_hit_count;
+		stats.miss_count = m_miss_count;
+		stats.evict_count = m_evict_count;
+		stats.evict_bytes = m_evict_bytes;
+		stats.bytes = m_bytes;
+		for (int i = 0; i < (int) Type::Count; i++)
+		{
+			stats.type_bytes[i] = m_type_bytes[i];
+		}
+		stats.entry_count = m_entry_count;
+
+		return stats;
+	}
+}
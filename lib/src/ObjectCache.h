@@ -0,0 +1,115 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "string/String.h"
+#include "memory/Ref.h"
+#include "container/Map.h"
+#include "container/Vector.h"
+#include "thread/Thread.h"
+#include <atomic>
+
+namespace Viry3D
+{
+	class Object;
+
+	//
+	//	path keyed asset cache, thread safe with locks sharded by path hash,
+	//	tracks bytes per asset type against a memory budget,
+	//	entries only referenced by the cache are evicted in clock order on main thread
+	//
+	class ObjectCache
+	{
+	public:
+		enum class Type
+		{
+			Texture,
+			Atlas,
+			Font,
+			Mesh,
+			Material,
+			AnimationClip,
+			Prefab,
+			Other,
+
+			Count
+		};
+
+		struct Stats
+		{
+			long long hit_count;
+			long long miss_count;
+			long long evict_count;
+			long long evict_bytes;
+			long long bytes;
+			long long type_bytes[(int) Type::Count];
+			int entry_count;
+		};
+
+		static const int ShardCount = 16;
+
+		static Ref<Object> Get(const String& path);
+		static void Add(const String& path, const Ref<Object>& obj, Type type, int bytes);
+		static void Clear();
+		//
+		//	evict until bytes under budget, called once per frame on main thread
+		//
+		static void Update();
+		//
+		//	0 means no limit
+		//
+		static void SetMemoryBudget(long long bytes) { m_budget = bytes; }
+		static long long GetMemoryBudget() { return m_budget; }
+		static Stats GetStats();
+
+	private:
+		struct Entry
+		{
+			String path;
+			Ref<Object> obj;
+			Type type;
+			int bytes;
+			bool referenced;
+		};
+
+		struct Shard
+		{
+			Map<String, int> index;
+			Vector<Entry> entries;
+			Vector<int> free;
+			int hand;
+			Mutex mutex;
+
+			Shard(): hand(0) { }
+		};
+
+		static Shard& GetShard(const String& path);
+		static bool EvictOne(Shard& shard, Vector<Ref<Object>>& evicted);
+
+		static Shard m_shards[ShardCount];
+		static int m_evict_shard;
+		static std::atomic<long long> m_budget;
+		static std::atomic<long long> m_bytes;
+		static std::atomic<long long> m_type_bytes[(int) Type::Count];
+		static std::atomic<long long> m_hit_count;
+		static std::atomic<long long> m_miss_count;
+		static std::atomic<long long> m_evict_count;
+		static std::atomic<long long> m_evict_bytes;
+		static std::atomic<int> m_entry_count;
+	};
+}
@@ -17,11 +17,129 @@
 
 #include "Profiler.h"
 #include "time/Time.h"
+#include "io/File.h"
+#include "math/Mathf.h"
+#include <chrono>
 
 namespace Viry3D
 {
 	Map<String, ProfilerSample> Profiler::m_samples;
 	List<ProfilerSample*> Profiler::m_current_samples;
+	Map<unsigned int, String> Profiler::m_names;
+	Map<String, long long> Profiler::m_counters;
+	Vector<Ref<ProfilerRing>> Profiler::m_rings;
+	Mutex Profiler::m_mutex;
+	std::atomic<bool> Profiler::m_capturing(false);
+	bool Profiler::m_capture_pending = false;
+	bool Profiler::m_capture_ready = false;
+	int Profiler::m_capture_frames = 0;
+	int Profiler::m_capture_frame_index = 0;
+	String Profiler::m_capture_path;
+	Vector<Profiler::CaptureEvent> Profiler::m_capture_events;
+	Vector<Profiler::CaptureCounter> Profiler::m_capture_counters;
+	Vector<long long> Profiler::m_capture_frame_times;
+	Vector<ProfilerEvent> Profiler::m_drain_buffer;
+
+	static thread_local ProfilerRing* g_ring = NULL;
+
+	static long long get_time_ns()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//
+	//	quote, backslash and control characters escaped, other bytes copied as utf-8
+	//
+	static String escape_json(const String& str)
+	{
+		String escaped;
+		const char* s = str.CString();
+		int start = 0;
+
+		for (int i = 0; i < str.Size(); i++)
+		{
+			unsigned char c = (unsigned char) s[i];
+			if (c != '\\' && c != '"' && c >= 0x20)
+			{
+				continue;
+			}
+
+			if (i > start)
+			{
+				escaped += String(&s[start], i - start);
+			}
+
+			if (c == '\\' || c == '"')
+			{
+				char pair[2] = { '\\', (char) c };
+				escaped += String(pair, 2);
+			}
+			else
+			{
+				escaped += String::Format("\\u%04x", c);
+			}
+
+			start = i + 1;
+		}
+
+		if (str.Size() > start)
+		{
+			escaped += String(&s[start], str.Size() - start);
+		}
+
+		return escaped;
+	}
+
+	ProfilerSampleId::ProfilerSampleId(const char* name, unsigned int id):
+		id(id)
+	{
+		Profiler::InternName(name, id);
+	}
+
+	ProfilerRing::ProfilerRing(int index):
+		index(index),
+		depth(0),
+		drop_depth(-1),
+		drop_count(0),
+		m_head(0),
+		m_tail(0)
+	{
+	}
+
+	bool ProfilerRing::Push(const ProfilerEvent& e)
+	{
+		unsigned int head = m_head.load(std::memory_order_relaxed);
+		unsigned int tail = m_tail.load(std::memory_order_acquire);
+
+		if (head - tail >= (unsigned int) Capacity)
+		{
+			return false;
+		}
+
+		// only owner thread pushes, storage allocated on first capture
+		if (m_events.Empty())
+		{
+			m_events.Resize(Capacity);
+		}
+
+		m_events[head & (Capacity - 1)] = e;
+		m_head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	void ProfilerRing::Drain(Vector<ProfilerEvent>& events)
+	{
+		unsigned int tail = m_tail.load(std::memory_order_relaxed);
+		unsigned int head = m_head.load(std::memory_order_acquire);
+
+		for (unsigned int i = tail; i != head; i++)
+		{
+			events.Add(m_events[i & (Capacity - 1)]);
+		}
+
+		m_tail.store(head, std::memory_order_release);
+	}
 
 	void Profiler::Reset()
 	{
@@ -51,6 +169,13 @@ namespace Viry3D
 		sample->time_begin = Time::GetRealTimeSinceStartup();
 
 		m_current_samples.AddFirst(sample);
+
+		unsigned int id = 0;
+		if (m_capturing.load(std::memory_order_relaxed))
+		{
+			id = InternName(name.CString(), ProfilerHash(name.CString()));
+		}
+		TraceBegin(id);
 	}
 
 	void Profiler::SampleEnd()
@@ -62,6 +187,8 @@ namespace Viry3D
 
 			sample->time += Time::GetRealTimeSinceStartup() - sample->time_begin;
 			sample->call_count++;
+
+			TraceEnd(0);
 		}
 	}
 
@@ -69,4 +196,295 @@ namespace Viry3D
 	{
 		return m_samples[name];
 	}
+
+	void Profiler::SetCounter(const String& name, long long value)
+	{
+		long long* ptr;
+		if (m_counters.TryGet(name, &ptr))
+		{
+			*ptr = value;
+		}
+		else
+		{
+			m_counters.Add(name, value);
+		}
+
+		if (m_capturing.load(std::memory_order_relaxed))
+		{
+			m_capture_counters.Add({ name, get_time_ns(), value });
+		}
+	}
+
+	unsigned int Profiler::InternName(const char* name, unsigned int id)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_names.Contains(id))
+		{
+			m_names.Add(id, name);
+		}
+
+		return id;
+	}
+
+	ProfilerRing* Profiler::GetRing()
+	{
+		if (g_ring == NULL)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto ring = RefMake<ProfilerRing>(m_rings.Size());
+			ring->name = String::Format("Thread %d", ring->index);
+			m_rings.Add(ring);
+
+			g_ring = ring.get();
+		}
+
+		return g_ring;
+	}
+
+	void Profiler::SetThreadName(const String& name)
+	{
+		auto ring = GetRing();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ring->name = name;
+	}
+
+	void Profiler::TraceBegin(unsigned int id)
+	{
+		auto ring = GetRing();
+		int depth = ring->depth++;
+
+		if (!m_capturing.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		// drop whole subtree if ring full, keep begin / end pairs balanced
+		if (ring->drop_depth >= 0)
+		{
+			ring->drop_count++;
+			return;
+		}
+
+		ProfilerEvent e;
+		e.time = get_time_ns();
+		e.id = id;
+		e.type = ProfilerEvent::Begin;
+
+		if (!ring->Push(e))
+		{
+			ring->drop_depth = depth;
+			ring->drop_count++;
+		}
+	}
+
+	void Profiler::TraceEnd(unsigned int id)
+	{
+		auto ring = GetRing();
+		int depth = --ring->depth;
+		if (depth < 0)
+		{
+			ring->depth = 0;
+			depth = 0;
+		}
+
+		if (ring->drop_depth >= 0)
+		{
+			if (depth <= ring->drop_depth)
+			{
+				ring->drop_depth = -1;
+			}
+			ring->drop_count++;
+			return;
+		}
+
+		if (!m_capturing.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		ProfilerEvent e;
+		e.time = get_time_ns();
+		e.id = id;
+		e.type = ProfilerEvent::End;
+
+		if (!ring->Push(e))
+		{
+			ring->drop_count++;
+		}
+	}
+
+	void Profiler::DrainRings()
+	{
+		Vector<Ref<ProfilerRing>> rings;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			rings = m_rings;
+		}
+
+		for (const auto& ring : rings)
+		{
+			m_drain_buffer.Clear();
+			ring->Drain(m_drain_buffer);
+
+			for (const auto& e : m_drain_buffer)
+			{
+				CaptureEvent c;
+				c.e = e;
+				c.thread = ring->index;
+				m_capture_events.Add(c);
+			}
+		}
+	}
+
+	void Profiler::BeginCapture(int frame_count, const String& path)
+	{
+		m_capture_frames = Mathf::Max(frame_count, 1);
+		m_capture_path = path;
+		m_capture_pending = true;
+		m_capture_ready = false;
+	}
+
+	void Profiler::NewFrame()
+	{
+		if (m_capturing)
+		{
+			DrainRings();
+			m_capture_frame_index++;
+
+			if (m_capture_frame_index >= m_capture_frames)
+			{
+				m_capture_frame_times.Add(get_time_ns());
+				m_capturing = false;
+				DrainRings();
+				m_capture_ready = true;
+
+				if (!m_capture_path.Empty())
+				{
+					SaveCapture(m_capture_path);
+				}
+			}
+			else
+			{
+				m_capture_frame_times.Add(get_time_ns());
+			}
+		}
+
+		if (m_capture_pending)
+		{
+			m_capture_pending = false;
+			m_capture_frame_index = 0;
+
+			// events pushed after last capture stopped and drops counted since belong to no capture
+			DrainRings();
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (const auto& ring : m_rings)
+				{
+					ring->drop_count = 0;
+				}
+			}
+
+			m_capture_events.Clear();
+			m_capture_counters.Clear();
+			m_capture_frame_times.Clear();
+			m_capture_frame_times.Add(get_time_ns());
+			m_capturing = true;
+		}
+	}
+
+	String Profiler::GetCaptureJson()
+	{
+		if (m_capture_frame_times.Empty())
+		{
+			return "";
+		}
+
+		Map<unsigned int, String> names;
+		Vector<Ref<ProfilerRing>> rings;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			names = m_names;
+			rings = m_rings;
+		}
+
+		long long time_base = m_capture_frame_times[0];
+		long long time_end = m_capture_frame_times[m_capture_frame_times.Size() - 1];
+		int drop_count = 0;
+
+		String json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Viry3D\"}}";
+
+		for (const auto& ring : rings)
+		{
+			json += String::Format(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+				ring->index, escape_json(ring->name).CString());
+			drop_count += ring->drop_count;
+		}
+
+		for (int i = 0; i < m_capture_frame_times.Size() - 1; i++)
+		{
+			json += String::Format(",\n{\"name\":\"Frame %d\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}",
+				i, (m_capture_frame_times[i] - time_base) / 1000.0);
+		}
+
+		// begin / end stack per thread, end without begin is skipped, begin without end closed at capture end
+		Vector<int> depths(rings.Size(), 0);
+
+		for (const auto& c : m_capture_events)
+		{
+			if (c.thread >= depths.Size())
+			{
+				depths.Resize(c.thread + 1);
+				depths[c.thread] = 0;
+			}
+
+			if (c.e.type == ProfilerEvent::Begin)
+			{
+				String* name_ptr;
+				String name = "Unknown";
+				if (names.TryGet(c.e.id, &name_ptr))
+				{
+					name = *name_ptr;
+				}
+
+				json += String::Format(",\n{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+					escape_json(name).CString(), c.thread, (c.e.time - time_base) / 1000.0);
+				depths[c.thread]++;
+			}
+			else if (depths[c.thread] > 0)
+			{
+				json += String::Format(",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+					c.thread, (c.e.time - time_base) / 1000.0);
+				depths[c.thread]--;
+			}
+		}
+
+		for (const auto& c : m_capture_counters)
+		{
+			json += String::Format(",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+				escape_json(c.name).CString(), (c.time - time_base) / 1000.0, c.value);
+		}
+
+		for (int i = 0; i < depths.Size(); i++)
+		{
+			for (int j = 0; j < depths[i]; j++)
+			{
+				json += String::Format(",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+					i, (time_end - time_base) / 1000.0);
+			}
+		}
+
+		json += String::Format("\n],\"otherData\":{\"frames\":%d,\"dropped_events\":%d}}\n",
+			m_capture_frame_times.Size() - 1, drop_count);
+
+		return json;
+	}
+
+	void Profiler::SaveCapture(const String& path)
+	{
+		File::WriteAllText(path, GetCaptureJson());
+	}
 }
@@ -20,9 +20,32 @@
 #include "string/String.h"
 #include "container/Map.h"
 #include "container/List.h"
+#include "container/Vector.h"
+#include "thread/Thread.h"
+#include <atomic>
+#include <type_traits>
+
+#define VR_PROFILE_CONCAT_INNER(a, b) a##b
+#define VR_PROFILE_CONCAT(a, b) VR_PROFILE_CONCAT_INNER(a, b)
+
+//
+//	scoped trace sample, name must be a string literal,
+//	id is hashed at compile time and name is interned once per call site
+//
+#define VR_PROFILE_SCOPE(name) \
+	static const Viry3D::ProfilerSampleId VR_PROFILE_CONCAT(_profiler_id_, __LINE__)(name, std::integral_constant<unsigned int, Viry3D::ProfilerHash(name)>::value); \
+	Viry3D::ProfilerScope VR_PROFILE_CONCAT(_profiler_scope_, __LINE__)(VR_PROFILE_CONCAT(_profiler_id_, __LINE__))
 
 namespace Viry3D
 {
+	//
+	//	fnv-1a
+	//
+	constexpr unsigned int ProfilerHash(const char* str, unsigned int hash = 2166136261u)
+	{
+		return *str ? ProfilerHash(str + 1, (hash ^ (unsigned char) *str) * 16777619u) : hash;
+	}
+
 	struct ProfilerSample
 	{
 		float time;
@@ -30,6 +53,50 @@ namespace Viry3D
 		float time_begin;
 	};
 
+	struct ProfilerSampleId
+	{
+		ProfilerSampleId(const char* name, unsigned int id);
+
+		unsigned int id;
+	};
+
+	struct ProfilerEvent
+	{
+		enum
+		{
+			Begin,
+			End,
+		};
+
+		long long time;
+		unsigned int id;
+		int type;
+	};
+
+	//
+	//	one per thread, written only by its own thread, drained by main thread at frame begin
+	//
+	class ProfilerRing
+	{
+	public:
+		static const int Capacity = 1 << 16;
+
+		ProfilerRing(int index);
+		bool Push(const ProfilerEvent& e);
+		void Drain(Vector<ProfilerEvent>& events);
+
+		int index;
+		String name;
+		int depth;
+		int drop_depth;
+		std::atomic<int> drop_count;
+
+	private:
+		Vector<ProfilerEvent> m_events;
+		std::atomic<unsigned int> m_head;
+		std::atomic<unsigned int> m_tail;
+	};
+
 	class Profiler
 	{
 	public:
@@ -38,9 +105,77 @@ namespace Viry3D
 		static void SampleEnd();
 		static const Map<String, ProfilerSample>& GetSamples() { return m_samples; }
 		static const ProfilerSample& GetSample(const String& name);
+		//
+		//	named value, main thread only, written to trace as counter track while capturing
+		//
+		static void SetCounter(const String& name, long long value);
+		static const Map<String, long long>& GetCounters() { return m_counters; }
+
+		//
+		//	trace mode,
+		//	records begin / end events of all threads for next frame_count frames,
+		//	writes chrome trace json to path when done if path not empty
+		//
+		static void BeginCapture(int frame_count, const String& path = "");
+		static void NewFrame();
+		static bool IsCapturing() { return m_capturing; }
+		static bool IsCaptureReady() { return m_capture_ready; }
+		static String GetCaptureJson();
+		static void SaveCapture(const String& path);
+		static void SetThreadName(const String& name);
+		static void TraceBegin(unsigned int id);
+		static void TraceEnd(unsigned int id);
+		static unsigned int InternName(const char* name, unsigned int id);
 
 	private:
+		struct CaptureEvent
+		{
+			ProfilerEvent e;
+			int thread;
+		};
+
+		struct CaptureCounter
+		{
+			String name;
+			long long time;
+			long long value;
+		};
+
+		static ProfilerRing* GetRing();
+		static void DrainRings();
+
 		static Map<String, ProfilerSample> m_samples;
 		static List<ProfilerSample*> m_current_samples;
+		static Map<unsigned int, String> m_names;
+		static Map<String, long long> m_counters;
+		static Vector<Ref<ProfilerRing>> m_rings;
+		static Mutex m_mutex;
+		static std::atomic<bool> m_capturing;
+		static bool m_capture_pending;
+		static bool m_capture_ready;
+		static int m_capture_frames;
+		static int m_capture_frame_index;
+		static String m_capture_path;
+		static Vector<CaptureEvent> m_capture_events;
+		static Vector<CaptureCounter> m_capture_counters;
+		static Vector<long long> m_capture_frame_times;
+		static Vector<ProfilerEvent> m_drain_buffer;
+	};
+
+	class ProfilerScope
+	{
+	public:
+		ProfilerScope(const ProfilerSampleId& id): m_id(id.id)
+		{
+			Profiler::TraceBegin(m_id);
+		}
+
+		~ProfilerScope()
+		{
+			Profiler::TraceEnd(m_id);
+		}
+
+	private:
+		unsigned int m_id;
 	};
 }
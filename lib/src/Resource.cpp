@@ -21,13 +21,19 @@
 #include "World.h"
 #include "Debug.h"
 #include "io/File.h"
+#include "io/AsyncFile.h"
 #include "io/MemoryStream.h"
+#include "string/StringPool.h"
 #include "graphics/Mesh.h"
+#include "graphics/MeshFile.h"
 #include "graphics/Material.h"
 #include "graphics/Graphics.h"
 #include "graphics/Display.h"
 #include "graphics/LightmapSettings.h"
 #include "graphics/Cubemap.h"
+#include "graphics/TextureTranscoder.h"
+#include "graphics/TextureStreaming.h"
+#include "graphics/ImageDecoder.h"
 #include "ui/UICanvasRenderer.h"
 #include "ui/UISprite.h"
 #include "ui/Atlas.h"
@@ -40,17 +46,207 @@
 #include "thread/Thread.h"
 #include "animation/AnimationClip.h"
 #include "animation/Animation.h"
+#include "math/Mathf.h"
+#include <condition_variable>
+#include <thread>
+#include <string.h>
 
 namespace Viry3D
 {
 	Ref<ThreadPool> Resource::m_thread_res_load;
+	Ref<ThreadPool> Resource::m_thread_res_decode;
+
+	//
+	//	names, paths and type names repeat across prefabs and their dependencies,
+	//	interned per loader thread for one load, reading a known one allocates nothing
+	//
+	static thread_local StringPool g_string_pool;
+	static thread_local int g_string_pool_depth = 0;
+
+	//
+	//	put at top of every load entry, outermost one on a thread clears pool when done,
+	//	so references from read_string must not be kept after load
+	//
+	struct StringPoolScope
+	{
+		StringPoolScope()
+		{
+			g_string_pool_depth++;
+		}
 
-	static String read_string(MemoryStream& ms)
+		~StringPoolScope()
+		{
+			if (--g_string_pool_depth == 0)
+			{
+				g_string_pool.Clear();
+			}
+		}
+	};
+
+	static const String& read_string(MemoryStream& ms)
+	{
+		static const String empty;
+
+		assert(g_string_pool_depth > 0);
+
+		auto size = ms.Read<int>();
+		const byte* str = ms.ReadPointer(size);
+		if (str == nullptr || size <= 0)
+		{
+			return empty;
+		}
+
+		return g_string_pool.Intern((const char*) str, size);
+	}
+
+	//
+	//	one-off strings like label text, not interned
+	//
+	static String read_text(MemoryStream& ms)
 	{
 		auto size = ms.Read<int>();
 		return ms.ReadString(size);
 	}
 
+	//
+	//	prefetch, cpu side work of prefab dependencies done on decode threads before prefab parsed,
+	//	gpu objects are still created by read_* on the thread which loads the prefab
+	//
+	struct PrefetchedImage
+	{
+		ByteBuffer colors;
+		int width;
+		int height;
+		TextureFormat format;
+	};
+
+	struct PrefetchedMesh
+	{
+		Ref<Mesh> mesh;
+		int bytes;
+	};
+
+	struct LoadedMesh
+	{
+		Ref<Mesh> mesh;
+		bool coarse_only;
+	};
+
+	static Mutex g_prefetch_mutex;
+	static std::condition_variable g_prefetch_condition;
+	static Map<String, bool> g_prefetch_done;
+	static Map<String, PrefetchedImage> g_prefetch_images;
+	static Map<String, PrefetchedMesh> g_prefetch_meshes;
+
+	static bool take_prefetched_image(const String& path, PrefetchedImage& image)
+	{
+		std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+
+		PrefetchedImage* ptr;
+		if (g_prefetch_images.TryGet(path, &ptr))
+		{
+			image = *ptr;
+			g_prefetch_images.Remove(path);
+			return true;
+		}
+
+		return false;
+	}
+
+	static Ref<Mesh> take_prefetched_mesh(const String& path, int& bytes)
+	{
+		std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+
+		Ref<Mesh> mesh;
+
+		PrefetchedMesh* ptr;
+		if (g_prefetch_meshes.TryGet(path, &ptr))
+		{
+			mesh = ptr->mesh;
+			bytes = ptr->bytes;
+			g_prefetch_meshes.Remove(path);
+		}
+
+		return mesh;
+	}
+
+	//
+	//	cooked ktx2 next to source image, made by TextureTranscoder::CookFile
+	//
+	static String cooked_texture_path(const String& image_path)
+	{
+		int dot = image_path.LastIndexOf(".");
+		if (dot < 0)
+		{
+			return image_path + ".ktx2";
+		}
+
+		return image_path.Substring(0, dot) + ".ktx2";
+	}
+
+	//
+	//	cooked vmesh next to source mesh, made by Resource::CookMesh
+	//
+	static String cooked_mesh_path(const String& mesh_path)
+	{
+		int dot = mesh_path.LastIndexOf(".");
+		if (dot < 0)
+		{
+			return mesh_path + ".vmesh";
+		}
+
+		return mesh_path.Substring(0, dot) + ".vmesh";
+	}
+
+	static int texture_memory_size(int width, int height, TextureFormat format, bool mipmap, int face_count)
+	{
+		int bpp;
+		switch (format)
+		{
+			case TextureFormat::R8:
+				bpp = 1;
+				break;
+			case TextureFormat::R16:
+			case TextureFormat::RG16:
+			case TextureFormat::RGB565:
+			case TextureFormat::RHalf:
+				bpp = 2;
+				break;
+			case TextureFormat::RGB24:
+				bpp = 3;
+				break;
+			case TextureFormat::RGHalf:
+			case TextureFormat::RFloat:
+				bpp = 4;
+				break;
+			case TextureFormat::RGBAHalf:
+			case TextureFormat::RGFloat:
+				bpp = 8;
+				break;
+			case TextureFormat::RGBFloat:
+				bpp = 12;
+				break;
+			case TextureFormat::RGBAFloat:
+				bpp = 16;
+				break;
+			default:
+				bpp = 4;
+				break;
+		}
+
+		int size = width * height * bpp * face_count;
+		if (TextureTranscoder::IsCompressed(format))
+		{
+			size = TextureTranscoder::GetLevelSize(format, width, height) * face_count;
+		}
+		if (mipmap)
+		{
+			size = size * 4 / 3;
+		}
+
+		return size;
+	}
+
 	static Ref<Texture> read_texture(const String& path)
 	{
 		Ref<Texture> texture;
@@ -68,14 +264,14 @@ namespace Viry3D
 		}
 		else
 		{
-			auto ms = MemoryStream(File::ReadAllBytes(full_path));
+			auto ms = MemoryStream(File::MapAllBytes(full_path));
 
-			auto texture_name = read_string(ms);
+			read_string(ms);	//	texture_name
 			auto width = ms.Read<int>();
 			auto height = ms.Read<int>();
 			auto wrap_mode = (TextureWrapMode) ms.Read<int>();
 			auto filter_mode = (FilterMode) ms.Read<int>();
-			auto texture_type = read_string(ms);
+			const auto& texture_type = read_string(ms);
 
 			if (texture_type == "Texture2D")
 			{
@@ -83,11 +279,27 @@ namespace Viry3D
 				auto png_path = read_string(ms);
 				png_path = Application::DataPath() + png_path.Substring(String("Assets").Size());
 
-				texture = Texture2D::LoadFromFile(png_path, wrap_mode, filter_mode, mipmap_count > 1);
+				auto ktx2_path = cooked_texture_path(png_path);
+
+				PrefetchedImage image;
+				if (take_prefetched_image(path, image))
+				{
+					texture = Texture2D::Create(image.width, image.height, image.format, wrap_mode, filter_mode, mipmap_count > 1, image.colors);
+				}
+				else if (File::Exist(ktx2_path))
+				{
+					texture = TextureStreaming::Load(ktx2_path, wrap_mode, filter_mode);
+				}
+
+				if (!texture)
+				{
+					texture = Texture2D::LoadFromFile(png_path, wrap_mode, filter_mode, mipmap_count > 1);
+				}
 
 				if (texture)
 				{
-					Object::AddCache(path, texture);
+					Object::AddCache(path, texture, ObjectCache::Type::Texture,
+						texture_memory_size(texture->GetWidth(), texture->GetHeight(), RefCast<Texture2D>(texture)->GetFormat(), texture->IsMipmap(), 1));
 				}
 			}
 			else if (texture_type == "Texture2DRGBFloat")
@@ -95,10 +307,11 @@ namespace Viry3D
 				int mipmap_count = ms.Read<int>();
 				auto data_path = read_string(ms);
 				data_path = Application::DataPath() + data_path.Substring(String("Assets").Size());
-				auto colors = File::ReadAllBytes(data_path);
+				auto colors = File::MapAllBytes(data_path);
 
 				texture = Texture2D::Create(width, height, TextureFormat::RGBFloat, wrap_mode, filter_mode, mipmap_count > 1, colors);
-				Object::AddCache(path, texture);
+				Object::AddCache(path, texture, ObjectCache::Type::Texture,
+					texture_memory_size(width, height, TextureFormat::RGBFloat, mipmap_count > 1, 1));
 			}
 			else if (texture_type == "Cubemap")
 			{
@@ -116,7 +329,7 @@ namespace Viry3D
 						ByteBuffer colors;
 						int w, h;
 						TextureFormat format;
-						auto buffer = File::ReadAllBytes(face_path);
+						auto buffer = File::MapAllBytes(face_path);
 						if (Texture2D::LoadImageData(buffer, colors, w, h, format))
 						{
 							cubemap->SetPixels(colors, (CubemapFace) j, i);
@@ -127,7 +340,8 @@ namespace Viry3D
 				cubemap->Apply(false, true);
 
 				texture = cubemap;
-				Object::AddCache(path, texture);
+				Object::AddCache(path, texture, ObjectCache::Type::Texture,
+					texture_memory_size(width, width, TextureFormat::RGBA32, mipmap_count > 1, 6));
 			}
 			else if(texture_type == "CubemapRGBFloat")
 			{
@@ -141,7 +355,7 @@ namespace Viry3D
 					{
 						auto face_path = read_string(ms);
 						face_path = Application::DataPath() + face_path.Substring(String("Assets").Size());
-						auto colors = File::ReadAllBytes(face_path);
+						auto colors = File::MapAllBytes(face_path);
 						cubemap->SetPixels(colors, (CubemapFace) j, i);
 					}
 				}
@@ -149,7 +363,8 @@ namespace Viry3D
 				cubemap->Apply(false, true);
 
 				texture = cubemap;
-				Object::AddCache(path, texture);
+				Object::AddCache(path, texture, ObjectCache::Type::Texture,
+					texture_memory_size(width, width, TextureFormat::RGBFloat, mipmap_count > 1, 6));
 			}
 
 			ms.Close();
@@ -175,18 +390,18 @@ namespace Viry3D
 		}
 		else
 		{
-			auto ms = MemoryStream(File::ReadAllBytes(full_path));
+			auto ms = MemoryStream(File::MapAllBytes(full_path));
 
 			atlas = Atlas::Create();
 
-			auto texture_path = read_string(ms);
+			const auto& texture_path = read_string(ms);
 			auto texture = RefCast<Texture2D>(read_texture(texture_path));
 			atlas->SetTexture(texture);
 
 			auto sprite_count = ms.Read<int>();
 			for (int i = 0; i < sprite_count; i++)
 			{
-				auto name = read_string(ms);
+				const auto& name = read_string(ms);
 				auto rect = ms.Read<Rect>();
 				ms.Read<Vector2>();//pivot
 				ms.Read<float>();//pixel per unit
@@ -197,7 +412,7 @@ namespace Viry3D
 				atlas->AddSprite(name, sprite);
 			}
 
-			Object::AddCache(path, atlas);
+			Object::AddCache(path, atlas, ObjectCache::Type::Atlas, ms.GetLength());
 
 			ms.Close();
 		}
@@ -213,11 +428,11 @@ namespace Viry3D
 		auto fill_origin = ms.Read<int>();
 		auto fill_amount = ms.Read<float>();
 		auto fill_clock_wise = ms.Read<bool>();
-		auto sprite_name = read_string(ms);
+		const auto& sprite_name = read_string(ms);
 
 		if (!sprite_name.Empty())
 		{
-			auto atlas_path = read_string(ms);
+			const auto& atlas_path = read_string(ms);
 			auto atlas = read_atlas(atlas_path);
 
 			view->SetAtlas(atlas);
@@ -253,7 +468,9 @@ namespace Viry3D
 
 			if (font)
 			{
-				Object::AddCache(path, font);
+				auto& texture = font->GetTexture();
+				Object::AddCache(path, font, ObjectCache::Type::Font,
+					texture ? texture_memory_size(texture->GetWidth(), texture->GetHeight(), texture->GetFormat(), false, 1) : 0);
 			}
 		}
 
@@ -263,13 +480,13 @@ namespace Viry3D
 	static void read_label(MemoryStream& ms, Ref<UILabel>& view)
 	{
 		auto color = ms.Read<Color>();
-		auto text = read_string(ms);
-		auto font_name = read_string(ms);
-		auto font_style = read_string(ms);
+		auto text = read_text(ms);
+		const auto& font_name = read_string(ms);
+		const auto& font_style = read_string(ms);
 		auto font_size = ms.Read<int>();
 		auto line_space = ms.Read<float>();
 		auto rich = ms.Read<bool>();
-		auto alignment = read_string(ms);
+		const auto& alignment = read_string(ms);
 
 		if (!font_name.Empty())
 		{
@@ -370,135 +587,138 @@ namespace Viry3D
 		canvas->SetSortingOrder(sorting_order);
 	}
 
-	static Ref<Mesh> read_mesh(const String& path)
+	static void parse_mesh(MemoryStream& ms, const Ref<Mesh>& mesh)
 	{
-		Ref<Mesh> mesh;
-
-		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
-		if (!File::Exist(full_path))
-		{
-			return mesh;
-		}
-
-		auto cache = Object::GetCache(path);
-		if (cache)
-		{
-			mesh = RefCast<Mesh>(cache);
+		const auto& mesh_name = read_string(ms);
+		mesh->SetName(mesh_name);
+
+		auto vertex_count = ms.Read<int>();
+		ms.ReadArray(mesh->vertices, vertex_count);
+		ms.ReadArray(mesh->uv, ms.Read<int>());
+		ms.ReadArray(mesh->colors, ms.Read<int>());
+		ms.ReadArray(mesh->uv2, ms.Read<int>());
+		ms.ReadArray(mesh->normals, ms.Read<int>());
+		ms.ReadArray(mesh->tangents, ms.Read<int>());
+		ms.ReadArray(mesh->bone_weights, ms.Read<int>());
+		ms.ReadArray(mesh->bone_indices, ms.Read<int>());
+		ms.ReadArray(mesh->bind_poses, ms.Read<int>());
+
+		auto index_count = ms.Read<int>();
+		if (index_count > 0)
+		{
+			// 16 bit on disk, widen to 32 bit
+			const byte* indices = ms.ReadPointer(index_count * sizeof(unsigned short));
+			mesh->triangles.Resize(index_count);
+			for (int i = 0; i < index_count; i++)
+			{
+				unsigned short index;
+				Memory::Copy(&index, &indices[i * sizeof(unsigned short)], sizeof(unsigned short));
+				mesh->triangles[i] = index;
+			}
 		}
-		else
-		{
-			auto ms = MemoryStream(File::ReadAllBytes(full_path));
 
-			mesh = Mesh::Create();
-			Object::AddCache(path, mesh);
+		ms.ReadArray(mesh->submeshes, ms.Read<int>());
 
-			auto mesh_name = read_string(ms);
-			mesh->SetName(mesh_name);
+		auto blend_shape_count = ms.Read<int>();
+		if (blend_shape_count > 0)
+		{
+			mesh->blend_shapes.Resize(blend_shape_count);
 
-			auto vertex_count = ms.Read<int>();
-			if (vertex_count > 0)
+			for (int i = 0; i < blend_shape_count; i++)
 			{
-				mesh->vertices.Resize(vertex_count);
-				ms.Read(&mesh->vertices[0], vertex_count * sizeof(Vector3));
-			}
+				mesh->blend_shapes[i].name = read_string(ms);
+				auto frame_count = ms.Read<int>();
+				if (frame_count > 0)
+				{
+					mesh->blend_shapes[i].frames.Resize(frame_count);
 
-			auto uv_count = ms.Read<int>();
-			if (uv_count > 0)
-			{
-				mesh->uv.Resize(uv_count);
-				ms.Read(&mesh->uv[0], uv_count * sizeof(Vector2));
+					for (int j = 0; j < frame_count; j++)
+					{
+						mesh->blend_shapes[i].frames[j].weight = ms.Read<float>();
+						ms.ReadArray(mesh->blend_shapes[i].frames[j].deltas, vertex_count);
+					}
+				}
 			}
 
-			auto color_count = ms.Read<int>();
-			if (color_count > 0)
-			{
-				mesh->colors.Resize(color_count);
-				ms.Read(&mesh->colors[0], color_count * sizeof(Color));
-			}
+			mesh->SetDynamic(true);
+		}
+	}
 
-			auto uv2_count = ms.Read<int>();
-			if (uv2_count > 0)
+	//
+	//	parse cooked vmesh if exist, else source mesh, return file size
+	//
+	static int load_mesh_file(const String& full_path, const Ref<Mesh>& mesh)
+	{
+		auto vmesh_path = cooked_mesh_path(full_path);
+		if (File::Exist(vmesh_path))
+		{
+			auto buffer = File::MapAllBytes(vmesh_path);
+			if (MeshFile::LoadFull(buffer, mesh))
 			{
-				mesh->uv2.Resize(uv2_count);
-				ms.Read(&mesh->uv2[0], uv2_count * sizeof(Vector2));
+				return buffer.Size();
 			}
+		}
 
-			auto normal_count = ms.Read<int>();
-			if (normal_count > 0)
-			{
-				mesh->normals.Resize(normal_count);
-				ms.Read(&mesh->normals[0], normal_count * sizeof(Vector3));
-			}
+		auto ms = MemoryStream(File::MapAllBytes(full_path));
+		int bytes = ms.GetLength();
 
-			auto tangent_count = ms.Read<int>();
-			if (tangent_count > 0)
-			{
-				mesh->tangents.Resize(tangent_count);
-				ms.Read(&mesh->tangents[0], tangent_count * sizeof(Vector4));
-			}
+		parse_mesh(ms, mesh);
 
-			auto bone_weight_count = ms.Read<int>();
-			if (bone_weight_count > 0)
-			{
-				mesh->bone_weights.Resize(bone_weight_count);
-				ms.Read(&mesh->bone_weights[0], bone_weight_count * sizeof(Vector4));
-			}
+		ms.Close();
 
-			auto bone_index_count = ms.Read<int>();
-			if (bone_index_count > 0)
-			{
-				mesh->bone_indices.Resize(bone_index_count);
-				ms.Read(&mesh->bone_indices[0], bone_index_count * sizeof(Vector4));
-			}
+		return bytes;
+	}
 
-			auto bind_pose_count = ms.Read<int>();
-			if (bind_pose_count > 0)
-			{
-				mesh->bind_poses.Resize(bind_pose_count);
-				ms.Read(&mesh->bind_poses[0], bind_pose_count * sizeof(Matrix4x4));
-			}
+	//
+	//	if coarse_only not null and mesh is cooked, only coarse lod is loaded and coarse_only set true,
+	//	caller should load the rest with MeshFile::LoadFull later
+	//
+	static Ref<Mesh> read_mesh(const String& path, bool* coarse_only = NULL)
+	{
+		Ref<Mesh> mesh;
 
-			auto index_count = ms.Read<int>();
-			if (index_count > 0)
-			{
-				mesh->triangles.Resize(index_count);
-				ms.Read(&mesh->triangles[0], index_count * sizeof(unsigned short));
-			}
+		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
+		if (!File::Exist(full_path))
+		{
+			return mesh;
+		}
 
-			auto submesh_count = ms.Read<int>();
-			if (submesh_count > 0)
+		auto cache = Object::GetCache(path);
+		if (cache)
+		{
+			mesh = RefCast<Mesh>(cache);
+		}
+		else
+		{
+			int bytes;
+			mesh = take_prefetched_mesh(path, bytes);
+
+			if (mesh)
 			{
-				mesh->submeshes.Resize(submesh_count);
-				ms.Read(&mesh->submeshes[0], submesh_count * sizeof(Mesh::Submesh));
+				Object::AddCache(path, mesh, ObjectCache::Type::Mesh, bytes);
 			}
-
-			auto blend_shape_count = ms.Read<int>();
-			if (blend_shape_count > 0)
+			else
 			{
-				mesh->blend_shapes.Resize(blend_shape_count);
+				mesh = Mesh::Create();
 
-				for (int i = 0; i < blend_shape_count; i++)
+				auto vmesh_path = cooked_mesh_path(full_path);
+				if (coarse_only != NULL && File::Exist(vmesh_path))
 				{
-					mesh->blend_shapes[i].name = read_string(ms);
-					auto frame_count = ms.Read<int>();
-					if (frame_count > 0)
+					auto buffer = File::MapAllBytes(vmesh_path);
+					if (MeshFile::LoadCoarse(buffer, mesh))
 					{
-						mesh->blend_shapes[i].frames.Resize(frame_count);
-
-						for (int j = 0; j < frame_count; j++)
-						{
-							mesh->blend_shapes[i].frames[j].weight = ms.Read<float>();
-							mesh->blend_shapes[i].frames[j].deltas.Resize(vertex_count);
-
-							ms.Read(&mesh->blend_shapes[i].frames[j].deltas[0], sizeof(Mesh::BlendShapeVertexDelta) * vertex_count);
-						}
+						*coarse_only = true;
+						bytes = buffer.Size();
 					}
 				}
 
-				mesh->SetDynamic(true);
-			}
+				if (coarse_only == NULL || !*coarse_only)
+				{
+					bytes = load_mesh_file(full_path, mesh);
+				}
 
-			ms.Close();
+				Object::AddCache(path, mesh, ObjectCache::Type::Mesh, bytes);
+			}
 
 			mesh->Apply();
 		}
@@ -523,21 +743,21 @@ namespace Viry3D
 		}
 		else
 		{
-			auto ms = MemoryStream(File::ReadAllBytes(full_path));
+			auto ms = MemoryStream(File::MapAllBytes(full_path));
 
-			auto mat_name = read_string(ms);
-			auto shader_name = read_string(ms);
+			const auto& mat_name = read_string(ms);
+			const auto& shader_name = read_string(ms);
 
 			mat = Material::Create(shader_name);
-			Object::AddCache(path, mat);
+			Object::AddCache(path, mat, ObjectCache::Type::Material, ms.GetLength());
 
 			mat->SetName(mat_name);
 
 			auto property_count = ms.Read<int>();
 			for (int i = 0; i < property_count; i++)
 			{
-				auto property_name = read_string(ms);
-				auto property_type = read_string(ms);
+				const auto& property_name = read_string(ms);
+				const auto& property_type = read_string(ms);
 
 				if (property_type == "Color")
 				{
@@ -557,7 +777,7 @@ namespace Viry3D
 				else if (property_type == "TexEnv")
 				{
 					auto tex_st = ms.Read<Vector4>();
-					auto tex_path = read_string(ms);
+					const auto& tex_path = read_string(ms);
 
 					if (!tex_path.Empty())
 					{
@@ -587,7 +807,7 @@ namespace Viry3D
 
 			for (int i = 0; i < mat_count; i++)
 			{
-				auto mat_path = read_string(ms);
+				const auto& mat_path = read_string(ms);
 
 				if (!mat_path.Empty())
 				{
@@ -603,7 +823,7 @@ namespace Viry3D
 
 	static void read_mesh_renderer(MemoryStream& ms, Ref<MeshRenderer>& renderer)
 	{
-		auto mesh_path = read_string(ms);
+		const auto& mesh_path = read_string(ms);
 		if (!mesh_path.Empty())
 		{
 			auto mesh = read_mesh(mesh_path);
@@ -628,7 +848,7 @@ namespace Viry3D
 		Ref<SkinnedMeshRenderer>& renderer,
 		Map<int, Ref<Transform>>& transform_instances)
 	{
-		auto mesh_path = read_string(ms);
+		const auto& mesh_path = read_string(ms);
 		if (!mesh_path.Empty())
 		{
 			auto mesh = read_mesh(mesh_path);
@@ -679,7 +899,7 @@ namespace Viry3D
 
 			if (curve)
 			{
-				curve->keys.Add(Keyframe(time, value, in_tangent, out_tangent));
+				curve->AddKey(Keyframe(time, value, in_tangent, out_tangent));
 			}
 		}
 	}
@@ -702,11 +922,12 @@ namespace Viry3D
 		else
 		{
 			clip = RefMake<AnimationClip>();
-			Object::AddCache(path, clip);
 
-			auto ms = MemoryStream(File::ReadAllBytes(full_path));
+			auto ms = MemoryStream(File::MapAllBytes(full_path));
 
-			auto name = read_string(ms);
+			Object::AddCache(path, clip, ObjectCache::Type::AnimationClip, ms.GetLength());
+
+			const auto& name = read_string(ms);
 			clip->SetName(name);
 			clip->frame_rate = ms.Read<float>();
 			clip->length = ms.Read<float>();
@@ -715,8 +936,8 @@ namespace Viry3D
 
 			for (int i = 0; i < curve_count; i++)
 			{
-				auto path = read_string(ms);
-				auto property = read_string(ms);
+				const auto& path = read_string(ms);
+				const auto& property = read_string(ms);
 
 				int property_index = -1;
 
@@ -776,6 +997,8 @@ namespace Viry3D
 				read_animation_curve(ms, curve);
 			}
 
+			clip->BuildCurveIndex();
+
 			ms.Close();
 		}
 
@@ -784,14 +1007,14 @@ namespace Viry3D
 
 	static void read_animation(MemoryStream& ms, Ref<Animation>& animation)
 	{
-		auto defaul_clip = read_string(ms);
+		read_string(ms);	//	defaul_clip
 		auto clip_count = ms.Read<int>();
 
 		Map<String, AnimationState> states;
 
 		for (int i = 0; i < clip_count; i++)
 		{
-			auto clip_path = read_string(ms);
+			const auto& clip_path = read_string(ms);
 
 			if (!clip_path.Empty())
 			{
@@ -841,9 +1064,9 @@ namespace Viry3D
 			float time = ms.Read<float>();
 			Color rgb = ms.Read<Color>();
 
-			grad.r.keys.Add(Keyframe(time, rgb.r));
-			grad.g.keys.Add(Keyframe(time, rgb.g));
-			grad.b.keys.Add(Keyframe(time, rgb.b));
+			grad.r.AddKey(Keyframe(time, rgb.r));
+			grad.g.AddKey(Keyframe(time, rgb.g));
+			grad.b.AddKey(Keyframe(time, rgb.b));
 		}
 
 		int alpha_len = ms.Read<int>();
@@ -852,7 +1075,7 @@ namespace Viry3D
 			float time = ms.Read<float>();
 			float alpha = ms.Read<float>();
 
-			grad.a.keys.Add(Keyframe(time, alpha));
+			grad.a.AddKey(Keyframe(time, alpha));
 		}
 	}
 
@@ -1245,7 +1468,7 @@ namespace Viry3D
 		}
 		else if (com->render_mode == ParticleSystemRenderMode::Mesh)
 		{
-			auto mesh_path = read_string(ms);
+			const auto& mesh_path = read_string(ms);
 			if (!mesh_path.Empty())
 			{
 				com->mesh = read_mesh(mesh_path);
@@ -1279,7 +1502,7 @@ namespace Viry3D
 		Vector<Ref<Texture2D>> alphamaps(alphamap_count);
 		for (int i = 0; i < alphamap_count; i++)
 		{
-			auto tex_path = read_string(ms);
+			const auto& tex_path = read_string(ms);
 			if (!tex_path.Empty())
 			{
 				alphamaps[i] = RefCast<Texture2D>(read_texture(tex_path));
@@ -1290,12 +1513,12 @@ namespace Viry3D
 		Vector<TerrainSplatTexture> splat_textures(splat_count);
 		for (int i = 0; i < splat_count; i++)
 		{
-			auto color_texture_path = read_string(ms);
+			const auto& color_texture_path = read_string(ms);
 			if (!color_texture_path.Empty())
 			{
 				splat_textures[i].texture = RefCast<Texture2D>(read_texture(color_texture_path));
 			}
-			auto normal_texture_path = read_string(ms);
+			const auto& normal_texture_path = read_string(ms);
 			if (!normal_texture_path.Empty())
 			{
 				splat_textures[i].normal = RefCast<Texture2D>(read_texture(normal_texture_path));
@@ -1322,7 +1545,7 @@ namespace Viry3D
 		FastList<Ref<GameObject>>& objs,
 		Map<int, Ref<Transform>>& transform_instances)
 	{
-		auto name = read_string(ms);
+		const auto& name = read_string(ms);
 		auto layer = ms.Read<int>();
 		auto active = ms.Read<bool>();
 		auto is_static = ms.Read<bool>();
@@ -1355,7 +1578,7 @@ namespace Viry3D
 
 		for (int i = 0; i < com_count; i++)
 		{
-			auto component_name = read_string(ms);
+			const auto& component_name = read_string(ms);
 
 			if (component_name == "MeshRenderer")
 			{
@@ -1445,6 +1668,154 @@ namespace Viry3D
 		return transform;
 	}
 
+	//
+	//	length prefixed strings starting with Assets/ in a serialized asset,
+	//	a false match only costs a useless prefetch
+	//
+	static void scan_asset_paths(const ByteBuffer& buffer, Vector<String>& paths)
+	{
+		const int prefix_size = 7;
+		const byte* bytes = buffer.Bytes();
+		int size = buffer.Size();
+
+		for (int i = 0; i + 4 + prefix_size <= size; i++)
+		{
+			if (memcmp(&bytes[i + 4], "Assets/", prefix_size) != 0)
+			{
+				continue;
+			}
+
+			int length;
+			memcpy(&length, &bytes[i], 4);
+			if (length <= prefix_size || length > 1024 || i + 4 + length > size)
+			{
+				continue;
+			}
+
+			bool valid = true;
+			for (int j = 0; j < length; j++)
+			{
+				if (bytes[i + 4 + j] < 32)
+				{
+					valid = false;
+					break;
+				}
+			}
+
+			if (valid)
+			{
+				paths.Add(String((const char*) &bytes[i + 4], length));
+				i += 4 + length - 1;
+			}
+		}
+	}
+
+	static bool is_prefetchable(const String& path)
+	{
+		return path.EndsWith(".tex") || path.EndsWith(".mesh") || path.EndsWith(".clip");
+	}
+
+	//
+	//	image file a texture asset needs decoded, empty if none or cooked
+	//
+	static String prefetch_image_path(const String& path)
+	{
+		String image_path;
+
+		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
+		if (!File::Exist(full_path))
+		{
+			return image_path;
+		}
+
+		auto ms = MemoryStream(File::MapAllBytes(full_path));
+
+		read_string(ms);
+		ms.Read<int>();
+		ms.Read<int>();
+		ms.Read<int>();
+		ms.Read<int>();
+		const auto& texture_type = read_string(ms);
+
+		if (texture_type == "Texture2D")
+		{
+			ms.Read<int>();
+			auto png_path = read_string(ms);
+			png_path = Application::DataPath() + png_path.Substring(String("Assets").Size());
+
+			//	cooked texture needs no decode
+			if (!File::Exist(cooked_texture_path(png_path)) && File::Exist(png_path))
+			{
+				image_path = png_path;
+			}
+		}
+
+		ms.Close();
+
+		return image_path;
+	}
+
+	static bool prefetch_image_format(int bpp, TextureFormat& format)
+	{
+		switch (bpp)
+		{
+			case 32:
+				format = TextureFormat::RGBA32;
+				return true;
+			case 24:
+				format = TextureFormat::RGB24;
+				return true;
+			case 8:
+				format = TextureFormat::R8;
+				return true;
+		}
+
+		return false;
+	}
+
+	//
+	//	textures go through ImageDecoder in one batch, see PrefetchDependencies
+	//
+	static void prefetch_asset(const String& path)
+	{
+		StringPoolScope scope;
+
+		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
+		if (!File::Exist(full_path))
+		{
+			return;
+		}
+
+		if (path.EndsWith(".mesh"))
+		{
+			PrefetchedMesh prefetched;
+			prefetched.mesh = Mesh::Create();
+			prefetched.bytes = load_mesh_file(full_path, prefetched.mesh);
+
+			std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+			g_prefetch_meshes.Add(path, prefetched);
+		}
+		else if (path.EndsWith(".clip"))
+		{
+			// no gpu object, load to cache directly
+			read_animation_clip(path);
+		}
+	}
+
+	static void release_prefetched(const Vector<String>& paths)
+	{
+		std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+
+		for (const auto& i : paths)
+		{
+			g_prefetch_done.Remove(i);
+			g_prefetch_images.Remove(i);
+			g_prefetch_meshes.Remove(i);
+		}
+
+		g_prefetch_condition.notify_all();
+	}
+
 	static Ref<GameObject> read_gameobject(const String& path, bool static_batch)
 	{
 		Ref<GameObject> obj;
@@ -1462,7 +1833,7 @@ namespace Viry3D
 		}
 		else
 		{
-			auto ms = MemoryStream(File::ReadAllBytes(full_path));
+			auto ms = MemoryStream(File::MapAllBytes(full_path));
 
 			FastList<Ref<GameObject>> objs;
 			Map<int, Ref<Transform>> transform_instances;
@@ -1487,7 +1858,7 @@ namespace Viry3D
 
 			if (obj)
 			{
-				Object::AddCache(path, obj);
+				Object::AddCache(path, obj, ObjectCache::Type::Prefab, ms.GetLength());
 
 				obj = GameObject::Instantiate(RefCast<GameObject>(obj));
 			}
@@ -1509,17 +1880,196 @@ namespace Viry3D
 		Vector<ThreadInfo> info;
 		info.Add({ thread_init, thread_deinit });
 		m_thread_res_load = RefMake<ThreadPool>(info);
+
+		// cpu only, no shared context
+		int decode_thread_count = Mathf::Max((int) std::thread::hardware_concurrency() - 1, 1);
+		m_thread_res_decode = RefMake<ThreadPool>(decode_thread_count);
+
+		ImageDecoder::Init();
+		AsyncFile::Init();
 	}
 
 	void Resource::Deinit()
 	{
 		m_thread_res_load->Wait();
 		m_thread_res_load.reset();
+		m_thread_res_decode->Wait();
+		m_thread_res_decode.reset();
+
+		ImageDecoder::Deinit();
+		AsyncFile::Deinit();
+	}
+
+	void Resource::PrefetchDependencies(const String& path, Vector<String>& owned)
+	{
+		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
+		if (!m_thread_res_decode || !File::Exist(full_path))
+		{
+			return;
+		}
+
+		Vector<String> paths;
+		scan_asset_paths(File::MapAllBytes(full_path), paths);
+
+		// materials and atlases are small, scan them here for their textures
+		int prefab_path_count = paths.Size();
+		for (int i = 0; i < prefab_path_count; i++)
+		{
+			if (paths[i].EndsWith(".mat") || paths[i].EndsWith(".atlas"))
+			{
+				String dep_path = Application::DataPath() + paths[i].Substring(String("Assets").Size());
+				if (File::Exist(dep_path))
+				{
+					scan_asset_paths(File::MapAllBytes(dep_path), paths);
+				}
+			}
+		}
+
+		Vector<String> waits;
+		{
+			std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+
+			for (const auto& i : paths)
+			{
+				if (!is_prefetchable(i))
+				{
+					continue;
+				}
+
+				// in flight by this or other load, wait for it
+				if (g_prefetch_done.Contains(i))
+				{
+					waits.Add(i);
+					continue;
+				}
+
+				if (Object::GetCache(i))
+				{
+					continue;
+				}
+
+				g_prefetch_done.Add(i, false);
+				owned.Add(i);
+			}
+		}
+
+		Vector<String> textures;
+		for (const auto& i : owned)
+		{
+			if (i.EndsWith(".tex"))
+			{
+				textures.Add(i);
+				continue;
+			}
+
+			String dep = i;
+			m_thread_res_decode->AddTask({
+				[=]() {
+					prefetch_asset(dep);
+
+					std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+					g_prefetch_done[dep] = true;
+					g_prefetch_condition.notify_all();
+
+					return Ref<Any>();
+				}
+			});
+		}
+
+		// images read as one batch with all reads in flight,
+		// then decode as one batch while decode threads parse meshes and clips
+		Vector<String> read_owners;
+		Vector<AsyncFile::Request> reads;
+		for (const auto& i : textures)
+		{
+			String image_path = prefetch_image_path(i);
+			if (image_path.Size() > 0)
+			{
+				AsyncFile::Request read;
+				read.path = image_path;
+				reads.Add(read);
+				read_owners.Add(i);
+			}
+		}
+
+		AsyncFile::ReadAll(reads);
+
+		Vector<String> image_owners;
+		Vector<ImageDecoder::Request> images;
+		for (int i = 0; i < reads.Size(); i++)
+		{
+			if (reads[i].ok && reads[i].size > 0)
+			{
+				ImageDecoder::Request request;
+				request.file = reads[i].buffer;
+				images.Add(request);
+				image_owners.Add(read_owners[i]);
+			}
+		}
+
+		ImageDecoder::DecodeAll(images);
+
+		{
+			std::lock_guard<std::mutex> lock(g_prefetch_mutex);
+
+			for (int i = 0; i < images.Size(); i++)
+			{
+				PrefetchedImage image;
+				if (images[i].ok && prefetch_image_format(images[i].bpp, image.format))
+				{
+					image.colors = images[i].colors;
+					image.width = images[i].width;
+					image.height = images[i].height;
+					g_prefetch_images.Add(image_owners[i], image);
+				}
+			}
+
+			for (const auto& i : textures)
+			{
+				g_prefetch_done[i] = true;
+			}
+			g_prefetch_condition.notify_all();
+		}
+
+		for (const auto& i : owned)
+		{
+			waits.Add(i);
+		}
+
+		std::unique_lock<std::mutex> lock(g_prefetch_mutex);
+		g_prefetch_condition.wait(lock, [&]() {
+			for (const auto& i : waits)
+			{
+				bool* done;
+				if (g_prefetch_done.TryGet(i, &done) && !*done)
+				{
+					return false;
+				}
+			}
+			return true;
+		});
 	}
 
 	Ref<GameObject> Resource::LoadGameObject(const String& path, bool static_batch, LoadComplete callback)
 	{
-		auto obj = read_gameobject(path, static_batch);
+		Ref<GameObject> obj;
+		{
+			StringPoolScope scope;
+
+			Vector<String> prefetched;
+			if (!Object::GetCache(path))
+			{
+				PrefetchDependencies(path, prefetched);
+			}
+
+			obj = read_gameobject(path, static_batch);
+
+			if (prefetched.Size() > 0)
+			{
+				release_prefetched(prefetched);
+			}
+		}
+
 		if (callback)
 		{
 			callback(obj);
@@ -1529,35 +2079,60 @@ namespace Viry3D
 
 	Ref<Texture> Resource::LoadTexture(const String& path)
 	{
+		StringPoolScope scope;
 		return read_texture(path);
 	}
 
 	Ref<Font> Resource::LoadFont(const String& path)
 	{
+		StringPoolScope scope;
 		return read_font(path);
 	}
 
 	Ref<Mesh> Resource::LoadMesh(const String& path)
 	{
+		StringPoolScope scope;
 		return read_mesh(path);
 	}
 
+	bool Resource::CookMesh(const String& path)
+	{
+		StringPoolScope scope;
+
+		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
+		if (!File::Exist(full_path))
+		{
+			return false;
+		}
+
+		auto ms = MemoryStream(File::MapAllBytes(full_path));
+		auto mesh = Mesh::Create();
+		parse_mesh(ms, mesh);
+		ms.Close();
+
+		File::WriteAllBytes(cooked_mesh_path(full_path), MeshFile::Save(mesh));
+
+		return true;
+	}
+
 	void Resource::LoadLightmapSettings(const String& path)
 	{
+		StringPoolScope scope;
+
 		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
 		if (!File::Exist(full_path))
 		{
 			return;
 		}
 
-		auto ms = MemoryStream(File::ReadAllBytes(full_path));
+		auto ms = MemoryStream(File::MapAllBytes(full_path));
 
 		auto map_count = ms.Read<int>();
 
 		Vector<Ref<Texture2D>> maps;
 		for (int i = 0; i < map_count; i++)
 		{
-			auto tex_path = read_string(ms);
+			const auto& tex_path = read_string(ms);
 			if (!tex_path.Empty())
 			{
 				auto texture = read_texture(tex_path);
@@ -1637,15 +2212,64 @@ namespace Viry3D
 		m_thread_res_load->AddTask(
 		{
 			[=]() {
-			auto mesh = Resource::LoadMesh(path);
+			StringPoolScope scope;
+			bool coarse_only = false;
+			auto mesh = read_mesh(path, &coarse_only);
 			Graphics::GetDisplay()->FlushContext();
-			return RefMake<Any>(mesh);
+			return RefMake<Any>(LoadedMesh({ mesh, coarse_only }));
 		},
 			[=](Ref<Any> any) {
-			auto mesh = any->Get<Ref<Mesh>>();
+			auto loaded = any->Get<LoadedMesh>();
+			if (loaded.coarse_only)
+			{
+				RefineMesh(path, loaded.mesh);
+			}
 			if (callback)
 			{
-				callback(mesh);
+				callback(loaded.mesh);
+			}
+		}
+		}
+		);
+	}
+
+	void Resource::RefineMesh(const String& path, const Ref<Mesh>& mesh)
+	{
+		String full_path = Application::DataPath() + path.Substring(String("Assets").Size());
+
+		m_thread_res_decode->AddTask(
+		{
+			[=]() {
+			auto full = Mesh::Create();
+			if (!MeshFile::LoadFull(File::MapAllBytes(cooked_mesh_path(full_path)), full))
+			{
+				full.reset();
+			}
+			return RefMake<Any>(full);
+		},
+			[=](Ref<Any> any) {
+			auto full = any->Get<Ref<Mesh>>();
+			if (full)
+			{
+				// swap on main thread, so renderers never see half updated data
+				std::swap(mesh->vertices, full->vertices);
+				std::swap(mesh->uv, full->uv);
+				std::swap(mesh->colors, full->colors);
+				std::swap(mesh->uv2, full->uv2);
+				std::swap(mesh->normals, full->normals);
+				std::swap(mesh->tangents, full->tangents);
+				std::swap(mesh->bone_weights, full->bone_weights);
+				std::swap(mesh->bone_indices, full->bone_indices);
+				std::swap(mesh->bind_poses, full->bind_poses);
+				std::swap(mesh->triangles, full->triangles);
+				std::swap(mesh->submeshes, full->submeshes);
+				std::swap(mesh->chunks, full->chunks);
+				std::swap(mesh->blend_shapes, full->blend_shapes);
+				if (full->IsDynamic())
+				{
+					mesh->SetDynamic(true);
+				}
+				mesh->Apply();
 			}
 		}
 		}
@@ -40,13 +40,28 @@ namespace Viry3D
 		static Ref<Font> LoadFont(const String& path);
 		static Ref<Mesh> LoadMesh(const String& path);
 		static void LoadLightmapSettings(const String& path);
+		//
+		//	write cooked .vmesh next to .mesh, loaded instead of .mesh when exist
+		//
+		static bool CookMesh(const String& path);
 
 		static void LoadGameObjectAsync(const String& path, bool static_batch = false, LoadComplete callback = NULL);
 		static void LoadTextureAsync(const String& path, LoadComplete callback = NULL);
 		static void LoadFontAsync(const String& path, LoadComplete callback = NULL);
+		//
+		//	cooked mesh completes with coarse lod first, full detail is swapped in on main thread later
+		//
 		static void LoadMeshAsync(const String& path, LoadComplete callback = NULL);
 
 	private:
+		//
+		//	scan prefab for referenced assets, decode / parse them in parallel,
+		//	wait until done, paths this call prefetched are added to owned
+		//
+		static void PrefetchDependencies(const String& path, Vector<String>& owned);
+		static void RefineMesh(const String& path, const Ref<Mesh>& mesh);
+
 		static Ref<ThreadPool> m_thread_res_load;
+		static Ref<ThreadPool> m_thread_res_decode;
 	};
 }
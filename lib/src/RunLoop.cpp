@@ -16,12 +16,22 @@
 */
 
 #include "RunLoop.h"
+#include "math/Mathf.h"
+#include <chrono>
+#include <string.h>
 
 namespace Viry3D
 {
+	static long long get_time_us()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
 	RunLoop::RunLoop()
 	{
 		m_id_counter = InvalidFuncId;
+		m_budget_ms = 0;
+		memset(&m_stats, 0, sizeof(m_stats));
 	}
 
 	RunLoop::~RunLoop()
@@ -33,13 +43,33 @@ namespace Viry3D
 		m_mutex.lock();
 
 		FuncId id = ++m_id_counter;
-		m_to_add.Add(id, task);
+
+		if (task.once)
+		{
+			// deadline counts from add time, not from next run
+			PendingTask pending = { id, task, 0 };
+			if (task.deadline_ms > 0)
+			{
+				pending.deadline = get_time_us() + task.deadline_ms * 1000LL;
+			}
+			m_queue_to_add.AddLast(pending);
+		}
+		else
+		{
+			m_to_add.Add(id, task);
+		}
 
 		m_mutex.unlock();
 
 		return id;
 	}
 
+	int RunLoop::GetQueueDepth()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_queue.Size() + m_queue_to_add.Size();
+	}
+
 	void RunLoop::Remove(FuncId id)
 	{
 		m_to_remove.Add(id);
@@ -57,6 +87,28 @@ namespace Viry3D
 			m_items.Add(i.first, i.second);
 		}
 		m_to_add.Clear();
+
+		// tasks added while running wait for next frame
+		if (!m_queue_to_add.Empty())
+		{
+			m_queue.AddRangeBefore(m_queue.end(), m_queue_to_add.begin(), m_queue_to_add.end());
+			m_queue_to_add.Clear();
+			m_queue.Sort([](const PendingTask& a, const PendingTask& b) {
+				if (a.task.priority != b.task.priority)
+				{
+					return (int) a.task.priority > (int) b.task.priority;
+				}
+				if (a.deadline != b.deadline)
+				{
+					if (a.deadline == 0 || b.deadline == 0)
+					{
+						return a.deadline != 0;
+					}
+					return a.deadline < b.deadline;
+				}
+				return a.id < b.id;
+			});
+		}
 	}
 
 	void RunLoop::RemoveFuncs()
@@ -71,6 +123,8 @@ namespace Viry3D
 
 	void RunLoop::Run()
 	{
+		Vector<Task> tasks;
+
 		m_mutex.lock();
 
 		this->RemoveFuncs();
@@ -78,14 +132,77 @@ namespace Viry3D
 
 		for (auto& i : m_items)
 		{
-			i.second.func();
+			tasks.Add(i.second);
+		}
+
+		m_mutex.unlock();
 
-			if (i.second.once)
+		// run without lock, so tasks could add tasks
+		for (auto& i : tasks)
+		{
+			i.func();
+		}
+
+		long long time_start = get_time_us();
+		int executed = 0;
+		int overdue = 0;
+
+		while (true)
+		{
+			m_mutex.lock();
+
+			if (m_queue.Empty())
+			{
+				m_mutex.unlock();
+				break;
+			}
+
+			long long now = get_time_us();
+			bool in_budget = m_budget_ms <= 0 || executed == 0 || (now - time_start) < (long long) (m_budget_ms * 1000);
+			auto it = m_queue.begin();
+
+			if (!in_budget)
 			{
-				this->Remove(i.first);
+				for (; it != m_queue.end(); it++)
+				{
+					if (it->deadline != 0 && it->deadline <= now)
+					{
+						break;
+					}
+				}
+
+				if (it == m_queue.end())
+				{
+					m_mutex.unlock();
+					break;
+				}
 			}
+
+			if (it->deadline != 0 && it->deadline <= now)
+			{
+				overdue++;
+			}
+
+			Action func = it->task.func;
+			m_queue.Remove(it);
+
+			m_mutex.unlock();
+
+			func();
+			executed++;
 		}
 
+		m_mutex.lock();
+
+		m_stats.queue_depth = m_queue.Size();
+		m_stats.queue_depth_max = Mathf::Max(m_stats.queue_depth_max, m_stats.queue_depth + executed);
+		m_stats.executed = executed;
+		m_stats.deferred = m_stats.queue_depth;
+		m_stats.overdue = overdue;
+		m_stats.time_ms = (get_time_us() - time_start) / 1000.0f;
+		m_stats.executed_total += executed;
+		m_stats.deferred_total += m_stats.deferred;
+
 		m_mutex.unlock();
 	}
 }
@@ -19,6 +19,7 @@
 
 #include "container/Map.h"
 #include "container/Vector.h"
+#include "container/List.h"
 #include "thread/Thread.h"
 #include "Action.h"
 
@@ -29,18 +30,52 @@ namespace Viry3D
 	public:
 		typedef int FuncId;
 		static const FuncId InvalidFuncId = 0;
+
+		//
+		//	higher value runs first
+		//
+		enum class Priority
+		{
+			Low = -1,
+			Normal = 0,
+			High = 1,
+		};
+
+		//
+		//	once tasks are time sliced by frame budget, not finished ones carry to next frames,
+		//	ordered by priority, then deadline, then add order,
+		//	a task past its deadline runs even if budget is used up,
+		//	deadline_ms is relative to add time, 0 means no deadline,
+		//	not once tasks run every frame and are not budgeted
+		//
 		struct Task
 		{
 			Action func;
 			bool once;
+			Priority priority;
+			int deadline_ms;
 
-			Task(Action func, bool once = true):
+			Task(Action func, bool once = true, Priority priority = Priority::Normal, int deadline_ms = 0):
 				func(func),
-				once(once)
+				once(once),
+				priority(priority),
+				deadline_ms(deadline_ms)
 			{
 			}
 		};
 
+		struct Stats
+		{
+			int queue_depth;
+			int queue_depth_max;
+			int executed;
+			int deferred;
+			int overdue;
+			float time_ms;
+			long long executed_total;
+			long long deferred_total;
+		};
+
 		RunLoop();
 		~RunLoop();
 
@@ -50,7 +85,21 @@ namespace Viry3D
 		/// add a func to the run loop
 		FuncId Add(const Task& task);
 
+		/// ms per frame for once tasks, 0 means run all
+		void SetFrameBudget(float ms) { m_budget_ms = ms; }
+		float GetFrameBudget() const { return m_budget_ms; }
+		/// counters of last run
+		const Stats& GetStats() const { return m_stats; }
+		int GetQueueDepth();
+
 	private:
+		struct PendingTask
+		{
+			FuncId id;
+			Task task;
+			long long deadline;
+		};
+
 		/// remove a func
 		void Remove(FuncId id);
 		/// test if a func has been attached
@@ -64,6 +113,10 @@ namespace Viry3D
 		Map<FuncId, Task> m_items;
 		Map<FuncId, Task> m_to_add;
 		Vector<FuncId> m_to_remove;
+		List<PendingTask> m_queue;
+		List<PendingTask> m_queue_to_add;
+		float m_budget_ms;
+		Stats m_stats;
 		Mutex m_mutex;
 	};
 }
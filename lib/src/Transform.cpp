@@ -23,29 +23,25 @@ namespace Viry3D
 	DEFINE_COM_CLASS(Transform);
 
 	Transform::Transform():
-		m_local_position(0, 0, 0),
-		m_local_rotation(0, 0, 0, 1),
-		m_local_scale(1, 1, 1),
-		m_changed(true),
-		m_position(m_local_position),
-		m_rotation(m_local_rotation),
-		m_scale(m_local_scale),
+		m_index(TransformSystem::Alloc(this)),
 		m_change_notifying(false)
 	{
 	}
 
+	Transform::~Transform()
+	{
+		TransformSystem::Free(m_index);
+	}
+
 	void Transform::DeepCopy(const Ref<Object>& source)
 	{
 		Component::DeepCopy(source);
 
 		auto src = RefCast<Transform>(source);
-		m_changed = true;
-		m_position = src->GetPosition();
-		m_rotation = src->GetRotation();
-		m_scale = src->GetScale();
-		SetLocalPosition(m_position);
-		SetLocalRotation(m_rotation);
-		SetLocalScale(m_scale);
+		Changed();
+		SetLocalPosition(src->GetPosition());
+		SetLocalRotation(src->GetRotation());
+		SetLocalScale(src->GetScale());
 
 		for (int i = 0; i < src->m_children.Size(); i++)
 		{
@@ -104,13 +100,14 @@ namespace Viry3D
 			p->RemoveChild(m_transform.lock());
 			p->NotifyParentHierarchyChange();
 			m_parent.reset();
+			TransformSystem::SetParent(m_index, -1);
 
 			//	become root
 			if (parent.expired())
 			{
-				m_local_position = m_position;
-				m_local_rotation = m_rotation;
-				m_local_scale = m_scale;
+				TransformSystem::LocalPosition(m_index) = TransformSystem::Position(m_index);
+				TransformSystem::LocalRotation(m_index) = TransformSystem::Rotation(m_index);
+				TransformSystem::LocalScale(m_index) = TransformSystem::Scale(m_index);
 				this->Changed();
 				this->NotifyChildHierarchyChange();
 
@@ -125,16 +122,18 @@ namespace Viry3D
 			auto p = m_parent.lock();
 			p->AddChild(m_transform.lock());
 			p->NotifyParentHierarchyChange();
+			TransformSystem::SetParent(m_index, p->m_index);
 
 			//become child
 			{
-				m_local_position = p->InverseTransformPoint(m_position);
-				m_local_rotation = Quaternion::Inverse(p->GetRotation()) * m_rotation;
+				const Vector3& scale = TransformSystem::Scale(m_index);
+				TransformSystem::LocalPosition(m_index) = p->InverseTransformPoint(TransformSystem::Position(m_index));
+				TransformSystem::LocalRotation(m_index) = Quaternion::Inverse(p->GetRotation()) * TransformSystem::Rotation(m_index);
 				const Vector3& parent_scale = p->GetScale();
-				float x = m_scale.x / parent_scale.x;
-				float y = m_scale.y / parent_scale.y;
-				float z = m_scale.z / parent_scale.z;
-				m_local_scale = Vector3(x, y, z);
+				float x = scale.x / parent_scale.x;
+				float y = scale.y / parent_scale.y;
+				float z = scale.z / parent_scale.z;
+				TransformSystem::LocalScale(m_index) = Vector3(x, y, z);
 				this->Changed();
 				this->NotifyChildHierarchyChange();
 
@@ -180,16 +179,60 @@ namespace Viry3D
 
 	void Transform::NotifyChange()
 	{
-		m_change_notifying = true;
+		int start;
+		int end;
+		if (TransformSystem::GetSubtree(m_index, start, end))
+		{
+			// subtree is one range of order
+			for (int i = start; i < end; i++)
+			{
+				TransformSystem::GetOrderTransform(i)->m_change_notifying = true;
+			}
 
-		GetGameObject()->OnTranformChanged();
+			for (int i = start; i < end; i++)
+			{
+				TransformSystem::GetOrderTransform(i)->GetGameObject()->OnTranformChanged();
+			}
 
-		for (auto& i : m_children)
-		{
-			i->GetTransform()->NotifyChange();
+			for (int i = start; i < end; i++)
+			{
+				TransformSystem::GetOrderTransform(i)->m_change_notifying = false;
+			}
 		}
+		else
+		{
+			// not sorted yet, walk children with a stack
+			Vector<Transform*> subtree;
+			Vector<Transform*> stack;
+			stack.Add(this);
 
-		m_change_notifying = false;
+			while (!stack.Empty())
+			{
+				auto t = stack[stack.Size() - 1];
+				stack.Remove(stack.Size() - 1);
+				subtree.Add(t);
+
+				for (int i = t->m_children.Size() - 1; i >= 0; i--)
+				{
+					stack.Add(t->m_children[i]->GetTransform().get());
+				}
+			}
+
+			for (auto i : subtree)
+			{
+				i->m_change_notifying = true;
+			}
+
+			for (auto i : subtree)
+			{
+				i->GetGameObject()->OnTranformChanged();
+			}
+
+			for (auto i : subtree)
+			{
+				i->m_change_notifying = false;
+			}
+		}
 	}
 
 	void Transform::NotifyParentHierarchyChange()
@@ -225,9 +268,10 @@ namespace Viry3D
 
 	void Transform::SetLocalPosition(const Vector3& pos)
 	{
-		if (m_local_position != pos)
+		auto& local_position = TransformSystem::LocalPosition(m_index);
+		if (local_position != pos)
 		{
-			m_local_position = pos;
+			local_position = pos;
 			Changed();
 			NotifyChange();
 		}
@@ -238,9 +282,10 @@ namespace Viry3D
 		Quaternion r = rot;
 		r.Normalize();
 
-		if (m_local_rotation != r)
+		auto& local_rotation = TransformSystem::LocalRotation(m_index);
+		if (local_rotation != r)
 		{
-			m_local_rotation = r;
+			local_rotation = r;
 			Changed();
 			NotifyChange();
 		}
@@ -248,9 +293,10 @@ namespace Viry3D
 
 	void Transform::SetLocalScale(const Vector3& sca)
 	{
-		if (m_local_scale != sca)
+		auto& local_scale = TransformSystem::LocalScale(m_index);
+		if (local_scale != sca)
 		{
-			m_local_scale = sca;
+			local_scale = sca;
 			Changed();
 			NotifyChange();
 		}
@@ -258,7 +304,7 @@ namespace Viry3D
 
 	void Transform::SetPosition(const Vector3& pos)
 	{
-		if (!m_changed && m_position == pos)
+		if (!TransformSystem::Changed(m_index) && TransformSystem::Position(m_index) == pos)
 		{
 			return;
 		}
@@ -278,12 +324,12 @@ namespace Viry3D
 	{
 		ApplyChange();
 
-		return m_position;
+		return TransformSystem::Position(m_index);
 	}
 
 	void Transform::SetRotation(const Quaternion& rot)
 	{
-		if (!m_changed && m_rotation == rot)
+		if (!TransformSystem::Changed(m_index) && TransformSystem::Rotation(m_index) == rot)
 		{
 			return;
 		}
@@ -303,12 +349,12 @@ namespace Viry3D
 	{
 		ApplyChange();
 
-		return m_rotation;
+		return TransformSystem::Rotation(m_index);
 	}
 
 	void Transform::SetScale(const Vector3& sca)
 	{
-		if (!m_changed && m_scale == sca)
+		if (!TransformSystem::Changed(m_index) && TransformSystem::Scale(m_index) == sca)
 		{
 			return;
 		}
@@ -331,45 +377,22 @@ namespace Viry3D
 	{
 		ApplyChange();
 
-		return m_scale;
+		return TransformSystem::Scale(m_index);
 	}
 
 	void Transform::Changed()
 	{
-		m_changed = true;
-		for (auto& i : m_children)
+		// children of a changed transform are always changed too,
+		// so the subtree is already marked
+		if (TransformSystem::Changed(m_index))
 		{
-			i->GetTransform()->Changed();
+			return;
 		}
-	}
 
-	void Transform::ApplyChange()
-	{
-		if (m_changed)
+		TransformSystem::Changed(m_index) = true;
+		for (auto& i : m_children)
 		{
-			m_changed = false;
-
-			if (IsRoot())
-			{
-				m_position = m_local_position;
-				m_rotation = m_local_rotation;
-				m_scale = m_local_scale;
-			}
-			else
-			{
-				auto parent = m_parent.lock();
-
-				m_position = parent->TransformPoint(m_local_position);
-				m_rotation = parent->GetRotation() * m_local_rotation;
-
-				const Vector3& ps = parent->GetScale();
-				float x = m_local_scale.x * ps.x;
-				float y = m_local_scale.y * ps.y;
-				float z = m_local_scale.z * ps.z;
-				m_scale = Vector3(x, y, z);
-			}
-
-			m_local_to_world_matrix = Matrix4x4::TRS(m_position, m_rotation, m_scale);
+			i->GetTransform()->Changed();
 		}
 	}
 
@@ -397,14 +420,15 @@ namespace Viry3D
 	{
 		ApplyChange();
 
-		return m_local_to_world_matrix;
+		return TransformSystem::LocalToWorldMatrix(m_index);
 	}
 
 	const Matrix4x4& Transform::GetWorldToLocalMatrix()
 	{
-		m_world_to_local_matrix = GetLocalToWorldMatrix().Inverse();
+		auto& world_to_local_matrix = TransformSystem::WorldToLocalMatrix(m_index);
+		world_to_local_matrix = GetLocalToWorldMatrix().Inverse();
 
-		return m_world_to_local_matrix;
+		return world_to_local_matrix;
 	}
 
     void Transform::SetLocalToWorldMatrixExternal(const Matrix4x4& mat)
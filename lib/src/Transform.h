@@ -18,6 +18,7 @@
 #pragma once
 
 #include "Component.h"
+#include "TransformSystem.h"
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
 #include "math/Matrix4x4.h"
@@ -30,8 +31,10 @@ namespace Viry3D
 
 	private:
 		friend class GameObject;
+		friend class TransformSystem;
 
 	public:
+		virtual ~Transform();
 		WeakRef<Transform> GetParent() const { return m_parent; }
 		void SetParent(const WeakRef<Transform>& parent);
 		String PathInParent(const Ref<Transform>& parent) const;
@@ -40,20 +43,20 @@ namespace Viry3D
 		Ref<Transform> GetChild(int index) const;
 		Ref<Transform> Find(const String& path) const;
 		void SetLocalPosition(const Vector3& pos);
-		const Vector3& GetLocalPosition() const { return m_local_position; }
+		const Vector3& GetLocalPosition() const { return TransformSystem::LocalPosition(m_index); }
 		void SetLocalRotation(const Quaternion& rot);
-		const Quaternion& GetLocalRotation() const { return m_local_rotation; }
+		const Quaternion& GetLocalRotation() const { return TransformSystem::LocalRotation(m_index); }
 		void SetLocalScale(const Vector3& sca);
-		const Vector3& GetLocalScale() const { return m_local_scale; }
+		const Vector3& GetLocalScale() const { return TransformSystem::LocalScale(m_index); }
 		void SetPosition(const Vector3& pos);
 		const Vector3& GetPosition();
 		void SetRotation(const Quaternion& rot);
 		const Quaternion& GetRotation();
 		void SetScale(const Vector3& sca);
 		const Vector3& GetScale();
-		void SetLocalPositionDirect(const Vector3& pos) { m_local_position = pos; }
-		void SetLocalRotationDirect(const Quaternion& rot) { m_local_rotation = rot; }
-		void SetLocalScaleDirect(const Vector3& sca) { m_local_scale = sca; }
+		void SetLocalPositionDirect(const Vector3& pos) { TransformSystem::LocalPosition(m_index) = pos; }
+		void SetLocalRotationDirect(const Quaternion& rot) { TransformSystem::LocalRotation(m_index) = rot; }
+		void SetLocalScaleDirect(const Vector3& sca) { TransformSystem::LocalScale(m_index) = sca; }
 		Vector3 TransformPoint(const Vector3& point);
 		Vector3 TransformDirection(const Vector3& dir);
 		Vector3 InverseTransformPoint(const Vector3& point);
@@ -72,22 +75,14 @@ namespace Viry3D
 		Transform();
 		void RemoveChild(const Ref<Transform>& child);
 		void AddChild(const Ref<Transform>& child);
-		void ApplyChange();
+		void ApplyChange() { TransformSystem::ApplyChange(m_index); }
 		void NotifyChange();
 		void NotifyParentHierarchyChange();
 		void NotifyChildHierarchyChange();
 
 		WeakRef<Transform> m_parent;
 		Vector<Ref<GameObject>> m_children;
-		Vector3 m_local_position;
-		Quaternion m_local_rotation;
-		Vector3 m_local_scale;
-		bool m_changed;
-		Vector3 m_position;
-		Quaternion m_rotation;
-		Vector3 m_scale;
-		Matrix4x4 m_local_to_world_matrix;
-		Matrix4x4 m_world_to_local_matrix;
+		int m_index;
 		bool m_change_notifying;
 	};
 }
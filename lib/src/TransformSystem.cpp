@@ -0,0 +1,309 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "TransformSystem.h"
+#include "GameObject.h"
+#include <algorithm>
+
+namespace Viry3D
+{
+	TransformSystem::Chunk* TransformSystem::m_chunks[MaxChunkCount];
+	int TransformSystem::m_chunk_count = 0;
+	int TransformSystem::m_count = 0;
+	Vector<int> TransformSystem::m_free;
+	Vector<int> TransformSystem::m_free_pending;
+	Vector<int> TransformSystem::m_order;
+	std::atomic<bool> TransformSystem::m_hierarchy_dirty(true);
+	Mutex TransformSystem::m_mutex;
+
+	int TransformSystem::Alloc(Transform* transform)
+	{
+		int index;
+
+		m_mutex.lock();
+
+		if (!m_free.Empty())
+		{
+			index = m_free[m_free.Size() - 1];
+			m_free.Remove(m_free.Size() - 1);
+		}
+		else
+		{
+			index = m_count++;
+
+			if ((index >> ChunkShift) >= m_chunk_count)
+			{
+				assert(m_chunk_count < MaxChunkCount);
+
+				m_chunks[m_chunk_count++] = new Chunk();
+			}
+		}
+
+		// new slot is sorted into order at next Update
+		m_hierarchy_dirty = true;
+
+		m_mutex.unlock();
+
+		LocalPosition(index) = Vector3(0, 0, 0);
+		LocalRotation(index) = Quaternion(0, 0, 0, 1);
+		LocalScale(index) = Vector3(1, 1, 1);
+		Position(index) = LocalPosition(index);
+		Rotation(index) = LocalRotation(index);
+		Scale(index) = LocalScale(index);
+		m_chunks[index >> ChunkShift]->parents[index & ChunkMask] = -1;
+		m_chunks[index >> ChunkShift]->order_positions[index & ChunkMask] = -1;
+		m_chunks[index >> ChunkShift]->subtree_sizes[index & ChunkMask] = 1;
+		Owner(index) = transform;
+		Changed(index) = true;
+
+		return index;
+	}
+
+	void TransformSystem::Free(int index)
+	{
+		// slot may still be in order list, reuse it after order rebuilt
+		Owner(index) = NULL;
+
+		m_mutex.lock();
+		m_free_pending.Add(index);
+		m_hierarchy_dirty = true;
+		m_mutex.unlock();
+	}
+
+	void TransformSystem::SetParent(int index, int parent)
+	{
+		m_chunks[index >> ChunkShift]->parents[index & ChunkMask] = parent;
+		m_hierarchy_dirty = true;
+	}
+
+	bool TransformSystem::GetSubtree(int index, int& start, int& end)
+	{
+		if (m_hierarchy_dirty)
+		{
+			return false;
+		}
+
+		start = m_chunks[index >> ChunkShift]->order_positions[index & ChunkMask];
+		if (start < 0)
+		{
+			return false;
+		}
+		end = start + m_chunks[index >> ChunkShift]->subtree_sizes[index & ChunkMask];
+
+		return true;
+	}
+
+	void TransformSystem::BuildOrder(const FastList<Ref<GameObject>>& objs)
+	{
+		for (auto i : m_order)
+		{
+			m_chunks[i >> ChunkShift]->order_positions[i & ChunkMask] = -1;
+		}
+		m_order.Clear();
+
+		// depth first, children pushed reversed to be visited in child order
+		Vector<Transform*> transforms;
+		Vector<int> parents;
+		Vector<Transform*> stack;
+		Vector<int> stack_parents;
+
+		for (auto& i : objs)
+		{
+			auto transform = i->GetTransform();
+			if (transform && transform->IsRoot())
+			{
+				stack.Add(transform.get());
+				stack_parents.Add(-1);
+
+				while (!stack.Empty())
+				{
+					auto t = stack[stack.Size() - 1];
+					int parent = stack_parents[stack_parents.Size() - 1];
+					stack.Remove(stack.Size() - 1);
+					stack_parents.Remove(stack_parents.Size() - 1);
+
+					int position = transforms.Size();
+					transforms.Add(t);
+					parents.Add(parent);
+
+					for (int j = t->m_children.Size() - 1; j >= 0; j--)
+					{
+						stack.Add(t->m_children[j]->GetTransform().get());
+						stack_parents.Add(position);
+					}
+				}
+			}
+		}
+
+		SortSlots(transforms, parents);
+
+		m_mutex.lock();
+		for (auto i : m_free_pending)
+		{
+			m_free.Add(i);
+		}
+		m_free_pending.Clear();
+		m_mutex.unlock();
+	}
+
+	//
+	//	move data of ordered transforms so their slots ascend in order,
+	//	only slots of these transforms are exchanged, slots of other transforms are not touched
+	//
+	void TransformSystem::SortSlots(const Vector<Transform*>& transforms, const Vector<int>& parents)
+	{
+		int count = transforms.Size();
+
+		Vector<int> slots(count);
+		bool sorted = true;
+		for (int i = 0; i < count; i++)
+		{
+			slots[i] = transforms[i]->m_index;
+			if (i > 0 && slots[i] < slots[i - 1])
+			{
+				sorted = false;
+			}
+		}
+
+		if (!sorted)
+		{
+			std::sort(slots.begin(), slots.end());
+
+			Vector<Vector3> local_positions(count);
+			Vector<Quaternion> local_rotations(count);
+			Vector<Vector3> local_scales(count);
+			Vector<Vector3> positions(count);
+			Vector<Quaternion> rotations(count);
+			Vector<Vector3> scales(count);
+			Vector<Matrix4x4> local_to_world_matrices(count);
+			Vector<Matrix4x4> world_to_local_matrices(count);
+			Vector<char> changed(count);
+
+			for (int i = 0; i < count; i++)
+			{
+				int index = transforms[i]->m_index;
+				local_positions[i] = LocalPosition(index);
+				local_rotations[i] = LocalRotation(index);
+				local_scales[i] = LocalScale(index);
+				positions[i] = Position(index);
+				rotations[i] = Rotation(index);
+				scales[i] = Scale(index);
+				local_to_world_matrices[i] = LocalToWorldMatrix(index);
+				world_to_local_matrices[i] = WorldToLocalMatrix(index);
+				changed[i] = Changed(index);
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				int index = slots[i];
+				LocalPosition(index) = local_positions[i];
+				LocalRotation(index) = local_rotations[i];
+				LocalScale(index) = local_scales[i];
+				Position(index) = positions[i];
+				Rotation(index) = rotations[i];
+				Scale(index) = scales[i];
+				LocalToWorldMatrix(index) = local_to_world_matrices[i];
+				WorldToLocalMatrix(index) = world_to_local_matrices[i];
+				Changed(index) = changed[i] != 0;
+				Owner(index) = transforms[i];
+				transforms[i]->m_index = index;
+			}
+		}
+
+		// children are after their parent, sizes summed from back
+		Vector<int> sizes(count, 1);
+		for (int i = count - 1; i > 0; i--)
+		{
+			if (parents[i] >= 0)
+			{
+				sizes[parents[i]] += sizes[i];
+			}
+		}
+
+		m_order.Resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			int index = slots[i];
+			auto& chunk = *m_chunks[index >> ChunkShift];
+			chunk.parents[index & ChunkMask] = parents[i] >= 0 ? slots[parents[i]] : -1;
+			chunk.order_positions[index & ChunkMask] = i;
+			chunk.subtree_sizes[index & ChunkMask] = sizes[i];
+			m_order[i] = index;
+		}
+	}
+
+	void TransformSystem::Compute(int index, int parent)
+	{
+		auto& chunk = *m_chunks[index >> ChunkShift];
+		int i = index & ChunkMask;
+
+		chunk.changed[i] = false;
+
+		if (parent < 0)
+		{
+			chunk.positions[i] = chunk.local_positions[i];
+			chunk.rotations[i] = chunk.local_rotations[i];
+			chunk.scales[i] = chunk.local_scales[i];
+		}
+		else
+		{
+			const Vector3& ps = Scale(parent);
+			const Vector3& ls = chunk.local_scales[i];
+
+			chunk.positions[i] = LocalToWorldMatrix(parent).MultiplyPoint3x4(chunk.local_positions[i]);
+			chunk.rotations[i] = Rotation(parent) * chunk.local_rotations[i];
+			chunk.scales[i] = Vector3(ls.x * ps.x, ls.y * ps.y, ls.z * ps.z);
+		}
+
+		chunk.local_to_world_matrices[i] = Matrix4x4::TRS(chunk.positions[i], chunk.rotations[i], chunk.scales[i]);
+	}
+
+	void TransformSystem::ApplyChange(int index)
+	{
+		if (Changed(index))
+		{
+			int parent = Parent(index);
+			if (parent >= 0)
+			{
+				ApplyChange(parent);
+			}
+
+			Compute(index, parent);
+		}
+	}
+
+	void TransformSystem::Update(const FastList<Ref<GameObject>>& objs)
+	{
+		if (m_hierarchy_dirty)
+		{
+			m_hierarchy_dirty = false;
+
+			BuildOrder(objs);
+		}
+
+		// parents are always before children in order,
+		// so every parent is up to date when its children are computed
+		for (int i = 0; i < m_order.Size(); i++)
+		{
+			int index = m_order[i];
+			if (Changed(index))
+			{
+				Compute(index, Parent(index));
+			}
+		}
+	}
+}
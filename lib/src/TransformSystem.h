@@ -0,0 +1,113 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "container/Vector.h"
+#include "container/FastList.h"
+#include "math/Vector3.h"
+#include "math/Quaternion.h"
+#include "math/Matrix4x4.h"
+#include "memory/Ref.h"
+#include "thread/Thread.h"
+#include <atomic>
+
+namespace Viry3D
+{
+	class Transform;
+	class GameObject;
+
+	//
+	//	transform data of all objects, stored as arrays per attribute in fixed size chunks,
+	//	slots of objects in world are sorted in hierarchy order when Update finds hierarchy changed,
+	//	parents before children and each subtree in one range of order,
+	//	references returned by Transform getters stay valid until then,
+	//	alloc and free are thread safe, loader threads could create transforms
+	//
+	class TransformSystem
+	{
+	public:
+		static const int ChunkShift = 8;
+		static const int ChunkSize = 1 << ChunkShift;
+		static const int ChunkMask = ChunkSize - 1;
+		static const int MaxChunkCount = 16384;
+
+		struct Chunk
+		{
+			Vector3 local_positions[ChunkSize];
+			Quaternion local_rotations[ChunkSize];
+			Vector3 local_scales[ChunkSize];
+			Vector3 positions[ChunkSize];
+			Quaternion rotations[ChunkSize];
+			Vector3 scales[ChunkSize];
+			Matrix4x4 local_to_world_matrices[ChunkSize];
+			Matrix4x4 world_to_local_matrices[ChunkSize];
+			int parents[ChunkSize];
+			bool changed[ChunkSize];
+			Transform* transforms[ChunkSize];
+			int order_positions[ChunkSize];
+			int subtree_sizes[ChunkSize];
+		};
+
+		static int Alloc(Transform* transform);
+		static void Free(int index);
+		static void SetParent(int index, int parent);
+		static void SetHierarchyDirty() { m_hierarchy_dirty = true; }
+		//
+		//	recompute world data of all changed transforms in objs,
+		//	parents first in one pass, called once per frame on main thread
+		//
+		static void Update(const FastList<Ref<GameObject>>& objs);
+		//
+		//	recompute world data of one transform and its changed parents
+		//
+		static void ApplyChange(int index);
+		static int GetCount() { return m_count; }
+		//
+		//	index and its descendants are order[start, end),
+		//	return false if hierarchy changed since last Update or index not in world
+		//
+		static bool GetSubtree(int index, int& start, int& end);
+		static Transform* GetOrderTransform(int order) { return Owner(m_order[order]); }
+
+		static Vector3& LocalPosition(int index) { return m_chunks[index >> ChunkShift]->local_positions[index & ChunkMask]; }
+		static Quaternion& LocalRotation(int index) { return m_chunks[index >> ChunkShift]->local_rotations[index & ChunkMask]; }
+		static Vector3& LocalScale(int index) { return m_chunks[index >> ChunkShift]->local_scales[index & ChunkMask]; }
+		static Vector3& Position(int index) { return m_chunks[index >> ChunkShift]->positions[index & ChunkMask]; }
+		static Quaternion& Rotation(int index) { return m_chunks[index >> ChunkShift]->rotations[index & ChunkMask]; }
+		static Vector3& Scale(int index) { return m_chunks[index >> ChunkShift]->scales[index & ChunkMask]; }
+		static Matrix4x4& LocalToWorldMatrix(int index) { return m_chunks[index >> ChunkShift]->local_to_world_matrices[index & ChunkMask]; }
+		static Matrix4x4& WorldToLocalMatrix(int index) { return m_chunks[index >> ChunkShift]->world_to_local_matrices[index & ChunkMask]; }
+		static int Parent(int index) { return m_chunks[index >> ChunkShift]->parents[index & ChunkMask]; }
+		static bool& Changed(int index) { return m_chunks[index >> ChunkShift]->changed[index & ChunkMask]; }
+		static Transform*& Owner(int index) { return m_chunks[index >> ChunkShift]->transforms[index & ChunkMask]; }
+
+	private:
+		static void BuildOrder(const FastList<Ref<GameObject>>& objs);
+		static void SortSlots(const Vector<Transform*>& transforms, const Vector<int>& parents);
+		static void Compute(int index, int parent);
+
+		static Chunk* m_chunks[MaxChunkCount];
+		static int m_chunk_count;
+		static int m_count;
+		static Vector<int> m_free;
+		static Vector<int> m_free_pending;
+		static Vector<int> m_order;
+		static std::atomic<bool> m_hierarchy_dirty;
+		static Mutex m_mutex;
+	};
+}
@@ -18,6 +18,7 @@
 #include "World.h"
 #include "Resource.h"
 #include "Profiler.h"
+#include "TransformSystem.h"
 #include "ui/Font.h"
 #include "time/Time.h"
 #include "graphics/Shader.h"
@@ -25,8 +26,10 @@
 #include "graphics/RenderTexture.h"
 #include "graphics/LightmapSettings.h"
 #include "renderer/Renderer.h"
+#include "renderer/ParticleSystem.h"
 #include "audio/AudioManager.h"
 #include "physics/Physics.h"
+#include "math/Mathf.h"
 #include <stdlib.h>
 
 namespace Viry3D
@@ -34,6 +37,9 @@ namespace Viry3D
 	FastList<Ref<GameObject>> World::m_gameobjects;
 	List<Ref<GameObject>> World::m_gameobjects_start;
 	Mutex World::m_mutex;
+	bool World::m_parallel_update = false;
+	int World::m_parallel_update_batch_size = 64;
+	int World::m_update_thread_count = -1;
 
 	void World::AddGameObject(const Ref<GameObject>& obj)
 	{
@@ -52,10 +58,64 @@ namespace Viry3D
 		m_mutex.unlock();
 	}
 
+	void World::SetParallelUpdate(bool enable, int thread_count)
+	{
+		m_parallel_update = enable;
+		m_update_thread_count = thread_count;
+	}
+
+	void World::SetParallelUpdateBatchSize(int size)
+	{
+		m_parallel_update_batch_size = Mathf::Max(size, 1);
+	}
+
+	void World::UpdateParallel(const Vector<Ref<Component>>& coms, bool late_update)
+	{
+		if (coms.Empty())
+		{
+			return;
+		}
+
+		// resolve changed world transforms on main thread,
+		// so update threads only read them
+		for (const auto& i : coms)
+		{
+			i->GetTransform()->GetLocalToWorldMatrix();
+		}
+
+		int batch_size = m_parallel_update_batch_size;
+		int batch_count = (coms.Size() + batch_size - 1) / batch_size;
+
+		ThreadPool::ParallelFor(batch_count, [&](int batch, int thread_index) {
+			int start = batch * batch_size;
+			int end = Mathf::Min(start + batch_size, coms.Size());
+
+			for (int i = start; i < end; i++)
+			{
+				const auto& com = coms[i];
+				if (com->IsEnable())
+				{
+					if (late_update)
+					{
+						com->LateUpdate();
+					}
+					else
+					{
+						com->Update();
+					}
+				}
+			}
+		}, m_update_thread_count);
+	}
+
 	void World::Update()
 	{
 		Physics::Update();
 
+		bool parallel = m_parallel_update;
+		// held by ref, the component sweep in LateUpdate could remove them before batches run
+		Vector<Ref<Component>> parallel_coms;
+
         for (auto i = m_gameobjects.begin(); i != m_gameobjects.end(); )
         {
             auto& obj = *i;
@@ -64,7 +124,7 @@ namespace Viry3D
                 if (obj->IsActiveInHierarchy())
                 {
                     obj->Start();
-                    obj->Update();
+                    obj->Update(parallel ? &parallel_coms : NULL);
                 }
             }
             else
@@ -76,6 +136,12 @@ namespace Viry3D
             ++i;
         }
 
+		if (parallel)
+		{
+			UpdateParallel(parallel_coms, false);
+			parallel_coms.Clear();
+		}
+
         for (auto i = m_gameobjects.begin(); i != m_gameobjects.end(); )
         {
             auto& obj = *i;
@@ -83,7 +149,7 @@ namespace Viry3D
             {
                 if (obj->IsActiveInHierarchy())
                 {
-                    obj->LateUpdate();
+                    obj->LateUpdate(parallel ? &parallel_coms : NULL);
                 }
             }
             else
@@ -95,6 +161,13 @@ namespace Viry3D
             ++i;
         }
 
+		if (parallel)
+		{
+			// all update threads joined here, before renderers are collected
+			UpdateParallel(parallel_coms, true);
+			parallel_coms.Clear();
+		}
+
         List<Ref<GameObject>> starts;
         do
         {
@@ -134,6 +207,11 @@ namespace Viry3D
             m_mutex.unlock();
         } while (starts.Size() > 0);
 
+		// particle simulation jobs joined here, before renderers are collected
+		ParticleSystem::UpdateAll();
+
+		TransformSystem::Update(m_gameobjects);
+
 		if (Renderer::IsRenderersDirty())
 		{
 			Renderer::SetRenderersDirty(false);
@@ -143,6 +221,7 @@ namespace Viry3D
 			renderers.Clear();
 
 			FindAllRenders(m_gameobjects, renderers, false, false, false);
+			Renderer::OnRenderersChanged();
 		}
 	}
 
@@ -202,6 +281,9 @@ namespace Viry3D
 		LightmapSettings::Clear();
 		Resource::Deinit();
 		m_gameobjects.Clear();
+		m_parallel_update = false;
+		ParticleSystem::Deinit();
+		ThreadPool::ReleaseShared();
 
         m_mutex.lock();
         m_gameobjects_start.Clear();
@@ -20,6 +20,7 @@
 #include "GameObject.h"
 #include "container/FastList.h"
 #include "container/List.h"
+#include "container/Vector.h"
 
 namespace Viry3D
 {
@@ -35,13 +36,25 @@ namespace Viry3D
 		static void Update();
 		static void OnPause();
 		static void OnResume();
+		//
+		//	components return true from IsThreadSafeUpdate run their Update and LateUpdate
+		//	on the shared thread pool in batches, other components still run on main thread in order,
+		//	thread_count limits pool threads used, <= 0 means use all
+		//
+		static void SetParallelUpdate(bool enable, int thread_count = -1);
+		static bool IsParallelUpdate() { return m_parallel_update; }
+		static void SetParallelUpdateBatchSize(int size);
 
 	private:
+		static void UpdateParallel(const Vector<Ref<Component>>& coms, bool late_update);
 		static void FindAllRenders(const FastList<Ref<GameObject>>& objs, List<Renderer*>& renderers, bool include_inactive, bool include_disable, bool static_only);
 
 	private:
 		static FastList<Ref<GameObject>> m_gameobjects;
 		static List<Ref<GameObject>> m_gameobjects_start;
 		static Mutex m_mutex;
+		static bool m_parallel_update;
+		static int m_parallel_update_batch_size;
+		static int m_update_thread_count;
 	};
 }
@@ -201,6 +201,7 @@ namespace Viry3D
 		}
 
 		this->UpdateBlend();
+		this->SampleClips();
 		this->UpdateBones();
 		this->UpdateBlendShapes();
 	}
@@ -256,6 +257,27 @@ namespace Viry3D
 		}
 	}
 
+	void Animation::SampleClips()
+	{
+		for (auto i = m_blends.begin(); i != m_blends.end(); i++)
+		{
+			auto state = i->state;
+			const auto& clip = state->clip;
+
+			int curve_count = clip->GetCurveCount();
+			if (state->sample_values.Size() != curve_count)
+			{
+				state->sample_values.Resize(curve_count);
+				state->sample_cursors.Resize(curve_count, 0);
+			}
+
+			if (curve_count > 0)
+			{
+				clip->Sample(state->time, &state->sample_values[0], &state->sample_cursors[0]);
+			}
+		}
+	}
+
 	void Animation::UpdateBones()
 	{
 		for (auto i = m_bones.begin(); i != m_bones.end(); i++)
@@ -283,9 +305,9 @@ namespace Viry3D
 					for (int k = 0; k < cb.transform_curves.Size(); k++)
 					{
 						auto& curve = cb.transform_curves[k];
-						if (!curve.keys.Empty())
+						if (!curve.GetKeys().Empty())
 						{
-							float value = curve.Evaluate(state->time);
+							float value = state->sample_values[cb.transform_curve_index + k];
 
 							change_mask |= 1 << k;
 
@@ -410,7 +432,7 @@ namespace Viry3D
 			auto state = i->state;
 			float weight = i->weight;
 
-			for (auto j : state->clip->curves)
+			for (const auto& j : state->clip->curves)
 			{
 				auto& path = j.second.path;
 
@@ -421,9 +443,9 @@ namespace Viry3D
 						auto& property = j.second.blend_shape_properties[k];
 						auto& curve = j.second.blend_shape_curves[k];
 						float value = 0;
-						if (!curve.keys.Empty())
+						if (!curve.GetKeys().Empty())
 						{
-							value = curve.Evaluate(state->time);
+							value = state->sample_values[j.second.blend_shape_curve_index + k];
 						}
 
 						String key = path + property;
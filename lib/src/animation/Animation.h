@@ -42,6 +42,7 @@ namespace Viry3D
 		void Stop();
 		void CrossFade(const String& clip, float fade_length = 0.3f, PlayMode mode = PlayMode::StopSameLayer);
 		AnimationState GetAnimationState(const String& clip) const;
+		const Map<String, AnimationState>& GetAnimationStates() const { return m_states; }
 		void UpdateAnimationState(const String& clip, const AnimationState& state);
 
 	private:
@@ -83,6 +84,7 @@ namespace Viry3D
 		virtual void Update();
 		void UpdateAnimation();
 		void UpdateBlend();
+		void SampleClips();
 		void UpdateBones();
 		void UpdateBlendShapes();
 		void Play(AnimationState& state);
@@ -0,0 +1,52 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AnimationClip.h"
+
+namespace Viry3D
+{
+	void AnimationClip::BuildCurveIndex()
+	{
+		m_flat_curves.Clear();
+
+		for (auto& i : curves)
+		{
+			auto& binding = i.second;
+
+			binding.transform_curve_index = m_flat_curves.Size();
+			for (const auto& j : binding.transform_curves)
+			{
+				m_flat_curves.Add(&j);
+			}
+
+			binding.blend_shape_curve_index = m_flat_curves.Size();
+			for (const auto& j : binding.blend_shape_curves)
+			{
+				m_flat_curves.Add(&j);
+			}
+		}
+	}
+
+	void AnimationClip::Sample(float time, float* values, int* cursors) const
+	{
+		int count = m_flat_curves.Size();
+		for (int i = 0; i < count; i++)
+		{
+			values[i] = m_flat_curves[i]->Evaluate(time, cursors[i]);
+		}
+	}
+}
@@ -41,18 +41,44 @@ namespace Viry3D
 
 	struct CurveBinding
 	{
+		CurveBinding():
+			transform_curve_index(-1),
+			blend_shape_curve_index(-1)
+		{
+		}
+
 		String path;
 		Vector<AnimationCurve> transform_curves;
 		Vector<String> blend_shape_properties;
 		Vector<AnimationCurve> blend_shape_curves;
+		//
+		//	index of first curve in the flat array of AnimationClip::Sample
+		//
+		int transform_curve_index;
+		int blend_shape_curve_index;
 	};
 
 	class AnimationClip: public Object
 	{
 	public:
+		//
+		//	number curves of all bindings for Sample,
+		//	call after curves loaded or changed
+		//
+		void BuildCurveIndex();
+		int GetCurveCount() const { return m_flat_curves.Size(); }
+		//
+		//	evaluate all curves at time into values in one pass, indexed by curve index of binding,
+		//	cursors keep key index of each curve between calls, both sized by GetCurveCount
+		//
+		void Sample(float time, float* values, int* cursors) const;
+
 		float frame_rate;
 		float length;
 		AnimationWrapMode wrap_mode;
 		Map<String, CurveBinding> curves;
+
+	private:
+		Vector<const AnimationCurve*> m_flat_curves;
 	};
 }
@@ -24,8 +24,8 @@ namespace Viry3D
 	AnimationCurve AnimationCurve::DefaultLinear()
 	{
 		AnimationCurve c;
-		c.keys.Add(Keyframe(0, 0, 1, 1));
-		c.keys.Add(Keyframe(1, 1, 1, 1));
+		c.AddKey(Keyframe(0, 0, 1, 1));
+		c.AddKey(Keyframe(1, 1, 1, 1));
 
 		return c;
 	}
@@ -53,36 +53,134 @@ namespace Viry3D
 		return value;
 	}
 
+	void AnimationCurve::Bake(int resolution)
+	{
+		m_baked.Clear();
+
+		if (m_keys.Size() < 2 || resolution < 2)
+		{
+			return;
+		}
+
+		float start = m_keys[0].time;
+		float end = m_keys[m_keys.Size() - 1].time;
+		if (end - start < Mathf::Epsilon)
+		{
+			return;
+		}
+
+		m_baked.Resize(resolution);
+		for (int i = 0; i < resolution; i++)
+		{
+			m_baked[i] = this->EvaluateKeys(start + (end - start) * i / (resolution - 1));
+		}
+		m_baked_start = start;
+		m_baked_scale = (resolution - 1) / (end - start);
+	}
+
 	float AnimationCurve::Evaluate(float time)
 	{
-		if (keys.Empty())
+		if (!m_baked.Empty())
+		{
+			return this->EvaluateBaked(time);
+		}
+
+		return this->EvaluateKeys(time);
+	}
+
+	float AnimationCurve::Evaluate(float time, int& cursor) const
+	{
+		if (!m_baked.Empty())
+		{
+			return this->EvaluateBaked(time);
+		}
+
+		return this->EvaluateKeys(time, cursor);
+	}
+
+	float AnimationCurve::EvaluateBaked(float time) const
+	{
+		float x = (time - m_baked_start) * m_baked_scale;
+		int last = m_baked.Size() - 1;
+		if (x <= 0)
+		{
+			return m_baked[0];
+		}
+		if (x >= last)
+		{
+			return m_baked[last];
+		}
+
+		int i = (int) x;
+		return m_baked[i] + (m_baked[i + 1] - m_baked[i]) * (x - i);
+	}
+
+	float AnimationCurve::EvaluateKeys(float time) const
+	{
+		int cursor = 0;
+		return this->EvaluateKeys(time, cursor);
+	}
+
+	float AnimationCurve::EvaluateKeys(float time, int& cursor) const
+	{
+		if (m_keys.Empty())
 		{
 			return 0;
 		}
 
-		const auto& back = keys[keys.Size() - 1];
+		const auto& back = m_keys[m_keys.Size() - 1];
 		if (time >= back.time)
 		{
 			return back.value;
 		}
 
-		for (int i = 0; i < keys.Size(); i++)
+		const auto& front = m_keys[0];
+		if (time < front.time)
+		{
+			return front.value;
+		}
+
+		cursor = this->FindKey(time, cursor);
+
+		return evaluate(time, m_keys[cursor], m_keys[cursor + 1]);
+	}
+
+	//
+	//	index i of keys[i].time <= time < keys[i + 1].time,
+	//	time must be in [front.time, back.time)
+	//
+	int AnimationCurve::FindKey(float time, int cursor) const
+	{
+		int last = m_keys.Size() - 1;
+
+		if (cursor >= 0 && cursor < last && m_keys[cursor].time <= time)
 		{
-			const auto& frame = keys[i];
+			if (time < m_keys[cursor + 1].time)
+			{
+				return cursor;
+			}
 
-			if (time < frame.time)
+			if (cursor + 1 < last && time < m_keys[cursor + 2].time)
+			{
+				return cursor + 1;
+			}
+		}
+
+		int low = 0;
+		int high = last;
+		while (high - low > 1)
+		{
+			int mid = (low + high) >> 1;
+			if (m_keys[mid].time <= time)
+			{
+				low = mid;
+			}
+			else
 			{
-				if (i == 0)
-				{
-					return frame.value;
-				}
-				else
-				{
-					return evaluate(time, keys[i - 1], frame);
-				}
+				high = mid;
 			}
 		}
 
-		return 0;
+		return low;
 	}
 }
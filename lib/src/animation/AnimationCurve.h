@@ -43,9 +43,39 @@ namespace Viry3D
 
 	struct AnimationCurve
 	{
+		static const int BakeResolution = 128;
+
 		static AnimationCurve DefaultLinear();
+		AnimationCurve(): m_baked_start(0), m_baked_scale(0) { }
 		float Evaluate(float time);
+		//
+		//	cursor is the key index of last call kept by caller, checked first with its next key,
+		//	so time moving forward finds its key in constant time, seek falls back to binary search
+		//
+		float Evaluate(float time, int& cursor) const;
+		//
+		//	sample keys into a lookup table, Evaluate then lerps two samples,
+		//	every key edit drops the table, Evaluate falls back to keys until baked again
+		//
+		void Bake(int resolution = BakeResolution);
+		void ClearBake() { m_baked.Clear(); }
+		bool IsBaked() const { return !m_baked.Empty(); }
+		float EvaluateKeys(float time) const;
+		float EvaluateKeys(float time, int& cursor) const;
+		const Vector<Keyframe>& GetKeys() const { return m_keys; }
+		int GetKeyCount() const { return m_keys.Size(); }
+		const Keyframe& GetKey(int index) const { return m_keys[index]; }
+		void AddKey(const Keyframe& key) { m_keys.Add(key); this->ClearBake(); }
+		void SetKey(int index, const Keyframe& key) { m_keys[index] = key; this->ClearBake(); }
+		void ClearKeys() { m_keys.Clear(); this->ClearBake(); }
+
+	private:
+		float EvaluateBaked(float time) const;
+		int FindKey(float time, int cursor) const;
 
-		Vector<Keyframe> keys;
+		Vector<Keyframe> m_keys;
+		Vector<float> m_baked;
+		float m_baked_start;
+		float m_baked_scale;
 	};
 }
@@ -92,5 +92,10 @@ namespace Viry3D
 		float time_last;
 		int play_dir;
 		AnimationFade fade;
+		//
+		//	clip curves sampled at time each update, with key cursors kept across frames
+		//
+		Vector<float> sample_values;
+		Vector<int> sample_cursors;
 	};
 }
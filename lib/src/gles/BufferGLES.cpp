@@ -108,6 +108,18 @@ namespace Viry3D
 		LogGLError();
 	}
 
+	ByteBuffer BufferGLES::Map()
+	{
+		assert(m_usage == GL_DYNAMIC_DRAW);
+
+		return *this->GetLocalBuffer().get();
+	}
+
+	void BufferGLES::Unmap()
+	{
+		this->UpdateRange(0, m_size, m_local_buffer->Bytes());
+	}
+
 	void BufferGLES::Fill(void* param, FillFunc fill)
 	{
 		LogGLError();
@@ -35,6 +35,12 @@ namespace Viry3D
 		typedef std::function<void(void* param, const ByteBuffer& buffer)> FillFunc;
 		void Fill(void* param, FillFunc fill);
 		void UpdateRange(int offset, int size, const void* data);
+		//
+		//	whole buffer mapped for writing, could be filled on any thread,
+		//	Unmap on render thread after all writes done
+		//
+		ByteBuffer Map();
+		void Unmap();
 
 	protected:
 		BufferGLES();
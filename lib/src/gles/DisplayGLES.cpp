@@ -85,7 +85,8 @@ namespace Viry3D
 	DisplayGLES::DisplayGLES():
 		m_private(RefMake<DisplayGLESPrivate>()),
 		m_uniform_buffer_offset_alignment(0),
-		m_default_vao(0)
+		m_default_vao(0),
+		m_instance_buffer(0)
 	{
 	}
 
@@ -430,6 +431,11 @@ namespace Viry3D
 		LogGLError();
 	}
 
+	void DisplayGLES::BindInstanceBuffer(const VertexBuffer* buffer)
+	{
+		m_instance_buffer = buffer->GetBuffer();
+	}
+
 	void DisplayGLES::BindIndexBuffer(const IndexBuffer* buffer, IndexType index_type)
 	{
 		LogGLError();
@@ -446,14 +452,33 @@ namespace Viry3D
 		auto vs = shader->GetVertexShaderInfo(pass_index);
 		for (const auto& i : vs->attrs)
 		{
-			glEnableVertexAttribArray(i.location);
-			glVertexAttribPointer(i.location, i.size / 4, GL_FLOAT, GL_FALSE, vs->stride, (const GLvoid*) (size_t) i.offset);
+			if (!i.instance)
+			{
+				glEnableVertexAttribArray(i.location);
+				glVertexAttribPointer(i.location, i.size / 4, GL_FLOAT, GL_FALSE, vs->stride, (const GLvoid*) (size_t) i.offset);
+			}
+		}
+
+		// after per vertex ones, pointers take the buffer bound when set
+		if (vs->instance_stride > 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+
+			for (const auto& i : vs->attrs)
+			{
+				if (i.instance)
+				{
+					glEnableVertexAttribArray(i.location);
+					glVertexAttribPointer(i.location, i.size / 4, GL_FLOAT, GL_FALSE, vs->instance_stride, (const GLvoid*) (size_t) i.offset);
+					glVertexAttribDivisor(i.location, 1);
+				}
+			}
 		}
 
 		LogGLError();
 	}
 
-	void DisplayGLES::DrawIndexed(int start, int count, IndexType index_type)
+	void DisplayGLES::DrawIndexed(int start, int count, IndexType index_type, int instance_count)
 	{
 		LogGLError();
 
@@ -470,7 +495,14 @@ namespace Viry3D
 			type_size = 4;
 		}
 
-		glDrawElements(GL_TRIANGLES, count, type, (const GLvoid*) (size_t) (start * type_size));
+		if (instance_count > 1)
+		{
+			glDrawElementsInstanced(GL_TRIANGLES, count, type, (const GLvoid*) (size_t) (start * type_size), instance_count);
+		}
+		else
+		{
+			glDrawElements(GL_TRIANGLES, count, type, (const GLvoid*) (size_t) (start * type_size));
+		}
 
 		Graphics::draw_call++;
 
@@ -484,6 +516,10 @@ namespace Viry3D
 		auto vs = shader->GetVertexShaderInfo(pass_index);
 		for (const auto& i : vs->attrs)
 		{
+			if (i.instance)
+			{
+				glVertexAttribDivisor(i.location, 0);
+			}
 			glDisableVertexAttribArray(i.location);
 		}
 
@@ -64,11 +64,16 @@ namespace Viry3D
 		void WaitQueueIdle() { }
 		void BindVertexArray();
 		void BindVertexBuffer(const VertexBuffer* buffer);
+		//
+		//	source of per instance attributes for next draws
+		//
+		void BindInstanceBuffer(const VertexBuffer* buffer);
 		void BindIndexBuffer(const IndexBuffer* buffer, IndexType index_type);
 		void BindVertexAttribArray(const Ref<Shader>& shader, int pass_index);
-		void DrawIndexed(int start, int count, IndexType index_type);
+		void DrawIndexed(int start, int count, IndexType index_type, int instance_count = 1);
 		void DisableVertexArray(const Ref<Shader>& shader, int pass_index);
 		void SubmitQueue(void* cmd) { }
+		bool IsParallelRecording() const { return false; }
 		virtual void BeginRecord(const String& file);
 		virtual void EndRecord();
 
@@ -116,5 +121,6 @@ namespace Viry3D
 		String m_extensions;
 		String m_device_name;
 		GLuint m_default_vao;
+		GLuint m_instance_buffer;
 	};
 }
@@ -499,11 +499,17 @@ namespace Viry3D
 		"#define VR_GLES 1\n"
 		"#define UniformBuffer(set_index, binding_index) layout(std140)\n"
 		"#define UniformTexture(set_index, binding_index)\n"
-		"#define Varying(location_index)\n";
+		"#define Varying(location_index)\n"
+		"#define VR_INSTANCE_ID gl_InstanceID\n";
 
-	static String combine_shader_src(const Vector<String>& includes, const String& src)
+	static String combine_shader_src(const Vector<String>& includes, const String& src, bool instancing)
 	{
 		String source = g_shader_header;
+		if (instancing)
+		{
+			source += "#define VR_INSTANCING 1\n";
+			source += "#define VR_INSTANCE_MAX " + String::ToString(Graphics::InstanceCountMax) + "\n";
+		}
 		for (const auto& i : includes)
 		{
 			auto include_path = Application::DataPath() + "/shader/Include/" + i;
@@ -522,7 +528,7 @@ namespace Viry3D
 
 		for (const auto& i : xml.vss)
 		{
-			auto source = combine_shader_src(i.includes, i.src);
+			auto source = combine_shader_src(i.includes, i.src, xml.instancing);
 
 			auto shader = create_shader(GL_VERTEX_SHADER, source);
 			if (shader == 0)
@@ -535,7 +541,7 @@ namespace Viry3D
 
 		for (const auto& i : xml.pss)
 		{
-			auto source = combine_shader_src(i.includes, i.src);
+			auto source = combine_shader_src(i.includes, i.src, false);
 
 			auto shader = create_shader(GL_FRAGMENT_SHADER, source);
 			if (shader == 0)
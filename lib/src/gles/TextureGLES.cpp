@@ -21,9 +21,76 @@
 #include "graphics/Cubemap.h"
 #include "Debug.h"
 #include "math/Mathf.h"
+#include "thread/Thread.h"
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
 
 namespace Viry3D
 {
+	static GLenum compressed_gl_format(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::ETC2_RGB8:
+				return GL_COMPRESSED_RGB8_ETC2;
+			case TextureFormat::ETC2_RGBA8:
+				return GL_COMPRESSED_RGBA8_ETC2_EAC;
+			case TextureFormat::ASTC_4x4:
+				return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+			case TextureFormat::BC7:
+				return GL_COMPRESSED_RGBA_BPTC_UNORM;
+			default:
+				return 0;
+		}
+	}
+
+	bool TextureGLES::IsFormatSupported(TextureFormat format)
+	{
+		GLenum gl_format = compressed_gl_format(format);
+		if (gl_format == 0)
+		{
+			return true;
+		}
+
+		static Mutex s_mutex;
+		static bool s_queried = false;
+		static Vector<GLint> s_formats;
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		if (!s_queried)
+		{
+			GLint count = 0;
+			glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+			if (count > 0)
+			{
+				s_formats.Resize(count);
+				glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &s_formats[0]);
+			}
+			s_queried = true;
+		}
+
+		for (int i = 0; i < s_formats.Size(); i++)
+		{
+			if (s_formats[i] == (GLint) gl_format)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	TextureGLES::TextureGLES():
 		m_texture(0),
 		m_target(0),
@@ -108,6 +175,13 @@ namespace Viry3D
 
 	void TextureGLES::CreateTexture2D()
 	{
+		// recreated when resident levels of a streamed texture change
+		if (m_texture != 0)
+		{
+			glDeleteTextures(1, &m_texture);
+			m_texture = 0;
+		}
+
 		auto texture = (Texture2D*) this;
 		auto texture_format = texture->GetFormat();
 		auto colors = texture->GetColors();
@@ -138,12 +212,23 @@ namespace Viry3D
 			format = GL_RGB;
 			type = GL_FLOAT;
 		}
+		else if (compressed_gl_format(texture_format) != 0)
+		{
+			m_format = compressed_gl_format(texture_format);
+		}
 		else
 		{
 			assert(!"texture format not implement");
 		}
 
-		this->Create2D(format, type, colors.Bytes());
+		if (texture->GetLevels().Size() > 0)
+		{
+			this->Create2DLevels(format, type, compressed_gl_format(texture_format) != 0);
+		}
+		else
+		{
+			this->Create2D(format, type, colors.Bytes());
+		}
 	}
 
 	void TextureGLES::UpdateTexture2D(int x, int y, int w, int h, const ByteBuffer& colors)
@@ -207,6 +292,52 @@ namespace Viry3D
 		this->UpdateSampler();
 	}
 
+	void TextureGLES::Create2DLevels(GLenum format, GLenum type, bool compressed)
+	{
+		LogGLError();
+
+		auto texture = (Texture2D*) this;
+		int width = texture->GetWidth();
+		int height = texture->GetHeight();
+		const auto& levels = texture->GetLevels();
+
+		m_target = GL_TEXTURE_2D;
+
+		glGenTextures(1, &m_texture);
+		glBindTexture(m_target, m_texture);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (int i = 0; i < levels.Size(); i++)
+		{
+			int w = Mathf::Max(width >> i, 1);
+			int h = Mathf::Max(height >> i, 1);
+
+			if (compressed)
+			{
+				glCompressedTexImage2D(m_target, i, m_format, w, h, 0, levels[i].Size(), levels[i].Bytes());
+			}
+			else
+			{
+				glTexImage2D(m_target, i, m_format, w, h, 0, format, type, levels[i].Bytes());
+			}
+		}
+
+		if (levels.Size() > 1)
+		{
+			glTexParameteri(m_target, GL_TEXTURE_MAX_LEVEL, levels.Size() - 1);
+		}
+
+		glBindTexture(m_target, 0);
+
+		LogGLError();
+
+		if (levels.Size() == 1)
+		{
+			this->GenerateMipmap();
+		}
+		this->UpdateSampler();
+	}
+
     void TextureGLES::SetExternalTexture2D(void* texture)
     {
         m_target = GL_TEXTURE_2D;
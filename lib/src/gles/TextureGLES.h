@@ -19,6 +19,7 @@
 
 #include "Object.h"
 #include "gles_include.h"
+#include "graphics/TextureFormat.h"
 
 namespace Viry3D
 {
@@ -28,6 +29,10 @@ namespace Viry3D
 		virtual ~TextureGLES();
 		GLuint GetTexture() const { return m_texture; }
 		void UpdateSampler();
+		//
+		//	uncompressed formats always, compressed ones by driver report
+		//
+		static bool IsFormatSupported(TextureFormat format);
 
 	protected:
 		TextureGLES();
@@ -44,6 +49,7 @@ namespace Viry3D
 
 	private:
 		void Create2D(GLenum format, GLenum type, void* pixels);
+		void Create2DLevels(GLenum format, GLenum type, bool compressed);
 
 	private:
 		GLuint m_texture;
@@ -208,14 +208,13 @@ namespace Viry3D
 
 	void Camera::BeginRenderPass(bool post) const
 	{
-		Graphics::GetDisplay()->WaitQueueIdle();
 		if (post)
 		{
 			m_render_pass_post->Begin(this->GetClearColor());
 		}
 		else
 		{
-			m_render_pass->Begin(this->GetClearColor());
+			m_render_pass->Begin(this->GetClearColor(), Graphics::GetDisplay()->IsParallelRecording());
 		}
 	}
 
@@ -24,10 +24,14 @@
 #include "RenderPass.h"
 #include "RenderTexture.h"
 #include "DescriptorSet.h"
+#include "UniformBuffer.h"
+#include "TextureStreaming.h"
+#include "math/Mathf.h"
 
 namespace Viry3D
 {
 	int Graphics::draw_call = 0;
+	int Graphics::dynamic_batched_draw_call = 0;
 	Ref<Display> Graphics::m_display;
 	Ref<Mesh> Graphics::m_blit_mesh;
 	Vector<Ref<Material>> Graphics::m_blit_materials;
@@ -35,11 +39,13 @@ namespace Viry3D
 	Ref<DescriptorSet> Graphics::m_draw_descriptor_set;
 	Ref<UniformBuffer> Graphics::m_draw_descriptor_set_buffer;
 	CullFace Graphics::m_global_cull_face = CullFace::NoSet;
+	Map<int, Map<int, Graphics::InstanceBufferPool>> Graphics::m_instance_buffer_pools;
 
 	void Graphics::Init(int width, int height, int fps)
 	{
 		m_display = RefMake<Display>();
 		m_display->Init(width, height, fps);
+		TextureStreaming::Init();
 
 		Application::RunTaskInPreLoop(RunLoop::Task([] {
 			m_display->ProcessSystemEvents();
@@ -67,6 +73,7 @@ namespace Viry3D
 
 	void Graphics::Deinit()
 	{
+		m_instance_buffer_pools.Clear();
 		m_draw_descriptor_set.reset();
 		m_draw_descriptor_set_buffer.reset();
 		m_blit_render_passes.Clear();
@@ -76,6 +83,7 @@ namespace Viry3D
 			m_blit_mesh.reset();
 		}
 
+		TextureStreaming::Deinit();
 		m_display->Deinit();
 		m_display.reset();
 	}
@@ -88,6 +96,8 @@ namespace Viry3D
 	void Graphics::Render()
 	{
 		Graphics::draw_call = 0;
+		Graphics::dynamic_batched_draw_call = 0;
+		Graphics::ResetInstanceBuffers();
 
 		m_display->BeginFrame();
 
@@ -156,7 +166,7 @@ namespace Viry3D
 			mesh->uv.Add(Vector2(1, 1));
 			mesh->uv.Add(Vector2(1, 0));
 			mesh->uv.Add(Vector2(0, 0));
-			unsigned short triangles[] = {
+			unsigned int triangles[] = {
 				0, 1, 2, 0, 2, 3
 			};
 			mesh->triangles.AddRange(triangles, 6);
@@ -170,6 +180,12 @@ namespace Viry3D
 
 	void Graphics::DrawMesh(const Ref<Mesh>& mesh, const Matrix4x4& matrix, const Ref<Material>& material, int pass)
 	{
+		if (material->GetShader()->IsInstancing())
+		{
+			Graphics::DrawMeshInstanced(mesh, Vector<Matrix4x4>(1, matrix), material, pass);
+			return;
+		}
+
 		auto render_pass = RenderPass::GetRenderPassBinding();
 		if (render_pass == NULL)
 		{
@@ -182,6 +198,59 @@ namespace Viry3D
 		auto shader = material->GetShader();
 		shader->UpdateRendererDescriptorSet(m_draw_descriptor_set, m_draw_descriptor_set_buffer, &matrix, sizeof(Matrix4x4), -1);
 
+		Graphics::DrawMeshPasses(mesh, material, pass, m_draw_descriptor_set, m_draw_descriptor_set_buffer, 1);
+
+		if (render_pass == NULL)
+		{
+			Camera::Current()->EndRenderPass(true);
+		}
+	}
+
+	void Graphics::DrawMeshInstanced(const Ref<Mesh>& mesh, const Vector<Matrix4x4>& matrices, const Ref<Material>& material, int pass)
+	{
+		auto shader = material->GetShader();
+		if (!shader->IsInstancing())
+		{
+			for (const auto& i : matrices)
+			{
+				Graphics::DrawMesh(mesh, i, material, pass);
+			}
+			return;
+		}
+
+		auto render_pass = RenderPass::GetRenderPassBinding();
+		if (render_pass == NULL)
+		{
+			Camera::Current()->BeginRenderPass(true);
+		}
+
+		auto vp = Camera::Current()->GetProjectionMatrix() * Camera::Current()->GetViewMatrix();
+		material->SetMatrix("_ViewProjection", vp);
+
+		InstanceData instances[InstanceCountMax];
+		for (int i = 0; i < matrices.Size(); i += InstanceCountMax)
+		{
+			int count = Mathf::Min(matrices.Size() - i, InstanceCountMax);
+			for (int j = 0; j < count; j++)
+			{
+				instances[j].world_matrix = matrices[i + j];
+				instances[j].lightmap_scale_offset = Vector4(1, 1, 0, 0);
+			}
+
+			auto buffer = Graphics::GetInstanceBuffer(shader, instances, count, -1);
+			Graphics::DrawMeshPasses(mesh, material, pass, buffer->descriptor_set, buffer->descriptor_set_buffer, count);
+		}
+
+		if (render_pass == NULL)
+		{
+			Camera::Current()->EndRenderPass(true);
+		}
+	}
+
+	void Graphics::DrawMeshPasses(const Ref<Mesh>& mesh, const Ref<Material>& material, int pass, const Ref<DescriptorSet>& descriptor_set, Ref<UniformBuffer>& descriptor_set_buffer, int instance_count)
+	{
+		auto shader = material->GetShader();
+
 		int pass_begin = 0;
 		int pass_end = 0;
 		if (pass < 0)
@@ -204,10 +273,10 @@ namespace Viry3D
 
 				shader->BeginPass(j);
 				shader->BindSharedMaterial(j, material);
-				shader->BindMaterial(j, material, m_draw_descriptor_set);
-				shader->BindRendererDescriptorSet(j, m_draw_descriptor_set_buffer, -1);
+				shader->BindMaterial(j, material, descriptor_set);
+				shader->BindRendererDescriptorSet(j, descriptor_set_buffer, -1);
 
-				auto index_type = IndexType::UnsignedShort;
+				auto index_type = mesh->GetIndexType();
 				int index_start;
 				int index_count;
 				mesh->GetIndexRange(i, index_start, index_count);
@@ -216,16 +285,39 @@ namespace Viry3D
 				GetDisplay()->BindVertexBuffer(mesh->GetVertexBuffer().get());
 				GetDisplay()->BindIndexBuffer(mesh->GetIndexBuffer().get(), index_type);
 				GetDisplay()->BindVertexAttribArray(shader, j);
-				GetDisplay()->DrawIndexed(index_start, index_count, index_type);
+				GetDisplay()->DrawIndexed(index_start, index_count, index_type, instance_count);
 				GetDisplay()->DisableVertexArray(shader, j);
 
 				shader->EndPass(j);
 			}
 		}
+	}
 
-		if (render_pass == NULL)
+	InstanceBuffer* Graphics::GetInstanceBuffer(const Ref<Shader>& shader, const InstanceData* data, int count, int lightmap_index)
+	{
+		auto& pool = m_instance_buffer_pools[shader->GetId()][lightmap_index];
+
+		if (pool.used == pool.buffers.Size())
 		{
-			Camera::Current()->EndRenderPass(true);
+			auto buffer = RefMake<InstanceBuffer>();
+			buffer->descriptor_set_buffer = UniformBuffer::Create(sizeof(InstanceData) * InstanceCountMax);
+			pool.buffers.Add(buffer);
+		}
+
+		auto buffer = pool.buffers[pool.used++].get();
+		shader->UpdateRendererDescriptorSet(buffer->descriptor_set, buffer->descriptor_set_buffer, data, sizeof(InstanceData) * count, lightmap_index);
+
+		return buffer;
+	}
+
+	void Graphics::ResetInstanceBuffers()
+	{
+		for (auto& i : m_instance_buffer_pools)
+		{
+			for (auto& j : i.second)
+			{
+				j.second.used = 0;
+			}
 		}
 	}
 
@@ -260,7 +352,6 @@ namespace Viry3D
 			m_blit_render_passes.Add(render_pass);
 		}
 
-		GetDisplay()->WaitQueueIdle();
 		render_pass->Begin(Color(0, 0, 0, 1));
 
 #if VR_GLES
@@ -20,7 +20,10 @@
 #include "Display.h"
 #include "memory/Ref.h"
 #include "container/Vector.h"
+#include "container/Map.h"
 #include "math/Rect.h"
+#include "math/Matrix4x4.h"
+#include "math/Vector4.h"
 
 namespace Viry3D
 {
@@ -38,10 +41,25 @@ namespace Viry3D
 	class Mesh;
 	class RenderTexture;
 	class RenderPass;
-	struct Matrix4x4;
+	class Shader;
 	class DescriptorSet;
 	class UniformBuffer;
 
+	//
+	//	layout of one element of instance array in instancing shaders
+	//
+	struct InstanceData
+	{
+		Matrix4x4 world_matrix;
+		Vector4 lightmap_scale_offset;
+	};
+
+	struct InstanceBuffer
+	{
+		Ref<DescriptorSet> descriptor_set;
+		Ref<UniformBuffer> descriptor_set_buffer;
+	};
+
 	class Graphics
 	{
 	public:
@@ -63,13 +81,28 @@ namespace Viry3D
 		static void DrawQuad(const Rect* rect, const Ref<Texture>& texture, bool reverse_uv_y = false);
 		static void DrawQuad(const Rect* rect, const Ref<Material>& material, int pass, bool reverse_uv_y = false);
 		static void DrawMesh(const Ref<Mesh>& mesh, const Matrix4x4& matrix, const Ref<Material>& material, int pass = -1);
+		//
+		//	one draw per InstanceCountMax matrices if material shader is instancing,
+		//	otherwise one draw per matrix
+		//
+		static void DrawMeshInstanced(const Ref<Mesh>& mesh, const Vector<Matrix4x4>& matrices, const Ref<Material>& material, int pass = -1);
 		static void Blit(const Ref<RenderTexture>& src, const Ref<RenderTexture>& dest, const Ref<Material>& material = Ref<Material>(), int pass = 0, const Rect* rect = NULL);
 
 		static CullFace GetGlobalCullFace() { return m_global_cull_face; }
 		static void SetGlobalCullFace(CullFace cull_face) { m_global_cull_face = cull_face; }
 
+		//
+		//	upload count <= InstanceCountMax elements into a free buffer of this frame,
+		//	buffers are reused after ResetInstanceBuffers, call it only when gpu not using them
+		//
+		static InstanceBuffer* GetInstanceBuffer(const Ref<Shader>& shader, const InstanceData* data, int count, int lightmap_index);
+		static void ResetInstanceBuffers();
+
 	public:
+		static const int InstanceCountMax = 64;
 		static int draw_call;
+		// draw calls saved by dynamic batching
+		static int dynamic_batched_draw_call;
 
 	private:
 		static Ref<Display> m_display;
@@ -79,5 +112,18 @@ namespace Viry3D
 		static Ref<DescriptorSet> m_draw_descriptor_set;
 		static Ref<UniformBuffer> m_draw_descriptor_set_buffer;
 		static CullFace m_global_cull_face;
+
+		struct InstanceBufferPool
+		{
+			Vector<Ref<InstanceBuffer>> buffers;
+			int used;
+
+			InstanceBufferPool(): used(0) { }
+		};
+
+		static void DrawMeshPasses(const Ref<Mesh>& mesh, const Ref<Material>& material, int pass, const Ref<DescriptorSet>& descriptor_set, Ref<UniformBuffer>& descriptor_set_buffer, int instance_count);
+
+		// by shader id, lightmap index
+		static Map<int, Map<int, InstanceBufferPool>> m_instance_buffer_pools;
 	};
 }
@@ -27,66 +27,140 @@ extern "C"
 #include "png/pngstruct.h"
 }
 
+#include <setjmp.h>
+#include <atomic>
+
+// neon filters not yet checked on device, define to 1 to build them,
+// then run png filter check of AppBenchmark before turning on by default
+#ifndef VR_IMAGE_NEON_FILTERS
+#define VR_IMAGE_NEON_FILTERS 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VR_IMAGE_SSE2 1
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && VR_IMAGE_NEON_FILTERS
+#define VR_IMAGE_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace Viry3D
 {
+	static std::atomic<bool> g_png_simd_filters(true);
+
 	struct PNGData
 	{
 		char *buffer;
 		int size;
 	};
 
-	ByteBuffer Image::LoadJPEG(const ByteBuffer& jpeg, int& width, int& height, int& bpp)
+	struct PNGReader
+	{
+		const byte* data;
+		int size;
+		int pos;
+	};
+
+	struct JPEGError
+	{
+		jpeg_error_mgr mgr;
+		jmp_buf jump;
+	};
+
+	static void jpeg_error_exit(j_common_ptr cinfo)
+	{
+		longjmp(((JPEGError*) cinfo->err)->jump, 1);
+	}
+
+	static void jpeg_output_message(j_common_ptr cinfo)
+	{
+	}
+
+	//
+	//	colors NULL reads header only
+	//
+	static bool decode_jpeg(const ByteBuffer& jpeg, ByteBuffer* colors, int& width, int& height, int& bpp, int scale_denom)
 	{
-		//use lib jpeg
 		jpeg_decompress_struct cinfo;
-		jpeg_error_mgr jerr;
-		JSAMPARRAY buffer;		/* Output row buffer */
-		int row_stride;		/* physical row width in output buffer */
+		JPEGError jerr;
+
+		cinfo.err = jpeg_std_error(&jerr.mgr);
+		jerr.mgr.error_exit = jpeg_error_exit;
+		jerr.mgr.output_message = jpeg_output_message;
 
-		cinfo.err = jpeg_std_error(&jerr);
+		if (setjmp(jerr.jump))
+		{
+			jpeg_destroy_decompress(&cinfo);
+			return false;
+		}
 
 		jpeg_create_decompress(&cinfo);
 		jpeg_mem_src(&cinfo, jpeg.Bytes(), jpeg.Size());
 		jpeg_read_header(&cinfo, TRUE);
-		jpeg_start_decompress(&cinfo);
-		row_stride = cinfo.output_width * cinfo.output_components;
-		/* Make a one-row-high sample array that will go away when done with image */
-		buffer = (*cinfo.mem->alloc_sarray)
-			((j_common_ptr) &cinfo, JPOOL_IMAGE, row_stride, 1);
+
+		cinfo.scale_num = 1;
+		cinfo.scale_denom = scale_denom;
+		jpeg_calc_output_dimensions(&cinfo);
 
 		width = cinfo.output_width;
 		height = cinfo.output_height;
 		bpp = cinfo.output_components * 8;
 
-		ByteBuffer colors(width * height * cinfo.output_components);
-
-		unsigned char *pPixel = colors.Bytes();
+		if (colors == NULL)
+		{
+			jpeg_destroy_decompress(&cinfo);
+			return true;
+		}
 
-		while (cinfo.output_scanline < cinfo.output_height)
+		int row_stride = width * cinfo.output_components;
+		if (colors->Size() < row_stride * height)
 		{
-			jpeg_read_scanlines(&cinfo, buffer, 1);
+			*colors = ByteBuffer(row_stride * height);
+		}
 
-			unsigned char *pixel_data = buffer[0];
+		jpeg_start_decompress(&cinfo);
 
-			for (int j = 0; j < width; j++)
-			{
-				memcpy(pPixel, pixel_data, cinfo.output_components);
+		// scanlines written straight into output, as many per call as the decoder has ready
+		JSAMPARRAY rows = (JSAMPARRAY) (*cinfo.mem->alloc_small)((j_common_ptr) &cinfo, JPOOL_IMAGE, sizeof(JSAMPROW) * height);
+		for (int i = 0; i < height; i++)
+		{
+			rows[i] = colors->Bytes() + i * row_stride;
+		}
 
-				pPixel += cinfo.output_components;
-				pixel_data += cinfo.output_components;
-			}
+		while (cinfo.output_scanline < cinfo.output_height)
+		{
+			jpeg_read_scanlines(&cinfo, &rows[cinfo.output_scanline], cinfo.output_height - cinfo.output_scanline);
 		}
 
 		jpeg_finish_decompress(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
 
+		return true;
+	}
+
+	ByteBuffer Image::LoadJPEG(const ByteBuffer& jpeg, int& width, int& height, int& bpp, int scale_denom)
+	{
+		ByteBuffer colors;
+
+		if (!decode_jpeg(jpeg, &colors, width, height, bpp, scale_denom))
+		{
+			colors = ByteBuffer();
+		}
+
 		return colors;
 	}
 
 	static void user_png_read(png_structp png_ptr, png_bytep data, png_size_t length)
 	{
-		memcpy(data, png_ptr->io_ptr, length);
-		png_ptr->io_ptr = (char *) png_ptr->io_ptr + length;
+		PNGReader* reader = (PNGReader*) png_get_io_ptr(png_ptr);
+
+		if (reader->pos + (int) length > reader->size)
+		{
+			png_error(png_ptr, "read past end of png data");
+		}
+
+		memcpy(data, &reader->data[reader->pos], length);
+		reader->pos += (int) length;
 	}
 
 	static void user_png_write(png_structp png_ptr, png_bytep data, png_size_t length)
@@ -110,100 +184,454 @@ namespace Viry3D
 	{
 	}
 
-	ByteBuffer Image::LoadPNG(const ByteBuffer& png, int& width, int& height, int& bpp)
+#if VR_IMAGE_SSE2
+	template<int bpp>
+	static inline __m128i load_pixel(const png_byte* p)
 	{
-		ByteBuffer colors;
+		int v = 0;
+		memcpy(&v, p, bpp);
+		return _mm_cvtsi32_si128(v);
+	}
 
-		png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
-		png_infop info_ptr = png_create_info_struct(png_ptr);
-		setjmp(png_jmpbuf(png_ptr));
+	template<int bpp>
+	static inline void store_pixel(png_byte* p, __m128i v)
+	{
+		int i = _mm_cvtsi128_si32(v);
+		memcpy(p, &i, bpp);
+	}
 
-		png_set_read_fn(png_ptr, png.Bytes(), user_png_read);
-		png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_EXPAND, 0);
+	static inline __m128i mask_pixel3(__m128i v)
+	{
+		return _mm_and_si128(v, _mm_cvtsi32_si128(0xffffff));
+	}
 
-		width = png_get_image_width(png_ptr, info_ptr);
-		height = png_get_image_height(png_ptr, info_ptr);
+	static inline __m128i select(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
 
-		int color_type = png_get_color_type(png_ptr, info_ptr);
-		if (color_type == PNG_COLOR_TYPE_RGBA)
+	static inline __m128i abs16(__m128i x)
+	{
+		return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+	}
+
+	//
+	//	pixel ops take raw x and prior b, lanes past the pixel are zero in and out
+	//
+	struct PNGFilterSub
+	{
+		__m128i a;
+
+		PNGFilterSub(): a(_mm_setzero_si128()) { }
+		__m128i operator ()(__m128i x, __m128i b)
 		{
-			bpp = png_get_bit_depth(png_ptr, info_ptr) * 4;
+			a = _mm_add_epi8(x, a);
+			return a;
+		}
+	};
 
-			png_bytep* row_pointers = png_get_rows(png_ptr, info_ptr);
+	struct PNGFilterAvg
+	{
+		__m128i a;
 
-			colors = ByteBuffer(width * height * 4);
+		PNGFilterAvg(): a(_mm_setzero_si128()) { }
+		__m128i operator ()(__m128i x, __m128i b)
+		{
+			// avg_epu8 rounds up, png wants floor
+			__m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+			a = _mm_add_epi8(x, avg);
+			return a;
+		}
+	};
 
-			unsigned char *pPixel = colors.Bytes();
+	struct PNGFilterPaeth
+	{
+		__m128i a;
+		__m128i c;
 
-			for (int i = 0; i < height; i++)
-			{
-				memcpy(pPixel, row_pointers[i], width * 4);
-				pPixel += width * 4;
-			}
+		PNGFilterPaeth(): a(_mm_setzero_si128()), c(_mm_setzero_si128()) { }
+		__m128i operator ()(__m128i x, __m128i b)
+		{
+			__m128i zero = _mm_setzero_si128();
+			b = _mm_unpacklo_epi8(b, zero);
+
+			__m128i pa = _mm_sub_epi16(b, c);
+			__m128i pb = _mm_sub_epi16(a, c);
+			__m128i pc = abs16(_mm_add_epi16(pa, pb));
+			pa = abs16(pa);
+			pb = abs16(pb);
+
+			__m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+			__m128i nearest = select(_mm_cmpeq_epi16(pa, smallest), a,
+				select(_mm_cmpeq_epi16(pb, smallest), b, c));
+
+			__m128i d = _mm_add_epi8(x, _mm_packus_epi16(nearest, zero));
+			a = _mm_unpacklo_epi8(d, zero);
+			c = b;
+			return d;
 		}
-		else if (color_type == PNG_COLOR_TYPE_RGB)
+	};
+
+	//
+	//	3 byte pixels go 4 at a time from one 16 byte load,
+	//	stores never overlap the next load so store forwarding holds
+	//
+	template<int bpp, class Op>
+	static void png_filter_row(png_row_infop row_info, png_bytep row, png_const_bytep prev_row)
+	{
+		png_size_t n = row_info->rowbytes;
+		Op op;
+
+		while (bpp == 3 && n >= 16)
 		{
-			bpp = png_get_bit_depth(png_ptr, info_ptr) * 3;
+			__m128i x = _mm_loadu_si128((const __m128i*) row);
+			__m128i b = _mm_loadu_si128((const __m128i*) prev_row);
 
-			png_bytep* row_pointers = png_get_rows(png_ptr, info_ptr);
+			__m128i d0 = op(mask_pixel3(x), mask_pixel3(b));
+			__m128i d1 = op(mask_pixel3(_mm_srli_si128(x, 3)), mask_pixel3(_mm_srli_si128(b, 3)));
+			__m128i d2 = op(mask_pixel3(_mm_srli_si128(x, 6)), mask_pixel3(_mm_srli_si128(b, 6)));
+			__m128i d3 = op(mask_pixel3(_mm_srli_si128(x, 9)), mask_pixel3(_mm_srli_si128(b, 9)));
 
-			colors = ByteBuffer(width * height * 3);
+			__m128i d = _mm_or_si128(_mm_or_si128(d0, _mm_slli_si128(d1, 3)), _mm_or_si128(_mm_slli_si128(d2, 6), _mm_slli_si128(d3, 9)));
+			_mm_storel_epi64((__m128i*) row, d);
+			store_pixel<4>(row + 8, _mm_srli_si128(d, 8));
 
-			unsigned char *pPixel = colors.Bytes();
+			row += 12;
+			prev_row += 12;
+			n -= 12;
+		}
 
-			for (int i = 0; i < height; i++)
-			{
-				memcpy(pPixel, row_pointers[i], width * 3);
-				pPixel += width * 3;
-			}
+		while (n >= bpp)
+		{
+			store_pixel<bpp>(row, op(load_pixel<bpp>(row), load_pixel<bpp>(prev_row)));
+			row += bpp;
+			prev_row += bpp;
+			n -= bpp;
 		}
-		else if (color_type == PNG_COLOR_TYPE_GRAY)
+	}
+
+	static void png_filter_up(png_row_infop row_info, png_bytep row, png_const_bytep prev_row)
+	{
+		png_size_t n = row_info->rowbytes;
+
+		while (n >= 16)
 		{
-			bpp = png_get_bit_depth(png_ptr, info_ptr) * 1;
+			__m128i a = _mm_loadu_si128((const __m128i*) row);
+			__m128i b = _mm_loadu_si128((const __m128i*) prev_row);
+			_mm_storeu_si128((__m128i*) row, _mm_add_epi8(a, b));
+			row += 16;
+			prev_row += 16;
+			n -= 16;
+		}
+
+		while (n > 0)
+		{
+			*row = (png_byte) (*row + *prev_row);
+			row++;
+			prev_row++;
+			n--;
+		}
+	}
+
+	static void png_filter_sub4(png_row_infop row_info, png_bytep row, png_const_bytep prev_row)
+	{
+		png_size_t n = row_info->rowbytes;
+		__m128i a = _mm_setzero_si128();
 
-			png_bytep* row_pointers = png_get_rows(png_ptr, info_ptr);
+		// prefix sum of 4 pixels, last pixel carried to next 4
+		while (n >= 16)
+		{
+			__m128i d = _mm_loadu_si128((const __m128i*) row);
+			d = _mm_add_epi8(d, _mm_slli_si128(d, 4));
+			d = _mm_add_epi8(d, _mm_slli_si128(d, 8));
+			d = _mm_add_epi8(d, a);
+			_mm_storeu_si128((__m128i*) row, d);
+			a = _mm_shuffle_epi32(d, 0xff);
+			row += 16;
+			n -= 16;
+		}
 
-			colors = ByteBuffer(width * height);
+		while (n >= 4)
+		{
+			a = _mm_add_epi8(load_pixel<4>(row), a);
+			store_pixel<4>(row, a);
+			row += 4;
+			n -= 4;
+		}
+	}
+#elif VR_IMAGE_NEON
+	template<int bpp>
+	static inline uint8x8_t load_pixel(const png_byte* p)
+	{
+		uint32_t v = 0;
+		memcpy(&v, p, bpp);
+		return vreinterpret_u8_u32(vdup_n_u32(v));
+	}
 
-			unsigned char *pPixel = colors.Bytes();
+	template<int bpp>
+	static inline void store_pixel(png_byte* p, uint8x8_t v)
+	{
+		uint32_t i = vget_lane_u32(vreinterpret_u32_u8(v), 0);
+		memcpy(p, &i, bpp);
+	}
 
-			for (int i = 0; i < height; i++)
-			{
-				memcpy(pPixel, row_pointers[i], width * 1);
-				pPixel += width * 1;
-			}
+	//
+	//	pixel ops take raw x and prior b, lanes past the pixel are zero in and out
+	//
+	struct PNGFilterSub
+	{
+		uint8x8_t a;
+
+		PNGFilterSub(): a(vdup_n_u8(0)) { }
+		uint8x8_t operator ()(uint8x8_t x, uint8x8_t b)
+		{
+			a = vadd_u8(x, a);
+			return a;
+		}
+	};
+
+	struct PNGFilterAvg
+	{
+		uint8x8_t a;
+
+		PNGFilterAvg(): a(vdup_n_u8(0)) { }
+		uint8x8_t operator ()(uint8x8_t x, uint8x8_t b)
+		{
+			// halving add truncates, as png wants
+			a = vadd_u8(x, vhadd_u8(a, b));
+			return a;
+		}
+	};
+
+	struct PNGFilterPaeth
+	{
+		uint8x8_t a;
+		uint8x8_t c;
+
+		PNGFilterPaeth(): a(vdup_n_u8(0)), c(vdup_n_u8(0)) { }
+		uint8x8_t operator ()(uint8x8_t x, uint8x8_t b)
+		{
+			uint16x8_t pa = vabdl_u8(b, c);
+			uint16x8_t pb = vabdl_u8(a, c);
+			uint16x8_t pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c));
+
+			uint8x8_t use_a = vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+			uint8x8_t use_b = vmovn_u16(vcleq_u16(pb, pc));
+			uint8x8_t nearest = vbsl_u8(use_a, a, vbsl_u8(use_b, b, c));
+
+			a = vadd_u8(x, nearest);
+			c = b;
+			return a;
+		}
+	};
+
+	template<int bpp, class Op>
+	static void png_filter_row(png_row_infop row_info, png_bytep row, png_const_bytep prev_row)
+	{
+		png_size_t n = row_info->rowbytes;
+		Op op;
+
+		while (n >= bpp)
+		{
+			store_pixel<bpp>(row, op(load_pixel<bpp>(row), load_pixel<bpp>(prev_row)));
+			row += bpp;
+			prev_row += bpp;
+			n -= bpp;
+		}
+	}
+
+	static void png_filter_up(png_row_infop row_info, png_bytep row, png_const_bytep prev_row)
+	{
+		png_size_t n = row_info->rowbytes;
+
+		while (n >= 16)
+		{
+			vst1q_u8(row, vaddq_u8(vld1q_u8(row), vld1q_u8(prev_row)));
+			row += 16;
+			prev_row += 16;
+			n -= 16;
+		}
+
+		while (n > 0)
+		{
+			*row = (png_byte) (*row + *prev_row);
+			row++;
+			prev_row++;
+			n--;
+		}
+	}
+
+	static void png_filter_sub4(png_row_infop row_info, png_bytep row, png_const_bytep prev_row)
+	{
+		png_filter_row<4, PNGFilterSub>(row_info, row, prev_row);
+	}
+#endif
+
+	//
+	//	libpng 1.5 has no simd filters of its own,
+	//	set ours for 3 and 4 byte pixels before first row, libpng keeps them
+	//
+	static void set_png_filters(png_structp png_ptr)
+	{
+#if VR_IMAGE_SSE2 || VR_IMAGE_NEON
+		if (!g_png_simd_filters)
+		{
+			return;
+		}
+
+		int bpp = (png_ptr->pixel_depth + 7) >> 3;
+
+		if (bpp == 3)
+		{
+			png_ptr->read_filter[PNG_FILTER_VALUE_SUB - 1] = png_filter_row<3, PNGFilterSub>;
+			png_ptr->read_filter[PNG_FILTER_VALUE_UP - 1] = png_filter_up;
+			png_ptr->read_filter[PNG_FILTER_VALUE_AVG - 1] = png_filter_row<3, PNGFilterAvg>;
+			png_ptr->read_filter[PNG_FILTER_VALUE_PAETH - 1] = png_filter_row<3, PNGFilterPaeth>;
+		}
+		else if (bpp == 4)
+		{
+			png_ptr->read_filter[PNG_FILTER_VALUE_SUB - 1] = png_filter_sub4;
+			png_ptr->read_filter[PNG_FILTER_VALUE_UP - 1] = png_filter_up;
+			png_ptr->read_filter[PNG_FILTER_VALUE_AVG - 1] = png_filter_row<4, PNGFilterAvg>;
+			png_ptr->read_filter[PNG_FILTER_VALUE_PAETH - 1] = png_filter_row<4, PNGFilterPaeth>;
+		}
+#endif
+	}
+
+	//
+	//	colors NULL reads header only,
+	//	output is 8 bit gray, rgb or rgba, gray with alpha expands to rgba
+	//
+	static bool decode_png(const ByteBuffer& png, ByteBuffer* colors, int& width, int& height, int& bpp)
+	{
+		png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+		if (png_ptr == NULL)
+		{
+			return false;
+		}
+
+		png_infop info_ptr = png_create_info_struct(png_ptr);
+		PNGReader reader = { png.Bytes(), png.Size(), 0 };
+
+		if (setjmp(png_jmpbuf(png_ptr)))
+		{
+			png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+			return false;
 		}
-		else if (color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+
+		png_set_read_fn(png_ptr, &reader, user_png_read);
+		png_read_info(png_ptr, info_ptr);
+
+		int color_type = png_get_color_type(png_ptr, info_ptr);
+		png_set_expand(png_ptr);
+		png_set_strip_16(png_ptr);
+		if (color_type == PNG_COLOR_TYPE_GRAY_ALPHA ||
+			(color_type == PNG_COLOR_TYPE_GRAY && png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)))
 		{
-			bpp = png_get_bit_depth(png_ptr, info_ptr) * 4;
+			png_set_gray_to_rgb(png_ptr);
+		}
+		int pass_count = png_set_interlace_handling(png_ptr);
+		png_read_update_info(png_ptr, info_ptr);
 
-			png_bytep* row_pointers = png_get_rows(png_ptr, info_ptr);
+		width = png_get_image_width(png_ptr, info_ptr);
+		height = png_get_image_height(png_ptr, info_ptr);
+		bpp = png_get_channels(png_ptr, info_ptr) * 8;
 
-			colors = ByteBuffer(width * height * 4);
+		if (colors == NULL)
+		{
+			png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+			return true;
+		}
 
-			byte* pPixel = colors.Bytes();
+		int row_stride = (int) png_get_rowbytes(png_ptr, info_ptr);
+		if (colors->Size() < row_stride * height)
+		{
+			*colors = ByteBuffer(row_stride * height);
+		}
 
-			for (int i = 0; i < height; i++)
+		set_png_filters(png_ptr);
+
+		// rows straight into output, no intermediate row buffers
+		for (int i = 0; i < pass_count; i++)
+		{
+			for (int j = 0; j < height; j++)
 			{
-				for (int j = 0; j < width; j++)
-				{
-					png_byte g = row_pointers[i][j * 2];
-					png_byte a = row_pointers[i][j * 2 + 1];
-					pPixel[0] = g;
-					pPixel[1] = g;
-					pPixel[2] = g;
-					pPixel[3] = a;
-
-					pPixel += 4;
-				}
+				png_read_row(png_ptr, colors->Bytes() + j * row_stride, NULL);
 			}
 		}
 
+		png_read_end(png_ptr, NULL);
 		png_destroy_read_struct(&png_ptr, &info_ptr, 0);
 
+		return true;
+	}
+
+	ByteBuffer Image::LoadPNG(const ByteBuffer& png, int& width, int& height, int& bpp)
+	{
+		ByteBuffer colors;
+
+		if (!decode_png(png, &colors, width, height, bpp))
+		{
+			colors = ByteBuffer();
+		}
+
 		return colors;
 	}
 
+	static bool is_jpeg(const ByteBuffer& file)
+	{
+		const byte JPG_HEAD[] = { 0xff, 0xd8, 0xff };
+		return file.Size() >= 3 && Memory::Compare(file.Bytes(), JPG_HEAD, 3) == 0;
+	}
+
+	static bool is_png(const ByteBuffer& file)
+	{
+		const byte PNG_HEAD[] = { 0x89, 0x50, 0x4e, 0x47 };
+		return file.Size() >= 4 && Memory::Compare(file.Bytes(), PNG_HEAD, 4) == 0;
+	}
+
+	bool Image::ReadInfo(const ByteBuffer& file, int& width, int& height, int& bpp, int scale_denom)
+	{
+		if (is_jpeg(file))
+		{
+			return decode_jpeg(file, NULL, width, height, bpp, scale_denom);
+		}
+		else if (is_png(file))
+		{
+			return decode_png(file, NULL, width, height, bpp);
+		}
+
+		return false;
+	}
+
+	bool Image::Decode(const ByteBuffer& file, ByteBuffer& colors, int& width, int& height, int& bpp, int scale_denom)
+	{
+		if (is_jpeg(file))
+		{
+			return decode_jpeg(file, &colors, width, height, bpp, scale_denom);
+		}
+		else if (is_png(file))
+		{
+			return decode_png(file, &colors, width, height, bpp);
+		}
+
+		return false;
+	}
+
+	bool Image::HasPNGSimdFilters()
+	{
+#if VR_IMAGE_SSE2 || VR_IMAGE_NEON
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void Image::SetPNGSimdFilters(bool enable)
+	{
+		g_png_simd_filters = enable;
+	}
+
 	void Image::EncodeToPNG(Texture2D *tex, int bpp, const String& file)
 	{
 		int color_type = -1;
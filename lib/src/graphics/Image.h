@@ -26,8 +26,25 @@ namespace Viry3D
 	class Image
 	{
 	public:
-		static ByteBuffer LoadJPEG(const ByteBuffer& jpeg, int& width, int& height, int& bpp);
+		//
+		//	scale_denom 1 2 4 8, jpg decoded with dct scaling to 1 / scale_denom size
+		//
+		static ByteBuffer LoadJPEG(const ByteBuffer& jpeg, int& width, int& height, int& bpp, int scale_denom = 1);
 		static ByteBuffer LoadPNG(const ByteBuffer& png, int& width, int& height, int& bpp);
+		//
+		//	output size from header only, no pixel decode
+		//
+		static bool ReadInfo(const ByteBuffer& file, int& width, int& height, int& bpp, int scale_denom = 1);
+		//
+		//	png or jpg, decoded into colors if it is large enough, otherwise colors reallocated
+		//
+		static bool Decode(const ByteBuffer& file, ByteBuffer& colors, int& width, int& height, int& bpp, int scale_denom = 1);
+		//
+		//	simd png unfilter compiled in for this target, used by default,
+		//	turned off decodes with libpng filters, so both outputs can be compared
+		//
+		static bool HasPNGSimdFilters();
+		static void SetPNGSimdFilters(bool enable);
 		static void EncodeToPNG(Texture2D *tex, int bpp, const String& file);
 	};
 }
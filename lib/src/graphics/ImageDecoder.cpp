@@ -0,0 +1,140 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ImageDecoder.h"
+#include "Image.h"
+#include "thread/Thread.h"
+#include "math/Mathf.h"
+#include <algorithm>
+#include <atomic>
+
+namespace Viry3D
+{
+	Ref<ThreadPool> ImageDecoder::m_thread_pool;
+
+	struct DecodeBatch
+	{
+		Vector<ImageDecoder::Request>* requests;
+		Vector<int> order;
+		std::atomic<int> next;
+		int done;
+		Mutex mutex;
+		std::condition_variable condition;
+	};
+
+	static void decode_batch(DecodeBatch* batch)
+	{
+		while (true)
+		{
+			int i = batch->next.fetch_add(1);
+			if (i >= batch->order.Size())
+			{
+				break;
+			}
+
+			auto& r = (*batch->requests)[batch->order[i]];
+			r.ok = Image::Decode(r.file, r.colors, r.width, r.height, r.bpp, r.scale_denom);
+
+			std::lock_guard<Mutex> lock(batch->mutex);
+			batch->done++;
+			if (batch->done == batch->order.Size())
+			{
+				batch->condition.notify_all();
+			}
+		}
+	}
+
+	void ImageDecoder::Init(int thread_count)
+	{
+		if (thread_count < 0)
+		{
+			thread_count = Mathf::Max((int) std::thread::hardware_concurrency() - 1, 1);
+		}
+
+		if (thread_count > 0)
+		{
+			m_thread_pool = RefMake<ThreadPool>(thread_count);
+		}
+	}
+
+	void ImageDecoder::Deinit()
+	{
+		if (m_thread_pool)
+		{
+			m_thread_pool->Wait();
+			m_thread_pool.reset();
+		}
+	}
+
+	int ImageDecoder::GetThreadCount()
+	{
+		return m_thread_pool ? m_thread_pool->GetThreadCount() : 0;
+	}
+
+	void ImageDecoder::DecodeAll(Vector<Request>& requests)
+	{
+		auto batch = RefMake<DecodeBatch>();
+		batch->requests = &requests;
+		batch->next = 0;
+		batch->done = 0;
+
+		for (int i = 0; i < requests.Size(); i++)
+		{
+			auto& r = requests[i];
+			r.ok = Image::ReadInfo(r.file, r.width, r.height, r.bpp, r.scale_denom);
+
+			if (r.ok)
+			{
+				int size = r.width * r.height * r.bpp / 8;
+				if (r.colors.Size() < size)
+				{
+					r.colors = ByteBuffer(size);
+				}
+
+				batch->order.Add(i);
+			}
+		}
+
+		if (batch->order.Empty())
+		{
+			return;
+		}
+
+		std::sort(batch->order.begin(), batch->order.end(), [&](int a, int b) {
+			return requests[a].colors.Size() > requests[b].colors.Size();
+		});
+
+		// late workers find nothing left and only touch the batch they keep alive
+		int worker_count = Mathf::Min(GetThreadCount(), batch->order.Size() - 1);
+		for (int i = 0; i < worker_count; i++)
+		{
+			m_thread_pool->AddTask({
+				[=]() {
+					decode_batch(batch.get());
+					return Ref<Any>();
+				}
+			});
+		}
+
+		decode_batch(batch.get());
+
+		std::unique_lock<Mutex> lock(batch->mutex);
+		batch->condition.wait(lock, [&]() {
+			return batch->done == batch->order.Size();
+		});
+	}
+}
@@ -0,0 +1,64 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "memory/ByteBuffer.h"
+#include "memory/Ref.h"
+#include "container/Vector.h"
+
+namespace Viry3D
+{
+	class ThreadPool;
+
+	//
+	//	batch png / jpeg decode on its own threads,
+	//	kept apart from resource threads so a texture batch never queues behind mesh parsing
+	//
+	class ImageDecoder
+	{
+	public:
+		struct Request
+		{
+			ByteBuffer file;
+			int scale_denom;
+			ByteBuffer colors;
+			int width;
+			int height;
+			int bpp;
+			bool ok;
+
+			Request(): scale_denom(1), width(0), height(0), bpp(0), ok(false) { }
+		};
+
+		//
+		//	thread_count -1 means one less than hardware threads, at least one
+		//
+		static void Init(int thread_count = -1);
+		static void Deinit();
+		static int GetThreadCount();
+		//
+		//	decode all on decode threads and caller thread, return when all done,
+		//	outputs allocated from headers before decode starts, largest images first,
+		//	colors already big enough are reused
+		//
+		static void DecodeAll(Vector<Request>& requests);
+
+	private:
+		static Ref<ThreadPool> m_thread_pool;
+	};
+}
@@ -0,0 +1,300 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "KTX2.h"
+#include "TextureTranscoder.h"
+#include "memory/Memory.h"
+#include "math/Mathf.h"
+
+namespace Viry3D
+{
+	static const byte KTX2_IDENTIFIER[12] = { 0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a };
+
+	struct KTX2Header
+	{
+		byte identifier[12];
+		unsigned int vk_format;
+		unsigned int type_size;
+		unsigned int pixel_width;
+		unsigned int pixel_height;
+		unsigned int pixel_depth;
+		unsigned int layer_count;
+		unsigned int face_count;
+		unsigned int level_count;
+		unsigned int supercompression_scheme;
+		unsigned int dfd_byte_offset;
+		unsigned int dfd_byte_length;
+		unsigned int kvd_byte_offset;
+		unsigned int kvd_byte_length;
+		unsigned long long sgd_byte_offset;
+		unsigned long long sgd_byte_length;
+	};
+
+	struct KTX2Level
+	{
+		unsigned long long byte_offset;
+		unsigned long long byte_length;
+		unsigned long long uncompressed_byte_length;
+	};
+
+	static_assert(sizeof(KTX2Header) == 80, "ktx2 header size");
+	static_assert(sizeof(KTX2Level) == 24, "ktx2 level size");
+
+	//	khr_df_model, khr_df_channel
+	enum
+	{
+		DF_MODEL_RGBSDA = 1,
+		DF_MODEL_BC7 = 134,
+		DF_MODEL_ETC2 = 161,
+		DF_MODEL_ASTC = 162,
+
+		DF_CHANNEL_RGBSDA_R = 0,
+		DF_CHANNEL_RGBSDA_G = 1,
+		DF_CHANNEL_RGBSDA_B = 2,
+		DF_CHANNEL_RGBSDA_A = 15,
+		DF_CHANNEL_ETC2_COLOR = 2,
+		DF_CHANNEL_ETC2_ALPHA = 15,
+		DF_CHANNEL_BC7_COLOR = 0,
+		DF_CHANNEL_ASTC_DATA = 0,
+	};
+
+	unsigned int KTX2::GetVkFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::R8:
+				return 9;		//	VK_FORMAT_R8_UNORM
+			case TextureFormat::RGB24:
+				return 23;		//	VK_FORMAT_R8G8B8_UNORM
+			case TextureFormat::RGBA32:
+				return 37;		//	VK_FORMAT_R8G8B8A8_UNORM
+			case TextureFormat::BC7:
+				return 145;		//	VK_FORMAT_BC7_UNORM_BLOCK
+			case TextureFormat::ETC2_RGB8:
+				return 147;		//	VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+			case TextureFormat::ETC2_RGBA8:
+				return 151;		//	VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+			case TextureFormat::ASTC_4x4:
+				return 157;		//	VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+			default:
+				return 0;
+		}
+	}
+
+	bool KTX2::GetTextureFormat(unsigned int vk_format, TextureFormat& format)
+	{
+		switch (vk_format)
+		{
+			case 9:
+				format = TextureFormat::R8;
+				return true;
+			case 23:
+				format = TextureFormat::RGB24;
+				return true;
+			case 37:
+				format = TextureFormat::RGBA32;
+				return true;
+			case 145:
+				format = TextureFormat::BC7;
+				return true;
+			case 147:
+				format = TextureFormat::ETC2_RGB8;
+				return true;
+			case 151:
+				format = TextureFormat::ETC2_RGBA8;
+				return true;
+			case 157:
+				format = TextureFormat::ASTC_4x4;
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	bool KTX2::IsKTX2(const ByteBuffer& buffer)
+	{
+		return buffer.Size() >= (int) sizeof(KTX2Header) && Memory::Compare(buffer.Bytes(), (void*) KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+	}
+
+	bool KTX2::Load(const ByteBuffer& buffer, Image& image)
+	{
+		if (!IsKTX2(buffer))
+		{
+			return false;
+		}
+
+		KTX2Header header;
+		Memory::Copy(&header, buffer.Bytes(), sizeof(header));
+
+		if (header.supercompression_scheme != 0 ||
+			header.pixel_depth > 1 ||
+			header.layer_count > 1 ||
+			header.face_count != 1 ||
+			header.pixel_width == 0 ||
+			header.pixel_height == 0)
+		{
+			return false;
+		}
+
+		if (!GetTextureFormat(header.vk_format, image.format))
+		{
+			return false;
+		}
+
+		int level_count = Mathf::Max((int) header.level_count, 1);
+		unsigned long long size = (unsigned long long) buffer.Size();
+		if (sizeof(KTX2Header) + sizeof(KTX2Level) * level_count > size)
+		{
+			return false;
+		}
+
+		image.width = (int) header.pixel_width;
+		image.height = (int) header.pixel_height;
+		image.levels.Clear();
+
+		Ref<ByteBuffer> owner = RefMake<ByteBuffer>(buffer);
+
+		for (int i = 0; i < level_count; i++)
+		{
+			KTX2Level level;
+			Memory::Copy(&level, &buffer.Bytes()[sizeof(KTX2Header) + sizeof(KTX2Level) * i], sizeof(level));
+
+			int w = Mathf::Max(image.width >> i, 1);
+			int h = Mathf::Max(image.height >> i, 1);
+			unsigned long long level_size = (unsigned long long) TextureTranscoder::GetLevelSize(image.format, w, h);
+
+			if (level.byte_length < level_size || level.byte_offset + level_size > size)
+			{
+				image.levels.Clear();
+				return false;
+			}
+
+			image.levels.Add(ByteBuffer(&buffer.Bytes()[level.byte_offset], (int) level_size, owner));
+		}
+
+		return true;
+	}
+
+	ByteBuffer KTX2::Save(const Image& image)
+	{
+		bool compressed = TextureTranscoder::IsCompressed(image.format);
+		int block_size = TextureTranscoder::GetBlockSize(image.format);
+		int level_count = image.levels.Size();
+
+		//	basic data format descriptor
+		Vector<unsigned int> samples;
+		int color_model;
+		if (image.format == TextureFormat::ETC2_RGB8)
+		{
+			color_model = DF_MODEL_ETC2;
+			samples.Add(0 | (63 << 16) | (DF_CHANNEL_ETC2_COLOR << 24));
+		}
+		else if (image.format == TextureFormat::ETC2_RGBA8)
+		{
+			color_model = DF_MODEL_ETC2;
+			samples.Add(0 | (63 << 16) | (DF_CHANNEL_ETC2_ALPHA << 24));
+			samples.Add(64 | (63 << 16) | (DF_CHANNEL_ETC2_COLOR << 24));
+		}
+		else if (image.format == TextureFormat::BC7)
+		{
+			color_model = DF_MODEL_BC7;
+			samples.Add(0 | (127 << 16) | (DF_CHANNEL_BC7_COLOR << 24));
+		}
+		else if (image.format == TextureFormat::ASTC_4x4)
+		{
+			color_model = DF_MODEL_ASTC;
+			samples.Add(0 | (127 << 16) | (DF_CHANNEL_ASTC_DATA << 24));
+		}
+		else
+		{
+			const int channels[4] = { DF_CHANNEL_RGBSDA_R, DF_CHANNEL_RGBSDA_G, DF_CHANNEL_RGBSDA_B, DF_CHANNEL_RGBSDA_A };
+			color_model = DF_MODEL_RGBSDA;
+			for (int i = 0; i < block_size; i++)
+			{
+				samples.Add((i * 8) | (7 << 16) | (channels[i] << 24));
+			}
+		}
+
+		Vector<unsigned int> dfd;
+		dfd.Add(0);
+		dfd.Add(0);
+		dfd.Add(2 | ((24 + 16 * samples.Size()) << 16));
+		dfd.Add(color_model | (1 << 8) | (1 << 16));
+		dfd.Add(compressed ? (3 | (3 << 8)) : 0);
+		dfd.Add(block_size);
+		dfd.Add(0);
+		for (int i = 0; i < samples.Size(); i++)
+		{
+			dfd.Add(samples[i]);
+			dfd.Add(0);
+			dfd.Add(0);
+			dfd.Add(compressed ? 0xffffffff : 255);
+		}
+		dfd[0] = dfd.Size() * 4;
+
+		const char kv[] = "KTXwriter\0Viry3D";
+		int kv_length = (int) sizeof(kv);
+		int kvd_length = (4 + kv_length + 3) & ~3;
+
+		int level_alignment = compressed ? block_size : (block_size == 4 ? 4 : block_size * 4);
+		int dfd_offset = (int) (sizeof(KTX2Header) + sizeof(KTX2Level) * level_count);
+		int kvd_offset = dfd_offset + dfd.Size() * 4;
+		int data_offset = kvd_offset + kvd_length;
+
+		Vector<KTX2Level> levels(level_count);
+		int offset = data_offset;
+		for (int i = level_count - 1; i >= 0; i--)
+		{
+			offset = (offset + level_alignment - 1) / level_alignment * level_alignment;
+			levels[i].byte_offset = offset;
+			levels[i].byte_length = image.levels[i].Size();
+			levels[i].uncompressed_byte_length = image.levels[i].Size();
+			offset += image.levels[i].Size();
+		}
+
+		ByteBuffer buffer(offset);
+		Memory::Zero(buffer.Bytes(), buffer.Size());
+
+		KTX2Header header;
+		Memory::Zero(&header, sizeof(header));
+		Memory::Copy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+		header.vk_format = GetVkFormat(image.format);
+		header.type_size = 1;
+		header.pixel_width = image.width;
+		header.pixel_height = image.height;
+		header.face_count = 1;
+		header.level_count = level_count;
+		header.dfd_byte_offset = dfd_offset;
+		header.dfd_byte_length = dfd.Size() * 4;
+		header.kvd_byte_offset = kvd_offset;
+		header.kvd_byte_length = kvd_length;
+
+		Memory::Copy(buffer.Bytes(), &header, sizeof(header));
+		Memory::Copy(&buffer[sizeof(KTX2Header)], levels.Bytes(), sizeof(KTX2Level) * level_count);
+		Memory::Copy(&buffer[dfd_offset], dfd.Bytes(), dfd.Size() * 4);
+		Memory::Copy(&buffer[kvd_offset], &kv_length, 4);
+		Memory::Copy(&buffer[kvd_offset + 4], kv, kv_length);
+
+		for (int i = 0; i < level_count; i++)
+		{
+			Memory::Copy(&buffer[(int) levels[i].byte_offset], image.levels[i].Bytes(), image.levels[i].Size());
+		}
+
+		return buffer;
+	}
+}
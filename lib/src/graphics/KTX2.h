@@ -0,0 +1,51 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include "TextureFormat.h"
+#include "memory/ByteBuffer.h"
+#include "container/Vector.h"
+
+namespace Viry3D
+{
+	//
+	//	khronos ktx2 container, 2d textures with mip levels, no supercompression,
+	//	loaded levels point into source buffer, no copy
+	//
+	class KTX2
+	{
+	public:
+		struct Image
+		{
+			int width;
+			int height;
+			TextureFormat format;
+			//
+			//	level 0 is the largest
+			//
+			Vector<ByteBuffer> levels;
+		};
+
+		static bool IsKTX2(const ByteBuffer& buffer);
+		static bool Load(const ByteBuffer& buffer, Image& image);
+		static ByteBuffer Save(const Image& image);
+		static unsigned int GetVkFormat(TextureFormat format);
+		static bool GetTextureFormat(unsigned int vk_format, TextureFormat& format);
+	};
+}
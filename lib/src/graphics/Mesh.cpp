@@ -23,7 +23,9 @@ namespace Viry3D
 {
 	Mesh::Mesh():
 		m_dynamic(false),
-		m_blend_shape_dirty(false)
+		m_index_type(IndexType::UnsignedShort),
+		m_blend_shape_dirty(false),
+		m_bounds(Vector3::Zero(), Vector3::Zero())
 	{
 		SetName("Mesh");
 	}
@@ -139,10 +141,29 @@ namespace Viry3D
 
 	void Mesh::Apply()
 	{
+		this->RecalculateBounds();
 		this->UpdateVertexBuffer();
 		this->UpdateIndexBuffer();
 	}
 
+	void Mesh::RecalculateBounds()
+	{
+		if (vertices.Empty())
+		{
+			m_bounds = Bounds(Vector3::Zero(), Vector3::Zero());
+			return;
+		}
+
+		Vector3 min = vertices[0];
+		Vector3 max = vertices[0];
+		for (int i = 1; i < vertices.Size(); i++)
+		{
+			min = Vector3::Min(min, vertices[i]);
+			max = Vector3::Max(max, vertices[i]);
+		}
+		m_bounds = Bounds(min, max);
+	}
+
 	void Mesh::UpdateVertexBuffer()
 	{
 		int buffer_size = this->VertexBufferSize();
@@ -157,6 +178,8 @@ namespace Viry3D
 
 	void Mesh::UpdateIndexBuffer()
 	{
+		m_index_type = vertices.Size() > 65536 ? IndexType::UnsignedInt : IndexType::UnsignedShort;
+
 		int buffer_size = this->IndexBufferSize();
 		bool dynamic = this->IsDynamic();
 
@@ -174,7 +197,14 @@ namespace Viry3D
 
 	int Mesh::IndexBufferSize() const
 	{
-		return triangles.Size() * sizeof(unsigned short);
+		if (m_index_type == IndexType::UnsignedShort)
+		{
+			return triangles.Size() * sizeof(unsigned short);
+		}
+		else
+		{
+			return triangles.Size() * sizeof(unsigned int);
+		}
 	}
 
 	void Mesh::FillVertexBuffer(void* param, const ByteBuffer& buffer)
@@ -280,7 +310,20 @@ namespace Viry3D
 	void Mesh::FillIndexBuffer(void* param, const ByteBuffer& buffer)
 	{
 		auto mesh = (Mesh*) param;
-		Memory::Copy(buffer.Bytes(), (void*) &mesh->triangles[0], mesh->IndexBufferSize());
+
+		if (mesh->m_index_type == IndexType::UnsignedShort)
+		{
+			auto indices = (unsigned short*) buffer.Bytes();
+			int count = mesh->triangles.Size();
+			for (int i = 0; i < count; i++)
+			{
+				indices[i] = (unsigned short) mesh->triangles[i];
+			}
+		}
+		else
+		{
+			Memory::Copy(buffer.Bytes(), (void*) &mesh->triangles[0], mesh->IndexBufferSize());
+		}
 	}
 
 	void Mesh::GetIndexRange(int submesh_index, int& start, int& count)
@@ -25,6 +25,7 @@
 #include "math/Vector3.h"
 #include "math/Vector4.h"
 #include "math/Matrix4x4.h"
+#include "math/Bounds.h"
 
 namespace Viry3D
 {
@@ -38,6 +39,7 @@ namespace Viry3D
 		void Apply();
 		const Ref<VertexBuffer>& GetVertexBuffer() const { return m_vertex_buffer; }
 		const Ref<IndexBuffer>& GetIndexBuffer() const { return m_index_buffer; }
+		IndexType GetIndexType() const { return m_index_type; }
 		void GetIndexRange(int submesh_index, int& start, int& count);
 		int GetSubmeshCount() const;
 		void SetDynamic(bool dynamic);
@@ -47,6 +49,11 @@ namespace Viry3D
 		float GetBlendShapeWeight(int index) const;
 		void SetBlendShapeWeight(int index, float weight);
 		void UpdateBlendShapes();
+		//
+		//	local bounds of vertices, updated by Apply
+		//
+		const Bounds& GetBounds() const { return m_bounds; }
+		void RecalculateBounds();
 
 		Vector<Vector3> vertices;
 		Vector<Vector2> uv;				//Texture
@@ -63,6 +70,17 @@ namespace Viry3D
 			int count;
 		};
 
+		//
+		//	meshlet of a cooked mesh, index range inside one submesh with its bounds
+		//
+		struct Chunk
+		{
+			int start;
+			int count;
+			Vector3 min;
+			Vector3 max;
+		};
+
 		struct BlendShapeVertexDelta
 		{
 			Vector3 vertex;
@@ -88,8 +106,12 @@ namespace Viry3D
 			}
 		};
 
-		Vector<unsigned short> triangles;
+		//
+		//	32 bit on cpu, index buffer stays 16 bit while vertex count fits
+		//
+		Vector<unsigned int> triangles;
 		Vector<Submesh> submeshes;
+		Vector<Chunk> chunks;
 		Vector<Matrix4x4> bind_poses;
 		Vector<BlendShape> blend_shapes;
 		Vector<BlendShapeVertexDelta> blend_shapes_deltas;
@@ -107,6 +129,8 @@ namespace Viry3D
 		bool m_dynamic;
 		Ref<VertexBuffer> m_vertex_buffer;
 		Ref<IndexBuffer> m_index_buffer;
+		IndexType m_index_type;
 		bool m_blend_shape_dirty;
+		Bounds m_bounds;
 	};
 }
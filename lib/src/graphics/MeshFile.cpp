@@ -0,0 +1,959 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "MeshFile.h"
+#include "io/MemoryStream.h"
+#include "container/Map.h"
+#include "math/Mathf.h"
+#include <math.h>
+#include <array>
+#include <set>
+
+namespace Viry3D
+{
+	static const byte MESH_FILE_MAGIC[] = { 'V', 'M', 'S', 'H' };
+
+	enum
+	{
+		MESH_FILE_UV = 1 << 0,
+		MESH_FILE_COLOR = 1 << 1,
+		MESH_FILE_UV2 = 1 << 2,
+		MESH_FILE_NORMAL = 1 << 3,
+		MESH_FILE_TANGENT = 1 << 4,
+		MESH_FILE_SKIN = 1 << 5,
+		MESH_FILE_INDEX32 = 1 << 6,
+	};
+
+	struct MeshFileHeader
+	{
+		String name;
+		int flags;
+		int vertex_count;
+		int index_count;
+		int coarse_vertex_count;
+		int coarse_index_count;
+		Vector3 min;
+		Vector3 max;
+		Vector<Mesh::Submesh> submeshes;
+		Vector<Mesh::Submesh> coarse_submeshes;
+		Vector<Mesh::Chunk> chunks;
+		Vector<Matrix4x4> bind_poses;
+	};
+
+	static unsigned short float_to_half(float f)
+	{
+		unsigned int x;
+		Memory::Copy(&x, &f, 4);
+
+		unsigned int sign = (x >> 16) & 0x8000;
+		int exp = (int) ((x >> 23) & 0xff) - 127 + 15;
+		unsigned int mantissa = x & 0x7fffff;
+
+		if (exp >= 31)
+		{
+			// overflow to inf, nan stays nan
+			return (unsigned short) (sign | 0x7c00 | ((x & 0x7fffffff) > 0x7f800000 ? 0x200 : 0));
+		}
+		if (exp <= 0)
+		{
+			if (exp < -10)
+			{
+				return (unsigned short) sign;
+			}
+
+			// subnormal, round to nearest
+			mantissa |= 0x800000;
+			int shift = 14 - exp;
+			unsigned int half = mantissa >> shift;
+			if ((mantissa >> (shift - 1)) & 1)
+			{
+				half++;
+			}
+			return (unsigned short) (sign | half);
+		}
+
+		// round to nearest, carry may move into exponent which is still right
+		unsigned int half = sign | (exp << 10) | (mantissa >> 13);
+		if (mantissa & 0x1000)
+		{
+			half++;
+		}
+		return (unsigned short) half;
+	}
+
+	static float half_to_float(unsigned short h)
+	{
+		unsigned int sign = (unsigned int) (h & 0x8000) << 16;
+		unsigned int exp = (h >> 10) & 0x1f;
+		unsigned int mantissa = h & 0x3ff;
+		unsigned int x;
+
+		if (exp == 0)
+		{
+			if (mantissa == 0)
+			{
+				x = sign;
+			}
+			else
+			{
+				// subnormal, normalize
+				exp = 127 - 15 + 1;
+				while ((mantissa & 0x400) == 0)
+				{
+					mantissa <<= 1;
+					exp--;
+				}
+				x = sign | (exp << 23) | ((mantissa & 0x3ff) << 13);
+			}
+		}
+		else if (exp == 31)
+		{
+			x = sign | 0x7f800000 | (mantissa << 13);
+		}
+		else
+		{
+			x = sign | ((exp - 15 + 127) << 23) | (mantissa << 13);
+		}
+
+		float f;
+		Memory::Copy(&f, &x, 4);
+		return f;
+	}
+
+	static short float_to_snorm16(float f)
+	{
+		return (short) Mathf::RoundToInt(Mathf::Clamp(f, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	static float sign_not_zero(float f)
+	{
+		return f >= 0 ? 1.0f : -1.0f;
+	}
+
+	static void oct_encode(const Vector3& n, short& x, short& y)
+	{
+		float l = fabs(n.x) + fabs(n.y) + fabs(n.z);
+		if (l <= 0)
+		{
+			x = 0;
+			y = 0;
+			return;
+		}
+
+		float px = n.x / l;
+		float py = n.y / l;
+		if (n.z < 0)
+		{
+			float ox = (1 - fabs(py)) * sign_not_zero(px);
+			float oy = (1 - fabs(px)) * sign_not_zero(py);
+			px = ox;
+			py = oy;
+		}
+
+		x = float_to_snorm16(px);
+		y = float_to_snorm16(py);
+	}
+
+	static Vector3 oct_decode(short x, short y)
+	{
+		float px = Mathf::Max(x / 32767.0f, -1.0f);
+		float py = Mathf::Max(y / 32767.0f, -1.0f);
+
+		Vector3 n(px, py, 1 - fabs(px) - fabs(py));
+		if (n.z < 0)
+		{
+			n.x = (1 - fabs(py)) * sign_not_zero(px);
+			n.y = (1 - fabs(px)) * sign_not_zero(py);
+		}
+
+		return Vector3::Normalize(n);
+	}
+
+	template<class T>
+	static void write(Vector<byte>& out, const T& t)
+	{
+		out.AddRange((const byte*) &t, sizeof(T));
+	}
+
+	static void write(Vector<byte>& out, const void* data, int size)
+	{
+		out.AddRange((const byte*) data, size);
+	}
+
+	static void write_align(Vector<byte>& out)
+	{
+		while (out.Size() % 4 != 0)
+		{
+			out.Add(0);
+		}
+	}
+
+	static void write_string(Vector<byte>& out, const String& str)
+	{
+		write<int>(out, str.Size());
+		write(out, str.CString(), str.Size());
+	}
+
+	static const byte* read_aligned(MemoryStream& ms, int size)
+	{
+		int pad = (4 - ms.GetPosition() % 4) % 4;
+		if (pad > 0 && ms.ReadPointer(pad) == NULL)
+		{
+			return NULL;
+		}
+
+		return ms.ReadPointer(size);
+	}
+
+	template<class T>
+	static bool read_array(MemoryStream& ms, Vector<T>& array, int count)
+	{
+		array.Resize(count);
+		if (count > 0)
+		{
+			const byte* p = ms.ReadPointer(count * sizeof(T));
+			if (p == NULL)
+			{
+				return false;
+			}
+			Memory::Copy(&array[0], p, count * sizeof(T));
+		}
+		return true;
+	}
+
+	static bool read_header(MemoryStream& ms, MeshFileHeader& header)
+	{
+		byte magic[4];
+		if (ms.Read(magic, 4) != 4 || Memory::Compare(magic, MESH_FILE_MAGIC, 4) != 0)
+		{
+			return false;
+		}
+
+		if (ms.Read<int>() != MeshFile::Version)
+		{
+			return false;
+		}
+
+		int name_size = ms.Read<int>();
+		header.name = ms.ReadString(name_size);
+		header.flags = ms.Read<int>();
+		header.vertex_count = ms.Read<int>();
+		header.index_count = ms.Read<int>();
+		header.coarse_vertex_count = ms.Read<int>();
+		header.coarse_index_count = ms.Read<int>();
+		header.min = ms.Read<Vector3>();
+		header.max = ms.Read<Vector3>();
+
+		int submesh_count = ms.Read<int>();
+		if (!read_array(ms, header.submeshes, submesh_count) ||
+			!read_array(ms, header.coarse_submeshes, submesh_count))
+		{
+			return false;
+		}
+
+		int chunk_count = ms.Read<int>();
+		if (!read_array(ms, header.chunks, chunk_count))
+		{
+			return false;
+		}
+
+		int bind_pose_count = ms.Read<int>();
+		return read_array(ms, header.bind_poses, bind_pose_count);
+	}
+
+	static void resize_vertices(const MeshFileHeader& header, const Ref<Mesh>& mesh, int count)
+	{
+		mesh->vertices.Resize(count);
+		mesh->uv.Resize((header.flags & MESH_FILE_UV) ? count : 0);
+		mesh->colors.Resize((header.flags & MESH_FILE_COLOR) ? count : 0);
+		mesh->uv2.Resize((header.flags & MESH_FILE_UV2) ? count : 0);
+		mesh->normals.Resize((header.flags & MESH_FILE_NORMAL) ? count : 0);
+		mesh->tangents.Resize((header.flags & MESH_FILE_TANGENT) ? count : 0);
+		mesh->bone_weights.Resize((header.flags & MESH_FILE_SKIN) ? count : 0);
+		mesh->bone_indices.Resize((header.flags & MESH_FILE_SKIN) ? count : 0);
+	}
+
+	//
+	//	one vertex range, each attribute stored as its own 4 byte aligned array
+	//
+	static bool read_vertices(MemoryStream& ms, const MeshFileHeader& header, const Ref<Mesh>& mesh, int start, int count)
+	{
+		const unsigned short* p;
+
+		p = (const unsigned short*) read_aligned(ms, count * 6);
+		if (p == NULL)
+		{
+			return false;
+		}
+		Vector3 scale = (header.max - header.min) * (1.0f / 65535);
+		for (int i = 0; i < count; i++)
+		{
+			Vector3& v = mesh->vertices[start + i];
+			v.x = header.min.x + p[i * 3 + 0] * scale.x;
+			v.y = header.min.y + p[i * 3 + 1] * scale.y;
+			v.z = header.min.z + p[i * 3 + 2] * scale.z;
+		}
+
+		if (header.flags & MESH_FILE_UV)
+		{
+			p = (const unsigned short*) read_aligned(ms, count * 4);
+			if (p == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				mesh->uv[start + i] = Vector2(half_to_float(p[i * 2 + 0]), half_to_float(p[i * 2 + 1]));
+			}
+		}
+
+		if (header.flags & MESH_FILE_COLOR)
+		{
+			const byte* c = read_aligned(ms, count * 4);
+			if (c == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				mesh->colors[start + i] = Color(c[i * 4 + 0] / 255.0f, c[i * 4 + 1] / 255.0f, c[i * 4 + 2] / 255.0f, c[i * 4 + 3] / 255.0f);
+			}
+		}
+
+		if (header.flags & MESH_FILE_UV2)
+		{
+			p = (const unsigned short*) read_aligned(ms, count * 4);
+			if (p == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				mesh->uv2[start + i] = Vector2(half_to_float(p[i * 2 + 0]), half_to_float(p[i * 2 + 1]));
+			}
+		}
+
+		if (header.flags & MESH_FILE_NORMAL)
+		{
+			const short* s = (const short*) read_aligned(ms, count * 4);
+			if (s == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				mesh->normals[start + i] = oct_decode(s[i * 2 + 0], s[i * 2 + 1]);
+			}
+		}
+
+		if (header.flags & MESH_FILE_TANGENT)
+		{
+			const short* s = (const short*) read_aligned(ms, count * 6);
+			if (s == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				Vector3 t = oct_decode(s[i * 3 + 0], s[i * 3 + 1]);
+				mesh->tangents[start + i] = Vector4(t.x, t.y, t.z, s[i * 3 + 2] < 0 ? -1.0f : 1.0f);
+			}
+		}
+
+		if (header.flags & MESH_FILE_SKIN)
+		{
+			p = (const unsigned short*) read_aligned(ms, count * 16);
+			if (p == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				const unsigned short* w = &p[i * 8];
+				const unsigned short* b = &p[i * 8 + 4];
+				mesh->bone_weights[start + i] = Vector4(w[0] / 65535.0f, w[1] / 65535.0f, w[2] / 65535.0f, w[3] / 65535.0f);
+				mesh->bone_indices[start + i] = Vector4((float) b[0], (float) b[1], (float) b[2], (float) b[3]);
+			}
+		}
+
+		return true;
+	}
+
+	static bool read_indices(MemoryStream& ms, const MeshFileHeader& header, Vector<unsigned int>& indices, int count)
+	{
+		indices.Resize(count);
+
+		if (header.flags & MESH_FILE_INDEX32)
+		{
+			const byte* p = read_aligned(ms, count * 4);
+			if (p == NULL)
+			{
+				return false;
+			}
+			if (count > 0)
+			{
+				Memory::Copy(&indices[0], p, count * 4);
+			}
+		}
+		else
+		{
+			const unsigned short* p = (const unsigned short*) read_aligned(ms, count * 2);
+			if (p == NULL)
+			{
+				return false;
+			}
+			for (int i = 0; i < count; i++)
+			{
+				indices[i] = p[i];
+			}
+		}
+
+		return true;
+	}
+
+	static void set_header_data(const MeshFileHeader& header, const Ref<Mesh>& mesh)
+	{
+		mesh->SetName(header.name);
+		mesh->bind_poses = header.bind_poses;
+	}
+
+	bool MeshFile::IsMeshFile(const ByteBuffer& buffer)
+	{
+		return buffer.Size() >= 4 && Memory::Compare(buffer.Bytes(), MESH_FILE_MAGIC, 4) == 0;
+	}
+
+	bool MeshFile::LoadCoarse(const ByteBuffer& buffer, const Ref<Mesh>& mesh)
+	{
+		auto ms = MemoryStream(buffer);
+
+		MeshFileHeader header;
+		if (!read_header(ms, header) || header.coarse_vertex_count == 0)
+		{
+			return false;
+		}
+
+		set_header_data(header, mesh);
+		resize_vertices(header, mesh, header.coarse_vertex_count);
+		if (!read_vertices(ms, header, mesh, 0, header.coarse_vertex_count) ||
+			!read_indices(ms, header, mesh->triangles, header.coarse_index_count))
+		{
+			return false;
+		}
+
+		mesh->submeshes = header.coarse_submeshes;
+		mesh->chunks.Clear();
+
+		return true;
+	}
+
+	bool MeshFile::LoadFull(const ByteBuffer& buffer, const Ref<Mesh>& mesh)
+	{
+		auto ms = MemoryStream(buffer);
+
+		MeshFileHeader header;
+		if (!read_header(ms, header))
+		{
+			return false;
+		}
+
+		set_header_data(header, mesh);
+		resize_vertices(header, mesh, header.vertex_count);
+
+		// coarse block, then the rest
+		Vector<unsigned int> coarse_indices;
+		if (!read_vertices(ms, header, mesh, 0, header.coarse_vertex_count) ||
+			!read_indices(ms, header, coarse_indices, header.coarse_index_count) ||
+			!read_vertices(ms, header, mesh, header.coarse_vertex_count, header.vertex_count - header.coarse_vertex_count) ||
+			!read_indices(ms, header, mesh->triangles, header.index_count))
+		{
+			return false;
+		}
+
+		mesh->submeshes = header.submeshes;
+		mesh->chunks = header.chunks;
+
+		int blend_shape_count = ms.Read<int>();
+		mesh->blend_shapes.Resize(blend_shape_count);
+		for (int i = 0; i < blend_shape_count; i++)
+		{
+			auto& shape = mesh->blend_shapes[i];
+			int name_size = ms.Read<int>();
+			shape.name = ms.ReadString(name_size);
+
+			int frame_count = ms.Read<int>();
+			shape.frames.Resize(frame_count);
+			for (int j = 0; j < frame_count; j++)
+			{
+				shape.frames[j].weight = ms.Read<float>();
+				if (!read_array(ms, shape.frames[j].deltas, header.vertex_count))
+				{
+					return false;
+				}
+			}
+		}
+
+		if (blend_shape_count > 0)
+		{
+			mesh->SetDynamic(true);
+		}
+
+		return true;
+	}
+
+	//
+	//	vertex clustering, one vertex kept per grid cell, grid grows until about an eighth of vertices kept,
+	//	returns false if that does not at least halve the triangles
+	//
+	static bool build_coarse(const Ref<Mesh>& mesh, const Vector<Mesh::Submesh>& submeshes, const Vector3& min, const Vector3& max,
+		Vector<unsigned int>& coarse_indices, Vector<Mesh::Submesh>& coarse_submeshes)
+	{
+		int vertex_count = mesh->vertices.Size();
+		int target = vertex_count / 8;
+		if (target < 4)
+		{
+			return false;
+		}
+
+		Vector3 size = max - min;
+		float extent = Mathf::Max(size.x, Mathf::Max(size.y, size.z));
+		if (extent <= 0)
+		{
+			return false;
+		}
+
+		Vector<int> cells(vertex_count);
+		auto cell_of = [&](const Vector3& v, int grid) {
+			int x = Mathf::Min((int) ((v.x - min.x) / extent * grid), grid - 1);
+			int y = Mathf::Min((int) ((v.y - min.y) / extent * grid), grid - 1);
+			int z = Mathf::Min((int) ((v.z - min.z) / extent * grid), grid - 1);
+			return (x * grid + y) * grid + z;
+		};
+
+		// smallest grid keeping at least target cells
+		int grid = 1;
+		std::set<int> occupied;
+		for (int g = 2; g <= 1024; g *= 2)
+		{
+			occupied.clear();
+			for (int i = 0; i < vertex_count; i++)
+			{
+				occupied.insert(cell_of(mesh->vertices[i], g));
+			}
+
+			grid = g;
+			if ((int) occupied.size() >= target)
+			{
+				break;
+			}
+		}
+
+		// representative nearest to cell centroid
+		Map<int, Vector4> centroids;
+		for (int i = 0; i < vertex_count; i++)
+		{
+			cells[i] = cell_of(mesh->vertices[i], grid);
+			const Vector3& v = mesh->vertices[i];
+			Vector4* c;
+			if (centroids.TryGet(cells[i], &c))
+			{
+				*c = Vector4(c->x + v.x, c->y + v.y, c->z + v.z, c->w + 1);
+			}
+			else
+			{
+				centroids.Add(cells[i], Vector4(v.x, v.y, v.z, 1));
+			}
+		}
+
+		Map<int, int> representatives;
+		for (int i = 0; i < vertex_count; i++)
+		{
+			Vector4* c;
+			centroids.TryGet(cells[i], &c);
+			Vector3 center(c->x / c->w, c->y / c->w, c->z / c->w);
+
+			int* r;
+			if (!representatives.TryGet(cells[i], &r))
+			{
+				representatives.Add(cells[i], i);
+			}
+			else if ((mesh->vertices[i] - center).SqrMagnitude() < (mesh->vertices[*r] - center).SqrMagnitude())
+			{
+				*r = i;
+			}
+		}
+
+		coarse_indices.Clear();
+		coarse_submeshes.Clear();
+		for (const auto& submesh : submeshes)
+		{
+			Mesh::Submesh coarse;
+			coarse.start = coarse_indices.Size();
+
+			std::set<std::array<unsigned int, 3>> triangles;
+			for (int i = 0; i < submesh.count / 3; i++)
+			{
+				unsigned int t[3];
+				for (int j = 0; j < 3; j++)
+				{
+					int* r;
+					representatives.TryGet(cells[mesh->triangles[submesh.start + i * 3 + j]], &r);
+					t[j] = *r;
+				}
+
+				if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0])
+				{
+					continue;
+				}
+
+				// same triangle from other cells collapses once, winding kept
+				int first = t[0] < t[1] ? (t[0] < t[2] ? 0 : 2) : (t[1] < t[2] ? 1 : 2);
+				std::array<unsigned int, 3> key = { { t[first], t[(first + 1) % 3], t[(first + 2) % 3] } };
+				if (triangles.insert(key).second)
+				{
+					coarse_indices.AddRange(t, 3);
+				}
+			}
+
+			coarse.count = coarse_indices.Size() - coarse.start;
+			coarse_submeshes.Add(coarse);
+		}
+
+		return coarse_indices.Size() > 0 && coarse_indices.Size() * 2 <= mesh->triangles.Size();
+	}
+
+	//
+	//	split each submesh in triangle order into chunks of bounded vertex and triangle count
+	//
+	static void build_chunks(const Ref<Mesh>& mesh, const Vector<Mesh::Submesh>& submeshes, Vector<Mesh::Chunk>& chunks)
+	{
+		// chunk index each vertex was last counted in
+		Vector<int> counted_in(mesh->vertices.Size(), -1);
+
+		for (const auto& submesh : submeshes)
+		{
+			Mesh::Chunk chunk;
+			chunk.count = 0;
+			int chunk_vertex_count = 0;
+
+			for (int i = 0; i < submesh.count / 3; i++)
+			{
+				int start = submesh.start + i * 3;
+				const unsigned int* t = &mesh->triangles[start];
+
+				int new_vertex_count = 0;
+				for (int j = 0; j < 3; j++)
+				{
+					if (counted_in[t[j]] != chunks.Size())
+					{
+						new_vertex_count++;
+					}
+				}
+
+				if (chunk.count > 0 &&
+					(chunk_vertex_count + new_vertex_count > MeshFile::MaxChunkVertices || chunk.count / 3 >= MeshFile::MaxChunkTriangles))
+				{
+					chunks.Add(chunk);
+					chunk.count = 0;
+					chunk_vertex_count = 0;
+				}
+
+				if (chunk.count == 0)
+				{
+					chunk.start = start;
+					chunk.min = mesh->vertices[t[0]];
+					chunk.max = chunk.min;
+				}
+
+				for (int j = 0; j < 3; j++)
+				{
+					if (counted_in[t[j]] != chunks.Size())
+					{
+						counted_in[t[j]] = chunks.Size();
+						chunk_vertex_count++;
+					}
+					chunk.min = Vector3::Min(chunk.min, mesh->vertices[t[j]]);
+					chunk.max = Vector3::Max(chunk.max, mesh->vertices[t[j]]);
+				}
+				chunk.count += 3;
+			}
+
+			if (chunk.count > 0)
+			{
+				chunks.Add(chunk);
+			}
+		}
+	}
+
+	static void write_vertices(Vector<byte>& out, int flags, const Ref<Mesh>& mesh, const Vector<int>& order, int start, int count, const Vector3& min, const Vector3& max)
+	{
+		Vector3 size = max - min;
+		Vector3 scale(size.x > 0 ? 65535 / size.x : 0, size.y > 0 ? 65535 / size.y : 0, size.z > 0 ? 65535 / size.z : 0);
+
+		write_align(out);
+		for (int i = start; i < start + count; i++)
+		{
+			const Vector3& v = mesh->vertices[order[i]];
+			unsigned short q[3] = {
+				(unsigned short) Mathf::Clamp(Mathf::RoundToInt((v.x - min.x) * scale.x), 0, 65535),
+				(unsigned short) Mathf::Clamp(Mathf::RoundToInt((v.y - min.y) * scale.y), 0, 65535),
+				(unsigned short) Mathf::Clamp(Mathf::RoundToInt((v.z - min.z) * scale.z), 0, 65535),
+			};
+			write(out, q, sizeof(q));
+		}
+
+		if (flags & MESH_FILE_UV)
+		{
+			write_align(out);
+			for (int i = start; i < start + count; i++)
+			{
+				const Vector2& uv = mesh->uv[order[i]];
+				write<unsigned short>(out, float_to_half(uv.x));
+				write<unsigned short>(out, float_to_half(uv.y));
+			}
+		}
+
+		if (flags & MESH_FILE_COLOR)
+		{
+			write_align(out);
+			for (int i = start; i < start + count; i++)
+			{
+				const Color& c = mesh->colors[order[i]];
+				byte q[4] = {
+					(byte) Mathf::RoundToInt(Mathf::Clamp01(c.r) * 255),
+					(byte) Mathf::RoundToInt(Mathf::Clamp01(c.g) * 255),
+					(byte) Mathf::RoundToInt(Mathf::Clamp01(c.b) * 255),
+					(byte) Mathf::RoundToInt(Mathf::Clamp01(c.a) * 255),
+				};
+				write(out, q, sizeof(q));
+			}
+		}
+
+		if (flags & MESH_FILE_UV2)
+		{
+			write_align(out);
+			for (int i = start; i < start + count; i++)
+			{
+				const Vector2& uv = mesh->uv2[order[i]];
+				write<unsigned short>(out, float_to_half(uv.x));
+				write<unsigned short>(out, float_to_half(uv.y));
+			}
+		}
+
+		if (flags & MESH_FILE_NORMAL)
+		{
+			write_align(out);
+			for (int i = start; i < start + count; i++)
+			{
+				short q[2];
+				oct_encode(mesh->normals[order[i]], q[0], q[1]);
+				write(out, q, sizeof(q));
+			}
+		}
+
+		if (flags & MESH_FILE_TANGENT)
+		{
+			write_align(out);
+			for (int i = start; i < start + count; i++)
+			{
+				const Vector4& t = mesh->tangents[order[i]];
+				short q[3];
+				oct_encode(Vector3(t.x, t.y, t.z), q[0], q[1]);
+				q[2] = t.w < 0 ? -1 : 1;
+				write(out, q, sizeof(q));
+			}
+		}
+
+		if (flags & MESH_FILE_SKIN)
+		{
+			write_align(out);
+			for (int i = start; i < start + count; i++)
+			{
+				const Vector4& w = mesh->bone_weights[order[i]];
+				const Vector4& b = mesh->bone_indices[order[i]];
+				unsigned short q[8] = {
+					(unsigned short) Mathf::RoundToInt(Mathf::Clamp01(w.x) * 65535),
+					(unsigned short) Mathf::RoundToInt(Mathf::Clamp01(w.y) * 65535),
+					(unsigned short) Mathf::RoundToInt(Mathf::Clamp01(w.z) * 65535),
+					(unsigned short) Mathf::RoundToInt(Mathf::Clamp01(w.w) * 65535),
+					(unsigned short) Mathf::RoundToInt(b.x),
+					(unsigned short) Mathf::RoundToInt(b.y),
+					(unsigned short) Mathf::RoundToInt(b.z),
+					(unsigned short) Mathf::RoundToInt(b.w),
+				};
+				write(out, q, sizeof(q));
+			}
+		}
+	}
+
+	static void write_indices(Vector<byte>& out, int flags, const Vector<unsigned int>& indices, const Vector<int>& remap)
+	{
+		write_align(out);
+		for (auto i : indices)
+		{
+			if (flags & MESH_FILE_INDEX32)
+			{
+				write<unsigned int>(out, remap[i]);
+			}
+			else
+			{
+				write<unsigned short>(out, (unsigned short) remap[i]);
+			}
+		}
+	}
+
+	ByteBuffer MeshFile::Save(const Ref<Mesh>& mesh)
+	{
+		int vertex_count = mesh->vertices.Size();
+
+		int flags = 0;
+		if (mesh->uv.Size() == vertex_count && vertex_count > 0)
+		{
+			flags |= MESH_FILE_UV;
+		}
+		if (mesh->colors.Size() == vertex_count && vertex_count > 0)
+		{
+			flags |= MESH_FILE_COLOR;
+		}
+		if (mesh->uv2.Size() == vertex_count && vertex_count > 0)
+		{
+			flags |= MESH_FILE_UV2;
+		}
+		if (mesh->normals.Size() == vertex_count && vertex_count > 0)
+		{
+			flags |= MESH_FILE_NORMAL;
+		}
+		if (mesh->tangents.Size() == vertex_count && vertex_count > 0)
+		{
+			flags |= MESH_FILE_TANGENT;
+		}
+		if (mesh->bone_weights.Size() == vertex_count && mesh->bone_indices.Size() == vertex_count && vertex_count > 0)
+		{
+			flags |= MESH_FILE_SKIN;
+		}
+		if (vertex_count > 65536)
+		{
+			flags |= MESH_FILE_INDEX32;
+		}
+
+		Vector3 min;
+		Vector3 max;
+		if (vertex_count > 0)
+		{
+			min = mesh->vertices[0];
+			max = min;
+			for (const auto& v : mesh->vertices)
+			{
+				min = Vector3::Min(min, v);
+				max = Vector3::Max(max, v);
+			}
+		}
+
+		Vector<Mesh::Submesh> submeshes = mesh->submeshes;
+		if (submeshes.Empty())
+		{
+			submeshes.Add({ 0, mesh->triangles.Size() });
+		}
+
+		Vector<unsigned int> coarse_indices;
+		Vector<Mesh::Submesh> coarse_submeshes;
+		if (!build_coarse(mesh, submeshes, min, max, coarse_indices, coarse_submeshes))
+		{
+			coarse_indices.Clear();
+			coarse_submeshes.Clear();
+			for (int i = 0; i < submeshes.Size(); i++)
+			{
+				coarse_submeshes.Add({ 0, 0 });
+			}
+		}
+
+		Vector<Mesh::Chunk> chunks;
+		build_chunks(mesh, submeshes, chunks);
+
+		// coarse vertices first, then rest by first use in chunk order, unused last
+		Vector<int> order;
+		Vector<int> remap(vertex_count, -1);
+		for (auto i : coarse_indices)
+		{
+			if (remap[i] < 0)
+			{
+				remap[i] = order.Size();
+				order.Add(i);
+			}
+		}
+		int coarse_vertex_count = order.Size();
+		for (auto i : mesh->triangles)
+		{
+			if (remap[i] < 0)
+			{
+				remap[i] = order.Size();
+				order.Add(i);
+			}
+		}
+		for (int i = 0; i < vertex_count; i++)
+		{
+			if (remap[i] < 0)
+			{
+				remap[i] = order.Size();
+				order.Add(i);
+			}
+		}
+
+		Vector<byte> out;
+		write(out, MESH_FILE_MAGIC, 4);
+		write<int>(out, (int) Version);
+		write_string(out, mesh->GetName());
+		write<int>(out, flags);
+		write<int>(out, vertex_count);
+		write<int>(out, mesh->triangles.Size());
+		write<int>(out, coarse_vertex_count);
+		write<int>(out, coarse_indices.Size());
+		write<Vector3>(out, min);
+		write<Vector3>(out, max);
+		write<int>(out, submeshes.Size());
+		write(out, submeshes.Bytes(), submeshes.SizeInBytes());
+		write(out, coarse_submeshes.Bytes(), coarse_submeshes.SizeInBytes());
+		write<int>(out, chunks.Size());
+		write(out, chunks.Bytes(), chunks.SizeInBytes());
+		write<int>(out, mesh->bind_poses.Size());
+		write(out, mesh->bind_poses.Bytes(), mesh->bind_poses.SizeInBytes());
+
+		write_vertices(out, flags, mesh, order, 0, coarse_vertex_count, min, max);
+		write_indices(out, flags, coarse_indices, remap);
+		write_vertices(out, flags, mesh, order, coarse_vertex_count, vertex_count - coarse_vertex_count, min, max);
+		write_indices(out, flags, mesh->triangles, remap);
+
+		write<int>(out, mesh->blend_shapes.Size());
+		for (const auto& shape : mesh->blend_shapes)
+		{
+			write_string(out, shape.name);
+			write<int>(out, shape.frames.Size());
+			for (const auto& frame : shape.frames)
+			{
+				write<float>(out, frame.weight);
+				for (int i = 0; i < vertex_count; i++)
+				{
+					write<Mesh::BlendShapeVertexDelta>(out, frame.deltas[order[i]]);
+				}
+			}
+		}
+
+		ByteBuffer buffer(out.Size());
+		Memory::Copy(buffer.Bytes(), out.Bytes(), out.Size());
+
+		return buffer;
+	}
+}
@@ -0,0 +1,50 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "Mesh.h"
+
+namespace Viry3D
+{
+	//
+	//	cooked mesh file (.vmesh), 32 bit indices, meshlet chunks,
+	//	positions 16 bit in bounds, octahedral normals and tangents, half uvs,
+	//	vertices and indices of a coarse lod come first so a mesh can show before the rest is read
+	//
+	class MeshFile
+	{
+	public:
+		static const int Version = 1;
+		static const int MaxChunkVertices = 64;
+		static const int MaxChunkTriangles = 124;
+
+		static bool IsMeshFile(const ByteBuffer& buffer);
+		//
+		//	header and coarse lod only, false if file has no coarse lod
+		//
+		static bool LoadCoarse(const ByteBuffer& buffer, const Ref<Mesh>& mesh);
+		//
+		//	all vertices and full detail, replaces any coarse data in mesh
+		//
+		static bool LoadFull(const ByteBuffer& buffer, const Ref<Mesh>& mesh);
+		//
+		//	cpu data of mesh only, vertices reordered by coarse lod then by chunk
+		//
+		static ByteBuffer Save(const Ref<Mesh>& mesh);
+	};
+}
@@ -42,12 +42,12 @@ namespace Viry3D
 	{
 	}
 
-	void RenderPass::Begin(const Color& clear_color)
+	void RenderPass::Begin(const Color& clear_color, bool secondary_contents)
 	{
 		Bind();
 
 #if VR_VULKAN
-		RenderPassVulkan::Begin(clear_color);
+		RenderPassVulkan::Begin(clear_color, secondary_contents);
 #elif VR_GLES
 		RenderPassGLES::Begin(clear_color);
 #endif
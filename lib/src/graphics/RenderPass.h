@@ -42,7 +42,10 @@ namespace Viry3D
 		static RenderPass* GetRenderPassBinding() { return m_render_pass_binding; }
 		static Ref<RenderPass> Create(Ref<RenderTexture> color_texture, Ref<RenderTexture> depth_texture, CameraClearFlags clear_flag, bool need_depth, Rect rect);
 
-		void Begin(const Color& clear_color);
+		//
+		//	secondary_contents, pass commands recorded by Display::RecordSecondaryCommandBuffers, vulkan only
+		//
+		void Begin(const Color& clear_color, bool secondary_contents = false);
 		void End();
 		void Bind();
 		void Unbind();
@@ -190,4 +190,9 @@ namespace Viry3D
 	{
 		return m_xml.queue;
 	}
+
+	bool Shader::IsInstancing() const
+	{
+		return m_xml.instancing;
+	}
 }
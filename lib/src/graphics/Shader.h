@@ -50,6 +50,11 @@ namespace Viry3D
 		static const Ref<Texture2D>& GetDefaultTexture(const String& name);
 
 		int GetQueue() const;
+		//
+		//	vertex shaders read object data from instance array by instance id,
+		//	renderer data must be set by Graphics::GetInstanceBuffer
+		//
+		bool IsInstancing() const;
 
 	private:
 		Shader(const String& name);
@@ -17,6 +17,9 @@
 
 #include "Texture2D.h"
 #include "Image.h"
+#include "KTX2.h"
+#include "TextureTranscoder.h"
+#include "TextureStreaming.h"
 #include "io/File.h"
 #include "memory/Memory.h"
 
@@ -95,7 +98,7 @@ namespace Viry3D
 
 		if (File::Exist(file))
 		{
-			auto bytes = File::ReadAllBytes(file);
+			auto bytes = File::MapAllBytes(file);
 
 			texture = LoadFromData(bytes, wrap_mode, filter_mode, mipmap);
 		}
@@ -126,6 +129,96 @@ namespace Viry3D
 		return texture;
 	}
 
+	Ref<Texture2D> Texture2D::LoadFromKTX2(const ByteBuffer& buffer,
+		TextureWrapMode wrap_mode,
+		FilterMode filter_mode,
+		int first_level)
+	{
+		Ref<Texture2D> texture;
+
+		KTX2::Image image;
+		if (!KTX2::Load(buffer, image))
+		{
+			return texture;
+		}
+
+		//	smaller levels only make a valid texture if the chain is full,
+		//	keep at least two levels so the texture stays mipmapped
+		int full_count = (int) floor(Mathf::Log2((float) Mathf::Max(image.width, image.height))) + 1;
+		if (image.levels.Size() != full_count)
+		{
+			first_level = 0;
+		}
+		first_level = Mathf::Clamp(first_level, 0, Mathf::Max(image.levels.Size() - 2, 0));
+
+		int width = Mathf::Max(image.width >> first_level, 1);
+		int height = Mathf::Max(image.height >> first_level, 1);
+
+		if (Texture2D::IsFormatSupported(image.format))
+		{
+			Vector<ByteBuffer> levels;
+			for (int i = first_level; i < image.levels.Size(); i++)
+			{
+				levels.Add(image.levels[i]);
+			}
+
+			texture = Create(width, height, image.format, wrap_mode, filter_mode, levels);
+		}
+		else if (TextureTranscoder::CanDecode(image.format))
+		{
+			Vector<ByteBuffer> levels;
+			for (int i = first_level; i < image.levels.Size(); i++)
+			{
+				int w = Mathf::Max(image.width >> i, 1);
+				int h = Mathf::Max(image.height >> i, 1);
+				levels.Add(TextureTranscoder::Decode(image.format, w, h, image.levels[i]));
+			}
+
+			texture = Create(width, height, TextureFormat::RGBA32, wrap_mode, filter_mode, levels);
+		}
+
+		if (texture && first_level > 0)
+		{
+			texture->SetWidth(image.width);
+			texture->SetHeight(image.height);
+			texture->m_resident_level = first_level;
+		}
+
+		return texture;
+	}
+
+	Ref<Texture2D> Texture2D::Create(
+		int width,
+		int height,
+		TextureFormat format,
+		TextureWrapMode wrap_mode,
+		FilterMode filter_mode,
+		const Vector<ByteBuffer>& levels)
+	{
+		Ref<Texture2D> texture = Ref<Texture2D>(new Texture2D());
+		texture->SetWidth(width);
+		texture->SetHeight(height);
+		texture->SetWrapMode(wrap_mode);
+		texture->SetFilterMode(filter_mode);
+		texture->m_mipmap = levels.Size() > 1;
+		texture->m_format = format;
+		texture->m_colors = levels[0];
+		texture->m_levels = levels;
+
+		//	partial chain, keep level 0 and let gpu build the rest if it can
+		if (texture->m_mipmap && levels.Size() != texture->GetMipmapCount())
+		{
+			texture->m_mipmap = !TextureTranscoder::IsCompressed(format);
+			texture->m_levels.Clear();
+			texture->m_levels.Add(levels[0]);
+		}
+
+		texture->CreateTexture2D();
+		texture->m_levels.Clear();
+
+		return texture;
+	}
+
 	Ref<Texture2D> Texture2D::CreateExternalTexture(int width, int height, TextureFormat format, bool mipmap, void* external_texture)
 	{
 		Ref<Texture2D> texture = Ref<Texture2D>(new Texture2D());
@@ -143,11 +236,43 @@ namespace Viry3D
 	}
 
 	Texture2D::Texture2D():
-		m_format(TextureFormat::RGBA32)
+		m_format(TextureFormat::RGBA32),
+		m_resident_level(0),
+		m_stream_id(-1)
 	{
 		SetName("Texture2D");
 	}
 
+	Texture2D::~Texture2D()
+	{
+		if (m_stream_id >= 0)
+		{
+			TextureStreaming::Unregister(m_stream_id);
+		}
+	}
+
+	void Texture2D::SetResidentLevels(int first_level, const Vector<ByteBuffer>& levels)
+	{
+		//	backends size the gpu texture and its mip count from width and height,
+		//	so present level first_level as level 0 while creating
+		int width = this->GetWidth();
+		int height = this->GetHeight();
+
+		this->SetWidth(Mathf::Max(width >> first_level, 1));
+		this->SetHeight(Mathf::Max(height >> first_level, 1));
+		m_mipmap = levels.Size() > 1;
+		m_colors = levels[0];
+		m_levels = levels;
+
+		this->CreateTexture2D();
+
+		m_levels.Clear();
+		this->SetWidth(width);
+		this->SetHeight(height);
+		m_mipmap = true;
+		m_resident_level = first_level;
+	}
+
 	void Texture2D::EncodeToPNG(const String& file)
 	{
 		int bpp;
@@ -19,6 +19,7 @@
 
 #include "Texture.h"
 #include "TextureFormat.h"
+#include "container/Vector.h"
 
 namespace Viry3D
 {
@@ -41,6 +42,16 @@ namespace Viry3D
 			bool mipmap = false);
 		static bool LoadImageData(const ByteBuffer& buffer, ByteBuffer& colors, int& width, int& height, TextureFormat& format);
 		//
+		//	cooked ktx2, levels uploaded as stored,
+		//	format not supported by gpu is transcoded to RGBA32 on cpu,
+		//	return null if neither works,
+		//	first_level > 0 uploads only smaller levels of a full chain, see SetResidentLevels
+		//
+		static Ref<Texture2D> LoadFromKTX2(const ByteBuffer& buffer,
+			TextureWrapMode wrap_mode = TextureWrapMode::Clamp,
+			FilterMode filter_mode = FilterMode::Bilinear,
+			int first_level = 0);
+		//
 		//	̰߳ȫ
 		//
 		static Ref<Texture2D> Create(
@@ -51,19 +62,45 @@ namespace Viry3D
 			FilterMode filter_mode,
 			bool mipmap,
 			const ByteBuffer& colors);
+		//
+		//	prebuilt mip chain, level 0 first, no mipmap generation
+		//
+		static Ref<Texture2D> Create(
+			int width,
+			int height,
+			TextureFormat format,
+			TextureWrapMode wrap_mode,
+			FilterMode filter_mode,
+			const Vector<ByteBuffer>& levels);
         static Ref<Texture2D> CreateExternalTexture(int width, int height, TextureFormat format, bool mipmap, void* external_texture);
         void UpdateExternalTexture(void* external_texture);
 
 		ByteBuffer& GetColors() { return m_colors; }
+		const Vector<ByteBuffer>& GetLevels() const { return m_levels; }
 		void UpdateTexture(int x, int y, int w, int h, const ByteBuffer& colors);
 		void EncodeToPNG(const String& file);
 		TextureFormat GetFormat() const { return m_format; }
+		//
+		//	gpu texture holds levels from resident level to the smallest,
+		//	width and height stay those of level 0
+		//
+		int GetResidentLevel() const { return m_resident_level; }
+		//
+		//	replace gpu texture, levels are first_level to the smallest, format unchanged
+		//
+		void SetResidentLevels(int first_level, const Vector<ByteBuffer>& levels);
+		virtual ~Texture2D();
 
 	private:
+		friend class TextureStreaming;
+
 		Texture2D();
 
 	private:
 		TextureFormat m_format;
 		ByteBuffer m_colors;
+		Vector<ByteBuffer> m_levels;
+		int m_resident_level;
+		int m_stream_id;
 	};
 }
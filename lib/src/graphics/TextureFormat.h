@@ -35,5 +35,11 @@ namespace Viry3D
 		RGFloat,
 		RGBFloat,
 		RGBAFloat,
+
+		//	4x4 blocks
+		ETC2_RGB8,
+		ETC2_RGBA8,
+		ASTC_4x4,
+		BC7,
 	};
 }
@@ -0,0 +1,430 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "TextureStreaming.h"
+#include "KTX2.h"
+#include "TextureTranscoder.h"
+#include "Camera.h"
+#include "Material.h"
+#include "renderer/Renderer.h"
+#include "Transform.h"
+#include "io/File.h"
+#include "memory/Memory.h"
+#include "math/Mathf.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace Viry3D
+{
+	bool TextureStreaming::m_enable = true;
+	long long TextureStreaming::m_budget = 256 * 1024 * 1024;
+	int TextureStreaming::m_start_size = 64;
+	int TextureStreaming::m_frame = 0;
+	int TextureStreaming::m_next_id = 0;
+	Map<int, TextureStreaming::Entry> TextureStreaming::m_entries;
+	Mutex TextureStreaming::m_mutex;
+	Ref<ThreadPool> TextureStreaming::m_thread_pool;
+	TextureStreaming::Stats TextureStreaming::m_stats;
+
+	static int level_memory_size(TextureFormat format, int width, int height)
+	{
+		if (TextureTranscoder::IsCompressed(format))
+		{
+			return TextureTranscoder::GetLevelSize(format, width, height);
+		}
+
+		switch (format)
+		{
+			case TextureFormat::R8:
+				return width * height;
+			case TextureFormat::RGB24:
+				return width * height * 3;
+			default:
+				return width * height * 4;
+		}
+	}
+
+	void TextureStreaming::Init()
+	{
+		m_thread_pool = RefMake<ThreadPool>(1);
+		Memory::Zero(&m_stats, sizeof(m_stats));
+	}
+
+	void TextureStreaming::Deinit()
+	{
+		if (m_thread_pool)
+		{
+			m_thread_pool->Wait();
+			m_thread_pool.reset();
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& i : m_entries)
+		{
+			i.second.texture->m_stream_id = -1;
+		}
+		m_entries.Clear();
+	}
+
+	Ref<Texture2D> TextureStreaming::Load(const String& path, TextureWrapMode wrap_mode, FilterMode filter_mode)
+	{
+		Ref<Texture2D> texture;
+
+		auto buffer = File::MapAllBytes(path);
+
+		KTX2::Image image;
+		if (!KTX2::Load(buffer, image))
+		{
+			return texture;
+		}
+
+		int start_level = 0;
+		if (m_enable && m_thread_pool)
+		{
+			int size = Mathf::Max(image.width, image.height);
+			while ((size >> start_level) > m_start_size)
+			{
+				start_level++;
+			}
+		}
+
+		texture = Texture2D::LoadFromKTX2(buffer, wrap_mode, filter_mode, start_level);
+		if (!texture || texture->GetResidentLevel() == 0)
+		{
+			return texture;
+		}
+
+		Entry entry;
+		entry.texture = texture.get();
+		entry.path = path;
+		entry.width = image.width;
+		entry.height = image.height;
+		entry.transcode = !Texture2D::IsFormatSupported(image.format);
+		entry.start_level = texture->GetResidentLevel();
+		entry.resident_level = entry.start_level;
+		entry.requested_level = image.levels.Size();
+		entry.wanted_level = entry.start_level;
+		entry.loading = false;
+		entry.failed = false;
+
+		for (int i = 0; i < image.levels.Size(); i++)
+		{
+			int w = Mathf::Max(image.width >> i, 1);
+			int h = Mathf::Max(image.height >> i, 1);
+			entry.level_bytes.Add(level_memory_size(entry.transcode ? TextureFormat::RGBA32 : image.format, w, h));
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		entry.id = m_next_id++;
+		entry.last_request_frame = m_frame - EvictFrames;
+		texture->m_stream_id = entry.id;
+		m_entries.Add(entry.id, entry);
+
+		return texture;
+	}
+
+	void TextureStreaming::Unregister(int id)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_entries.Remove(id);
+	}
+
+	void TextureStreaming::RequestLevels(Camera* cam, const List<Renderer*>& renderers)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_entries.Empty() || !m_enable)
+		{
+			return;
+		}
+
+		Vector3 cam_pos = cam->GetTransform()->GetPosition();
+		float screen_height = (float) cam->GetTargetHeight();
+		float tan_half_fov = tanf(cam->GetFieldOfView() * 0.5f * Mathf::Deg2Rad);
+
+		for (auto renderer : renderers)
+		{
+			const auto& bounds = renderer->GetBounds();
+
+			//	pixels the renderer covers on screen, uv assumed to span it once,
+			//	renderer without finite bounds taken as covering the screen
+			float pixels;
+			if (Renderer::IsUnbounded(bounds))
+			{
+				pixels = screen_height;
+			}
+			else
+			{
+				Vector3 center = (bounds.Min() + bounds.Max()) * 0.5f;
+				float radius = (bounds.Max() - bounds.Min()).Magnitude() * 0.5f;
+
+				if (cam->IsOrthographic())
+				{
+					pixels = radius * screen_height / cam->GetOrthographicSize();
+				}
+				else
+				{
+					float distance = Mathf::Max((center - cam_pos).Magnitude() - radius, cam->GetClipNear());
+					pixels = radius * screen_height / (tan_half_fov * distance);
+				}
+			}
+
+			for (const auto& mat : renderer->GetSharedMaterials())
+			{
+				if (!mat)
+				{
+					continue;
+				}
+
+				for (const auto& i : mat->GetTextures())
+				{
+					auto texture = dynamic_cast<Texture2D*>(i.second.get());
+					if (texture == NULL || texture->m_stream_id < 0)
+					{
+						continue;
+					}
+
+					Entry* entry;
+					if (!m_entries.TryGet(texture->m_stream_id, &entry))
+					{
+						continue;
+					}
+
+					int level = entry->level_bytes.Size() - 1;
+					if (pixels >= 1)
+					{
+						float texels = (float) Mathf::Max(entry->width, entry->height);
+						level = (int) floor(Mathf::Log2(Mathf::Max(texels / pixels, 1.0f)));
+					}
+
+					entry->requested_level = Mathf::Min(entry->requested_level, level);
+					entry->last_request_frame = m_frame;
+				}
+			}
+		}
+	}
+
+	long long TextureStreaming::GetResidentBytes(const Entry& entry, int level)
+	{
+		long long bytes = 0;
+		for (int i = level; i < entry.level_bytes.Size(); i++)
+		{
+			bytes += entry.level_bytes[i];
+		}
+		return bytes;
+	}
+
+	void TextureStreaming::LoadLevels(Entry& entry, int level)
+	{
+		entry.loading = true;
+		m_stats.pending_count++;
+
+		int id = entry.id;
+		String path = entry.path;
+		bool transcode = entry.transcode;
+
+		m_thread_pool->AddTask(
+		{
+			[=]() {
+			Vector<ByteBuffer> levels;
+
+			KTX2::Image image;
+			if (KTX2::Load(File::MapAllBytes(path), image))
+			{
+				for (int i = level; i < image.levels.Size(); i++)
+				{
+					if (transcode)
+					{
+						int w = Mathf::Max(image.width >> i, 1);
+						int h = Mathf::Max(image.height >> i, 1);
+						levels.Add(TextureTranscoder::Decode(image.format, w, h, image.levels[i]));
+					}
+					else
+					{
+						levels.Add(image.levels[i]);
+					}
+				}
+			}
+
+			return RefMake<Any>(levels);
+		},
+			[=](Ref<Any> any) {
+			const auto& levels = any->Get<Vector<ByteBuffer>>();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stats.pending_count--;
+
+			Entry* entry;
+			if (m_entries.TryGet(id, &entry))
+			{
+				// the smallest level alone is a valid result
+				if (!levels.Empty())
+				{
+					if (level < entry->resident_level)
+					{
+						m_stats.streamed_in_count++;
+					}
+					else
+					{
+						m_stats.streamed_out_count++;
+					}
+
+					entry->texture->SetResidentLevels(level, levels);
+					entry->resident_level = level;
+					entry->levels = levels;
+				}
+				else
+				{
+					// file gone or broken, keep resident levels and stop loading it
+					entry->failed = true;
+				}
+				entry->loading = false;
+			}
+		}
+		}
+		);
+	}
+
+	void TextureStreaming::DropLevels(Entry& entry, int level)
+	{
+		Vector<ByteBuffer> levels;
+		for (int i = level - entry.resident_level; i < entry.levels.Size(); i++)
+		{
+			levels.Add(entry.levels[i]);
+		}
+
+		entry.texture->SetResidentLevels(level, levels);
+		entry.resident_level = level;
+		m_stats.streamed_out_count++;
+
+		if (level < entry.start_level)
+		{
+			entry.levels = levels;
+		}
+		else
+		{
+			entry.levels.Clear();
+		}
+	}
+
+	void TextureStreaming::Update()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		long long resident_bytes = 0;
+		long long wanted_bytes = 0;
+		Vector<Entry*> entries;
+
+		for (auto& i : m_entries)
+		{
+			auto& entry = i.second;
+
+			if (!m_enable || m_frame - entry.last_request_frame >= EvictFrames)
+			{
+				entry.wanted_level = entry.start_level;
+			}
+			else if (entry.last_request_frame == m_frame)
+			{
+				// never below start level, it is loaded anyway
+				entry.wanted_level = Mathf::Min(entry.requested_level, entry.start_level);
+			}
+			entry.requested_level = entry.level_bytes.Size();
+
+			resident_bytes += GetResidentBytes(entry, entry.resident_level);
+			wanted_bytes += GetResidentBytes(entry, entry.wanted_level);
+			entries.Add(&entry);
+		}
+
+		// over budget, drop top levels of least recently requested, then largest, textures first
+		long long total_bytes = wanted_bytes;
+		if (total_bytes > m_budget)
+		{
+			std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+				if (a->last_request_frame != b->last_request_frame)
+				{
+					return a->last_request_frame < b->last_request_frame;
+				}
+				return a->level_bytes[a->wanted_level] > b->level_bytes[b->wanted_level];
+			});
+
+			for (auto entry : entries)
+			{
+				while (total_bytes > m_budget && entry->wanted_level < entry->start_level)
+				{
+					total_bytes -= entry->level_bytes[entry->wanted_level];
+					entry->wanted_level++;
+				}
+
+				if (total_bytes <= m_budget)
+				{
+					break;
+				}
+			}
+		}
+
+		// drops first to free memory, then the largest missing detail
+		Vector<Entry*> loads;
+		for (auto entry : entries)
+		{
+			if (!entry->loading && !entry->failed && entry->wanted_level != entry->resident_level)
+			{
+				loads.Add(entry);
+			}
+		}
+		std::sort(loads.begin(), loads.end(), [](const Entry* a, const Entry* b) {
+			bool a_drop = a->wanted_level > a->resident_level;
+			bool b_drop = b->wanted_level > b->resident_level;
+			if (a_drop != b_drop)
+			{
+				return a_drop;
+			}
+			return abs(a->wanted_level - a->resident_level) > abs(b->wanted_level - b->resident_level);
+		});
+
+		for (auto entry : loads)
+		{
+			// smaller levels already in memory, dropped right here
+			if (entry->wanted_level > entry->resident_level &&
+				entry->wanted_level - entry->resident_level < entry->levels.Size())
+			{
+				DropLevels(*entry, entry->wanted_level);
+				continue;
+			}
+
+			if (m_stats.pending_count >= MaxPendingLoads)
+			{
+				continue;
+			}
+
+			LoadLevels(*entry, entry->wanted_level);
+		}
+
+		m_stats.texture_count = m_entries.Size();
+		m_stats.budget_bytes = m_budget;
+		m_stats.resident_bytes = resident_bytes;
+		m_stats.wanted_bytes = wanted_bytes;
+
+		m_frame++;
+
+		Profiler::SetCounter("TextureStreaming.TextureCount", m_stats.texture_count);
+		Profiler::SetCounter("TextureStreaming.PendingCount", m_stats.pending_count);
+		Profiler::SetCounter("TextureStreaming.ResidentBytes", m_stats.resident_bytes);
+		Profiler::SetCounter("TextureStreaming.WantedBytes", m_stats.wanted_bytes);
+		Profiler::SetCounter("TextureStreaming.BudgetBytes", m_stats.budget_bytes);
+	}
+}
@@ -0,0 +1,125 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include "Texture2D.h"
+#include "container/Map.h"
+#include "container/List.h"
+#include "thread/Thread.h"
+
+namespace Viry3D
+{
+	class Camera;
+	class Renderer;
+	class ThreadPool;
+
+	//
+	//	mip residency of cooked ktx2 textures,
+	//	textures load with small levels only, render passes request levels by screen size,
+	//	Update streams levels in and drops them again within a memory budget
+	//
+	class TextureStreaming
+	{
+	public:
+		struct Stats
+		{
+			int texture_count;
+			int pending_count;
+			long long budget_bytes;
+			long long resident_bytes;
+			//
+			//	bytes of requested levels before budget applied
+			//
+			long long wanted_bytes;
+			int streamed_in_count;
+			int streamed_out_count;
+		};
+
+		static const int MaxPendingLoads = 2;
+		//
+		//	frames without request before a texture drops back to start level
+		//
+		static const int EvictFrames = 60;
+
+		static void Init();
+		static void Deinit();
+		static void SetEnable(bool enable) { m_enable = enable; }
+		static bool IsEnable() { return m_enable; }
+		static void SetBudget(long long bytes) { m_budget = bytes; }
+		static long long GetBudget() { return m_budget; }
+		//
+		//	levels larger than size are not loaded until requested
+		//
+		static void SetStartSize(int size) { m_start_size = size; }
+		static int GetStartSize() { return m_start_size; }
+		//
+		//	thread safe, load cooked ktx2 with small levels only and register it,
+		//	texture with full chain not larger than start size loads as usual
+		//
+		static Ref<Texture2D> Load(const String& path, TextureWrapMode wrap_mode, FilterMode filter_mode);
+		static void Unregister(int id);
+		//
+		//	request levels for textures of renderers visible from camera, called after culling
+		//
+		static void RequestLevels(Camera* cam, const List<Renderer*>& renderers);
+		//
+		//	once per frame on main thread, publishes stats to Profiler counters
+		//
+		static void Update();
+		static const Stats& GetStats() { return m_stats; }
+
+	private:
+		struct Entry
+		{
+			int id;
+			Texture2D* texture;
+			String path;
+			int width;
+			int height;
+			bool transcode;
+			int start_level;
+			int resident_level;
+			int requested_level;
+			int wanted_level;
+			int last_request_frame;
+			bool loading;
+			bool failed;
+			Vector<int> level_bytes;
+			//
+			//	cpu copy of resident levels above start level, drops rebuild from it without file reads,
+			//	empty at start level
+			//
+			Vector<ByteBuffer> levels;
+		};
+
+		static long long GetResidentBytes(const Entry& entry, int level);
+		static void LoadLevels(Entry& entry, int level);
+		static void DropLevels(Entry& entry, int level);
+
+		static bool m_enable;
+		static long long m_budget;
+		static int m_start_size;
+		static int m_frame;
+		static int m_next_id;
+		static Map<int, Entry> m_entries;
+		static Mutex m_mutex;
+		static Ref<ThreadPool> m_thread_pool;
+		static Stats m_stats;
+	};
+}
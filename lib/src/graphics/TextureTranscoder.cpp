@@ -0,0 +1,1318 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "TextureTranscoder.h"
+#include "Texture2D.h"
+#include "KTX2.h"
+#include "io/File.h"
+#include "math/Mathf.h"
+#include "memory/Memory.h"
+
+namespace Viry3D
+{
+	static const int ETC1_MODIFIERS[8][4] = {
+		{ 2, 8, -2, -8 },
+		{ 5, 17, -5, -17 },
+		{ 9, 29, -9, -29 },
+		{ 13, 42, -13, -42 },
+		{ 18, 60, -18, -60 },
+		{ 24, 80, -24, -80 },
+		{ 33, 106, -33, -106 },
+		{ 47, 183, -47, -183 },
+	};
+
+	static const int ETC2_DISTANCES[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+	static const int EAC_MODIFIERS[16][8] = {
+		{ -3, -6, -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5, -8, -13, 1, 4, 7, 12 },
+		{ -2, -4, -6, -13, 1, 3, 5, 12 },
+		{ -3, -6, -8, -12, 2, 5, 7, 11 },
+		{ -3, -7, -9, -11, 2, 6, 8, 10 },
+		{ -4, -7, -8, -11, 3, 6, 7, 10 },
+		{ -3, -5, -8, -11, 2, 4, 7, 10 },
+		{ -2, -6, -8, -10, 1, 5, 7, 9 },
+		{ -2, -5, -8, -10, 1, 4, 7, 9 },
+		{ -2, -4, -8, -10, 1, 3, 7, 9 },
+		{ -2, -5, -7, -10, 1, 4, 6, 9 },
+		{ -3, -4, -7, -10, 2, 3, 6, 9 },
+		{ -1, -2, -3, -10, 0, 1, 2, 9 },
+		{ -4, -6, -8, -9, 3, 5, 7, 8 },
+		{ -3, -5, -7, -9, 2, 4, 6, 8 },
+	};
+
+	struct BC7Mode
+	{
+		int subsets;
+		int partition_bits;
+		int rotation_bits;
+		int index_selection_bits;
+		int color_bits;
+		int alpha_bits;
+		int endpoint_pbits;
+		int shared_pbits;
+		int index_bits;
+		int index_bits2;
+	};
+
+	static const BC7Mode BC7_MODES[8] = {
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+	};
+
+	static const int BC7_WEIGHTS2[4] = { 0, 21, 43, 64 };
+	static const int BC7_WEIGHTS3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	static const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	//	bit i is subset of pixel i
+	static const unsigned short BC7_PARTITIONS2[64] = {
+		0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+		0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+		0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+		0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+		0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+		0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+		0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+		0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+	};
+
+	static const byte BC7_PARTITIONS3[64][16] = {
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+		{ 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+		{ 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+		{ 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+		{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+		{ 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+		{ 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+		{ 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+		{ 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+		{ 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+		{ 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+		{ 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+		{ 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+		{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+		{ 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+		{ 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+		{ 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+		{ 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+		{ 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+		{ 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+		{ 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+		{ 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+		{ 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+		{ 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+		{ 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+		{ 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+		{ 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+		{ 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+		{ 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+		{ 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+		{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+		{ 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+		{ 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+		{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+		{ 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+		{ 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+		{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+		{ 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+		{ 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+		{ 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+		{ 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+		{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+		{ 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 },
+	};
+
+	static const byte BC7_ANCHORS2[64] = {
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+		15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+		6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+	};
+
+	static const byte BC7_ANCHORS3_1[64] = {
+		3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+		3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+		8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+		3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+	};
+
+	static const byte BC7_ANCHORS3_2[64] = {
+		15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+		15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+		15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+		15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+	};
+
+	static inline int clamp255(int value)
+	{
+		return value < 0 ? 0 : (value > 255 ? 255 : value);
+	}
+
+	static inline unsigned long long read_be64(const byte* p)
+	{
+		unsigned long long value = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			value = (value << 8) | p[i];
+		}
+		return value;
+	}
+
+	static inline void write_be64(byte* p, unsigned long long value)
+	{
+		for (int i = 7; i >= 0; i--)
+		{
+			p[i] = (byte) (value & 0xff);
+			value >>= 8;
+		}
+	}
+
+	static inline int extend4(int value)
+	{
+		return (value << 4) | value;
+	}
+
+	static inline int extend5(int value)
+	{
+		return (value << 3) | (value >> 2);
+	}
+
+	static inline int extend6(int value)
+	{
+		return (value << 2) | (value >> 4);
+	}
+
+	static inline int extend7(int value)
+	{
+		return (value << 1) | (value >> 6);
+	}
+
+	static inline unsigned int bits(unsigned long long value, int high, int low)
+	{
+		return (unsigned int) ((value >> low) & ((1ull << (high - low + 1)) - 1));
+	}
+
+	//	lsb first reader over a 128 bit bc7 block
+	struct BlockBitReader
+	{
+		const byte* data;
+		int pos;
+
+		BlockBitReader(const byte* block): data(block), pos(0) { }
+
+		int Read(int count)
+		{
+			int value = 0;
+			for (int i = 0; i < count; i++)
+			{
+				value |= ((data[pos >> 3] >> (pos & 7)) & 1) << i;
+				pos++;
+			}
+			return value;
+		}
+	};
+
+	struct BlockBitWriter
+	{
+		byte* data;
+		int pos;
+
+		BlockBitWriter(byte* block): data(block), pos(0) { }
+
+		void Write(int value, int count)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				data[pos >> 3] |= ((value >> i) & 1) << (pos & 7);
+				pos++;
+			}
+		}
+	};
+
+	bool TextureTranscoder::IsCompressed(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::ETC2_RGB8:
+			case TextureFormat::ETC2_RGBA8:
+			case TextureFormat::ASTC_4x4:
+			case TextureFormat::BC7:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	int TextureTranscoder::GetBlockSize(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::ETC2_RGB8:
+				return 8;
+			case TextureFormat::ETC2_RGBA8:
+			case TextureFormat::ASTC_4x4:
+			case TextureFormat::BC7:
+				return 16;
+			case TextureFormat::RGBA32:
+				return 4;
+			case TextureFormat::RGB24:
+				return 3;
+			case TextureFormat::R8:
+				return 1;
+			default:
+				return 0;
+		}
+	}
+
+	int TextureTranscoder::GetLevelSize(TextureFormat format, int width, int height)
+	{
+		if (IsCompressed(format))
+		{
+			return ((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+		}
+		else
+		{
+			return width * height * GetBlockSize(format);
+		}
+	}
+
+	bool TextureTranscoder::CanDecode(TextureFormat format)
+	{
+		return format == TextureFormat::ETC2_RGB8 || format == TextureFormat::ETC2_RGBA8 || format == TextureFormat::BC7;
+	}
+
+	bool TextureTranscoder::CanEncode(TextureFormat format)
+	{
+		return CanDecode(format);
+	}
+
+	void TextureTranscoder::DecodeETC2Block(const byte* block, byte* out)
+	{
+		unsigned long long b = read_be64(block);
+		int paint[4][3];
+		int colors[2][3];
+		bool planar = false;
+		bool t_mode = false;
+		bool h_mode = false;
+
+		if (bits(b, 33, 33) == 0)
+		{
+			colors[0][0] = extend4(bits(b, 63, 60));
+			colors[1][0] = extend4(bits(b, 59, 56));
+			colors[0][1] = extend4(bits(b, 55, 52));
+			colors[1][1] = extend4(bits(b, 51, 48));
+			colors[0][2] = extend4(bits(b, 47, 44));
+			colors[1][2] = extend4(bits(b, 43, 40));
+		}
+		else
+		{
+			int base[3];
+			int delta[3];
+			for (int c = 0; c < 3; c++)
+			{
+				base[c] = bits(b, 63 - c * 8, 59 - c * 8);
+				delta[c] = bits(b, 58 - c * 8, 56 - c * 8);
+				if (delta[c] >= 4)
+				{
+					delta[c] -= 8;
+				}
+			}
+
+			if (base[0] + delta[0] < 0 || base[0] + delta[0] > 31)
+			{
+				t_mode = true;
+			}
+			else if (base[1] + delta[1] < 0 || base[1] + delta[1] > 31)
+			{
+				h_mode = true;
+			}
+			else if (base[2] + delta[2] < 0 || base[2] + delta[2] > 31)
+			{
+				planar = true;
+			}
+			else
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					colors[0][c] = extend5(base[c]);
+					colors[1][c] = extend5(base[c] + delta[c]);
+				}
+			}
+		}
+
+		if (planar)
+		{
+			int o[3];
+			int h[3];
+			int v[3];
+			o[0] = extend6(bits(b, 62, 57));
+			o[1] = extend7((bits(b, 56, 56) << 6) | bits(b, 54, 49));
+			o[2] = extend6((bits(b, 48, 48) << 5) | (bits(b, 44, 43) << 3) | bits(b, 41, 39));
+			h[0] = extend6((bits(b, 38, 34) << 1) | bits(b, 32, 32));
+			h[1] = extend7(bits(b, 31, 25));
+			h[2] = extend6(bits(b, 24, 19));
+			v[0] = extend6(bits(b, 18, 13));
+			v[1] = extend7(bits(b, 12, 6));
+			v[2] = extend6(bits(b, 5, 0));
+
+			for (int y = 0; y < 4; y++)
+			{
+				for (int x = 0; x < 4; x++)
+				{
+					byte* p = &out[(y * 4 + x) * 4];
+					for (int c = 0; c < 3; c++)
+					{
+						p[c] = (byte) clamp255((x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2);
+					}
+					p[3] = 255;
+				}
+			}
+			return;
+		}
+
+		if (t_mode || h_mode)
+		{
+			int c0[3];
+			int c1[3];
+			int distance;
+
+			if (t_mode)
+			{
+				c0[0] = extend4((bits(b, 60, 59) << 2) | bits(b, 57, 56));
+				c0[1] = extend4(bits(b, 55, 52));
+				c0[2] = extend4(bits(b, 51, 48));
+				c1[0] = extend4(bits(b, 47, 44));
+				c1[1] = extend4(bits(b, 43, 40));
+				c1[2] = extend4(bits(b, 39, 36));
+				distance = ETC2_DISTANCES[(bits(b, 35, 34) << 1) | bits(b, 32, 32)];
+
+				for (int c = 0; c < 3; c++)
+				{
+					paint[0][c] = c0[c];
+					paint[1][c] = clamp255(c1[c] + distance);
+					paint[2][c] = c1[c];
+					paint[3][c] = clamp255(c1[c] - distance);
+				}
+			}
+			else
+			{
+				c0[0] = extend4(bits(b, 62, 59));
+				c0[1] = extend4((bits(b, 58, 56) << 1) | bits(b, 52, 52));
+				c0[2] = extend4((bits(b, 51, 51) << 3) | bits(b, 49, 47));
+				c1[0] = extend4(bits(b, 46, 43));
+				c1[1] = extend4(bits(b, 42, 39));
+				c1[2] = extend4(bits(b, 38, 35));
+				int order = ((c0[0] << 16) | (c0[1] << 8) | c0[2]) >= ((c1[0] << 16) | (c1[1] << 8) | c1[2]) ? 1 : 0;
+				distance = ETC2_DISTANCES[(bits(b, 34, 34) << 2) | (bits(b, 32, 32) << 1) | order];
+
+				for (int c = 0; c < 3; c++)
+				{
+					paint[0][c] = clamp255(c0[c] + distance);
+					paint[1][c] = clamp255(c0[c] - distance);
+					paint[2][c] = clamp255(c1[c] + distance);
+					paint[3][c] = clamp255(c1[c] - distance);
+				}
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int x = i >> 2;
+				int y = i & 3;
+				int index = (bits(b, 16 + i, 16 + i) << 1) | bits(b, i, i);
+				byte* p = &out[(y * 4 + x) * 4];
+				p[0] = (byte) paint[index][0];
+				p[1] = (byte) paint[index][1];
+				p[2] = (byte) paint[index][2];
+				p[3] = 255;
+			}
+			return;
+		}
+
+		int tables[2] = { (int) bits(b, 39, 37), (int) bits(b, 36, 34) };
+		bool flip = bits(b, 32, 32) != 0;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int x = i >> 2;
+			int y = i & 3;
+			int sub = flip ? (y >> 1) : (x >> 1);
+			int index = (bits(b, 16 + i, 16 + i) << 1) | bits(b, i, i);
+			int modifier = ETC1_MODIFIERS[tables[sub]][index];
+			byte* p = &out[(y * 4 + x) * 4];
+			p[0] = (byte) clamp255(colors[sub][0] + modifier);
+			p[1] = (byte) clamp255(colors[sub][1] + modifier);
+			p[2] = (byte) clamp255(colors[sub][2] + modifier);
+			p[3] = 255;
+		}
+	}
+
+	void TextureTranscoder::DecodeEACAlphaBlock(const byte* block, byte* out)
+	{
+		unsigned long long b = read_be64(block);
+		int base = bits(b, 63, 56);
+		int multiplier = bits(b, 55, 52);
+		const int* modifiers = EAC_MODIFIERS[bits(b, 51, 48)];
+
+		for (int i = 0; i < 16; i++)
+		{
+			int x = i >> 2;
+			int y = i & 3;
+			int index = bits(b, 47 - i * 3, 45 - i * 3);
+			out[(y * 4 + x) * 4 + 3] = (byte) clamp255(base + modifiers[index] * multiplier);
+		}
+	}
+
+	void TextureTranscoder::DecodeBC7Block(const byte* block, byte* out)
+	{
+		int mode_index = 0;
+		while (mode_index < 8 && (block[0] & (1 << mode_index)) == 0)
+		{
+			mode_index++;
+		}
+
+		if (mode_index == 8)
+		{
+			Memory::Zero(out, 64);
+			return;
+		}
+
+		const BC7Mode& mode = BC7_MODES[mode_index];
+		BlockBitReader reader(block);
+		reader.Read(mode_index + 1);
+
+		int partition = reader.Read(mode.partition_bits);
+		int rotation = reader.Read(mode.rotation_bits);
+		int index_selection = reader.Read(mode.index_selection_bits);
+
+		int endpoints[3][2][4];
+		for (int c = 0; c < 3; c++)
+		{
+			for (int s = 0; s < mode.subsets; s++)
+			{
+				endpoints[s][0][c] = reader.Read(mode.color_bits);
+				endpoints[s][1][c] = reader.Read(mode.color_bits);
+			}
+		}
+		for (int s = 0; s < mode.subsets; s++)
+		{
+			for (int e = 0; e < 2; e++)
+			{
+				endpoints[s][e][3] = mode.alpha_bits > 0 ? reader.Read(mode.alpha_bits) : 255;
+			}
+		}
+
+		int color_bits = mode.color_bits;
+		int alpha_bits = mode.alpha_bits;
+		if (mode.endpoint_pbits || mode.shared_pbits)
+		{
+			int pbits[3][2];
+			for (int s = 0; s < mode.subsets; s++)
+			{
+				if (mode.endpoint_pbits)
+				{
+					pbits[s][0] = reader.Read(1);
+					pbits[s][1] = reader.Read(1);
+				}
+				else
+				{
+					pbits[s][0] = pbits[s][1] = reader.Read(1);
+				}
+			}
+			for (int s = 0; s < mode.subsets; s++)
+			{
+				for (int e = 0; e < 2; e++)
+				{
+					for (int c = 0; c < (alpha_bits > 0 ? 4 : 3); c++)
+					{
+						endpoints[s][e][c] = (endpoints[s][e][c] << 1) | pbits[s][e];
+					}
+				}
+			}
+			color_bits++;
+			if (alpha_bits > 0)
+			{
+				alpha_bits++;
+			}
+		}
+
+		for (int s = 0; s < mode.subsets; s++)
+		{
+			for (int e = 0; e < 2; e++)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					int v = endpoints[s][e][c] << (8 - color_bits);
+					endpoints[s][e][c] = v | (v >> color_bits);
+				}
+				if (alpha_bits > 0)
+				{
+					int v = endpoints[s][e][3] << (8 - alpha_bits);
+					endpoints[s][e][3] = v | (v >> alpha_bits);
+				}
+			}
+		}
+
+		int subsets[16];
+		for (int i = 0; i < 16; i++)
+		{
+			if (mode.subsets == 1)
+			{
+				subsets[i] = 0;
+			}
+			else if (mode.subsets == 2)
+			{
+				subsets[i] = (BC7_PARTITIONS2[partition] >> i) & 1;
+			}
+			else
+			{
+				subsets[i] = BC7_PARTITIONS3[partition][i];
+			}
+		}
+
+		int indices[16];
+		for (int i = 0; i < 16; i++)
+		{
+			bool anchor = i == 0;
+			if (mode.subsets == 2 && subsets[i] == 1)
+			{
+				anchor = i == BC7_ANCHORS2[partition];
+			}
+			else if (mode.subsets == 3 && subsets[i] == 1)
+			{
+				anchor = i == BC7_ANCHORS3_1[partition];
+			}
+			else if (mode.subsets == 3 && subsets[i] == 2)
+			{
+				anchor = i == BC7_ANCHORS3_2[partition];
+			}
+			indices[i] = reader.Read(anchor ? mode.index_bits - 1 : mode.index_bits);
+		}
+
+		int indices2[16];
+		if (mode.index_bits2 > 0)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				indices2[i] = reader.Read(i == 0 ? mode.index_bits2 - 1 : mode.index_bits2);
+			}
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			const int (*e)[4] = endpoints[subsets[i]];
+			int color_index = indices[i];
+			int alpha_index = indices[i];
+			int color_index_bits = mode.index_bits;
+			int alpha_index_bits = mode.index_bits;
+
+			if (mode.index_bits2 > 0)
+			{
+				if (index_selection == 0)
+				{
+					alpha_index = indices2[i];
+					alpha_index_bits = mode.index_bits2;
+				}
+				else
+				{
+					color_index = indices2[i];
+					color_index_bits = mode.index_bits2;
+				}
+			}
+
+			const int* color_weights = color_index_bits == 2 ? BC7_WEIGHTS2 : (color_index_bits == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS4);
+			const int* alpha_weights = alpha_index_bits == 2 ? BC7_WEIGHTS2 : (alpha_index_bits == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS4);
+			int cw = color_weights[color_index];
+			int aw = alpha_weights[alpha_index];
+
+			byte* p = &out[i * 4];
+			for (int c = 0; c < 3; c++)
+			{
+				p[c] = (byte) (((64 - cw) * e[0][c] + cw * e[1][c] + 32) >> 6);
+			}
+			p[3] = (byte) (((64 - aw) * e[0][3] + aw * e[1][3] + 32) >> 6);
+
+			if (rotation > 0)
+			{
+				byte t = p[3];
+				p[3] = p[rotation - 1];
+				p[rotation - 1] = t;
+			}
+		}
+	}
+
+	ByteBuffer TextureTranscoder::Decode(TextureFormat format, int width, int height, const ByteBuffer& data)
+	{
+		if (!CanDecode(format) || data.Size() < GetLevelSize(format, width, height))
+		{
+			return ByteBuffer();
+		}
+
+		ByteBuffer colors(width * height * 4);
+		int block_size = GetBlockSize(format);
+		int block_x_count = (width + 3) / 4;
+		int block_y_count = (height + 3) / 4;
+		byte pixels[64];
+
+		for (int by = 0; by < block_y_count; by++)
+		{
+			for (int bx = 0; bx < block_x_count; bx++)
+			{
+				const byte* block = &data.Bytes()[(by * block_x_count + bx) * block_size];
+
+				if (format == TextureFormat::ETC2_RGB8)
+				{
+					DecodeETC2Block(block, pixels);
+				}
+				else if (format == TextureFormat::ETC2_RGBA8)
+				{
+					DecodeETC2Block(block + 8, pixels);
+					DecodeEACAlphaBlock(block, pixels);
+				}
+				else
+				{
+					DecodeBC7Block(block, pixels);
+				}
+
+				int w = Mathf::Min(4, width - bx * 4);
+				int h = Mathf::Min(4, height - by * 4);
+				for (int y = 0; y < h; y++)
+				{
+					Memory::Copy(&colors[((by * 4 + y) * width + bx * 4) * 4], &pixels[y * 16], w * 4);
+				}
+			}
+		}
+
+		return colors;
+	}
+
+	static int etc1_subblock_error(const byte* pixels, const int* color, int table, bool flip, int sub, int* indices)
+	{
+		int error = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			int x = i >> 2;
+			int y = i & 3;
+			if ((flip ? (y >> 1) : (x >> 1)) != sub)
+			{
+				continue;
+			}
+
+			const byte* p = &pixels[(y * 4 + x) * 4];
+			int best = 0x7fffffff;
+			for (int j = 0; j < 4; j++)
+			{
+				int modifier = ETC1_MODIFIERS[table][j];
+				int dr = clamp255(color[0] + modifier) - p[0];
+				int dg = clamp255(color[1] + modifier) - p[1];
+				int db = clamp255(color[2] + modifier) - p[2];
+				int e = dr * dr + dg * dg + db * db;
+				if (e < best)
+				{
+					best = e;
+					indices[i] = j;
+				}
+			}
+			error += best;
+		}
+		return error;
+	}
+
+	void TextureTranscoder::EncodeETC2Block(const byte* pixels, byte* block)
+	{
+		//	individual and differential modes only, the etc1 compatible subset of etc2
+		unsigned long long best_bits = 0;
+		int best_error = 0x7fffffff;
+
+		for (int flip = 0; flip < 2; flip++)
+		{
+			int average[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+			for (int i = 0; i < 16; i++)
+			{
+				int x = i >> 2;
+				int y = i & 3;
+				int sub = flip ? (y >> 1) : (x >> 1);
+				for (int c = 0; c < 3; c++)
+				{
+					average[sub][c] += pixels[(y * 4 + x) * 4 + c];
+				}
+			}
+
+			for (int differential = 0; differential < 2; differential++)
+			{
+				int quant[2][3];
+				int colors[2][3];
+				bool valid = true;
+
+				for (int s = 0; s < 2; s++)
+				{
+					for (int c = 0; c < 3; c++)
+					{
+						if (differential)
+						{
+							quant[s][c] = Mathf::Clamp((average[s][c] * 31 + 255 * 4) / (255 * 8), 0, 31);
+							colors[s][c] = extend5(quant[s][c]);
+						}
+						else
+						{
+							quant[s][c] = Mathf::Clamp((average[s][c] * 15 + 255 * 4) / (255 * 8), 0, 15);
+							colors[s][c] = extend4(quant[s][c]);
+						}
+					}
+				}
+
+				if (differential)
+				{
+					for (int c = 0; c < 3; c++)
+					{
+						int delta = quant[1][c] - quant[0][c];
+						if (delta < -4 || delta > 3)
+						{
+							valid = false;
+						}
+					}
+				}
+
+				if (!valid)
+				{
+					continue;
+				}
+
+				int error = 0;
+				int tables[2];
+				int indices[16];
+				for (int s = 0; s < 2; s++)
+				{
+					int sub_best = 0x7fffffff;
+					for (int t = 0; t < 8; t++)
+					{
+						int sub_indices[16];
+						int e = etc1_subblock_error(pixels, colors[s], t, flip != 0, s, sub_indices);
+						if (e < sub_best)
+						{
+							sub_best = e;
+							tables[s] = t;
+							for (int i = 0; i < 16; i++)
+							{
+								int x = i >> 2;
+								int y = i & 3;
+								if ((flip ? (y >> 1) : (x >> 1)) == s)
+								{
+									indices[i] = sub_indices[i];
+								}
+							}
+						}
+					}
+					error += sub_best;
+				}
+
+				if (error < best_error)
+				{
+					unsigned long long b = 0;
+					if (differential)
+					{
+						for (int c = 0; c < 3; c++)
+						{
+							b |= (unsigned long long) quant[0][c] << (59 - c * 8);
+							b |= (unsigned long long) ((quant[1][c] - quant[0][c]) & 7) << (56 - c * 8);
+						}
+					}
+					else
+					{
+						for (int c = 0; c < 3; c++)
+						{
+							b |= (unsigned long long) quant[0][c] << (60 - c * 8);
+							b |= (unsigned long long) quant[1][c] << (56 - c * 8);
+						}
+					}
+					b |= (unsigned long long) tables[0] << 37;
+					b |= (unsigned long long) tables[1] << 34;
+					b |= (unsigned long long) differential << 33;
+					b |= (unsigned long long) flip << 32;
+					for (int i = 0; i < 16; i++)
+					{
+						b |= (unsigned long long) (indices[i] >> 1) << (16 + i);
+						b |= (unsigned long long) (indices[i] & 1) << i;
+					}
+
+					best_error = error;
+					best_bits = b;
+				}
+			}
+		}
+
+		write_be64(block, best_bits);
+	}
+
+	void TextureTranscoder::EncodeEACAlphaBlock(const byte* pixels, byte* block)
+	{
+		int alphas[16];
+		int min = 255;
+		int max = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			int x = i >> 2;
+			int y = i & 3;
+			alphas[i] = pixels[(y * 4 + x) * 4 + 3];
+			min = Mathf::Min(min, alphas[i]);
+			max = Mathf::Max(max, alphas[i]);
+		}
+
+		unsigned long long best_bits = 0;
+		int best_error = 0x7fffffff;
+
+		if (min == max)
+		{
+			//	table 13 index 4 is zero modifier
+			best_bits = ((unsigned long long) min << 56) | (1ull << 52) | (13ull << 48);
+			for (int i = 0; i < 16; i++)
+			{
+				best_bits |= 4ull << (45 - i * 3);
+			}
+			write_be64(block, best_bits);
+			return;
+		}
+
+		for (int t = 0; t < 16 && best_error > 0; t++)
+		{
+			const int* modifiers = EAC_MODIFIERS[t];
+			int low = modifiers[3];
+			int high = modifiers[7];
+			int multiplier_guess = (max - min + (high - low) - 1) / (high - low);
+
+			for (int m = multiplier_guess - 1; m <= multiplier_guess + 1; m++)
+			{
+				if (m < 1 || m > 15)
+				{
+					continue;
+				}
+
+				int base_guess = min - low * m;
+				for (int base = base_guess - 2; base <= base_guess + 2; base++)
+				{
+					if (base < 0 || base > 255)
+					{
+						continue;
+					}
+
+					int error = 0;
+					int indices[16];
+					for (int i = 0; i < 16 && error < best_error; i++)
+					{
+						int best = 0x7fffffff;
+						for (int j = 0; j < 8; j++)
+						{
+							int d = clamp255(base + modifiers[j] * m) - alphas[i];
+							if (d * d < best)
+							{
+								best = d * d;
+								indices[i] = j;
+							}
+						}
+						error += best;
+					}
+
+					if (error < best_error)
+					{
+						unsigned long long b = ((unsigned long long) base << 56) | ((unsigned long long) m << 52) | ((unsigned long long) t << 48);
+						for (int i = 0; i < 16; i++)
+						{
+							b |= (unsigned long long) indices[i] << (45 - i * 3);
+						}
+
+						best_error = error;
+						best_bits = b;
+					}
+				}
+			}
+		}
+
+		write_be64(block, best_bits);
+	}
+
+	void TextureTranscoder::EncodeBC7Block(const byte* pixels, byte* block)
+	{
+		//	mode 6, one subset, 7 bit rgba endpoints with unique p bits, 4 bit indices
+		float mean[4] = { 0, 0, 0, 0 };
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				mean[c] += pixels[i * 4 + c];
+			}
+		}
+		for (int c = 0; c < 4; c++)
+		{
+			mean[c] /= 16;
+		}
+
+		float cov[4][4] = { };
+		for (int i = 0; i < 16; i++)
+		{
+			float d[4];
+			for (int c = 0; c < 4; c++)
+			{
+				d[c] = pixels[i * 4 + c] - mean[c];
+			}
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					cov[r][c] += d[r] * d[c];
+				}
+			}
+		}
+
+		//	principal axis by power iteration
+		float axis[4] = { 1, 1, 1, 1 };
+		for (int iter = 0; iter < 8; iter++)
+		{
+			float next[4];
+			float length = 0;
+			for (int r = 0; r < 4; r++)
+			{
+				next[r] = cov[r][0] * axis[0] + cov[r][1] * axis[1] + cov[r][2] * axis[2] + cov[r][3] * axis[3];
+				length = Mathf::Max(length, fabsf(next[r]));
+			}
+			if (length < 1e-6f)
+			{
+				break;
+			}
+			for (int r = 0; r < 4; r++)
+			{
+				axis[r] = next[r] / length;
+			}
+		}
+
+		float axis_length2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+		float t_min = 0;
+		float t_max = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			float t = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				t += (pixels[i * 4 + c] - mean[c]) * axis[c];
+			}
+			t /= axis_length2;
+			t_min = Mathf::Min(t_min, t);
+			t_max = Mathf::Max(t_max, t);
+		}
+
+		int ends[2][4];
+		for (int c = 0; c < 4; c++)
+		{
+			ends[0][c] = clamp255((int) (mean[c] + axis[c] * t_min + 0.5f));
+			ends[1][c] = clamp255((int) (mean[c] + axis[c] * t_max + 0.5f));
+		}
+
+		int best_error = 0x7fffffff;
+		int best_quant[2][4];
+		int best_pbits[2];
+		int best_indices[16];
+
+		for (int pbits = 0; pbits < 4; pbits++)
+		{
+			int p[2] = { pbits & 1, pbits >> 1 };
+			int quant[2][4];
+			int unquant[2][4];
+			for (int e = 0; e < 2; e++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					quant[e][c] = Mathf::Clamp((ends[e][c] - p[e] + 1) >> 1, 0, 127);
+					unquant[e][c] = (quant[e][c] << 1) | p[e];
+				}
+			}
+
+			int palette[16][4];
+			for (int j = 0; j < 16; j++)
+			{
+				int w = BC7_WEIGHTS4[j];
+				for (int c = 0; c < 4; c++)
+				{
+					palette[j][c] = ((64 - w) * unquant[0][c] + w * unquant[1][c] + 32) >> 6;
+				}
+			}
+
+			int error = 0;
+			int indices[16];
+			for (int i = 0; i < 16 && error < best_error; i++)
+			{
+				const byte* px = &pixels[i * 4];
+				int best = 0x7fffffff;
+				for (int j = 0; j < 16; j++)
+				{
+					int e = 0;
+					for (int c = 0; c < 4; c++)
+					{
+						int d = palette[j][c] - px[c];
+						e += d * d;
+					}
+					if (e < best)
+					{
+						best = e;
+						indices[i] = j;
+					}
+				}
+				error += best;
+			}
+
+			if (error < best_error)
+			{
+				best_error = error;
+				Memory::Copy(best_quant, quant, sizeof(quant));
+				best_pbits[0] = p[0];
+				best_pbits[1] = p[1];
+				Memory::Copy(best_indices, indices, sizeof(indices));
+			}
+		}
+
+		//	anchor index msb must be zero
+		if (best_indices[0] & 8)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				int t = best_quant[0][c];
+				best_quant[0][c] = best_quant[1][c];
+				best_quant[1][c] = t;
+			}
+			int t = best_pbits[0];
+			best_pbits[0] = best_pbits[1];
+			best_pbits[1] = t;
+			for (int i = 0; i < 16; i++)
+			{
+				best_indices[i] = 15 - best_indices[i];
+			}
+		}
+
+		Memory::Zero(block, 16);
+		BlockBitWriter writer(block);
+		writer.Write(1 << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			writer.Write(best_quant[0][c], 7);
+			writer.Write(best_quant[1][c], 7);
+		}
+		writer.Write(best_pbits[0], 1);
+		writer.Write(best_pbits[1], 1);
+		for (int i = 0; i < 16; i++)
+		{
+			writer.Write(best_indices[i], i == 0 ? 3 : 4);
+		}
+	}
+
+	ByteBuffer TextureTranscoder::Encode(TextureFormat format, int width, int height, const ByteBuffer& colors)
+	{
+		if (!CanEncode(format) || colors.Size() < width * height * 4)
+		{
+			return ByteBuffer();
+		}
+
+		ByteBuffer data(GetLevelSize(format, width, height));
+		int block_size = GetBlockSize(format);
+		int block_x_count = (width + 3) / 4;
+		int block_y_count = (height + 3) / 4;
+		byte pixels[64];
+
+		for (int by = 0; by < block_y_count; by++)
+		{
+			for (int bx = 0; bx < block_x_count; bx++)
+			{
+				//	edge blocks repeat last row and column
+				for (int y = 0; y < 4; y++)
+				{
+					int sy = Mathf::Min(by * 4 + y, height - 1);
+					for (int x = 0; x < 4; x++)
+					{
+						int sx = Mathf::Min(bx * 4 + x, width - 1);
+						Memory::Copy(&pixels[(y * 4 + x) * 4], &colors.Bytes()[(sy * width + sx) * 4], 4);
+					}
+				}
+
+				byte* block = &data[(by * block_x_count + bx) * block_size];
+
+				if (format == TextureFormat::ETC2_RGB8)
+				{
+					EncodeETC2Block(pixels, block);
+				}
+				else if (format == TextureFormat::ETC2_RGBA8)
+				{
+					EncodeEACAlphaBlock(pixels, block);
+					EncodeETC2Block(pixels, block + 8);
+				}
+				else
+				{
+					EncodeBC7Block(pixels, block);
+				}
+			}
+		}
+
+		return data;
+	}
+
+	ByteBuffer TextureTranscoder::Downsample(int width, int height, const ByteBuffer& colors)
+	{
+		int w = Mathf::Max(width >> 1, 1);
+		int h = Mathf::Max(height >> 1, 1);
+		ByteBuffer result(w * h * 4);
+
+		for (int y = 0; y < h; y++)
+		{
+			int y0 = Mathf::Min(y * 2, height - 1);
+			int y1 = Mathf::Min(y * 2 + 1, height - 1);
+			for (int x = 0; x < w; x++)
+			{
+				int x0 = Mathf::Min(x * 2, width - 1);
+				int x1 = Mathf::Min(x * 2 + 1, width - 1);
+				for (int c = 0; c < 4; c++)
+				{
+					int sum = colors[(y0 * width + x0) * 4 + c] + colors[(y0 * width + x1) * 4 + c] +
+						colors[(y1 * width + x0) * 4 + c] + colors[(y1 * width + x1) * 4 + c];
+					result[(y * w + x) * 4 + c] = (byte) ((sum + 2) >> 2);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	ByteBuffer TextureTranscoder::ToRGBA32(TextureFormat format, int width, int height, const ByteBuffer& colors)
+	{
+		if (format == TextureFormat::RGBA32)
+		{
+			return colors;
+		}
+
+		int pixel_count = width * height;
+		ByteBuffer result(pixel_count * 4);
+
+		if (format == TextureFormat::RGB24)
+		{
+			for (int i = 0; i < pixel_count; i++)
+			{
+				result[i * 4 + 0] = colors[i * 3 + 0];
+				result[i * 4 + 1] = colors[i * 3 + 1];
+				result[i * 4 + 2] = colors[i * 3 + 2];
+				result[i * 4 + 3] = 255;
+			}
+		}
+		else if (format == TextureFormat::R8)
+		{
+			for (int i = 0; i < pixel_count; i++)
+			{
+				result[i * 4 + 0] = colors[i];
+				result[i * 4 + 1] = colors[i];
+				result[i * 4 + 2] = colors[i];
+				result[i * 4 + 3] = 255;
+			}
+		}
+		else
+		{
+			return ByteBuffer();
+		}
+
+		return result;
+	}
+
+	bool TextureTranscoder::Cook(const ByteBuffer& image_file, TextureFormat format, bool mipmap, ByteBuffer& ktx2)
+	{
+		if (!CanEncode(format))
+		{
+			return false;
+		}
+
+		ByteBuffer colors;
+		int width;
+		int height;
+		TextureFormat image_format;
+		if (!Texture2D::LoadImageData(image_file, colors, width, height, image_format))
+		{
+			return false;
+		}
+
+		KTX2::Image image;
+		image.width = width;
+		image.height = height;
+		image.format = format;
+
+		colors = ToRGBA32(image_format, width, height, colors);
+		while (true)
+		{
+			image.levels.Add(Encode(format, width, height, colors));
+
+			if (!mipmap || (width == 1 && height == 1))
+			{
+				break;
+			}
+
+			colors = Downsample(width, height, colors);
+			width = Mathf::Max(width >> 1, 1);
+			height = Mathf::Max(height >> 1, 1);
+		}
+
+		ktx2 = KTX2::Save(image);
+
+		return true;
+	}
+
+	bool TextureTranscoder::CookFile(const String& image_path, const String& ktx2_path, TextureFormat format, bool mipmap)
+	{
+		if (!File::Exist(image_path))
+		{
+			return false;
+		}
+
+		ByteBuffer ktx2;
+		if (!Cook(File::ReadAllBytes(image_path), format, mipmap, ktx2))
+		{
+			return false;
+		}
+
+		File::WriteAllBytes(ktx2_path, ktx2);
+
+		return true;
+	}
+}
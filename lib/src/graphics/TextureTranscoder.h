@@ -0,0 +1,72 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include "TextureFormat.h"
+#include "memory/ByteBuffer.h"
+#include "string/String.h"
+
+namespace Viry3D
+{
+	//
+	//	cpu codecs for block compressed formats,
+	//	decode is the fallback when gpu has no support for a cooked format,
+	//	encode is used by texture cooking, no gpu needed for either
+	//
+	class TextureTranscoder
+	{
+	public:
+		static bool IsCompressed(TextureFormat format);
+		static int GetBlockSize(TextureFormat format);
+		//
+		//	bytes of one mip level, compressed formats round up to 4x4 blocks
+		//
+		static int GetLevelSize(TextureFormat format, int width, int height);
+		static bool CanDecode(TextureFormat format);
+		static bool CanEncode(TextureFormat format);
+		//
+		//	ETC2_RGB8, ETC2_RGBA8, BC7 to RGBA32,
+		//	return empty buffer if format not supported
+		//
+		static ByteBuffer Decode(TextureFormat format, int width, int height, const ByteBuffer& data);
+		//
+		//	RGBA32 to ETC2_RGB8, ETC2_RGBA8, BC7 (mode 6),
+		//	return empty buffer if format not supported
+		//
+		static ByteBuffer Encode(TextureFormat format, int width, int height, const ByteBuffer& colors);
+		//
+		//	RGBA32 2x2 box filter, odd size clamps to edge
+		//
+		static ByteBuffer Downsample(int width, int height, const ByteBuffer& colors);
+		static ByteBuffer ToRGBA32(TextureFormat format, int width, int height, const ByteBuffer& colors);
+		//
+		//	png or jpg file to ktx2 file in format, mip chain built offline
+		//
+		static bool Cook(const ByteBuffer& image_file, TextureFormat format, bool mipmap, ByteBuffer& ktx2);
+		static bool CookFile(const String& image_path, const String& ktx2_path, TextureFormat format, bool mipmap);
+
+	private:
+		static void DecodeETC2Block(const byte* block, byte* out);
+		static void DecodeEACAlphaBlock(const byte* block, byte* out);
+		static void DecodeBC7Block(const byte* block, byte* out);
+		static void EncodeETC2Block(const byte* pixels, byte* block);
+		static void EncodeEACAlphaBlock(const byte* pixels, byte* block);
+		static void EncodeBC7Block(const byte* pixels, byte* block);
+	};
+}
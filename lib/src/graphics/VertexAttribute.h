@@ -37,6 +37,13 @@ namespace Viry3D
 		BlendWeight,
 		BlendIndices,
 
+		// per instance, in ParticleInstance
+		ParticlePosition,
+		ParticleDirection,
+		ParticleSize,
+		ParticleColor,
+		ParticleUV,
+
 		Count
 	};
 
@@ -52,6 +59,19 @@ namespace Viry3D
 		Vector4 bone_indices;
 	};
 
+	//
+	//	one particle expanded to a quad in vertex shader,
+	//	zero direction length means billboard
+	//
+	struct ParticleInstance
+	{
+		Vector4 position;	// world position, w rotation in radians
+		Vector4 direction;	// world stretch direction, w stretch length
+		Vector2 size;
+		Color color;
+		Vector4 uv_scale_offset;
+	};
+
 	extern const char* VERTEX_ATTR_TYPES[(int) VertexAttributeType::Count];
 	extern const int VERTEX_ATTR_SIZES[(int) VertexAttributeType::Count];
 	extern const int VERTEX_ATTR_OFFSETS[(int) VertexAttributeType::Count];
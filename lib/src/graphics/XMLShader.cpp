@@ -48,16 +48,24 @@ namespace Viry3D
 		"Normal",
 		"Tangent",
 		"BlendWeight",
-		"BlendIndices"
+		"BlendIndices",
+		"ParticlePosition",
+		"ParticleDirection",
+		"ParticleSize",
+		"ParticleColor",
+		"ParticleUV"
 	};
 
 	const int VERTEX_ATTR_SIZES[(int) VertexAttributeType::Count] = {
-		12, 16, 8, 8, 12, 16, 16, 16
+		12, 16, 8, 8, 12, 16, 16, 16,
+		16, 16, 8, 16, 16
 	};
 
+	// offsets of per instance attributes are in ParticleInstance
 	const int VERTEX_ATTR_OFFSETS[(int) VertexAttributeType::Count] =
 	{
-		0, 12, 28, 36, 44, 56, 72, 88
+		0, 12, 28, 36, 44, 56, 72, 88,
+		0, 16, 32, 40, 56
 	};
 
 	void XMLShader::Clear()
@@ -66,6 +74,7 @@ namespace Viry3D
 		vss.Clear();
 		pss.Clear();
 		rss.Clear();
+		instancing = false;
 	}
 
 	void XMLShader::Load(const String& path)
@@ -79,9 +88,13 @@ namespace Viry3D
 		{
 			auto shader_ele = doc.FirstChildElement();
 			String shader_queue;
+			String shader_instancing;
 
 			try_get_attribute(this->name, shader_ele, "name");
 			try_get_attribute(shader_queue, shader_ele, "queue");
+			try_get_attribute(shader_instancing, shader_ele, "instancing");
+
+			this->instancing = shader_instancing == "true";
 
 			if (shader_queue == "Background")
 			{
@@ -181,11 +194,17 @@ namespace Viry3D
 									attr.type = (VertexAttributeType) i;
 									attr.size = VERTEX_ATTR_SIZES[i];
 									attr.offset = VERTEX_ATTR_OFFSETS[i];
+									attr.instance = i >= (int) VertexAttributeType::ParticlePosition;
 									break;
 								}
 							}
 
 							vs.attrs.Add(attr);
+
+							if (attr.instance)
+							{
+								vs.instance_stride = sizeof(ParticleInstance);
+							}
 						}
 					}
 
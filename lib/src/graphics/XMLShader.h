@@ -83,12 +83,15 @@ namespace Viry3D
 
 		int size;
 		int offset;
+		// read per instance from the instance buffer
+		bool instance;
 
 		XMLVertexAttribute():
 			type(VertexAttributeType::None),
 			location(-1),
 			size(0),
-			offset(0)
+			offset(0),
+			instance(false)
 		{
 		}
 	};
@@ -101,9 +104,12 @@ namespace Viry3D
 		XMLUniformBuffer uniform_buffer;
 		Vector<XMLVertexAttribute> attrs;
 		int stride;
+		// 0 if no per instance attributes
+		int instance_stride;
 
 		XMLVertexShader():
-			stride(0)
+			stride(0),
+			instance_stride(0)
 		{
 		}
 	};
@@ -195,6 +201,7 @@ namespace Viry3D
 	{
 		String name;
 		int queue;
+		bool instancing;
 
 		Vector<XMLPass> passes;
 		Vector<XMLVertexShader> vss;
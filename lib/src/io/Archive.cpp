@@ -0,0 +1,228 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "Archive.h"
+#include "File.h"
+#include "Debug.h"
+#include "zlib/zlib.h"
+#include <string.h>
+
+namespace Viry3D
+{
+	static_assert(sizeof(Archive::Header) == 24, "vpak header size");
+	static_assert(sizeof(Archive::Entry) == 32, "vpak entry size");
+
+	Vector<Ref<Archive::Pack>> Archive::m_packs;
+	Mutex Archive::m_mutex;
+
+	unsigned long long Archive::Hash(const char* str)
+	{
+		unsigned long long hash = 14695981039346656037ULL;
+
+		while (*str)
+		{
+			hash ^= (unsigned char) *str++;
+			hash *= 1099511628211ULL;
+		}
+
+		return hash;
+	}
+
+	bool Archive::Mount(const String& path, const String& root)
+	{
+		auto data = File::MapAllBytes(path);
+		if (data.Size() < (int) sizeof(Header))
+		{
+			return false;
+		}
+
+		auto header = (const Header*) data.Bytes();
+		if (memcmp(header->magic, "VPAK", 4) != 0 || header->version != Version)
+		{
+			Log("invalid vpak: %s", path.CString());
+			return false;
+		}
+
+		if (sizeof(Header) + (unsigned long long) header->entry_count * sizeof(Entry) > header->name_table_offset ||
+			header->name_table_offset > (unsigned long long) data.Size())
+		{
+			Log("invalid vpak index: %s", path.CString());
+			return false;
+		}
+
+		auto entries = (const Entry*) (data.Bytes() + sizeof(Header));
+		auto names = (const char*) (data.Bytes() + header->name_table_offset);
+
+		// name table ends where first entry data starts
+		unsigned long long names_end = (unsigned long long) data.Size();
+		for (unsigned int i = 0; i < header->entry_count; i++)
+		{
+			if (entries[i].offset >= header->name_table_offset && entries[i].offset < names_end)
+			{
+				names_end = entries[i].offset;
+			}
+		}
+
+		// every name must start before last nul of the table, so strcmp stays in the mapping
+		long long names_size = (long long) (names_end - header->name_table_offset);
+		while (names_size > 0 && names[names_size - 1] != 0)
+		{
+			names_size--;
+		}
+
+		for (unsigned int i = 0; i < header->entry_count; i++)
+		{
+			if ((long long) entries[i].name_offset >= names_size)
+			{
+				Log("invalid vpak name table: %s", path.CString());
+				return false;
+			}
+		}
+
+		auto pack = RefMake<Pack>();
+		pack->root = root.Replace("\\", "/");
+		pack->data = data;
+		pack->header = header;
+		pack->entries = entries;
+		pack->names = names;
+
+		m_mutex.lock();
+		m_packs.Add(pack);
+		m_mutex.unlock();
+
+		return true;
+	}
+
+	void Archive::UnmountAll()
+	{
+		m_mutex.lock();
+		m_packs.Clear();
+		m_mutex.unlock();
+	}
+
+	bool Archive::Find(const String& path, Ref<Pack>& pack, const Entry** entry)
+	{
+		// searched under lock, only a hit takes a pack ref
+		std::lock_guard<Mutex> lock(m_mutex);
+		const auto& packs = m_packs;
+
+		if (packs.Empty())
+		{
+			return false;
+		}
+
+		auto full_path = path.Replace("\\", "/");
+
+		// later mounted archive overrides earlier one
+		for (int i = packs.Size() - 1; i >= 0; i--)
+		{
+			auto& p = packs[i];
+			int root_size = p->root.Size();
+
+			if (full_path.Size() <= root_size + 1 || !full_path.StartsWith(p->root) || full_path[root_size] != '/')
+			{
+				continue;
+			}
+
+			const char* name = full_path.CString() + root_size + 1;
+			unsigned long long hash = Hash(name);
+
+			// lower bound of hash
+			int low = 0;
+			int high = (int) p->header->entry_count;
+			while (low < high)
+			{
+				int mid = (low + high) / 2;
+				if (p->entries[mid].hash < hash)
+				{
+					low = mid + 1;
+				}
+				else
+				{
+					high = mid;
+				}
+			}
+
+			for (int j = low; j < (int) p->header->entry_count && p->entries[j].hash == hash; j++)
+			{
+				if (strcmp(p->names + p->entries[j].name_offset, name) == 0)
+				{
+					pack = p;
+					*entry = &p->entries[j];
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool Archive::Exist(const String& path)
+	{
+		Ref<Pack> pack;
+		const Entry* entry;
+		return Find(path, pack, &entry);
+	}
+
+	bool Archive::ReadAllBytes(const String& path, ByteBuffer& buffer)
+	{
+		Ref<Pack> pack;
+		const Entry* entry;
+		if (!Find(path, pack, &entry))
+		{
+			return false;
+		}
+
+		if (entry->offset > (unsigned long long) pack->data.Size() ||
+			entry->stored_size > (unsigned long long) pack->data.Size() - entry->offset)
+		{
+			Log("vpak entry out of range: %s", path.CString());
+			return false;
+		}
+
+		byte* stored = pack->data.Bytes() + entry->offset;
+
+		if ((Compression) entry->compression == Compression::None)
+		{
+			// size is what caller reads, only stored bytes were range checked
+			if (entry->size != entry->stored_size)
+			{
+				Log("vpak stored entry size mismatch: %s", path.CString());
+				buffer = ByteBuffer();
+				return false;
+			}
+
+			buffer = ByteBuffer(stored, entry->size, pack);
+			return true;
+		}
+		else if ((Compression) entry->compression == Compression::Zlib)
+		{
+			buffer = ByteBuffer(entry->size);
+
+			uLongf size = entry->size;
+			if (uncompress(buffer.Bytes(), &size, stored, entry->stored_size) == Z_OK && size == entry->size)
+			{
+				return true;
+			}
+
+			Log("vpak entry uncompress failed: %s", path.CString());
+		}
+
+		buffer = ByteBuffer();
+		return false;
+	}
+}
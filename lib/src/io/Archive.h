@@ -0,0 +1,89 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "string/String.h"
+#include "memory/ByteBuffer.h"
+#include "container/Vector.h"
+#include "thread/Thread.h"
+
+namespace Viry3D
+{
+	//
+	//	packed asset archive (vpak), made by pack_assets.py,
+	//	header, entries sorted by path hash, name table, entry data aligned to 4KB,
+	//	mounted archive is mapped once, File resolves paths under root through it
+	//
+	class Archive
+	{
+	public:
+		static const unsigned int Version = 1;
+
+		enum class Compression
+		{
+			None = 0,
+			Zlib = 1,
+		};
+
+		struct Header
+		{
+			char magic[4];
+			unsigned int version;
+			unsigned int entry_count;
+			unsigned int alignment;
+			unsigned long long name_table_offset;
+		};
+
+		struct Entry
+		{
+			unsigned long long hash;
+			unsigned long long offset;
+			unsigned int size;
+			unsigned int stored_size;
+			unsigned int compression;
+			unsigned int name_offset;
+		};
+
+		//
+		//	fnv-1a 64 of path relative to root, '/' separated
+		//
+		static unsigned long long Hash(const char* str);
+		static bool Mount(const String& path, const String& root);
+		static void UnmountAll();
+		static bool Exist(const String& path);
+		//
+		//	not compressed entry returns buffer pointing into mapped archive
+		//
+		static bool ReadAllBytes(const String& path, ByteBuffer& buffer);
+
+	private:
+		struct Pack
+		{
+			String root;
+			ByteBuffer data;
+			const Header* header;
+			const Entry* entries;
+			const char* names;
+		};
+
+		static bool Find(const String& path, Ref<Pack>& pack, const Entry** entry);
+
+		static Vector<Ref<Pack>> m_packs;
+		static Mutex m_mutex;
+	};
+}
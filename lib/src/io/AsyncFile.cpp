@@ -0,0 +1,580 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "AsyncFile.h"
+#include "Archive.h"
+#include "thread/Thread.h"
+#include "math/Mathf.h"
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+#if !VR_WINDOWS
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define VR_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace Viry3D
+{
+	AsyncFile::Backend AsyncFile::m_backend = AsyncFile::Backend::Auto;
+	Ref<ThreadPool> AsyncFile::m_thread_pool;
+
+	static bool prepare_buffer(AsyncFile::Request& r, int size)
+	{
+		if (size < 0)
+		{
+			return false;
+		}
+
+		if (r.buffer.Size() < size)
+		{
+			r.buffer = ByteBuffer(size);
+		}
+		r.size = size;
+
+		return true;
+	}
+
+	static void read_blocking(AsyncFile::Request& r)
+	{
+		r.ok = false;
+		r.size = 0;
+
+		if (Archive::ReadAllBytes(r.path, r.buffer))
+		{
+			r.size = r.buffer.Size();
+			r.ok = true;
+			return;
+		}
+
+#if VR_WINDOWS
+		FILE* file = fopen(r.path.CString(), "rb");
+		if (file == NULL)
+		{
+			return;
+		}
+
+		fseek(file, 0, SEEK_END);
+		int size = (int) ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		if (prepare_buffer(r, size))
+		{
+			r.ok = (int) fread(r.buffer.Bytes(), 1, size, file) == size;
+		}
+
+		fclose(file);
+#else
+		int fd = ::open(r.path.CString(), O_RDONLY);
+		if (fd < 0)
+		{
+			return;
+		}
+
+		struct stat st;
+		if (::fstat(fd, &st) == 0 && st.st_size < 0x7fffffff && prepare_buffer(r, (int) st.st_size))
+		{
+			int offset = 0;
+			while (offset < r.size)
+			{
+				ssize_t n = ::read(fd, &r.buffer[offset], r.size - offset);
+				if (n < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				if (n <= 0)
+				{
+					break;
+				}
+				offset += (int) n;
+			}
+			r.ok = offset == r.size;
+		}
+
+		::close(fd);
+#endif
+	}
+
+#if VR_IO_URING
+	//
+	//	raw syscalls, no liburing dependency,
+	//	one ring per thread, submitting and reaping only on that thread
+	//
+	class IOUring
+	{
+	public:
+		IOUring():
+			m_fd(-1),
+			m_sq_ptr(MAP_FAILED),
+			m_cq_ptr(MAP_FAILED),
+			m_sqes(MAP_FAILED),
+			m_sq_size(0),
+			m_cq_size(0),
+			m_sqes_size(0)
+		{
+		}
+
+		~IOUring()
+		{
+			this->Close();
+		}
+
+		bool IsOpen() const { return m_fd >= 0; }
+
+		bool Open(unsigned int entries)
+		{
+			io_uring_params params;
+			memset(&params, 0, sizeof(params));
+
+			m_fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+			if (m_fd < 0)
+			{
+				return false;
+			}
+
+			m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+			m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (single_mmap)
+			{
+				m_sq_size = m_cq_size = Mathf::Max(m_sq_size, m_cq_size);
+			}
+
+			m_sq_ptr = mmap(NULL, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+			if (single_mmap)
+			{
+				m_cq_ptr = m_sq_ptr;
+			}
+			else
+			{
+				m_cq_ptr = mmap(NULL, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+			}
+			m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+			m_sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+			if (m_sq_ptr == MAP_FAILED || m_cq_ptr == MAP_FAILED || m_sqes == MAP_FAILED)
+			{
+				this->Close();
+				return false;
+			}
+
+			byte* sq = (byte*) m_sq_ptr;
+			m_sq_tail = (unsigned int*) (sq + params.sq_off.tail);
+			m_sq_mask = *(unsigned int*) (sq + params.sq_off.ring_mask);
+			m_sq_array = (unsigned int*) (sq + params.sq_off.array);
+
+			byte* cq = (byte*) m_cq_ptr;
+			m_cq_head = (unsigned int*) (cq + params.cq_off.head);
+			m_cq_tail = (unsigned int*) (cq + params.cq_off.tail);
+			m_cq_mask = *(unsigned int*) (cq + params.cq_off.ring_mask);
+			m_cqes = (io_uring_cqe*) (cq + params.cq_off.cqes);
+
+			return true;
+		}
+
+		void Close()
+		{
+			if (m_sqes != MAP_FAILED)
+			{
+				munmap(m_sqes, m_sqes_size);
+			}
+			if (m_cq_ptr != MAP_FAILED && m_cq_ptr != m_sq_ptr)
+			{
+				munmap(m_cq_ptr, m_cq_size);
+			}
+			if (m_sq_ptr != MAP_FAILED)
+			{
+				munmap(m_sq_ptr, m_sq_size);
+			}
+			if (m_fd >= 0)
+			{
+				close(m_fd);
+			}
+
+			m_fd = -1;
+			m_sq_ptr = MAP_FAILED;
+			m_cq_ptr = MAP_FAILED;
+			m_sqes = MAP_FAILED;
+		}
+
+		//
+		//	queue one read, caller keeps in flight count below ring size
+		//
+		void PrepareRead(int fd, void* buffer, int size, int offset, unsigned long long user_data)
+		{
+			unsigned int tail = *m_sq_tail;
+			unsigned int index = tail & m_sq_mask;
+
+			io_uring_sqe* sqe = &((io_uring_sqe*) m_sqes)[index];
+			memset(sqe, 0, sizeof(io_uring_sqe));
+			sqe->opcode = IORING_OP_READ;
+			sqe->fd = fd;
+			sqe->addr = (unsigned long long) (size_t) buffer;
+			sqe->len = (unsigned int) size;
+			sqe->off = (unsigned long long) offset;
+			sqe->user_data = user_data;
+
+			m_sq_array[index] = index;
+			__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+			m_to_submit++;
+		}
+
+		//
+		//	submit queued reads and wait for at least wait_count completions
+		//
+		bool Submit(int wait_count)
+		{
+			while (true)
+			{
+				int ret = (int) syscall(__NR_io_uring_enter, m_fd, m_to_submit, wait_count, wait_count > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+				if (ret >= 0)
+				{
+					m_to_submit -= Mathf::Min(ret, m_to_submit);
+					return true;
+				}
+				if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+				{
+					return false;
+				}
+			}
+		}
+
+		template<class F>
+		void Reap(F on_complete)
+		{
+			unsigned int head = *m_cq_head;
+			unsigned int tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+
+			while (head != tail)
+			{
+				const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+				on_complete(cqe.user_data, cqe.res);
+				head++;
+			}
+
+			__atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+		}
+
+	private:
+		int m_fd;
+		void* m_sq_ptr;
+		void* m_cq_ptr;
+		void* m_sqes;
+		size_t m_sq_size;
+		size_t m_cq_size;
+		size_t m_sqes_size;
+		unsigned int* m_sq_tail;
+		unsigned int m_sq_mask;
+		unsigned int* m_sq_array;
+		unsigned int* m_cq_head;
+		unsigned int* m_cq_tail;
+		unsigned int m_cq_mask;
+		io_uring_cqe* m_cqes;
+		int m_to_submit = 0;
+	};
+
+	static thread_local IOUring g_ring;
+
+	static bool read_uring(Vector<AsyncFile::Request>& requests)
+	{
+		if (!g_ring.IsOpen() && !g_ring.Open(AsyncFile::QueueDepth))
+		{
+			return false;
+		}
+
+		struct Slot
+		{
+			int request;
+			int fd;
+			int offset;
+		};
+
+		Vector<Slot> slots(AsyncFile::QueueDepth, { -1, -1, 0 });
+		Vector<int> free_slots;
+		for (int i = AsyncFile::QueueDepth - 1; i >= 0; i--)
+		{
+			free_slots.Add(i);
+		}
+
+		// short reads continue from where they stopped
+		Vector<int> resubmits;
+		int next = 0;
+		int in_flight = 0;
+
+		// failed reads, e.g. IORING_OP_READ not supported before 5.6, go the blocking way
+		auto finish = [&](int slot, bool ok) {
+			auto& r = requests[slots[slot].request];
+			close(slots[slot].fd);
+			slots[slot].fd = -1;
+			free_slots.Add(slot);
+			if (ok)
+			{
+				r.ok = true;
+			}
+			else
+			{
+				read_blocking(r);
+			}
+		};
+
+		// a short read reaped last can leave nothing in flight with a resubmit pending
+		while (next < requests.Size() || in_flight > 0 || !resubmits.Empty())
+		{
+			for (auto slot : resubmits)
+			{
+				auto& s = slots[slot];
+				auto& r = requests[s.request];
+				g_ring.PrepareRead(s.fd, &r.buffer[s.offset], r.size - s.offset, s.offset, slot);
+				in_flight++;
+			}
+			resubmits.Clear();
+
+			while (next < requests.Size() && !free_slots.Empty())
+			{
+				auto& r = requests[next];
+				int request = next++;
+
+				r.ok = false;
+				r.size = 0;
+
+				if (Archive::ReadAllBytes(r.path, r.buffer))
+				{
+					r.size = r.buffer.Size();
+					r.ok = true;
+					continue;
+				}
+
+				// open and stat hit the dentry cache, the read is what blocks
+				int fd = ::open(r.path.CString(), O_RDONLY);
+				if (fd < 0)
+				{
+					continue;
+				}
+
+				struct stat st;
+				if (::fstat(fd, &st) != 0 || st.st_size >= 0x7fffffff || !prepare_buffer(r, (int) st.st_size))
+				{
+					close(fd);
+					continue;
+				}
+
+				if (r.size == 0)
+				{
+					close(fd);
+					r.ok = true;
+					continue;
+				}
+
+				int slot = free_slots[free_slots.Size() - 1];
+				free_slots.Resize(free_slots.Size() - 1);
+				slots[slot] = { request, fd, 0 };
+
+				g_ring.PrepareRead(fd, r.buffer.Bytes(), r.size, 0, slot);
+				in_flight++;
+			}
+
+			if (in_flight == 0)
+			{
+				continue;
+			}
+
+			if (!g_ring.Submit(1))
+			{
+				// ring unusable, read the rest the blocking way
+				g_ring.Close();
+				for (int i = 0; i < slots.Size(); i++)
+				{
+					if (slots[i].fd >= 0)
+					{
+						finish(i, false);
+					}
+				}
+				for (int i = next; i < requests.Size(); i++)
+				{
+					read_blocking(requests[i]);
+				}
+				return true;
+			}
+
+			g_ring.Reap([&](unsigned long long user_data, int res) {
+				int slot = (int) user_data;
+				auto& s = slots[slot];
+				auto& r = requests[s.request];
+				in_flight--;
+
+				if (res == -EINTR || res == -EAGAIN)
+				{
+					resubmits.Add(slot);
+				}
+				else if (res <= 0)
+				{
+					finish(slot, false);
+				}
+				else
+				{
+					s.offset += res;
+					if (s.offset < r.size)
+					{
+						resubmits.Add(slot);
+					}
+					else
+					{
+						finish(slot, true);
+					}
+				}
+			});
+		}
+
+		return true;
+	}
+#endif
+
+	//
+	//	kept alive by late workers after ReadAll returned,
+	//	they only compare against count and never touch requests then
+	//
+	struct ReadBatch
+	{
+		AsyncFile::Request* requests;
+		int count;
+		std::atomic<int> next;
+		int done;
+		Mutex mutex;
+		std::condition_variable condition;
+	};
+
+	static void read_batch(ReadBatch* batch)
+	{
+		while (true)
+		{
+			int i = batch->next.fetch_add(1);
+			if (i >= batch->count)
+			{
+				break;
+			}
+
+			read_blocking(batch->requests[i]);
+
+			std::lock_guard<Mutex> lock(batch->mutex);
+			batch->done++;
+			if (batch->done == batch->count)
+			{
+				batch->condition.notify_all();
+			}
+		}
+	}
+
+	void AsyncFile::Init(Backend backend, int thread_count)
+	{
+#if VR_IO_URING
+		if (backend == Backend::Auto || backend == Backend::IOUring)
+		{
+			// probe once, android may deny io_uring to apps
+			IOUring ring;
+			if (ring.Open(QueueDepth))
+			{
+				m_backend = Backend::IOUring;
+				return;
+			}
+		}
+#endif
+
+		m_backend = Backend::ThreadPool;
+
+		if (thread_count < 0)
+		{
+			thread_count = 4;
+		}
+
+		if (thread_count > 0)
+		{
+			m_thread_pool = RefMake<ThreadPool>(thread_count);
+		}
+	}
+
+	void AsyncFile::Deinit()
+	{
+		if (m_thread_pool)
+		{
+			m_thread_pool->Wait();
+			m_thread_pool.reset();
+		}
+
+		m_backend = Backend::Auto;
+	}
+
+	void AsyncFile::ReadAll(Vector<Request>& requests)
+	{
+		if (requests.Empty())
+		{
+			return;
+		}
+
+#if VR_IO_URING
+		if (m_backend == Backend::IOUring && read_uring(requests))
+		{
+			return;
+		}
+#endif
+
+		if (!m_thread_pool || requests.Size() == 1)
+		{
+			for (auto& i : requests)
+			{
+				read_blocking(i);
+			}
+			return;
+		}
+
+		auto batch = RefMake<ReadBatch>();
+		batch->requests = &requests[0];
+		batch->count = requests.Size();
+		batch->next = 0;
+		batch->done = 0;
+
+		int worker_count = Mathf::Min(m_thread_pool->GetThreadCount(), requests.Size() - 1);
+		for (int i = 0; i < worker_count; i++)
+		{
+			m_thread_pool->AddTask({
+				[=]() {
+					read_batch(batch.get());
+					return Ref<Any>();
+				}
+			});
+		}
+
+		read_batch(batch.get());
+
+		std::unique_lock<Mutex> lock(batch->mutex);
+		batch->condition.wait(lock, [&]() {
+			return batch->done == batch->count;
+		});
+	}
+}
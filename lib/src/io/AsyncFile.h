@@ -0,0 +1,81 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include "string/String.h"
+#include "memory/ByteBuffer.h"
+#include "memory/Ref.h"
+#include "container/Vector.h"
+
+namespace Viry3D
+{
+	class ThreadPool;
+
+	//
+	//	batched whole file reads with many requests in flight,
+	//	io_uring where the kernel allows it, blocking reads on worker threads elsewhere,
+	//	requests complete out of order into their own buffers
+	//
+	class AsyncFile
+	{
+	public:
+		enum class Backend
+		{
+			Auto,
+			IOUring,
+			ThreadPool,
+		};
+
+		struct Request
+		{
+			String path;
+			//
+			//	read into if big enough, else allocated to file size,
+			//	packed archive entries point into the archive
+			//
+			ByteBuffer buffer;
+			int size;
+			bool ok;
+
+			Request(): size(0), ok(false) { }
+		};
+
+		//
+		//	max reads in flight per batch
+		//
+		static const int QueueDepth = 64;
+
+		//
+		//	Auto picks io_uring if ring setup succeeds,
+		//	thread_count -1 means 4 workers for ThreadPool backend
+		//
+		static void Init(Backend backend = Backend::Auto, int thread_count = -1);
+		static void Deinit();
+		static Backend GetBackend() { return m_backend; }
+		//
+		//	thread safe, read all and return when all done,
+		//	without Init reads one by one on caller thread
+		//
+		static void ReadAll(Vector<Request>& requests);
+
+	private:
+		static Backend m_backend;
+		static Ref<ThreadPool> m_thread_pool;
+	};
+}
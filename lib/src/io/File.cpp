@@ -17,18 +17,29 @@
 
 #include "File.h"
 #include "Directory.h"
+#include "Archive.h"
 #include "Debug.h"
 #include "zlib/unzip.h"
 #include <fstream>
 
 #if VR_WINDOWS
 #include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 namespace Viry3D
 {
 	bool File::Exist(const String& path)
 	{
+		if (Archive::Exist(path))
+		{
+			return true;
+		}
+
 		std::ifstream is(path.CString(), std::ios::binary);
 
 		bool exist = !(!is);
@@ -45,6 +56,11 @@ namespace Viry3D
 	{
 		ByteBuffer buffer;
 
+		if (Archive::ReadAllBytes(path, buffer))
+		{
+			return buffer;
+		}
+
 		std::ifstream is(path.CString(), std::ios::binary);
 		if (is)
 		{
@@ -61,6 +77,71 @@ namespace Viry3D
 		return buffer;
 	}
 
+	ByteBuffer File::MapAllBytes(const String& path)
+	{
+		ByteBuffer buffer;
+		if (Archive::ReadAllBytes(path, buffer))
+		{
+			return buffer;
+		}
+
+#if VR_WINDOWS
+		HANDLE file = ::CreateFileA(path.CString(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER size;
+			if (::GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart < 0x7fffffff)
+			{
+				HANDLE mapping = ::CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+				if (mapping != NULL)
+				{
+					void* bytes = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+					::CloseHandle(mapping);
+
+					if (bytes != NULL)
+					{
+						::CloseHandle(file);
+
+						Ref<void> owner(bytes, [](void* p) {
+							::UnmapViewOfFile(p);
+						});
+						return ByteBuffer((byte*) bytes, (int) size.QuadPart, owner);
+					}
+				}
+			}
+			::CloseHandle(file);
+		}
+#else
+		int fd = ::open(path.CString(), O_RDONLY);
+		if (fd >= 0)
+		{
+			struct stat st;
+			if (::fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size < 0x7fffffff)
+			{
+				int size = (int) st.st_size;
+				void* bytes = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				::close(fd);
+
+				if (bytes != MAP_FAILED)
+				{
+					::madvise(bytes, size, MADV_SEQUENTIAL);
+
+					Ref<void> owner(bytes, [size](void* p) {
+						::munmap(p, size);
+					});
+					return ByteBuffer((byte*) bytes, size, owner);
+				}
+			}
+			else
+			{
+				::close(fd);
+			}
+		}
+#endif
+
+		return ReadAllBytes(path);
+	}
+
 	void File::WriteAllBytes(const String& path, const ByteBuffer& buffer)
 	{
 		std::ofstream os(path.CString(), std::ios::binary);
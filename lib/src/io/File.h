@@ -27,6 +27,11 @@ namespace Viry3D
 	public:
 		static bool Exist(const String& path);
 		static ByteBuffer ReadAllBytes(const String& path);
+		//
+		//	read only use, pages mapped copy on write, unmapped when last buffer copy released,
+		//	falls back to ReadAllBytes if map failed
+		//
+		static ByteBuffer MapAllBytes(const String& path);
 		static void WriteAllBytes(const String& path, const ByteBuffer& buffer);
 		static String ReadAllText(const String& path);
 		static void WriteAllText(const String& path, const String& text);
@@ -25,6 +25,41 @@ namespace Viry3D
 		m_length = m_buffer.Size();
 	}
 
+	void MemoryStream::Close()
+	{
+		Stream::Close();
+
+		m_buffer = ByteBuffer();
+		m_position = 0;
+		m_length = 0;
+	}
+
+	const byte* MemoryStream::ReadPointer(int size)
+	{
+		if (size < 0 || m_position + size > m_length)
+		{
+			return nullptr;
+		}
+
+		const byte* bytes = &m_buffer[m_position];
+		Stream::Read(nullptr, size);
+
+		return bytes;
+	}
+
+	ByteBuffer MemoryStream::ReadBuffer(int size)
+	{
+		if (size <= 0 || m_position + size > m_length)
+		{
+			return ByteBuffer();
+		}
+
+		ByteBuffer buffer(m_buffer, m_position, size);
+		Stream::Read(nullptr, size);
+
+		return buffer;
+	}
+
 	int MemoryStream::Read(void* buffer, int size)
 	{
 		int pos = m_position;
@@ -53,8 +88,12 @@ namespace Viry3D
 
 	String MemoryStream::ReadString(int size)
 	{
-		ByteBuffer buffer(size);
-		Read(buffer.Bytes(), size);
-		return String(buffer);
+		const byte* str = ReadPointer(size);
+		if (str == nullptr || size <= 0)
+		{
+			return String();
+		}
+
+		return String((const char*) str, size);
 	}
 }
@@ -21,6 +21,7 @@
 #include "memory/ByteBuffer.h"
 #include "memory/Memory.h"
 #include "string/String.h"
+#include "container/Vector.h"
 #include <assert.h>
 
 namespace Viry3D
@@ -29,10 +30,32 @@ namespace Viry3D
 	{
 	public:
 		MemoryStream(const ByteBuffer& buffer);
+		//
+		//	release buffer, so a mapped file could be unmapped before stream destroyed
+		//
+		virtual void Close();
 		virtual int Read(void* buffer, int size);
+		//
+		//	pointer into buffer without copy, valid until buffer released,
+		//	returns null if less than size bytes left
+		//
+		const byte* ReadPointer(int size);
+		//
+		//	view into buffer without copy, keeps buffer alive,
+		//	empty if less than size bytes left
+		//
+		ByteBuffer ReadBuffer(int size);
 		virtual int Write(void* buffer, int size);
+		//
+		//	copied straight out of buffer, no virtual call
+		//
 		template<class T>
 		T Read();
+		//
+		//	resize v to count and fill it with one copy
+		//
+		template<class T>
+		void ReadArray(Vector<T>& v, int count);
 		template<class T>
 		void Write(const T& t);
 		String ReadString(int size);
@@ -45,10 +68,32 @@ namespace Viry3D
 	T MemoryStream::Read()
 	{
 		T t;
-		Read((void*) &t, sizeof(T));
+		if (m_position + (int) sizeof(T) <= m_length)
+		{
+			Memory::Copy(&t, &m_buffer[m_position], sizeof(T));
+			m_position += sizeof(T);
+		}
+		else
+		{
+			Read((void*) &t, sizeof(T));
+		}
 		return t;
 	}
 
+	template<class T>
+	void MemoryStream::ReadArray(Vector<T>& v, int count)
+	{
+		if (count > 0)
+		{
+			v.Resize(count);
+			Read(v.Bytes(), count * sizeof(T));
+		}
+		else
+		{
+			v.Clear();
+		}
+	}
+
 	template<class T>
 	void MemoryStream::Write(const T& t)
 	{
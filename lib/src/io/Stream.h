@@ -27,6 +27,8 @@ namespace Viry3D
 		virtual void Close();
 		virtual int Read(void* buffer, int size);
 		virtual int Write(void* buffer, int size);
+		int GetLength() const { return m_length; }
+		int GetPosition() const { return m_position; }
 
 	protected:
 		int m_position;
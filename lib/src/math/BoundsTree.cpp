@@ -0,0 +1,596 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "BoundsTree.h"
+
+namespace Viry3D
+{
+	static Vector3 min_vector3(const Vector3& a, const Vector3& b)
+	{
+		return Vector3(Mathf::Min(a.x, b.x), Mathf::Min(a.y, b.y), Mathf::Min(a.z, b.z));
+	}
+
+	static Vector3 max_vector3(const Vector3& a, const Vector3& b)
+	{
+		return Vector3(Mathf::Max(a.x, b.x), Mathf::Max(a.y, b.y), Mathf::Max(a.z, b.z));
+	}
+
+	static float surface_area(const Vector3& min, const Vector3& max)
+	{
+		Vector3 d = max - min;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+
+	static bool overlap(const Vector3& min_a, const Vector3& max_a, const Vector3& min_b, const Vector3& max_b)
+	{
+		return !(max_a.x < min_b.x || max_a.y < min_b.y || max_a.z < min_b.z ||
+			min_a.x > max_b.x || min_a.y > max_b.y || min_a.z > max_b.z);
+	}
+
+	static bool contains(const Vector3& min_a, const Vector3& max_a, const Vector3& min_b, const Vector3& max_b)
+	{
+		return min_a.x <= min_b.x && min_a.y <= min_b.y && min_a.z <= min_b.z &&
+			max_a.x >= max_b.x && max_a.y >= max_b.y && max_a.z >= max_b.z;
+	}
+
+	static bool ray_hit(const Vector3& min, const Vector3& max, const Ray& ray, float max_distance)
+	{
+		const Vector3& origin = ray.GetOrigin();
+		const Vector3& dir = ray.GetDirection();
+		float t_min = 0;
+		float t_max = max_distance;
+
+		for (int i = 0; i < 3; i++)
+		{
+			float o = (&origin.x)[i];
+			float d = (&dir.x)[i];
+			float lo = (&min.x)[i];
+			float hi = (&max.x)[i];
+
+			if (Mathf::FloatEqual(d, 0))
+			{
+				if (o < lo || o > hi)
+				{
+					return false;
+				}
+			}
+			else
+			{
+				float inv = 1.0f / d;
+				float t0 = (lo - o) * inv;
+				float t1 = (hi - o) * inv;
+				if (t0 > t1)
+				{
+					float t = t0;
+					t0 = t1;
+					t1 = t;
+				}
+
+				t_min = Mathf::Max(t_min, t0);
+				t_max = Mathf::Min(t_max, t1);
+				if (t_min > t_max)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	BoundsTree::BoundsTree(float margin):
+		m_root(NullNode),
+		m_free(NullNode),
+		m_proxy_count(0),
+		m_margin(margin)
+	{
+	}
+
+	void BoundsTree::Clear()
+	{
+		m_nodes.Clear();
+		m_root = NullNode;
+		m_free = NullNode;
+		m_proxy_count = 0;
+	}
+
+	int BoundsTree::GetHeight() const
+	{
+		if (m_root == NullNode)
+		{
+			return 0;
+		}
+
+		return m_nodes[m_root].height;
+	}
+
+	int BoundsTree::AllocNode()
+	{
+		int node;
+
+		if (m_free == NullNode)
+		{
+			node = m_nodes.Size();
+			m_nodes.Add(Node());
+		}
+		else
+		{
+			// free nodes linked by parent
+			node = m_free;
+			m_free = m_nodes[node].parent;
+			m_nodes[node] = Node();
+		}
+
+		return node;
+	}
+
+	void BoundsTree::FreeNode(int node)
+	{
+		m_nodes[node].parent = m_free;
+		m_nodes[node].data = NULL;
+		m_nodes[node].height = -1;
+		m_free = node;
+	}
+
+	int BoundsTree::Insert(const Bounds& bounds, void* data)
+	{
+		int leaf = AllocNode();
+
+		auto& node = m_nodes[leaf];
+		node.min = bounds.Min() - Vector3::One() * m_margin;
+		node.max = bounds.Max() + Vector3::One() * m_margin;
+		node.bounds = bounds;
+		node.data = data;
+		node.height = 0;
+
+		InsertLeaf(leaf);
+		m_proxy_count++;
+
+		return leaf;
+	}
+
+	void BoundsTree::Remove(int proxy)
+	{
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_proxy_count--;
+	}
+
+	bool BoundsTree::Move(int proxy, const Bounds& bounds)
+	{
+		m_nodes[proxy].bounds = bounds;
+
+		if (contains(m_nodes[proxy].min, m_nodes[proxy].max, bounds.Min(), bounds.Max()))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxy);
+
+		m_nodes[proxy].min = bounds.Min() - Vector3::One() * m_margin;
+		m_nodes[proxy].max = bounds.Max() + Vector3::One() * m_margin;
+
+		InsertLeaf(proxy);
+
+		return true;
+	}
+
+	void BoundsTree::InsertLeaf(int leaf)
+	{
+		if (m_root == NullNode)
+		{
+			m_root = leaf;
+			m_nodes[m_root].parent = NullNode;
+			return;
+		}
+
+		// find the best sibling by surface area cost
+		Vector3 leaf_min = m_nodes[leaf].min;
+		Vector3 leaf_max = m_nodes[leaf].max;
+		int index = m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const auto& node = m_nodes[index];
+			int child1 = node.child1;
+			int child2 = node.child2;
+
+			float area = surface_area(node.min, node.max);
+			float combined_area = surface_area(min_vector3(node.min, leaf_min), max_vector3(node.max, leaf_max));
+
+			// cost of creating a new parent for this node and the new leaf
+			float cost = 2.0f * combined_area;
+
+			// minimum cost of pushing the leaf further down the tree
+			float inheritance_cost = 2.0f * (combined_area - area);
+
+			float cost1;
+			{
+				const auto& c = m_nodes[child1];
+				float new_area = surface_area(min_vector3(c.min, leaf_min), max_vector3(c.max, leaf_max));
+				cost1 = c.IsLeaf() ? new_area + inheritance_cost : new_area - surface_area(c.min, c.max) + inheritance_cost;
+			}
+
+			float cost2;
+			{
+				const auto& c = m_nodes[child2];
+				float new_area = surface_area(min_vector3(c.min, leaf_min), max_vector3(c.max, leaf_max));
+				cost2 = c.IsLeaf() ? new_area + inheritance_cost : new_area - surface_area(c.min, c.max) + inheritance_cost;
+			}
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			index = cost1 < cost2 ? child1 : child2;
+		}
+
+		int sibling = index;
+
+		// create a new parent
+		int old_parent = m_nodes[sibling].parent;
+		int new_parent = AllocNode();
+		m_nodes[new_parent].parent = old_parent;
+		m_nodes[new_parent].min = min_vector3(leaf_min, m_nodes[sibling].min);
+		m_nodes[new_parent].max = max_vector3(leaf_max, m_nodes[sibling].max);
+		m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+		m_nodes[new_parent].child1 = sibling;
+		m_nodes[new_parent].child2 = leaf;
+		m_nodes[sibling].parent = new_parent;
+		m_nodes[leaf].parent = new_parent;
+
+		if (old_parent != NullNode)
+		{
+			if (m_nodes[old_parent].child1 == sibling)
+			{
+				m_nodes[old_parent].child1 = new_parent;
+			}
+			else
+			{
+				m_nodes[old_parent].child2 = new_parent;
+			}
+		}
+		else
+		{
+			m_root = new_parent;
+		}
+
+		// walk back up the tree fixing heights and bounds
+		index = m_nodes[leaf].parent;
+		while (index != NullNode)
+		{
+			index = Balance(index);
+
+			auto& node = m_nodes[index];
+			const auto& c1 = m_nodes[node.child1];
+			const auto& c2 = m_nodes[node.child2];
+			node.height = 1 + Mathf::Max(c1.height, c2.height);
+			node.min = min_vector3(c1.min, c2.min);
+			node.max = max_vector3(c1.max, c2.max);
+
+			index = node.parent;
+		}
+	}
+
+	void BoundsTree::RemoveLeaf(int leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NullNode;
+			return;
+		}
+
+		int parent = m_nodes[leaf].parent;
+		int grand_parent = m_nodes[parent].parent;
+		int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		if (grand_parent != NullNode)
+		{
+			// destroy parent and connect sibling to grand parent
+			if (m_nodes[grand_parent].child1 == parent)
+			{
+				m_nodes[grand_parent].child1 = sibling;
+			}
+			else
+			{
+				m_nodes[grand_parent].child2 = sibling;
+			}
+			m_nodes[sibling].parent = grand_parent;
+			FreeNode(parent);
+
+			int index = grand_parent;
+			while (index != NullNode)
+			{
+				index = Balance(index);
+
+				auto& node = m_nodes[index];
+				const auto& c1 = m_nodes[node.child1];
+				const auto& c2 = m_nodes[node.child2];
+				node.height = 1 + Mathf::Max(c1.height, c2.height);
+				node.min = min_vector3(c1.min, c2.min);
+				node.max = max_vector3(c1.max, c2.max);
+
+				index = node.parent;
+			}
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = NullNode;
+			FreeNode(parent);
+		}
+
+		m_nodes[leaf].parent = NullNode;
+	}
+
+	//
+	//	rotate a up if unbalanced, return the new root of the subtree
+	//
+	int BoundsTree::Balance(int a)
+	{
+		auto* A = &m_nodes[a];
+		if (A->IsLeaf() || A->height < 2)
+		{
+			return a;
+		}
+
+		int b = A->child1;
+		int c = A->child2;
+		auto* B = &m_nodes[b];
+		auto* C = &m_nodes[c];
+
+		int balance = C->height - B->height;
+
+		// rotate c up
+		if (balance > 1)
+		{
+			int f = C->child1;
+			int g = C->child2;
+			auto* F = &m_nodes[f];
+			auto* G = &m_nodes[g];
+
+			C->child1 = a;
+			C->parent = A->parent;
+			A->parent = c;
+
+			if (C->parent != NullNode)
+			{
+				if (m_nodes[C->parent].child1 == a)
+				{
+					m_nodes[C->parent].child1 = c;
+				}
+				else
+				{
+					m_nodes[C->parent].child2 = c;
+				}
+			}
+			else
+			{
+				m_root = c;
+			}
+
+			if (F->height > G->height)
+			{
+				C->child2 = f;
+				A->child2 = g;
+				G->parent = a;
+				A->min = min_vector3(B->min, G->min);
+				A->max = max_vector3(B->max, G->max);
+				C->min = min_vector3(A->min, F->min);
+				C->max = max_vector3(A->max, F->max);
+				A->height = 1 + Mathf::Max(B->height, G->height);
+				C->height = 1 + Mathf::Max(A->height, F->height);
+			}
+			else
+			{
+				C->child2 = g;
+				A->child2 = f;
+				F->parent = a;
+				A->min = min_vector3(B->min, F->min);
+				A->max = max_vector3(B->max, F->max);
+				C->min = min_vector3(A->min, G->min);
+				C->max = max_vector3(A->max, G->max);
+				A->height = 1 + Mathf::Max(B->height, F->height);
+				C->height = 1 + Mathf::Max(A->height, G->height);
+			}
+
+			return c;
+		}
+
+		// rotate b up
+		if (balance < -1)
+		{
+			int d = B->child1;
+			int e = B->child2;
+			auto* D = &m_nodes[d];
+			auto* E = &m_nodes[e];
+
+			B->child1 = a;
+			B->parent = A->parent;
+			A->parent = b;
+
+			if (B->parent != NullNode)
+			{
+				if (m_nodes[B->parent].child1 == a)
+				{
+					m_nodes[B->parent].child1 = b;
+				}
+				else
+				{
+					m_nodes[B->parent].child2 = b;
+				}
+			}
+			else
+			{
+				m_root = b;
+			}
+
+			if (D->height > E->height)
+			{
+				B->child2 = d;
+				A->child1 = e;
+				E->parent = a;
+				A->min = min_vector3(C->min, E->min);
+				A->max = max_vector3(C->max, E->max);
+				B->min = min_vector3(A->min, D->min);
+				B->max = max_vector3(A->max, D->max);
+				A->height = 1 + Mathf::Max(C->height, E->height);
+				B->height = 1 + Mathf::Max(A->height, D->height);
+			}
+			else
+			{
+				B->child2 = e;
+				A->child1 = d;
+				D->parent = a;
+				A->min = min_vector3(C->min, D->min);
+				A->max = max_vector3(C->max, D->max);
+				B->min = min_vector3(A->min, E->min);
+				B->max = max_vector3(A->max, E->max);
+				A->height = 1 + Mathf::Max(C->height, D->height);
+				B->height = 1 + Mathf::Max(A->height, E->height);
+			}
+
+			return b;
+		}
+
+		return a;
+	}
+
+	void BoundsTree::AddSubtree(int node, Vector<void*>& result) const
+	{
+		const auto& n = m_nodes[node];
+		if (n.IsLeaf())
+		{
+			result.Add(n.data);
+		}
+		else
+		{
+			AddSubtree(n.child1, result);
+			AddSubtree(n.child2, result);
+		}
+	}
+
+	void BoundsTree::QueryNode(int node, const Frustum& frustum, Vector<void*>& result, Vector<int>& leaves) const
+	{
+		const auto& n = m_nodes[node];
+		if (n.IsLeaf())
+		{
+			// tested in batch later
+			leaves.Add(node);
+		}
+		else
+		{
+			auto contains = frustum.ContainsBounds(n.min, n.max);
+			if (contains == ContainsResult::In)
+			{
+				// whole subtree inside, no more tests
+				AddSubtree(node, result);
+			}
+			else if (contains == ContainsResult::Cross)
+			{
+				QueryNode(n.child1, frustum, result, leaves);
+				QueryNode(n.child2, frustum, result, leaves);
+			}
+		}
+	}
+
+	void BoundsTree::Query(const Frustum& frustum, Vector<void*>& result) const
+	{
+		if (m_root == NullNode)
+		{
+			return;
+		}
+
+		Vector<int> leaves;
+		QueryNode(m_root, frustum, result, leaves);
+
+		int count = leaves.Size();
+		if (count > 0)
+		{
+			Vector<Vector3> mins(count);
+			Vector<Vector3> maxs(count);
+			Vector<byte> results(count);
+
+			for (int i = 0; i < count; i++)
+			{
+				const auto& bounds = m_nodes[leaves[i]].bounds;
+				mins[i] = bounds.Min();
+				maxs[i] = bounds.Max();
+			}
+
+			frustum.CullBounds(&mins[0].x, &maxs[0].x, count, &results[0]);
+
+			for (int i = 0; i < count; i++)
+			{
+				if (results[i] != (byte) ContainsResult::Out)
+				{
+					result.Add(m_nodes[leaves[i]].data);
+				}
+			}
+		}
+	}
+
+	void BoundsTree::QueryNode(int node, const Bounds& bounds, Vector<void*>& result) const
+	{
+		const auto& n = m_nodes[node];
+		if (n.IsLeaf())
+		{
+			if (overlap(n.bounds.Min(), n.bounds.Max(), bounds.Min(), bounds.Max()))
+			{
+				result.Add(n.data);
+			}
+		}
+		else if (overlap(n.min, n.max, bounds.Min(), bounds.Max()))
+		{
+			QueryNode(n.child1, bounds, result);
+			QueryNode(n.child2, bounds, result);
+		}
+	}
+
+	void BoundsTree::Query(const Bounds& bounds, Vector<void*>& result) const
+	{
+		if (m_root != NullNode)
+		{
+			QueryNode(m_root, bounds, result);
+		}
+	}
+
+	void BoundsTree::RaycastNode(int node, const Ray& ray, float max_distance, Vector<void*>& result) const
+	{
+		const auto& n = m_nodes[node];
+		if (n.IsLeaf())
+		{
+			if (ray_hit(n.bounds.Min(), n.bounds.Max(), ray, max_distance))
+			{
+				result.Add(n.data);
+			}
+		}
+		else if (ray_hit(n.min, n.max, ray, max_distance))
+		{
+			RaycastNode(n.child1, ray, max_distance, result);
+			RaycastNode(n.child2, ray, max_distance, result);
+		}
+	}
+
+	void BoundsTree::Raycast(const Ray& ray, float max_distance, Vector<void*>& result) const
+	{
+		if (m_root != NullNode)
+		{
+			RaycastNode(m_root, ray, max_distance, result);
+		}
+	}
+}
@@ -0,0 +1,95 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "Bounds.h"
+#include "Frustum.h"
+#include "Ray.h"
+#include "container/Vector.h"
+
+namespace Viry3D
+{
+	//
+	//	dynamic aabb tree,
+	//	leaves keep exact bounds for tests and fat bounds for the tree,
+	//	so small bounds changes do not need reinsert
+	//
+	class BoundsTree
+	{
+	public:
+		static const int NullNode = -1;
+
+		BoundsTree(float margin = 0.1f);
+		int Insert(const Bounds& bounds, void* data);
+		void Remove(int proxy);
+		//
+		//	return true if proxy reinserted
+		//
+		bool Move(int proxy, const Bounds& bounds);
+		void* GetData(int proxy) const { return m_nodes[proxy].data; }
+		const Bounds& GetBounds(int proxy) const { return m_nodes[proxy].bounds; }
+		int GetProxyCount() const { return m_proxy_count; }
+		int GetHeight() const;
+		void Clear();
+
+		//
+		//	all data whose bounds is in or cross frustum
+		//
+		void Query(const Frustum& frustum, Vector<void*>& result) const;
+		//
+		//	all data whose bounds overlap bounds
+		//
+		void Query(const Bounds& bounds, Vector<void*>& result) const;
+		//
+		//	all data whose bounds hit by ray within max_distance
+		//
+		void Raycast(const Ray& ray, float max_distance, Vector<void*>& result) const;
+
+	private:
+		struct Node
+		{
+			Vector3 min;
+			Vector3 max;
+			Bounds bounds;
+			void* data;
+			int parent;
+			int child1;
+			int child2;
+			int height;
+
+			Node(): bounds(Vector3(), Vector3()), data(NULL), parent(NullNode), child1(NullNode), child2(NullNode), height(-1) { }
+			bool IsLeaf() const { return child1 == NullNode; }
+		};
+
+		int AllocNode();
+		void FreeNode(int node);
+		void InsertLeaf(int leaf);
+		void RemoveLeaf(int leaf);
+		int Balance(int a);
+		void AddSubtree(int node, Vector<void*>& result) const;
+		void QueryNode(int node, const Frustum& frustum, Vector<void*>& result, Vector<int>& leaves) const;
+		void QueryNode(int node, const Bounds& bounds, Vector<void*>& result) const;
+		void RaycastNode(int node, const Ray& ray, float max_distance, Vector<void*>& result) const;
+
+		Vector<Node> m_nodes;
+		int m_root;
+		int m_free;
+		int m_proxy_count;
+		float m_margin;
+	};
+}
@@ -17,6 +17,22 @@
 
 #include "Frustum.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define VR_FRUSTUM_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VR_FRUSTUM_NEON 1
+#include <arm_neon.h>
+#endif
+
+// plane distances must round the same in simd and scalar paths,
+// so no multiply add is fused in this file, gcc builds pass -ffp-contract=off
+#if defined(_MSC_VER)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
 namespace Viry3D
 {
 	Frustum::Frustum(const Matrix4x4& mat)
@@ -170,19 +186,176 @@ namespace Viry3D
 		return ContainsResult::In;
 	}
 
+	//
+	//	each product and sum rounded by itself, in the order of the simd lanes
+	//
+	static inline float plane_distance(const Vector4& plane, float x, float y, float z)
+	{
+		float ax = plane.x * x;
+		float by = plane.y * y;
+		float cz = plane.z * z;
+		float d = ax + by;
+		d = d + cz;
+		d = d + plane.w;
+
+		return d;
+	}
+
 	ContainsResult Frustum::ContainsBounds(const Vector3& min, const Vector3& max) const
 	{
-		Vector<Vector3> corners(8);
-		corners[0] = max;
-		corners[1] = Vector3(min.x, max.y, max.z);
-		corners[2] = Vector3(max.x, min.y, max.z);
-		corners[3] = Vector3(max.x, max.y, min.z);
-		corners[4] = Vector3(min.x, min.y, max.z);
-		corners[5] = Vector3(min.x, max.y, min.z);
-		corners[6] = Vector3(max.x, min.y, min.z);
-		corners[7] = min;
-
-		return ContainsPoints(corners, nullptr);
+		bool all_in = true;
+
+		for (int i = 0; i < 6; i++)
+		{
+			const Vector4& plane = m_planes[i];
+
+			// corners nearest and farthest along plane normal decide the result of all 8 corners
+			Vector3 p(plane.x >= 0 ? max.x : min.x, plane.y >= 0 ? max.y : min.y, plane.z >= 0 ? max.z : min.z);
+			if (plane_distance(plane, p.x, p.y, p.z) < 0)
+			{
+				return ContainsResult::Out;
+			}
+
+			Vector3 n(plane.x >= 0 ? min.x : max.x, plane.y >= 0 ? min.y : max.y, plane.z >= 0 ? min.z : max.z);
+			if (plane_distance(plane, n.x, n.y, n.z) < 0)
+			{
+				all_in = false;
+			}
+		}
+
+		if (all_in)
+		{
+			return ContainsResult::In;
+		}
+
+		return ContainsResult::Cross;
+	}
+
+	//
+	//	distances are computed in the same order as plane_distance without fused multiply add,
+	//	so results match ContainsBounds bit for bit
+	//
+	void Frustum::CullBounds(const float* mins, const float* maxs, int count, byte* results) const
+	{
+		int i = 0;
+
+#if VR_FRUSTUM_SSE
+		const __m128 zero = _mm_setzero_ps();
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* n = &mins[i * 3];
+			const float* x = &maxs[i * 3];
+			__m128 min_x = _mm_setr_ps(n[0], n[3], n[6], n[9]);
+			__m128 min_y = _mm_setr_ps(n[1], n[4], n[7], n[10]);
+			__m128 min_z = _mm_setr_ps(n[2], n[5], n[8], n[11]);
+			__m128 max_x = _mm_setr_ps(x[0], x[3], x[6], x[9]);
+			__m128 max_y = _mm_setr_ps(x[1], x[4], x[7], x[10]);
+			__m128 max_z = _mm_setr_ps(x[2], x[5], x[8], x[11]);
+			__m128 out = zero;
+			__m128 cross = zero;
+
+			for (int j = 0; j < 6; j++)
+			{
+				const Vector4& plane = m_planes[j];
+				__m128 a = _mm_set1_ps(plane.x);
+				__m128 b = _mm_set1_ps(plane.y);
+				__m128 c = _mm_set1_ps(plane.z);
+				__m128 d = _mm_set1_ps(plane.w);
+
+				__m128 px = plane.x >= 0 ? max_x : min_x;
+				__m128 py = plane.y >= 0 ? max_y : min_y;
+				__m128 pz = plane.z >= 0 ? max_z : min_z;
+				__m128 nx = plane.x >= 0 ? min_x : max_x;
+				__m128 ny = plane.y >= 0 ? min_y : max_y;
+				__m128 nz = plane.z >= 0 ? min_z : max_z;
+
+				__m128 dp = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, a), _mm_mul_ps(py, b)), _mm_mul_ps(pz, c)), d);
+				__m128 dn = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, a), _mm_mul_ps(ny, b)), _mm_mul_ps(nz, c)), d);
+
+				out = _mm_or_ps(out, _mm_cmplt_ps(dp, zero));
+				cross = _mm_or_ps(cross, _mm_cmplt_ps(dn, zero));
+			}
+
+			int out_mask = _mm_movemask_ps(out);
+			int cross_mask = _mm_movemask_ps(cross);
+
+			for (int k = 0; k < 4; k++)
+			{
+				ContainsResult ret = ContainsResult::In;
+				if (out_mask & (1 << k))
+				{
+					ret = ContainsResult::Out;
+				}
+				else if (cross_mask & (1 << k))
+				{
+					ret = ContainsResult::Cross;
+				}
+				results[i + k] = (byte) ret;
+			}
+		}
+#elif VR_FRUSTUM_NEON
+		const float32x4_t zero = vdupq_n_f32(0);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* n = &mins[i * 3];
+			const float* x = &maxs[i * 3];
+			float32x4x3_t min = vld3q_f32(n);
+			float32x4x3_t max = vld3q_f32(x);
+			uint32x4_t out = vdupq_n_u32(0);
+			uint32x4_t cross = vdupq_n_u32(0);
+
+			for (int j = 0; j < 6; j++)
+			{
+				const Vector4& plane = m_planes[j];
+				float32x4_t a = vdupq_n_f32(plane.x);
+				float32x4_t b = vdupq_n_f32(plane.y);
+				float32x4_t c = vdupq_n_f32(plane.z);
+				float32x4_t d = vdupq_n_f32(plane.w);
+
+				float32x4_t px = plane.x >= 0 ? max.val[0] : min.val[0];
+				float32x4_t py = plane.y >= 0 ? max.val[1] : min.val[1];
+				float32x4_t pz = plane.z >= 0 ? max.val[2] : min.val[2];
+				float32x4_t nx = plane.x >= 0 ? min.val[0] : max.val[0];
+				float32x4_t ny = plane.y >= 0 ? min.val[1] : max.val[1];
+				float32x4_t nz = plane.z >= 0 ? min.val[2] : max.val[2];
+
+				// separate mul and add, vmla may be fused
+				float32x4_t dp = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(px, a), vmulq_f32(py, b)), vmulq_f32(pz, c)), d);
+				float32x4_t dn = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(nx, a), vmulq_f32(ny, b)), vmulq_f32(nz, c)), d);
+
+				out = vorrq_u32(out, vcltq_f32(dp, zero));
+				cross = vorrq_u32(cross, vcltq_f32(dn, zero));
+			}
+
+			uint32_t out_lanes[4];
+			uint32_t cross_lanes[4];
+			vst1q_u32(out_lanes, out);
+			vst1q_u32(cross_lanes, cross);
+
+			for (int k = 0; k < 4; k++)
+			{
+				ContainsResult ret = ContainsResult::In;
+				if (out_lanes[k])
+				{
+					ret = ContainsResult::Out;
+				}
+				else if (cross_lanes[k])
+				{
+					ret = ContainsResult::Cross;
+				}
+				results[i + k] = (byte) ret;
+			}
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			Vector3 min(mins[i * 3], mins[i * 3 + 1], mins[i * 3 + 2]);
+			Vector3 max(maxs[i * 3], maxs[i * 3 + 1], maxs[i * 3 + 2]);
+			results[i] = (byte) ContainsBounds(min, max);
+		}
 	}
 
 	ContainsResult Frustum::ContainsPoints(const Vector<Vector3>& points, const Matrix4x4* matrix) const
@@ -19,6 +19,7 @@
 
 #include "Matrix4x4.h"
 #include "Vector3.h"
+#include "memory/ByteBuffer.h"
 
 namespace Viry3D
 {
@@ -57,6 +58,11 @@ namespace Viry3D
 		ContainsResult ContainsPoint(const Vector3& point) const;
 		ContainsResult ContainsSphere(const Vector3& center, float radius) const;
 		ContainsResult ContainsBounds(const Vector3& min, const Vector3& max) const;
+		//
+		//	batch version of ContainsBounds, mins and maxs are count packed xyz,
+		//	results are ContainsResult values, 4 bounds per step with sse or neon
+		//
+		void CullBounds(const float* mins, const float* maxs, int count, byte* results) const;
 		ContainsResult ContainsPoints(const Vector<Vector3>& points, const Matrix4x4* matrix) const;
 		float DistanceToPlane(const Vector3& point, int plane_index) const;
 
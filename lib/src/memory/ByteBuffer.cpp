@@ -17,18 +17,20 @@
 
 #include "ByteBuffer.h"
 #include "Memory.h"
+#include <assert.h>
 
 namespace Viry3D
 {
 	ByteBuffer::ByteBuffer(int size):
 		m_size(size),
-		m_bytes(nullptr),
-		m_weak_ref(false)
+		m_bytes(nullptr)
 	{
 		if (m_size > 0)
 		{
-			m_ref_count = RefMake<bool>(true);
 			m_bytes = Memory::Alloc<byte>(m_size);
+			m_owner = Ref<void>(m_bytes, [](void* p) {
+				Memory::Free(p);
+			});
 		}
 		else
 		{
@@ -36,50 +38,45 @@ namespace Viry3D
 		}
 	}
 
-	ByteBuffer::ByteBuffer(const ByteBuffer& buffer)
+	ByteBuffer::ByteBuffer(const ByteBuffer& buffer):
+		m_size(buffer.m_size),
+		m_bytes(buffer.m_bytes),
+		m_owner(buffer.m_owner)
 	{
-		m_size = buffer.m_size;
-		m_bytes = buffer.m_bytes;
-		m_ref_count = buffer.m_ref_count;
-		m_weak_ref = buffer.m_weak_ref;
+	}
+
+	ByteBuffer::ByteBuffer(const ByteBuffer& buffer, int offset, int size):
+		m_size(size),
+		m_bytes(buffer.m_bytes + offset),
+		m_owner(buffer.m_owner)
+	{
+		assert(offset >= 0 && size >= 0 && offset + size <= buffer.m_size);
 	}
 
 	ByteBuffer::ByteBuffer(byte* bytes, int size):
+		m_size(size),
+		m_bytes(bytes)
+	{
+	}
+
+	ByteBuffer::ByteBuffer(byte* bytes, int size, const Ref<void>& owner):
 		m_size(size),
 		m_bytes(bytes),
-		m_weak_ref(true)
+		m_owner(owner)
 	{
 	}
 
 	ByteBuffer& ByteBuffer::operator =(const ByteBuffer& buffer)
 	{
-		Free();
-
 		m_size = buffer.m_size;
 		m_bytes = buffer.m_bytes;
-		m_ref_count = buffer.m_ref_count;
-		m_weak_ref = buffer.m_weak_ref;
+		m_owner = buffer.m_owner;
 
 		return *this;
 	}
 
 	ByteBuffer::~ByteBuffer()
 	{
-		Free();
-	}
-
-	void ByteBuffer::Free()
-	{
-		if (!m_weak_ref)
-		{
-			if (m_ref_count && m_ref_count.use_count() == 1)
-			{
-				if (m_bytes != nullptr)
-				{
-					Memory::Free(m_bytes);
-				}
-			}
-		}
 	}
 
 	byte* ByteBuffer::Bytes() const
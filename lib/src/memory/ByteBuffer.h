@@ -23,12 +23,24 @@ namespace Viry3D
 {
 	typedef unsigned char byte;
 
+	//
+	//	bytes shared by all copies and slices, freed with the last one,
+	//	copy is one ref count add
+	//
 	class ByteBuffer
 	{
 	public:
 		ByteBuffer(int size = 0);
 		ByteBuffer(const ByteBuffer& buffer);
+		//
+		//	view of size bytes from offset without copy, keeps buffer alive
+		//
+		ByteBuffer(const ByteBuffer& buffer, int offset, int size);
 		ByteBuffer(byte* bytes, int size);
+		//
+		//	bytes not owned, kept alive by owner until last copy released
+		//
+		ByteBuffer(byte* bytes, int size, const Ref<void>& owner);
 		~ByteBuffer();
 
 		byte* Bytes() const;
@@ -39,11 +51,8 @@ namespace Viry3D
 		const byte& operator [](int index) const;
 
 	private:
-		void Free();
-
 		int m_size;
 		byte* m_bytes;
-		Ref<bool> m_ref_count;
-		bool m_weak_ref;
+		Ref<void> m_owner;
 	};
 }
@@ -70,15 +70,14 @@ namespace Viry3D
 			index_count += count;
 		}
 
-		int idnex_size = index_count * sizeof(unsigned short);
-		m_indices = new unsigned short[idnex_size];
+		m_indices = new unsigned int[index_count];
 
 		int old_size = 0;
 		for (int i = 0; i < submesh; i++)
 		{
 			int start, count;
 			m_mesh->GetIndexRange(i, start, count);
-			memcpy(&m_indices[old_size], &m_mesh->triangles[start], count * sizeof(unsigned short));
+			memcpy(&m_indices[old_size], &m_mesh->triangles[start], count * sizeof(unsigned int));
 			old_size += count;
 		}
 
@@ -89,14 +88,14 @@ namespace Viry3D
 		btIndexedMesh mesh;
 		mesh.m_numTriangles = index_count / 3;
 		mesh.m_triangleIndexBase = (const unsigned char*) m_indices;
-		mesh.m_triangleIndexStride = sizeof(unsigned short) * 3;
+		mesh.m_triangleIndexStride = sizeof(unsigned int) * 3;
 		mesh.m_numVertices = vertices.Size();
 		mesh.m_vertexBase = (const unsigned char*) m_vertices;
 		mesh.m_vertexStride = sizeof(Vector3);
 
 		auto collider_data = new btTriangleIndexVertexArray();
 		m_collider_data = collider_data;
-		collider_data->addIndexedMesh(mesh, PHY_SHORT);
+		collider_data->addIndexedMesh(mesh, PHY_INTEGER);
 
 		auto pos = GetTransform()->GetPosition();
 		auto rot = GetTransform()->GetRotation();
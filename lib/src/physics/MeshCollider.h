@@ -46,7 +46,7 @@ namespace Viry3D
 	private:
 		Ref<Mesh> m_mesh;
 		void* m_collider_data;
-		unsigned short* m_indices;
+		unsigned int* m_indices;
 		Vector3* m_vertices;
 	};
 }
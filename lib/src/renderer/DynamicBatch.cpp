@@ -0,0 +1,304 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "DynamicBatch.h"
+#include "math/Mathf.h"
+#include "Profiler.h"
+#include "thread/Thread.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define VR_DYNAMIC_BATCH_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VR_DYNAMIC_BATCH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Viry3D
+{
+	// fewer vertices filled on main thread only
+	static const int PARALLEL_VERTEX_COUNT_MIN = 8192;
+	static const int PARALLEL_ITEM_BATCH_SIZE = 32;
+
+	int DynamicBatch::m_vertex_count_max = 300;
+	Vector<DynamicBatch::Item> DynamicBatch::m_items;
+	Vector<DynamicBatch::Batch> DynamicBatch::m_batches;
+	int DynamicBatch::m_vertex_count = 0;
+	int DynamicBatch::m_index_count = 0;
+	Vector<Vertex> DynamicBatch::m_vertices;
+	Vector<unsigned int> DynamicBatch::m_indices;
+	Ref<VertexBuffer> DynamicBatch::m_vertex_buffers[BufferCount];
+	Ref<IndexBuffer> DynamicBatch::m_index_buffers[BufferCount];
+	int DynamicBatch::m_buffer_index = 0;
+
+#if VR_DYNAMIC_BATCH_SSE
+	typedef __m128 MatrixColumn;
+
+	static inline MatrixColumn load_column(float x, float y, float z)
+	{
+		return _mm_setr_ps(x, y, z, 0);
+	}
+
+	static inline Vector3 transform(const MatrixColumn* c, const Vector3& v, bool point)
+	{
+		__m128 r = _mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(v.x), c[0]),
+			_mm_mul_ps(_mm_set1_ps(v.y), c[1]));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.z), c[2]));
+		if (point)
+		{
+			r = _mm_add_ps(r, c[3]);
+		}
+
+		float out[4];
+		_mm_storeu_ps(out, r);
+		return Vector3(out[0], out[1], out[2]);
+	}
+#elif VR_DYNAMIC_BATCH_NEON
+	typedef float32x4_t MatrixColumn;
+
+	static inline MatrixColumn load_column(float x, float y, float z)
+	{
+		float v[4] = { x, y, z, 0 };
+		return vld1q_f32(v);
+	}
+
+	static inline Vector3 transform(const MatrixColumn* c, const Vector3& v, bool point)
+	{
+		float32x4_t r = point ? c[3] : vdupq_n_f32(0);
+		r = vmlaq_n_f32(r, c[0], v.x);
+		r = vmlaq_n_f32(r, c[1], v.y);
+		r = vmlaq_n_f32(r, c[2], v.z);
+
+		float out[4];
+		vst1q_f32(out, r);
+		return Vector3(out[0], out[1], out[2]);
+	}
+#else
+	typedef Vector3 MatrixColumn;
+
+	static inline MatrixColumn load_column(float x, float y, float z)
+	{
+		return Vector3(x, y, z);
+	}
+
+	static inline Vector3 transform(const MatrixColumn* c, const Vector3& v, bool point)
+	{
+		Vector3 r = c[0] * v.x + c[1] * v.y + c[2] * v.z;
+		if (point)
+		{
+			r += c[3];
+		}
+		return r;
+	}
+#endif
+
+	void DynamicBatch::Deinit()
+	{
+		for (int i = 0; i < BufferCount; i++)
+		{
+			m_vertex_buffers[i].reset();
+			m_index_buffers[i].reset();
+		}
+		m_items.Clear();
+		m_batches.Clear();
+		m_vertices.Clear();
+		m_indices.Clear();
+		m_vertex_count = 0;
+		m_index_count = 0;
+	}
+
+	bool DynamicBatch::IsBatchable(const Mesh* mesh)
+	{
+		return mesh != NULL &&
+			!mesh->vertices.Empty() &&
+			mesh->vertices.Size() <= m_vertex_count_max &&
+			mesh->blend_shapes_deltas.Empty();
+	}
+
+	void DynamicBatch::Begin()
+	{
+		m_items.Clear();
+		m_batches.Clear();
+		m_vertex_count = 0;
+		m_index_count = 0;
+		m_buffer_index = (m_buffer_index + 1) % BufferCount;
+	}
+
+	int DynamicBatch::BeginBatch()
+	{
+		Batch batch;
+		batch.index_start = m_index_count;
+		batch.index_count = 0;
+		m_batches.Add(batch);
+
+		return m_batches.Size() - 1;
+	}
+
+	void DynamicBatch::Add(Mesh* mesh, int submesh, const Matrix4x4& world_matrix, const Vector4& lightmap_scale_offset)
+	{
+		Item item;
+		item.mesh = mesh;
+		mesh->GetIndexRange(submesh, item.index_start, item.index_count);
+		item.world_matrix = world_matrix;
+		item.lightmap_scale_offset = lightmap_scale_offset;
+		item.vertex_offset = m_vertex_count;
+		item.index_offset = m_index_count;
+		m_items.Add(item);
+
+		m_vertex_count += mesh->vertices.Size();
+		m_index_count += item.index_count;
+		m_batches[m_batches.Size() - 1].index_count += item.index_count;
+	}
+
+	void DynamicBatch::GetBatchRange(int batch, int& start, int& count)
+	{
+		start = m_batches[batch].index_start;
+		count = m_batches[batch].index_count;
+	}
+
+	void DynamicBatch::FillItem(const Item& item, Vertex* vertices, unsigned int* indices)
+	{
+		auto mesh = item.mesh;
+		auto& mat = item.world_matrix;
+		auto& scale_offset = item.lightmap_scale_offset;
+
+		MatrixColumn c[4];
+		c[0] = load_column(mat.m00, mat.m10, mat.m20);
+		c[1] = load_column(mat.m01, mat.m11, mat.m21);
+		c[2] = load_column(mat.m02, mat.m12, mat.m22);
+		c[3] = load_column(mat.m03, mat.m13, mat.m23);
+
+		bool has_colors = !mesh->colors.Empty();
+		bool has_uv = !mesh->uv.Empty();
+		bool has_uv2 = !mesh->uv2.Empty();
+		bool has_normals = !mesh->normals.Empty();
+		bool has_tangents = !mesh->tangents.Empty();
+		bool has_bone_weights = !mesh->bone_weights.Empty();
+		bool has_bone_indices = !mesh->bone_indices.Empty();
+
+		int vertex_count = mesh->vertices.Size();
+		for (int i = 0; i < vertex_count; i++)
+		{
+			auto& v = vertices[item.vertex_offset + i];
+
+			v.vertex = transform(c, mesh->vertices[i], true);
+			v.color = has_colors ? mesh->colors[i] : Color(1, 1, 1, 1);
+			v.uv = has_uv ? mesh->uv[i] : Vector2(0, 0);
+
+			if (has_uv2)
+			{
+				// same as lightmap uv in shader, so batched vertices use scale offset (1, 1, 0, 0)
+				auto uv2 = mesh->uv2[i];
+				float x = uv2.x;
+				float y = 1.0f - uv2.y;
+				x = x * scale_offset.x + scale_offset.z;
+				y = y * scale_offset.y + scale_offset.w;
+				y = 1.0f - y;
+				v.uv2 = Vector2(x, y);
+			}
+			else
+			{
+				v.uv2 = Vector2(0, 0);
+			}
+
+			// renormalized after scale, as unbatched shading normalizes in shader
+			v.normal = has_normals ? Vector3::Normalize(transform(c, mesh->normals[i], false)) : Vector3(0, 0, 0);
+
+			if (has_tangents)
+			{
+				auto& tangent = mesh->tangents[i];
+				auto tangent_world = Vector3::Normalize(transform(c, Vector3(tangent.x, tangent.y, tangent.z), false));
+				v.tangent = Vector4(tangent_world.x, tangent_world.y, tangent_world.z, tangent.w);
+			}
+			else
+			{
+				v.tangent = Vector4(0, 0, 0, 0);
+			}
+
+			v.bone_weight = has_bone_weights ? mesh->bone_weights[i] : Vector4(0, 0, 0, 0);
+			v.bone_indices = has_bone_indices ? mesh->bone_indices[i] : Vector4(0, 0, 0, 0);
+		}
+
+		for (int i = 0; i < item.index_count; i++)
+		{
+			indices[item.index_offset + i] = mesh->triangles[item.index_start + i] + item.vertex_offset;
+		}
+	}
+
+	void DynamicBatch::End()
+	{
+		VR_PROFILE_SCOPE("DynamicBatch::End");
+
+		if (m_items.Empty())
+		{
+			return;
+		}
+
+		if (m_vertices.Size() < m_vertex_count)
+		{
+			m_vertices.Resize(m_vertex_count);
+		}
+		if (m_indices.Size() < m_index_count)
+		{
+			m_indices.Resize(m_index_count);
+		}
+
+		Vertex* vertices = &m_vertices[0];
+		unsigned int* indices = &m_indices[0];
+		int item_count = m_items.Size();
+
+		if (m_vertex_count >= PARALLEL_VERTEX_COUNT_MIN)
+		{
+			int batch_size = PARALLEL_ITEM_BATCH_SIZE;
+			int batch_count = (item_count + batch_size - 1) / batch_size;
+
+			ThreadPool::ParallelFor(batch_count, [&](int batch, int thread_index) {
+				int start = batch * batch_size;
+				int end = Mathf::Min(start + batch_size, item_count);
+
+				for (int i = start; i < end; i++)
+				{
+					FillItem(m_items[i], vertices, indices);
+				}
+			});
+		}
+		else
+		{
+			for (int i = 0; i < item_count; i++)
+			{
+				FillItem(m_items[i], vertices, indices);
+			}
+		}
+
+		int vertex_buffer_size = m_vertex_count * sizeof(Vertex);
+		auto& vertex_buffer = m_vertex_buffers[m_buffer_index];
+		if (!vertex_buffer || vertex_buffer->GetSize() < vertex_buffer_size)
+		{
+			vertex_buffer = VertexBuffer::Create(vertex_buffer_size, true);
+		}
+		vertex_buffer->UpdateRange(0, vertex_buffer_size, vertices);
+
+		int index_buffer_size = m_index_count * sizeof(unsigned int);
+		auto& index_buffer = m_index_buffers[m_buffer_index];
+		if (!index_buffer || index_buffer->GetSize() < index_buffer_size)
+		{
+			index_buffer = IndexBuffer::Create(index_buffer_size, true);
+		}
+		index_buffer->UpdateRange(0, index_buffer_size, indices);
+	}
+}
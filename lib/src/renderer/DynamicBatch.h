@@ -0,0 +1,92 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "graphics/Mesh.h"
+#include "graphics/VertexBuffer.h"
+#include "graphics/IndexBuffer.h"
+#include "graphics/VertexAttribute.h"
+#include "container/Vector.h"
+#include "math/Matrix4x4.h"
+#include "math/Vector4.h"
+
+namespace Viry3D
+{
+	//
+	//	small meshes merged into world space vertices each time a camera prepares,
+	//	buffers used in turn so writing new batches not wait for gpu reading last ones,
+	//	indices are unsigned int
+	//
+	class DynamicBatch
+	{
+	public:
+		static const int BufferCount = 3;
+
+		static void Deinit();
+		static int GetVertexCountMax() { return m_vertex_count_max; }
+		//
+		//	meshes with more vertices not batched, 0 to disable
+		//
+		static void SetVertexCountMax(int count) { m_vertex_count_max = count; }
+		static bool IsBatchable(const Mesh* mesh);
+		//
+		//	clear batches and move to next buffers
+		//
+		static void Begin();
+		static int BeginBatch();
+		static void Add(Mesh* mesh, int submesh, const Matrix4x4& world_matrix, const Vector4& lightmap_scale_offset);
+		//
+		//	transform all added meshes and upload
+		//
+		static void End();
+		static void GetBatchRange(int batch, int& start, int& count);
+		static const VertexBuffer* GetVertexBuffer() { return m_vertex_buffers[m_buffer_index].get(); }
+		static const IndexBuffer* GetIndexBuffer() { return m_index_buffers[m_buffer_index].get(); }
+
+	private:
+		struct Item
+		{
+			Mesh* mesh;
+			int index_start;
+			int index_count;
+			Matrix4x4 world_matrix;
+			Vector4 lightmap_scale_offset;
+			int vertex_offset;
+			int index_offset;
+		};
+
+		struct Batch
+		{
+			int index_start;
+			int index_count;
+		};
+
+		static void FillItem(const Item& item, Vertex* vertices, unsigned int* indices);
+
+		static int m_vertex_count_max;
+		static Vector<Item> m_items;
+		static Vector<Batch> m_batches;
+		static int m_vertex_count;
+		static int m_index_count;
+		static Vector<Vertex> m_vertices;
+		static Vector<unsigned int> m_indices;
+		static Ref<VertexBuffer> m_vertex_buffers[BufferCount];
+		static Ref<IndexBuffer> m_index_buffers[BufferCount];
+		static int m_buffer_index;
+	};
+}
@@ -33,6 +33,25 @@ namespace Viry3D
 		this->SetSharedMesh(src->GetSharedMesh());
 	}
 
+	void MeshRenderer::SetSharedMesh(const Ref<Mesh>& mesh)
+	{
+		m_mesh = mesh;
+
+		this->UpdateBounds();
+	}
+
+	bool MeshRenderer::GetLocalBounds(Bounds& bounds) const
+	{
+		if (!m_mesh || m_mesh->vertices.Empty())
+		{
+			return false;
+		}
+
+		bounds = m_mesh->GetBounds();
+
+		return true;
+	}
+
 	const VertexBuffer* MeshRenderer::GetVertexBuffer() const
 	{
 		return GetSharedMesh()->GetVertexBuffer().get();
@@ -43,6 +62,11 @@ namespace Viry3D
 		return GetSharedMesh()->GetIndexBuffer().get();
 	}
 
+	IndexType MeshRenderer::GetIndexType() const
+	{
+		return GetSharedMesh()->GetIndexType();
+	}
+
 	void MeshRenderer::GetIndexRange(int material_index, int& start, int& count) const
 	{
 		GetSharedMesh()->GetIndexRange(material_index, start, count);
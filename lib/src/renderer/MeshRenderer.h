@@ -28,10 +28,12 @@ namespace Viry3D
 	public:
 		virtual const VertexBuffer* GetVertexBuffer() const;
 		virtual const IndexBuffer* GetIndexBuffer() const;
+		virtual IndexType GetIndexType() const;
 		virtual void GetIndexRange(int material_index, int& start, int& count) const;
 		virtual bool IsValidPass(int material_index) const;
 		const Ref<Mesh>& GetSharedMesh() const { return m_mesh; }
-		void SetSharedMesh(const Ref<Mesh>& mesh) { m_mesh = mesh; }
+		void SetSharedMesh(const Ref<Mesh>& mesh);
+		virtual bool GetLocalBounds(Bounds& bounds) const;
 
 	private:
 		MeshRenderer();
@@ -24,14 +24,120 @@
 #include "math/Mathf.h"
 #include "graphics/VertexAttribute.h"
 #include "graphics/Camera.h"
+#include "Profiler.h"
+#include <atomic>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define VR_PARTICLE_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VR_PARTICLE_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace Viry3D
 {
 	DEFINE_COM_CLASS(ParticleSystem);
 
+	ParticleSystem::Stats ParticleSystem::m_stats;
+	Vector<ParticleSystem*> ParticleSystem::m_update_queue;
+	Mutex ParticleSystem::m_update_mutex;
+	Vector<ParticleSystem::Job> ParticleSystem::m_jobs;
+	Ref<VertexBuffer> ParticleSystem::m_quad_vertex_buffer;
+	Ref<IndexBuffer> ParticleSystem::m_quad_index_buffer;
+
+	//
+	//	dst[i] += src[i] * s, vector arrays passed as flat floats
+	//
+	static void multiply_add(float* dst, const float* src, float s, int count)
+	{
+		int i = 0;
+#if VR_PARTICLE_SSE
+		__m128 vs = _mm_set1_ps(s);
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(&dst[i], _mm_add_ps(_mm_loadu_ps(&dst[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), vs)));
+		}
+#elif VR_PARTICLE_NEON
+		float32x4_t vs = vdupq_n_f32(s);
+		for (; i + 4 <= count; i += 4)
+		{
+			vst1q_f32(&dst[i], vaddq_f32(vld1q_f32(&dst[i]), vmulq_f32(vld1q_f32(&src[i]), vs)));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			dst[i] += src[i] * s;
+		}
+	}
+
+	//
+	//	dst[i] *= src[i]
+	//
+	static void multiply(float* dst, const float* src, int count)
+	{
+		int i = 0;
+#if VR_PARTICLE_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_loadu_ps(&dst[i]), _mm_loadu_ps(&src[i])));
+		}
+#elif VR_PARTICLE_NEON
+		for (; i + 4 <= count; i += 4)
+		{
+			vst1q_f32(&dst[i], vmulq_f32(vld1q_f32(&dst[i]), vld1q_f32(&src[i])));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			dst[i] *= src[i];
+		}
+	}
+
+	static std::atomic<unsigned int> g_random_stream(0);
+
+	//
+	//	emission runs on update threads, rand() is not thread safe and on some crts
+	//	starts every thread at the same seed, so each thread gets its own xorshift state
+	//	seeded from a shared counter mixed with thread id and time
+	//
+	static unsigned int random_seed()
+	{
+		unsigned int seed = g_random_stream.fetch_add(1) * 0x9e3779b9u;
+		seed ^= (unsigned int) std::hash<std::thread::id>()(std::this_thread::get_id());
+		seed ^= (unsigned int) Time::GetTimeMS();
+
+		// murmur3 finalizer, spreads close counters over all bits
+		seed ^= seed >> 16;
+		seed *= 0x85ebca6bu;
+		seed ^= seed >> 13;
+		seed *= 0xc2b2ae35u;
+		seed ^= seed >> 16;
+
+		return seed != 0 ? seed : 1;
+	}
+
 	static float random01()
 	{
-		return Mathf::RandomRange(0.0f, 1.0f);
+		static thread_local unsigned int seed = random_seed();
+
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	static float random_range(float min, float max)
+	{
+		return min + random01() * (max - min);
+	}
+
+	// max exclusive like Mathf::RandomRange
+	static int random_range(int min, int max)
+	{
+		return (int) (min + random01() * (max - min));
 	}
 
 	static float get_min_max_curve_lerp(float& lerp)
@@ -43,16 +149,90 @@ namespace Viry3D
 		return lerp;
 	}
 
+	void ParticleSystem::Particles::Reserve(int new_capacity)
+	{
+		if (new_capacity <= capacity)
+		{
+			return;
+		}
+
+		capacity = new_capacity;
+		start_lifetime.Resize(new_capacity);
+		remaining_lifetime.Resize(new_capacity);
+		emit_time.Resize(new_capacity);
+		start_size.Resize(new_capacity);
+		start_color.Resize(new_capacity);
+		start_velocity.Resize(new_capacity);
+		force_velocity.Resize(new_capacity);
+		velocity.Resize(new_capacity);
+		angular_velocity.Resize(new_capacity);
+		color.Resize(new_capacity);
+		size.Resize(new_capacity);
+		position.Resize(new_capacity);
+		rotation.Resize(new_capacity);
+		uv_scale_offset.Resize(new_capacity);
+		texture_sheet_animation_row.Resize(new_capacity);
+		for (int i = 0; i < ParticleLerpCount; i++)
+		{
+			lerps[i].Resize(new_capacity);
+		}
+		lifetime_t.Resize(new_capacity);
+		speed_t.Resize(new_capacity);
+		colors.Resize(new_capacity);
+	}
+
+	void ParticleSystem::Particles::Remove(int index)
+	{
+		int last = count - 1;
+		if (index != last)
+		{
+			start_lifetime[index] = start_lifetime[last];
+			remaining_lifetime[index] = remaining_lifetime[last];
+			emit_time[index] = emit_time[last];
+			start_size[index] = start_size[last];
+			start_color[index] = start_color[last];
+			start_velocity[index] = start_velocity[last];
+			force_velocity[index] = force_velocity[last];
+			velocity[index] = velocity[last];
+			angular_velocity[index] = angular_velocity[last];
+			color[index] = color[last];
+			size[index] = size[last];
+			position[index] = position[last];
+			rotation[index] = rotation[last];
+			uv_scale_offset[index] = uv_scale_offset[last];
+			texture_sheet_animation_row[index] = texture_sheet_animation_row[last];
+			for (int i = 0; i < ParticleLerpCount; i++)
+			{
+				lerps[i][index] = lerps[i][last];
+			}
+		}
+		count--;
+	}
+
 	ParticleSystem::ParticleSystem():
 		m_time_start(0),
 		m_start_delay(0),
 		m_time(0),
-		m_time_emit(-1)
+		m_time_emit(-1),
+		m_delta_time(0),
+		m_vertices(NULL),
+		m_instances(NULL)
 	{
 	}
 
 	ParticleSystem::~ParticleSystem()
 	{
+		// destroyed between Update and UpdateAll, or by another thread while UpdateAll runs
+		std::lock_guard<std::mutex> lock(m_update_mutex);
+
+		for (int i = 0; i < m_update_queue.Size(); i++)
+		{
+			if (m_update_queue[i] == this)
+			{
+				m_update_queue.Remove(i);
+				break;
+			}
+		}
 	}
 
 	void ParticleSystem::DeepCopy(const Ref<Object>& source)
@@ -77,8 +257,60 @@ namespace Viry3D
 		this->texture_sheet_animation = src->texture_sheet_animation;
 	}
 
+	void ParticleSystem::BakeCurves()
+	{
+		main.start_delay.Bake();
+		main.start_lifetime.Bake();
+		main.start_speed.Bake();
+		main.start_size_x.Bake();
+		main.start_size_y.Bake();
+		main.start_size_z.Bake();
+		main.start_size.Bake();
+		main.start_rotation_x.Bake();
+		main.start_rotation_y.Bake();
+		main.start_rotation_z.Bake();
+		main.start_rotation.Bake();
+		main.start_color.Bake();
+		main.gravity_modifier.Bake();
+		emission.rate_over_time.Bake();
+		emission.rate_over_distance.Bake();
+		shape.arc_speed.Bake();
+		shape.radius_speed.Bake();
+		velocity_over_lifetime.x.Bake();
+		velocity_over_lifetime.y.Bake();
+		velocity_over_lifetime.z.Bake();
+		limit_velocity_over_lifetime.limit_x.Bake();
+		limit_velocity_over_lifetime.limit_y.Bake();
+		limit_velocity_over_lifetime.limit_z.Bake();
+		limit_velocity_over_lifetime.limit.Bake();
+		inherit_velocity.curve.Bake();
+		force_over_lifetime.x.Bake();
+		force_over_lifetime.y.Bake();
+		force_over_lifetime.z.Bake();
+		color_over_lifetime.color.Bake();
+		color_by_speed.color.Bake();
+		size_over_lifetime.x.Bake();
+		size_over_lifetime.y.Bake();
+		size_over_lifetime.z.Bake();
+		size_over_lifetime.size.Bake();
+		size_by_speed.x.Bake();
+		size_by_speed.y.Bake();
+		size_by_speed.z.Bake();
+		size_by_speed.size.Bake();
+		rotation_over_lifetime.x.Bake();
+		rotation_over_lifetime.y.Bake();
+		rotation_over_lifetime.z.Bake();
+		rotation_by_speed.x.Bake();
+		rotation_by_speed.y.Bake();
+		rotation_by_speed.z.Bake();
+		texture_sheet_animation.frame_over_time.Bake();
+		texture_sheet_animation.start_frame.Bake();
+	}
+
 	void ParticleSystem::Start()
 	{
+		this->BakeCurves();
+
 		m_start_delay = main.start_delay.Evaluate(0, random01());
 		m_time_start = Time::GetTime() + m_start_delay;
 		m_renderer = this->GetGameObject()->GetComponent<ParticleSystemRenderer>();
@@ -91,18 +323,190 @@ namespace Viry3D
 			return;
 		}
 
+		VR_PROFILE_SCOPE("ParticleSystem::Update");
+		float time = Time::GetRealTimeSinceStartup();
+
 		UpdateEmission();
-		UpdateParticles();
+		BeginUpdateParticles();
+
+		float update_time = Time::GetRealTimeSinceStartup() - time;
+
+		// Update could run on update threads
+		std::lock_guard<std::mutex> lock(m_update_mutex);
+
+		if (m_particles.count > 0)
+		{
+			m_update_queue.Add(this);
+		}
+
+		m_stats.update_count++;
+		m_stats.particle_count += m_particles.count;
+		m_stats.update_time += update_time;
+	}
+
+	void ParticleSystem::Deinit()
+	{
+		std::lock_guard<std::mutex> lock(m_update_mutex);
+
+		m_update_queue.Clear();
+		m_jobs.Clear();
+		m_quad_vertex_buffer.reset();
+		m_quad_index_buffer.reset();
+	}
+
+	void ParticleSystem::UpdateAll()
+	{
+		// held until jobs done, so no queued system is destroyed while its particles update
+		std::lock_guard<std::mutex> lock(m_update_mutex);
+
+		if (m_update_queue.Empty())
+		{
+			return;
+		}
+
+		VR_PROFILE_SCOPE("ParticleSystem::UpdateAll");
+		float time = Time::GetRealTimeSinceStartup();
+
+		for (auto i : m_update_queue)
+		{
+			// swaps materials, so on main thread before anything reads IsInstancing
+			i->m_renderer->UpdateInstancing();
+			AddJobs(i, i->m_particles.count);
+		}
+		m_update_queue.Clear();
+
+		RunJobs([](const Job& job) {
+			job.system->UpdateParticles(job.start, job.end);
+		});
+
+		m_stats.update_time += Time::GetRealTimeSinceStartup() - time;
+	}
+
+	void ParticleSystem::FillAll(const List<Renderer*>& renderers)
+	{
+		VR_PROFILE_SCOPE("ParticleSystem::FillAll");
+
+		Vector<ParticleSystem*> systems;
+		for (auto i : renderers)
+		{
+			auto renderer = dynamic_cast<ParticleSystemRenderer*>(i);
+			if (renderer == NULL)
+			{
+				continue;
+			}
+
+			auto system = renderer->m_particle_system.lock();
+			if (system && system->BeginFillBuffer())
+			{
+				systems.Add(system.get());
+				AddJobs(system.get(), system->m_particles.count);
+			}
+		}
+
+		RunJobs([](const Job& job) {
+			if (job.system->IsInstancing())
+			{
+				job.system->FillInstances(job.start, job.end);
+			}
+			else
+			{
+				job.system->FillVertices(job.start, job.end);
+			}
+		});
+
+		for (auto i : systems)
+		{
+			if (i->IsInstancing())
+			{
+				i->m_instance_buffer->Unmap();
+				i->m_instances = NULL;
+			}
+			else
+			{
+				i->m_vertex_buffer->Unmap();
+				i->m_vertices = NULL;
+			}
+		}
+	}
+
+	void ParticleSystem::AddJobs(ParticleSystem* system, int count)
+	{
+		for (int start = 0; start < count; start += JobParticleCount)
+		{
+			Job job;
+			job.system = system;
+			job.start = start;
+			job.end = Mathf::Min(start + JobParticleCount, count);
+			m_jobs.Add(job);
+		}
+	}
+
+	void ParticleSystem::RunJobs(const std::function<void(const Job&)>& run_job)
+	{
+		ThreadPool::ParallelFor(m_jobs.Size(), [&](int job, int thread_index) {
+			run_job(m_jobs[job]);
+		});
+
+		m_jobs.Clear();
 	}
 
 	int ParticleSystem::GetParticleCount() const
 	{
-		return m_particles.Size();
+		return m_particles.count;
+	}
+
+	const Ref<VertexBuffer>& ParticleSystem::GetVertexBuffer() const
+	{
+		return this->IsInstancing() ? m_quad_vertex_buffer : m_vertex_buffer;
+	}
+
+	const Ref<IndexBuffer>& ParticleSystem::GetIndexBuffer() const
+	{
+		return this->IsInstancing() ? m_quad_index_buffer : m_index_buffer;
+	}
+
+	bool ParticleSystem::IsInstancing() const
+	{
+		return m_renderer && m_renderer->IsInstancing();
+	}
+
+	bool ParticleSystem::IsRotation3D() const
+	{
+		return main.start_rotation_3d ||
+			(rotation_over_lifetime.enabled && rotation_over_lifetime.separate_axes) ||
+			(rotation_by_speed.enabled && rotation_by_speed.separate_axes);
 	}
 
-	void ParticleSystem::Emit(Particle& p)
+	void ParticleSystem::Emit(const Particle& p)
 	{
-        m_particles.AddLast(p);
+		auto& ps = m_particles;
+		if (ps.count >= ps.capacity)
+		{
+			return;
+		}
+
+		int i = ps.count++;
+		ps.start_lifetime[i] = p.start_lifetime;
+		ps.remaining_lifetime[i] = p.start_lifetime;
+		ps.emit_time[i] = p.emit_time;
+		ps.start_size[i] = p.start_size;
+		ps.start_color[i] = p.start_color;
+		ps.color[i] = p.start_color;
+		ps.start_velocity[i] = p.velocity;
+		ps.velocity[i] = p.velocity;
+		ps.force_velocity[i] = Vector3::Zero();
+		ps.angular_velocity[i] = Vector3::Zero();
+		ps.position[i] = p.position;
+		ps.rotation[i] = p.rotation;
+		ps.uv_scale_offset[i] = Vector4(1, 1, 0, 0);
+		ps.texture_sheet_animation_row[i] = p.texture_sheet_animation_row;
+
+		// picked on first use, so only modules in use draw randoms
+		for (int j = 0; j < ParticleLerpCount; j++)
+		{
+			ps.lerps[j][i] = -1;
+		}
+
 		m_time_emit = Time::GetTime();
 	}
 
@@ -131,7 +535,7 @@ namespace Viry3D
 						{
 							burst.emit_time = now;
 							burst.emit_count++;
-							emit_count += Mathf::RandomRange(burst.min_count, burst.max_count + 1);
+							emit_count += random_range(burst.min_count, burst.max_count + 1);
 						}
 					}
 				}
@@ -165,6 +569,8 @@ namespace Viry3D
 
 			if (emit_count > 0)
 			{
+				m_particles.Reserve(main.max_particles);
+
 				int can_emit_count = main.max_particles - GetParticleCount();
 				emit_count = Mathf::Min(emit_count, can_emit_count);
 
@@ -173,7 +579,6 @@ namespace Viry3D
 					float start_speed = main.start_speed.Evaluate(t, random01());
 					Color start_color = main.start_color.Evaluate(t, random01());
 					float start_lifetime = main.start_lifetime.Evaluate(t, random01());
-					float remaining_lifetime = start_lifetime;
 					Vector3 start_size(0, 0, 0);
 					Vector3 position(0, 0, 0);
 					Vector3 rotation(0, 0, 0);
@@ -255,12 +660,9 @@ namespace Viry3D
 					Particle p;
 					p.emit_time = Time::GetTime() - emit_time_offsets[i];
 					p.start_lifetime = start_lifetime;
-					p.remaining_lifetime = remaining_lifetime;
 					p.start_size = start_size;
-					p.angular_velocity = Vector3::Zero();
 					p.rotation = rotation;
 					p.start_color = start_color;
-					p.color = start_color;
 					if (main.simulation_space == ParticleSystemSimulationSpace::World)
 					{
 						auto& mat = this->GetTransform()->GetLocalToWorldMatrix();
@@ -273,14 +675,12 @@ namespace Viry3D
 						p.velocity = velocity * start_speed;
 						p.position = position;
 					}
-					p.start_velocity = p.velocity;
-					p.force_velocity = Vector3::Zero();
 
 					if (texture_sheet_animation.enabled)
 					{
 						if (texture_sheet_animation.animation == ParticleSystemAnimationType::SingleRow && texture_sheet_animation.use_random_row)
 						{
-							p.texture_sheet_animation_row = Mathf::RandomRange(0, texture_sheet_animation.num_tiles_y);
+							p.texture_sheet_animation_row = random_range(0, texture_sheet_animation.num_tiles_y);
 						}
 					}
 
@@ -315,68 +715,85 @@ namespace Viry3D
 		return false;
 	}
 
-	void ParticleSystem::UpdateParticles()
+	void ParticleSystem::BeginUpdateParticles()
 	{
-		for (auto i = m_particles.begin(); i != m_particles.end(); )
-		{
-			auto& p = *i;
+		auto& ps = m_particles;
+		const auto& transform = this->GetTransform();
 
-			if (p.remaining_lifetime > 0)
-			{
-				UpdateParticleLifetime(p);
-				UpdateParticleVelocity(p);
-				UpdateParticleAngularVelocity(p);
-				UpdateParticleColor(p);
-				UpdateParticleSize(p);
-				UpdateParticleUV(p);
-				UpdateParticlePosition(p);
-				UpdateParticleRotation(p);
-			}
+		m_delta_time = Time::GetDeltaTime() * main.simulation_speed;
+		m_local_to_world = transform->GetLocalToWorldMatrix();
+		m_world_to_local = transform->GetWorldToLocalMatrix();
+		m_world_scale = transform->GetScale();
+		m_local_scale = transform->GetLocalScale();
 
-			if (p.remaining_lifetime <= 0)
+		UpdateParticleLifetime();
+
+		for (int i = 0; i < ps.count; )
+		{
+			if (ps.remaining_lifetime[i] <= 0)
 			{
-				i = m_particles.Remove(i);
+				ps.Remove(i);
 				continue;
 			}
 
 			++i;
 		}
+
+		// shared by all particles, picked before jobs split them
+		get_min_max_curve_lerp(main.gravity_modifier_lerp);
 	}
 
-	void ParticleSystem::FillVertexBuffer(void* param, const ByteBuffer& buffer)
+	void ParticleSystem::UpdateParticles(int start, int end)
 	{
-		auto ps = (ParticleSystem*) param;
-		auto vs = (Vertex*) buffer.Bytes();
+		auto& ps = m_particles;
 
-		auto camera_to_world = Camera::Current()->GetTransform()->GetLocalToWorldMatrix();
-		auto world_to_camera = Camera::Current()->GetTransform()->GetWorldToLocalMatrix();
-		auto local_to_world = ps->GetTransform()->GetLocalToWorldMatrix();
-		auto world_scale = ps->GetTransform()->GetScale();
-		auto mat_scale_invert = Matrix4x4::Scaling(Vector3(1.0f / world_scale.x, 1.0f / world_scale.y, 1.0f / world_scale.z));
+		for (int i = start; i < end; i++)
+		{
+			ps.lifetime_t[i] = Mathf::Clamp01((ps.start_lifetime[i] - ps.remaining_lifetime[i]) / ps.start_lifetime[i]);
+		}
+
+		UpdateParticleVelocity(start, end);
+		UpdateParticleAngularVelocity(start, end);
+		UpdateParticleColor(start, end);
+		UpdateParticleSize(start, end);
+		UpdateParticleUV(start, end);
+		UpdateParticlePosition(start, end);
+		UpdateParticleRotation(start, end);
+	}
 
-		int index = 0;
-		for (auto i = ps->m_particles.begin(); i != ps->m_particles.end(); ++i, ++index)
+	void ParticleSystem::FillVertices(int start, int end) const
+	{
+		auto vs = m_vertices;
+		const auto& camera_to_world = m_fill.camera_to_world;
+		const auto& world_to_camera = m_fill.world_to_camera;
+
+		const auto& particles = m_particles;
+		for (int index = start; index < end; index++)
 		{
-			const auto& p = *i;
+			const Vector3& position = particles.position[index];
+			const Vector3& velocity = particles.velocity[index];
+			const Vector3& rotation = particles.rotation[index];
+			const Vector3& size = particles.size[index];
+			const Vector4& uv_scale_offset = particles.uv_scale_offset[index];
+			const Color& color = particles.color[index];
 
 			Vector3 pos_world;
 			Vector3 velocity_world;
 
-			if (ps->main.simulation_space == ParticleSystemSimulationSpace::World)
+			if (main.simulation_space == ParticleSystemSimulationSpace::World)
 			{
-				pos_world = p.position;
-				velocity_world = p.velocity;
+				pos_world = position;
+				velocity_world = velocity;
 			}
 			else
 			{
-                Matrix4x4 to_world = local_to_world * mat_scale_invert;
-				pos_world = to_world.MultiplyPoint3x4(p.position);
-				velocity_world = to_world.MultiplyDirection(p.velocity);
+				pos_world = m_fill.to_world.MultiplyPoint3x4(position);
+				velocity_world = m_fill.to_world.MultiplyDirection(velocity);
 			}
 
-			auto render_mode = ps->m_renderer->render_mode;
+			auto render_mode = m_renderer->render_mode;
 
-			if (render_mode == ParticleSystemRenderMode::Stretch && Mathf::FloatEqual(p.velocity.SqrMagnitude(), 0))
+			if (render_mode == ParticleSystemRenderMode::Stretch && Mathf::FloatEqual(velocity.SqrMagnitude(), 0))
 			{
 				render_mode = ParticleSystemRenderMode::Billboard;
 			}
@@ -388,12 +805,12 @@ namespace Viry3D
 				auto& v2 = vs[index * 4 + 2];
 				auto& v3 = vs[index * 4 + 3];
 
-				auto rot = Quaternion::Euler(p.rotation * Mathf::Rad2Deg);
+				auto rot = Quaternion::Euler(rotation * Mathf::Rad2Deg);
 				Vector3 pos_view = world_to_camera.MultiplyPoint3x4(pos_world);
-				v0.vertex = pos_view + rot * Vector3(-p.size.x * 0.5f, p.size.y * 0.5f, 0.0f);
-				v1.vertex = pos_view + rot * Vector3(-p.size.x * 0.5f, -p.size.y * 0.5f, 0.0f);
-				v2.vertex = pos_view + rot * Vector3(p.size.x * 0.5f, -p.size.y * 0.5f, 0.0f);
-				v3.vertex = pos_view + rot * Vector3(p.size.x * 0.5f, p.size.y * 0.5f, 0.0f);
+				v0.vertex = pos_view + rot * Vector3(-size.x * 0.5f, size.y * 0.5f, 0.0f);
+				v1.vertex = pos_view + rot * Vector3(-size.x * 0.5f, -size.y * 0.5f, 0.0f);
+				v2.vertex = pos_view + rot * Vector3(size.x * 0.5f, -size.y * 0.5f, 0.0f);
+				v3.vertex = pos_view + rot * Vector3(size.x * 0.5f, size.y * 0.5f, 0.0f);
 				v0.vertex = camera_to_world.MultiplyPoint3x4(v0.vertex);
 				v1.vertex = camera_to_world.MultiplyPoint3x4(v1.vertex);
 				v2.vertex = camera_to_world.MultiplyPoint3x4(v2.vertex);
@@ -407,7 +824,7 @@ namespace Viry3D
 				auto& v3 = vs[index * 4 + 3];
                 
 				Vector3 forward = Vector3::Normalize(velocity_world);
-				Vector3 right = forward * Camera::Current()->GetTransform()->GetForward();
+				Vector3 right = forward * m_fill.camera_forward;
 				Quaternion rot;
 				if (Mathf::FloatEqual(right.SqrMagnitude(), 0))
 				{
@@ -418,11 +835,11 @@ namespace Viry3D
 					Vector3 up = forward * right;
 					rot = Quaternion::LookRotation(forward, up);
 				}
-				float length = p.size.y * ps->m_renderer->length_scale + velocity_world.Magnitude() * ps->m_renderer->velocity_scale;
-                v0.vertex = pos_world + rot * Vector3(-p.size.x * 0.5f, 0.0f, 0);
-                v1.vertex = pos_world + rot * Vector3(-p.size.x * 0.5f, 0.0f, -length);
-                v2.vertex = pos_world + rot * Vector3(p.size.x * 0.5f, 0.0f, -length);
-                v3.vertex = pos_world + rot * Vector3(p.size.x * 0.5f, 0.0f, 0);
+				float length = size.y * m_renderer->length_scale + velocity_world.Magnitude() * m_renderer->velocity_scale;
+                v0.vertex = pos_world + rot * Vector3(-size.x * 0.5f, 0.0f, 0);
+                v1.vertex = pos_world + rot * Vector3(-size.x * 0.5f, 0.0f, -length);
+                v2.vertex = pos_world + rot * Vector3(size.x * 0.5f, 0.0f, -length);
+                v3.vertex = pos_world + rot * Vector3(size.x * 0.5f, 0.0f, 0);
 			}
 			else if (render_mode == ParticleSystemRenderMode::HorizontalBillboard)
 			{
@@ -431,11 +848,11 @@ namespace Viry3D
 				auto& v2 = vs[index * 4 + 2];
 				auto& v3 = vs[index * 4 + 3];
 				
-				auto rot = Quaternion::Euler(Vector3(0, 0, p.rotation.z) * Mathf::Rad2Deg);
-				v0.vertex = pos_world + rot * Vector3(-p.size.x * 0.5f, 0, p.size.y * 0.5f);
-				v1.vertex = pos_world + rot * Vector3(-p.size.x * 0.5f, 0, -p.size.y * 0.5f);
-				v2.vertex = pos_world + rot * Vector3(p.size.x * 0.5f, 0, -p.size.y * 0.5f);
-				v3.vertex = pos_world + rot * Vector3(p.size.x * 0.5f, 0, p.size.y * 0.5f);
+				auto rot = Quaternion::Euler(Vector3(0, 0, rotation.z) * Mathf::Rad2Deg);
+				v0.vertex = pos_world + rot * Vector3(-size.x * 0.5f, 0, size.y * 0.5f);
+				v1.vertex = pos_world + rot * Vector3(-size.x * 0.5f, 0, -size.y * 0.5f);
+				v2.vertex = pos_world + rot * Vector3(size.x * 0.5f, 0, -size.y * 0.5f);
+				v3.vertex = pos_world + rot * Vector3(size.x * 0.5f, 0, size.y * 0.5f);
 			}
 			else if (render_mode == ParticleSystemRenderMode::VerticalBillboard)
 			{
@@ -444,35 +861,34 @@ namespace Viry3D
 				auto& v2 = vs[index * 4 + 2];
 				auto& v3 = vs[index * 4 + 3];
 
-				auto cam_rot = Camera::Current()->GetTransform()->GetRotation().ToEulerAngles();
-				auto rot = Quaternion::Euler(Vector3(0, cam_rot.y, p.rotation.z * Mathf::Rad2Deg));
-				v0.vertex = pos_world + rot * Vector3(-p.size.x * 0.5f, p.size.y * 0.5f, 0);
-				v1.vertex = pos_world + rot * Vector3(-p.size.x * 0.5f, -p.size.y * 0.5f, 0);
-				v2.vertex = pos_world + rot * Vector3(p.size.x * 0.5f, -p.size.y * 0.5f, 0);
-				v3.vertex = pos_world + rot * Vector3(p.size.x * 0.5f, p.size.y * 0.5f, 0);
+				auto rot = Quaternion::Euler(Vector3(0, m_fill.camera_euler.y, rotation.z * Mathf::Rad2Deg));
+				v0.vertex = pos_world + rot * Vector3(-size.x * 0.5f, size.y * 0.5f, 0);
+				v1.vertex = pos_world + rot * Vector3(-size.x * 0.5f, -size.y * 0.5f, 0);
+				v2.vertex = pos_world + rot * Vector3(size.x * 0.5f, -size.y * 0.5f, 0);
+				v3.vertex = pos_world + rot * Vector3(size.x * 0.5f, size.y * 0.5f, 0);
 			}
 			else if (render_mode == ParticleSystemRenderMode::Mesh)
 			{
-				auto rot = Quaternion::Euler(p.rotation * Mathf::Rad2Deg);
+				auto rot = Quaternion::Euler(rotation * Mathf::Rad2Deg);
 
-				const auto& mesh = ps->m_renderer->mesh;
+				const auto& mesh = m_renderer->mesh;
 				int vertex_count = mesh->vertices.Size();
 				for (int j = 0; j < vertex_count; j++)
 				{
 					auto& v = vs[index * vertex_count + j];
 
                     Vector3 pos_view = world_to_camera.MultiplyPoint3x4(pos_world);
-                    v.vertex = pos_view + Matrix4x4::TRS(Vector3(0, 0, 0), rot, p.size).MultiplyPoint3x4(mesh->vertices[j]);
+                    v.vertex = pos_view + Matrix4x4::TRS(Vector3(0, 0, 0), rot, size).MultiplyPoint3x4(mesh->vertices[j]);
                     v.vertex = camera_to_world.MultiplyPoint3x4(v.vertex);
 
 					v.uv = mesh->uv[j];
 					if (mesh->colors.Size() > 0)
 					{
-						v.color = p.color * mesh->colors[j];
+						v.color = color * mesh->colors[j];
 					}
 					else
 					{
-						v.color = p.color;
+						v.color = color;
 					}
 				}
 			}
@@ -486,34 +902,70 @@ namespace Viry3D
 
 				if (render_mode == ParticleSystemRenderMode::Stretch)
 				{
-					v0.uv = Vector2(p.uv_scale_offset.z, p.uv_scale_offset.y + p.uv_scale_offset.w);
-					v1.uv = Vector2(p.uv_scale_offset.x + p.uv_scale_offset.z, p.uv_scale_offset.y + p.uv_scale_offset.w);
-					v2.uv = Vector2(p.uv_scale_offset.x + p.uv_scale_offset.z, p.uv_scale_offset.w);
-					v3.uv = Vector2(p.uv_scale_offset.z, p.uv_scale_offset.w);
+					v0.uv = Vector2(uv_scale_offset.z, uv_scale_offset.y + uv_scale_offset.w);
+					v1.uv = Vector2(uv_scale_offset.x + uv_scale_offset.z, uv_scale_offset.y + uv_scale_offset.w);
+					v2.uv = Vector2(uv_scale_offset.x + uv_scale_offset.z, uv_scale_offset.w);
+					v3.uv = Vector2(uv_scale_offset.z, uv_scale_offset.w);
 				}
 				else
 				{
-					v0.uv = Vector2(p.uv_scale_offset.z, p.uv_scale_offset.w);
-					v1.uv = Vector2(p.uv_scale_offset.z, p.uv_scale_offset.y + p.uv_scale_offset.w);
-					v2.uv = Vector2(p.uv_scale_offset.x + p.uv_scale_offset.z, p.uv_scale_offset.y + p.uv_scale_offset.w);
-					v3.uv = Vector2(p.uv_scale_offset.x + p.uv_scale_offset.z, p.uv_scale_offset.w);
+					v0.uv = Vector2(uv_scale_offset.z, uv_scale_offset.w);
+					v1.uv = Vector2(uv_scale_offset.z, uv_scale_offset.y + uv_scale_offset.w);
+					v2.uv = Vector2(uv_scale_offset.x + uv_scale_offset.z, uv_scale_offset.y + uv_scale_offset.w);
+					v3.uv = Vector2(uv_scale_offset.x + uv_scale_offset.z, uv_scale_offset.w);
 				}
 				
-				v0.color = p.color;
-				v1.color = p.color;
-				v2.color = p.color;
-				v3.color = p.color;
+				v0.color = color;
+				v1.color = color;
+				v2.color = color;
+				v3.color = color;
 			}
 		}
 	}
 
+	void ParticleSystem::FillInstances(int start, int end) const
+	{
+		auto is = m_instances;
+		bool world = main.simulation_space == ParticleSystemSimulationSpace::World;
+		bool stretch = m_renderer->render_mode == ParticleSystemRenderMode::Stretch;
+
+		const auto& particles = m_particles;
+		for (int index = start; index < end; index++)
+		{
+			const Vector3& position = particles.position[index];
+			const Vector3& velocity = particles.velocity[index];
+			const Vector3& size = particles.size[index];
+			auto& instance = is[index];
+
+			Vector3 pos_world = world ? position : m_fill.to_world.MultiplyPoint3x4(position);
+			instance.position = Vector4(pos_world.x, pos_world.y, pos_world.z, particles.rotation[index].z);
+
+			if (stretch && !Mathf::FloatEqual(velocity.SqrMagnitude(), 0))
+			{
+				Vector3 velocity_world = world ? velocity : m_fill.to_world.MultiplyDirection(velocity);
+				float speed = velocity_world.Magnitude();
+				float length = size.y * m_renderer->length_scale + speed * m_renderer->velocity_scale;
+				Vector3 direction = velocity_world * (1.0f / speed);
+				instance.direction = Vector4(direction.x, direction.y, direction.z, length);
+			}
+			else
+			{
+				instance.direction = Vector4(0, 0, 0, 0);
+			}
+
+			instance.size = Vector2(size.x, size.y);
+			instance.color = particles.color[index];
+			instance.uv_scale_offset = particles.uv_scale_offset[index];
+		}
+	}
+
 	void ParticleSystem::FillIndexBuffer(void* param, const ByteBuffer& buffer)
 	{
 		auto ps = (ParticleSystem*) param;
 		MemoryStream ms(buffer);
 
 		int index_offset = 0;
-		for (const auto& i : ps->m_particles)
+		for (int i = 0; i < ps->m_particles.count; i++)
 		{
 			if (ps->m_renderer->render_mode == ParticleSystemRenderMode::Mesh)
 			{
@@ -538,13 +990,58 @@ namespace Viry3D
 		ms.Close();
 	}
 
-	void ParticleSystem::UpdateBuffer()
+	bool ParticleSystem::BeginFillBuffer()
 	{
-		if (m_particles.Size() == 0)
+		if (!m_renderer || m_particles.count == 0)
 		{
-			return;
+			return false;
 		}
 
+		if (this->IsInstancing())
+		{
+			if (!m_quad_vertex_buffer)
+			{
+				// corners in xy, uv of billboard corners
+				Vertex vs[4];
+				Memory::Zero(vs, sizeof(vs));
+				vs[0].vertex = Vector3(-0.5f, 0.5f, 0);
+				vs[1].vertex = Vector3(-0.5f, -0.5f, 0);
+				vs[2].vertex = Vector3(0.5f, -0.5f, 0);
+				vs[3].vertex = Vector3(0.5f, 0.5f, 0);
+				vs[0].uv = Vector2(0, 0);
+				vs[1].uv = Vector2(0, 1);
+				vs[2].uv = Vector2(1, 1);
+				vs[3].uv = Vector2(1, 0);
+				for (int i = 0; i < 4; i++)
+				{
+					vs[i].color = Color(1, 1, 1, 1);
+				}
+
+				unsigned short is[6] = { 0, 1, 2, 0, 2, 3 };
+
+				m_quad_vertex_buffer = VertexBuffer::Create(sizeof(vs), true);
+				m_quad_vertex_buffer->UpdateRange(0, sizeof(vs), vs);
+				m_quad_index_buffer = IndexBuffer::Create(sizeof(is), true);
+				m_quad_index_buffer->UpdateRange(0, sizeof(is), is);
+			}
+
+			int instance_buffer_size = m_particles.count * sizeof(ParticleInstance);
+			if (!m_instance_buffer || m_instance_buffer->GetSize() < instance_buffer_size)
+			{
+				m_instance_buffer = VertexBuffer::Create(instance_buffer_size, true);
+			}
+
+			if (main.simulation_space != ParticleSystemSimulationSpace::World)
+			{
+				auto world_scale = this->GetTransform()->GetScale();
+				auto mat_scale_invert = Matrix4x4::Scaling(Vector3(1.0f / world_scale.x, 1.0f / world_scale.y, 1.0f / world_scale.z));
+				m_fill.to_world = this->GetTransform()->GetLocalToWorldMatrix() * mat_scale_invert;
+			}
+
+			m_instances = (ParticleInstance*) m_instance_buffer->Map().Bytes();
+
+			return true;
+		}
 		int vertex_count_per_particle = 4;
 		int index_count_per_particle = 6;
 
@@ -554,397 +1051,420 @@ namespace Viry3D
 			index_count_per_particle = m_renderer->mesh->triangles.Size();
 		}
 
-		int vertex_count = m_particles.Size() * vertex_count_per_particle;
+		int vertex_count = m_particles.count * vertex_count_per_particle;
 		assert(vertex_count < 65536);
 		int vertex_buffer_size = vertex_count * sizeof(Vertex);
 		if (!m_vertex_buffer || m_vertex_buffer->GetSize() < vertex_buffer_size)
 		{
 			m_vertex_buffer = VertexBuffer::Create(vertex_buffer_size, true);
 		}
-		m_vertex_buffer->Fill(this, ParticleSystem::FillVertexBuffer);
 
-		int index_count = m_particles.Size() * index_count_per_particle;
+		int index_count = m_particles.count * index_count_per_particle;
 		int index_buffer_size = index_count * sizeof(unsigned short);
 		if (!m_index_buffer || m_index_buffer->GetSize() < index_buffer_size)
 		{
 			m_index_buffer = IndexBuffer::Create(index_buffer_size, false);
 			m_index_buffer->Fill(this, ParticleSystem::FillIndexBuffer);
 		}
+
+		const auto& camera = Camera::Current()->GetTransform();
+		auto world_scale = this->GetTransform()->GetScale();
+		auto mat_scale_invert = Matrix4x4::Scaling(Vector3(1.0f / world_scale.x, 1.0f / world_scale.y, 1.0f / world_scale.z));
+		m_fill.camera_to_world = camera->GetLocalToWorldMatrix();
+		m_fill.world_to_camera = camera->GetWorldToLocalMatrix();
+		m_fill.to_world = this->GetTransform()->GetLocalToWorldMatrix() * mat_scale_invert;
+		m_fill.camera_forward = camera->GetForward();
+		m_fill.camera_euler = camera->GetRotation().ToEulerAngles();
+
+		m_vertices = (Vertex*) m_vertex_buffer->Map().Bytes();
+
+		return true;
 	}
 
 	void ParticleSystem::GetIndexRange(int submesh_index, int& start, int& count)
 	{
+		start = 0;
+
+		if (this->IsInstancing())
+		{
+			// one quad drawn per instance
+			count = m_particles.count > 0 ? 6 : 0;
+			return;
+		}
+
 		int index_count_per_particle = 6;
 		if (m_renderer->render_mode == ParticleSystemRenderMode::Mesh)
 		{
 			index_count_per_particle = m_renderer->mesh->triangles.Size();
 		}
 
-		start = 0;
-		count = m_particles.Size() * index_count_per_particle;
+		count = m_particles.count * index_count_per_particle;
 	}
 
-	void ParticleSystem::UpdateParticleVelocity(Particle& p)
+	void ParticleSystem::UpdateParticleLifetime()
 	{
-		Vector3 v = Vector3(0, 0, 0);
-		float delta_time = Time::GetDeltaTime() * main.simulation_speed;
-		float lifetime_t = Mathf::Clamp01((p.start_lifetime - p.remaining_lifetime) / p.start_lifetime);
-		auto mat_scale = Matrix4x4::Scaling(this->GetTransform()->GetScale());
-		auto local_to_world = this->GetTransform()->GetLocalToWorldMatrix();
-		auto world_to_local = this->GetTransform()->GetWorldToLocalMatrix();
-
-        if (main.simulation_space == ParticleSystemSimulationSpace::World)
-        {
-            v += p.start_velocity;
-        }
-        else
-        {
-            v += mat_scale.MultiplyPoint3x4(p.start_velocity);
-        }
-
-		if (velocity_over_lifetime.enabled)
+		auto& ps = m_particles;
+		float now = Time::GetTime();
+		float speed = main.simulation_speed;
+		float* remaining = &ps.remaining_lifetime[0];
+		const float* start = &ps.start_lifetime[0];
+		const float* emit = &ps.emit_time[0];
+
+		int i = 0;
+#if VR_PARTICLE_SSE
+		__m128 vnow = _mm_set1_ps(now);
+		__m128 vspeed = _mm_set1_ps(speed);
+		for (; i + 4 <= ps.count; i += 4)
+		{
+			__m128 age = _mm_mul_ps(_mm_sub_ps(vnow, _mm_loadu_ps(&emit[i])), vspeed);
+			_mm_storeu_ps(&remaining[i], _mm_sub_ps(_mm_loadu_ps(&start[i]), age));
+		}
+#elif VR_PARTICLE_NEON
+		float32x4_t vnow = vdupq_n_f32(now);
+		float32x4_t vspeed = vdupq_n_f32(speed);
+		for (; i + 4 <= ps.count; i += 4)
+		{
+			float32x4_t age = vmulq_f32(vsubq_f32(vnow, vld1q_f32(&emit[i])), vspeed);
+			vst1q_f32(&remaining[i], vsubq_f32(vld1q_f32(&start[i]), age));
+		}
+#endif
+		for (; i < ps.count; i++)
 		{
-			float x = velocity_over_lifetime.x.Evaluate(lifetime_t, get_min_max_curve_lerp(p.velocity_over_lifetime_x_lerp));
-			float y = velocity_over_lifetime.y.Evaluate(lifetime_t, get_min_max_curve_lerp(p.velocity_over_lifetime_y_lerp));
-			float z = velocity_over_lifetime.z.Evaluate(lifetime_t, get_min_max_curve_lerp(p.velocity_over_lifetime_z_lerp));
+			remaining[i] = start[i] - (now - emit[i]) * speed;
+		}
+	}
 
-			if (main.simulation_space == ParticleSystemSimulationSpace::World)
+	void ParticleSystem::UpdateParticleVelocity(int start, int end)
+	{
+		auto& ps = m_particles;
+		bool world = main.simulation_space == ParticleSystemSimulationSpace::World;
+		float delta_time = m_delta_time;
+		auto mat_scale = Matrix4x4::Scaling(m_world_scale);
+		const auto& local_to_world = m_local_to_world;
+		const auto& world_to_local = m_world_to_local;
+
+		for (int i = start; i < end; i++)
+		{
+			if (world)
 			{
-				if (velocity_over_lifetime.space == ParticleSystemSimulationSpace::World)
-				{
-					v += mat_scale.MultiplyPoint3x4(Vector3(x, y, z));
-				}
-				else
-				{
-					v += local_to_world.MultiplyDirection(mat_scale.MultiplyPoint3x4(Vector3(x, y, z)));
-				}
+				ps.velocity[i] = ps.start_velocity[i];
 			}
 			else
 			{
-				if (velocity_over_lifetime.space == ParticleSystemSimulationSpace::World)
-				{
-					v += world_to_local.MultiplyDirection(mat_scale.MultiplyPoint3x4(Vector3(x, y, z)));
-				}
-				else
-				{
-					v += mat_scale.MultiplyPoint3x4(Vector3(x, y, z));
-				}
+				ps.velocity[i] = mat_scale.MultiplyPoint3x4(ps.start_velocity[i]);
 			}
 		}
 
-		if (force_over_lifetime.enabled)
+		if (velocity_over_lifetime.enabled)
 		{
-            float x = force_over_lifetime.x.Evaluate(lifetime_t, get_min_max_curve_lerp(p.force_over_lifetime_x_lerp));
-            float y = force_over_lifetime.y.Evaluate(lifetime_t, get_min_max_curve_lerp(p.force_over_lifetime_y_lerp));
-            float z = force_over_lifetime.z.Evaluate(lifetime_t, get_min_max_curve_lerp(p.force_over_lifetime_z_lerp));
-
-            Vector3 force = Vector3(x, y, z);
+			// scale then into simulation space
+			Matrix4x4 to_space = mat_scale;
+			bool module_world = velocity_over_lifetime.space == ParticleSystemSimulationSpace::World;
+			if (world && !module_world)
+			{
+				to_space = local_to_world * mat_scale;
+			}
+			else if (!world && module_world)
+			{
+				to_space = world_to_local * mat_scale;
+			}
 
-			if (main.simulation_space == ParticleSystemSimulationSpace::World)
+			for (int i = start; i < end; i++)
 			{
-				if (force_over_lifetime.space == ParticleSystemSimulationSpace::World)
-				{
-                    p.force_velocity += mat_scale.MultiplyPoint3x4(force) * delta_time;
-				}
-				else
-				{
-                    Vector3 local_v = mat_scale.MultiplyPoint3x4(force);
-                    float len = local_v.Magnitude();
-                    Vector3 world_v = local_to_world.MultiplyDirection(local_v);
-                    if (len > 0)
-                    {
-                        world_v = Vector3::Normalize(world_v) * len;
-                    }
-					p.force_velocity += world_v * delta_time;
-				}
+				float x = velocity_over_lifetime.x.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[VelocityOverLifetimeX][i]));
+				float y = velocity_over_lifetime.y.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[VelocityOverLifetimeY][i]));
+				float z = velocity_over_lifetime.z.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[VelocityOverLifetimeZ][i]));
+
+				ps.velocity[i] += to_space.MultiplyDirection(Vector3(x, y, z));
 			}
-			else
+		}
+
+		if (force_over_lifetime.enabled)
+		{
+			bool module_world = force_over_lifetime.space == ParticleSystemSimulationSpace::World;
+			const Matrix4x4& to_space = world ? local_to_world : world_to_local;
+
+			for (int i = start; i < end; i++)
 			{
-				if (force_over_lifetime.space == ParticleSystemSimulationSpace::World)
-				{
-                    Vector3 world_v = mat_scale.MultiplyPoint3x4(force);
-                    float len = world_v.Magnitude();
-                    Vector3 local_v = world_to_local.MultiplyDirection(world_v);
-                    if (len > 0)
-                    {
-                        local_v = Vector3::Normalize(local_v) * len;
-                    }
-					p.force_velocity += local_v * delta_time;
-				}
-				else
+				float x = force_over_lifetime.x.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[ForceOverLifetimeX][i]));
+				float y = force_over_lifetime.y.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[ForceOverLifetimeY][i]));
+				float z = force_over_lifetime.z.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[ForceOverLifetimeZ][i]));
+
+				Vector3 force = mat_scale.MultiplyPoint3x4(Vector3(x, y, z));
+
+				// other space keeps force length
+				if (world != module_world)
 				{
-					p.force_velocity += mat_scale.MultiplyPoint3x4(force) * delta_time;
+					float len = force.Magnitude();
+					force = to_space.MultiplyDirection(force);
+					if (len > 0)
+					{
+						force = Vector3::Normalize(force) * len;
+					}
 				}
+
+				ps.force_velocity[i] += force * delta_time;
 			}
 		}
 
-        // apply gravity
-        {
-            float gravity = -10.0f * main.gravity_modifier.Evaluate(lifetime_t, get_min_max_curve_lerp(main.gravity_modifier_lerp));
+		// apply gravity
+		{
+			float lerp = main.gravity_modifier_lerp;
+
+			for (int i = start; i < end; i++)
+			{
+				float gravity = -10.0f * main.gravity_modifier.Evaluate(ps.lifetime_t[i], lerp);
 
-            p.force_velocity += Vector3(0, gravity, 0) * delta_time;
-        }
+				ps.force_velocity[i].y += gravity * delta_time;
+			}
+		}
 
-		v += p.force_velocity;
+		multiply_add((float*) &ps.velocity[start], (const float*) &ps.force_velocity[start], 1.0f, (end - start) * 3);
 
 		if (limit_velocity_over_lifetime.enabled)
 		{
+			float dampen = 1.0f - limit_velocity_over_lifetime.dampen;
+
 			if (limit_velocity_over_lifetime.separate_axes)
 			{
-				float x = limit_velocity_over_lifetime.limit_x.Evaluate(lifetime_t, get_min_max_curve_lerp(p.limit_velocity_over_lifetime_limit_x_lerp));
-				float y = limit_velocity_over_lifetime.limit_y.Evaluate(lifetime_t, get_min_max_curve_lerp(p.limit_velocity_over_lifetime_limit_y_lerp));
-				float z = limit_velocity_over_lifetime.limit_z.Evaluate(lifetime_t, get_min_max_curve_lerp(p.limit_velocity_over_lifetime_limit_z_lerp));
-				Vector3 limit;
+				Matrix4x4 to_space = mat_scale;
+				bool module_world = limit_velocity_over_lifetime.space == ParticleSystemSimulationSpace::World;
+				if (world && !module_world)
+				{
+					to_space = local_to_world * mat_scale;
+				}
+				else if (!world && module_world)
+				{
+					to_space = world_to_local * mat_scale;
+				}
 
-				if (main.simulation_space == ParticleSystemSimulationSpace::World)
+				for (int i = start; i < end; i++)
 				{
-					if (limit_velocity_over_lifetime.space == ParticleSystemSimulationSpace::World)
+					float x = limit_velocity_over_lifetime.limit_x.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[LimitVelocityOverLifetimeX][i]));
+					float y = limit_velocity_over_lifetime.limit_y.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[LimitVelocityOverLifetimeY][i]));
+					float z = limit_velocity_over_lifetime.limit_z.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[LimitVelocityOverLifetimeZ][i]));
+					Vector3 limit = to_space.MultiplyDirection(Vector3(x, y, z));
+					Vector3& v = ps.velocity[i];
+
+					if (v.x > limit.x)
 					{
-						limit = mat_scale.MultiplyPoint3x4(Vector3(x, y, z));
+						v.x = limit.x + (v.x - limit.x) * dampen;
 					}
-					else
+					if (v.y > limit.y)
 					{
-						limit = local_to_world.MultiplyDirection(mat_scale.MultiplyPoint3x4(Vector3(x, y, z)));
+						v.y = limit.y + (v.y - limit.y) * dampen;
 					}
-				}
-				else
-				{
-					if (limit_velocity_over_lifetime.space == ParticleSystemSimulationSpace::World)
-					{
-						limit = world_to_local.MultiplyDirection(mat_scale.MultiplyPoint3x4(Vector3(x, y, z)));
-					}
-					else
+					if (v.z > limit.z)
 					{
-						limit = mat_scale.MultiplyPoint3x4(Vector3(x, y, z));
+						v.z = limit.z + (v.z - limit.z) * dampen;
 					}
 				}
-
-				if (v.x > limit.x)
-				{
-					float exceed = v.x - limit.x;
-					exceed *= 1.0f - limit_velocity_over_lifetime.dampen;
-					v.x = limit.x + exceed;
-				}
-				if (v.y > limit.y)
-				{
-					float exceed = v.y - limit.y;
-					exceed *= 1.0f - limit_velocity_over_lifetime.dampen;
-					v.y = limit.y + exceed;
-				}
-				if (v.z > limit.z)
-				{
-					float exceed = v.z - limit.z;
-					exceed *= 1.0f - limit_velocity_over_lifetime.dampen;
-					v.z = limit.z + exceed;
-				}
 			}
 			else
 			{
-				float limit = limit_velocity_over_lifetime.limit.Evaluate(lifetime_t, get_min_max_curve_lerp(p.limit_velocity_over_lifetime_limit_lerp));
-				float mag = v.Magnitude();
-				if (mag > limit)
+				for (int i = start; i < end; i++)
 				{
-					float exceed = mag - limit;
-					exceed *= 1.0f - limit_velocity_over_lifetime.dampen;
-					v = Vector3::Normalize(v) * (limit + exceed);
+					float limit = limit_velocity_over_lifetime.limit.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[LimitVelocityOverLifetime][i]));
+					Vector3& v = ps.velocity[i];
+					float mag = v.Magnitude();
+					if (mag > limit)
+					{
+						v = Vector3::Normalize(v) * (limit + (mag - limit) * dampen);
+					}
 				}
 			}
 		}
+	}
+
+	void ParticleSystem::UpdateParticleSpeed(const Vector2& range, int start, int end)
+	{
+		auto& ps = m_particles;
 
-		p.velocity = v;
+		for (int i = start; i < end; i++)
+		{
+			float speed = ps.velocity[i].Magnitude();
+			ps.speed_t[i] = Mathf::Clamp01((speed - range.x) / (range.y - range.x));
+		}
 	}
 
-	void ParticleSystem::UpdateParticleAngularVelocity(Particle& p)
+	void ParticleSystem::UpdateParticleAngularVelocity(int start, int end)
 	{
-		Vector3 v = Vector3(0, 0, 0);
+		auto& ps = m_particles;
 
-		if (rotation_over_lifetime.enabled)
+		for (int i = start; i < end; i++)
 		{
-			float lifetime_t = Mathf::Clamp01((p.start_lifetime - p.remaining_lifetime) / p.start_lifetime);
+			ps.angular_velocity[i] = Vector3(0, 0, 0);
+		}
 
-			if (rotation_over_lifetime.separate_axes)
-			{
-				v.x += rotation_over_lifetime.x.Evaluate(lifetime_t, get_min_max_curve_lerp(p.rotation_over_lifetime_x_lerp));
-				v.y += rotation_over_lifetime.y.Evaluate(lifetime_t, get_min_max_curve_lerp(p.rotation_over_lifetime_y_lerp));
-				v.z += rotation_over_lifetime.z.Evaluate(lifetime_t, get_min_max_curve_lerp(p.rotation_over_lifetime_z_lerp));
-			}
-			else
+		if (rotation_over_lifetime.enabled)
+		{
+			for (int i = start; i < end; i++)
 			{
-				v.z += rotation_over_lifetime.z.Evaluate(lifetime_t, get_min_max_curve_lerp(p.rotation_over_lifetime_z_lerp));
+				Vector3& v = ps.angular_velocity[i];
+
+				if (rotation_over_lifetime.separate_axes)
+				{
+					v.x += rotation_over_lifetime.x.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[RotationOverLifetimeX][i]));
+					v.y += rotation_over_lifetime.y.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[RotationOverLifetimeY][i]));
+				}
+				v.z += rotation_over_lifetime.z.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[RotationOverLifetimeZ][i]));
 			}
 		}
 
 		if (rotation_by_speed.enabled)
 		{
-			float speed = p.velocity.Magnitude();
-			float speed_t = (speed - rotation_by_speed.range.x) / (rotation_by_speed.range.y - rotation_by_speed.range.x);
-			speed_t = Mathf::Clamp01(speed_t);
+			UpdateParticleSpeed(rotation_by_speed.range, start, end);
 
-			if (rotation_by_speed.separate_axes)
-			{
-				v.x += rotation_by_speed.x.Evaluate(speed_t, get_min_max_curve_lerp(p.rotation_by_speed_x_lerp));
-				v.y += rotation_by_speed.y.Evaluate(speed_t, get_min_max_curve_lerp(p.rotation_by_speed_y_lerp));
-				v.z += rotation_by_speed.z.Evaluate(speed_t, get_min_max_curve_lerp(p.rotation_by_speed_z_lerp));
-			}
-			else
+			for (int i = start; i < end; i++)
 			{
-				v.z += rotation_by_speed.z.Evaluate(speed_t, get_min_max_curve_lerp(p.rotation_by_speed_z_lerp));
+				Vector3& v = ps.angular_velocity[i];
+
+				if (rotation_by_speed.separate_axes)
+				{
+					v.x += rotation_by_speed.x.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[RotationBySpeedX][i]));
+					v.y += rotation_by_speed.y.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[RotationBySpeedY][i]));
+				}
+				v.z += rotation_by_speed.z.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[RotationBySpeedZ][i]));
 			}
 		}
-
-		p.angular_velocity = v;
 	}
 
-	void ParticleSystem::UpdateParticleColor(Particle& p)
+	void ParticleSystem::UpdateParticleColor(int start, int end)
 	{
-		Color c = p.start_color;
+		auto& ps = m_particles;
+
+		Memory::Copy(&ps.color[start], &ps.start_color[start], (end - start) * sizeof(Color));
 
 		if (color_over_lifetime.enabled)
 		{
-			float lifetime_t = Mathf::Clamp01((p.start_lifetime - p.remaining_lifetime) / p.start_lifetime);
-			c *= color_over_lifetime.color.Evaluate(lifetime_t, get_min_max_curve_lerp(p.color_over_lifetime_color_lerp));
+			for (int i = start; i < end; i++)
+			{
+				ps.colors[i] = color_over_lifetime.color.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[ColorOverLifetime][i]));
+			}
+
+			multiply((float*) &ps.color[start], (const float*) &ps.colors[start], (end - start) * 4);
 		}
 
 		if (color_by_speed.enabled)
 		{
-			float speed = p.velocity.Magnitude();
-			float speed_t = (speed - color_by_speed.range.x) / (color_by_speed.range.y - color_by_speed.range.x);
-			speed_t = Mathf::Clamp01(speed_t);
+			UpdateParticleSpeed(color_by_speed.range, start, end);
 
-			c *= color_by_speed.color.Evaluate(speed_t, get_min_max_curve_lerp(p.color_by_speed_color_lerp));
-		}
+			for (int i = start; i < end; i++)
+			{
+				ps.colors[i] = color_by_speed.color.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[ColorBySpeed][i]));
+			}
 
-		p.color = c;
+			multiply((float*) &ps.color[start], (const float*) &ps.colors[start], (end - start) * 4);
+		}
 	}
 
-	void ParticleSystem::UpdateParticleSize(Particle& p)
+	void ParticleSystem::UpdateParticleSize(int start, int end)
 	{
-		Vector3 s = p.start_size;
+		auto& ps = m_particles;
+		Vector3 scale(1, 1, 1);
 
 		if (main.scaling_mode == ParticleSystemScalingMode::Hierarchy)
 		{
-			Vector3 scale = this->GetTransform()->GetScale();
-			s.x *= scale.x;
-			s.y *= scale.y;
-			s.z *= scale.z;
+			scale = m_world_scale;
 		}
 		else if (main.scaling_mode == ParticleSystemScalingMode::Local)
 		{
-			Vector3 scale = this->GetTransform()->GetLocalScale();
-			s.x *= scale.x;
-			s.y *= scale.y;
-			s.z *= scale.z;
+			scale = m_local_scale;
 		}
 
-		if (size_over_lifetime.enabled)
+		for (int i = start; i < end; i++)
 		{
-			float lifetime_t = Mathf::Clamp01((p.start_lifetime - p.remaining_lifetime) / p.start_lifetime);
-
-			if (size_over_lifetime.separate_axes)
-			{
-				s.x *= size_over_lifetime.x.Evaluate(lifetime_t, get_min_max_curve_lerp(p.size_over_lifetime_x_lerp));
-				s.y *= size_over_lifetime.y.Evaluate(lifetime_t, get_min_max_curve_lerp(p.size_over_lifetime_y_lerp));
-				s.z *= size_over_lifetime.z.Evaluate(lifetime_t, get_min_max_curve_lerp(p.size_over_lifetime_z_lerp));
-			}
-			else
-			{
-				s *= size_over_lifetime.size.Evaluate(lifetime_t, get_min_max_curve_lerp(p.size_over_lifetime_size_lerp));
-			}
+			const Vector3& s = ps.start_size[i];
+			ps.size[i] = Vector3(s.x * scale.x, s.y * scale.y, s.z * scale.z);
 		}
 
-		if (size_by_speed.enabled)
+		if (size_over_lifetime.enabled)
 		{
-			float speed = p.velocity.Magnitude();
-			float speed_t = (speed - size_by_speed.range.x) / (size_by_speed.range.y - size_by_speed.range.x);
-			speed_t = Mathf::Clamp01(speed_t);
-
-			if (size_by_speed.separate_axes)
-			{
-				s.x *= size_by_speed.x.Evaluate(speed_t, get_min_max_curve_lerp(p.size_by_speed_x_lerp));
-				s.y *= size_by_speed.y.Evaluate(speed_t, get_min_max_curve_lerp(p.size_by_speed_y_lerp));
-				s.z *= size_by_speed.z.Evaluate(speed_t, get_min_max_curve_lerp(p.size_by_speed_z_lerp));
-			}
-			else
+			for (int i = start; i < end; i++)
 			{
-				s *= size_by_speed.size.Evaluate(speed_t, get_min_max_curve_lerp(p.size_by_speed_size_lerp));
+				Vector3& s = ps.size[i];
+
+				if (size_over_lifetime.separate_axes)
+				{
+					s.x *= size_over_lifetime.x.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[SizeOverLifetimeX][i]));
+					s.y *= size_over_lifetime.y.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[SizeOverLifetimeY][i]));
+					s.z *= size_over_lifetime.z.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[SizeOverLifetimeZ][i]));
+				}
+				else
+				{
+					s *= size_over_lifetime.size.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[SizeOverLifetime][i]));
+				}
 			}
 		}
 
-		p.size = s;
-	}
-
-	void ParticleSystem::UpdateParticleUV(Particle& p)
-	{
-		if (texture_sheet_animation.enabled)
+		if (size_by_speed.enabled)
 		{
-			p.uv_scale_offset.x = 1.0f / texture_sheet_animation.num_tiles_x;
-			p.uv_scale_offset.y = 1.0f / texture_sheet_animation.num_tiles_y;
-
-			int row = 0;
-			int start_frame;
-			int frame_over_time;
+			UpdateParticleSpeed(size_by_speed.range, start, end);
 
-			if (texture_sheet_animation.animation == ParticleSystemAnimationType::SingleRow)
+			for (int i = start; i < end; i++)
 			{
-				if (texture_sheet_animation.use_random_row)
+				Vector3& s = ps.size[i];
+
+				if (size_by_speed.separate_axes)
 				{
-					row = p.texture_sheet_animation_row;
+					s.x *= size_by_speed.x.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[SizeBySpeedX][i]));
+					s.y *= size_by_speed.y.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[SizeBySpeedY][i]));
+					s.z *= size_by_speed.z.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[SizeBySpeedZ][i]));
 				}
 				else
 				{
-					row = texture_sheet_animation.row_index;
+					s *= size_by_speed.size.Evaluate(ps.speed_t[i], get_min_max_curve_lerp(ps.lerps[SizeBySpeed][i]));
 				}
 			}
+		}
+	}
 
-			if (texture_sheet_animation.animation == ParticleSystemAnimationType::SingleRow)
-			{
-				start_frame = (int) (texture_sheet_animation.num_tiles_x * texture_sheet_animation.start_frame.Evaluate(0, get_min_max_curve_lerp(p.texture_sheet_animation_start_frame_lerp)));
-			}
-			else
-			{
-				start_frame = (int) (texture_sheet_animation.num_tiles_x * texture_sheet_animation.num_tiles_y * texture_sheet_animation.start_frame.Evaluate(0, get_min_max_curve_lerp(p.texture_sheet_animation_start_frame_lerp)));
-			}
+	void ParticleSystem::UpdateParticleUV(int start, int end)
+	{
+		auto& ps = m_particles;
 
-			float lifetime_t = Mathf::Clamp01((p.start_lifetime - p.remaining_lifetime) / p.start_lifetime);
-			if (texture_sheet_animation.animation == ParticleSystemAnimationType::SingleRow)
+		if (!texture_sheet_animation.enabled)
+		{
+			for (int i = start; i < end; i++)
 			{
-				frame_over_time = (int) (texture_sheet_animation.num_tiles_x * texture_sheet_animation.frame_over_time.Evaluate(lifetime_t, get_min_max_curve_lerp(p.texture_sheet_animation_frame_over_time_lerp)));
+				ps.uv_scale_offset[i] = Vector4(1, 1, 0, 0);
 			}
-			else
+			return;
+		}
+
+		const auto& sheet = texture_sheet_animation;
+		bool single_row = sheet.animation == ParticleSystemAnimationType::SingleRow;
+		int frame_count = single_row ? sheet.num_tiles_x : sheet.num_tiles_x * sheet.num_tiles_y;
+		float scale_x = 1.0f / sheet.num_tiles_x;
+		float scale_y = 1.0f / sheet.num_tiles_y;
+
+		for (int i = start; i < end; i++)
+		{
+			int row = 0;
+			if (single_row)
 			{
-				frame_over_time = (int) (texture_sheet_animation.num_tiles_x * texture_sheet_animation.num_tiles_y * texture_sheet_animation.frame_over_time.Evaluate(lifetime_t, get_min_max_curve_lerp(p.texture_sheet_animation_frame_over_time_lerp)));
+				row = sheet.use_random_row ? ps.texture_sheet_animation_row[i] : sheet.row_index;
 			}
 
-			int frame = row * texture_sheet_animation.num_tiles_x + start_frame + frame_over_time;
-			frame = frame % (texture_sheet_animation.num_tiles_x * texture_sheet_animation.num_tiles_y);
-			int x = frame % texture_sheet_animation.num_tiles_x;
-			int y = frame / texture_sheet_animation.num_tiles_x;
-			p.uv_scale_offset.z = x * p.uv_scale_offset.x;
-			p.uv_scale_offset.w = y * p.uv_scale_offset.y;
-		}
-		else
-		{
-			p.uv_scale_offset = Vector4(1, 1, 0, 0);
+			int start_frame = (int) (frame_count * texture_sheet_animation.start_frame.Evaluate(0, get_min_max_curve_lerp(ps.lerps[TextureSheetAnimationStartFrame][i])));
+			int frame_over_time = (int) (frame_count * texture_sheet_animation.frame_over_time.Evaluate(ps.lifetime_t[i], get_min_max_curve_lerp(ps.lerps[TextureSheetAnimationFrameOverTime][i])));
+
+			int frame = row * sheet.num_tiles_x + start_frame + frame_over_time;
+			frame = frame % (sheet.num_tiles_x * sheet.num_tiles_y);
+			int x = frame % sheet.num_tiles_x;
+			int y = frame / sheet.num_tiles_x;
+			ps.uv_scale_offset[i] = Vector4(scale_x, scale_y, x * scale_x, y * scale_y);
 		}
 	}
 
-	void ParticleSystem::UpdateParticlePosition(Particle& p)
+	void ParticleSystem::UpdateParticlePosition(int start, int end)
 	{
-		float delta_time = Time::GetDeltaTime() * main.simulation_speed;
-
-		p.position += p.velocity * delta_time;
+		multiply_add((float*) &m_particles.position[start], (const float*) &m_particles.velocity[start], m_delta_time, (end - start) * 3);
 	}
 
-	void ParticleSystem::UpdateParticleRotation(Particle& p)
+	void ParticleSystem::UpdateParticleRotation(int start, int end)
 	{
-		float delta_time = Time::GetDeltaTime() * main.simulation_speed;
-
-		p.rotation += p.angular_velocity * delta_time;
-	}
-
-	void ParticleSystem::UpdateParticleLifetime(Particle& p)
-	{
-		p.remaining_lifetime = p.start_lifetime - (Time::GetTime() - p.emit_time) * main.simulation_speed;
+		multiply_add((float*) &m_particles.rotation[start], (const float*) &m_particles.angular_velocity[start], m_delta_time, (end - start) * 3);
 	}
 
 	void ParticleSystem::EmitShapeSphere(Vector3& position, Vector3& velocity, bool hemi)
@@ -952,20 +1472,20 @@ namespace Viry3D
 		Vector3 dir;
 		do
 		{
-			dir.x = Mathf::RandomRange(-0.5f, 0.5f);
-			dir.y = Mathf::RandomRange(-0.5f, 0.5f);
+			dir.x = random_range(-0.5f, 0.5f);
+			dir.y = random_range(-0.5f, 0.5f);
 			if (hemi)
 			{
-				dir.z = Mathf::RandomRange(0.0f, 0.5f);
+				dir.z = random_range(0.0f, 0.5f);
 			}
 			else
 			{
-				dir.z = Mathf::RandomRange(-0.5f, 0.5f);
+				dir.z = random_range(-0.5f, 0.5f);
 			}
 		} while (Mathf::FloatEqual(dir.SqrMagnitude(), 0));
 		dir.Normalize();
 
-		float radius = Mathf::RandomRange(shape.radius * (1.0f - shape.radius_thickness), shape.radius);
+		float radius = random_range(shape.radius * (1.0f - shape.radius_thickness), shape.radius);
 		position = dir * radius;
 		velocity = dir;
 
@@ -974,9 +1494,9 @@ namespace Viry3D
 			Vector3 dir;
 			do
 			{
-				dir.x = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.y = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.z = Mathf::RandomRange(-0.5f, 0.5f);
+				dir.x = random_range(-0.5f, 0.5f);
+				dir.y = random_range(-0.5f, 0.5f);
+				dir.z = random_range(-0.5f, 0.5f);
 			} while (Mathf::FloatEqual(dir.SqrMagnitude(), 0));
 
 			velocity = Vector3::Lerp(velocity, Vector3::Normalize(dir), shape.random_direction_amount);
@@ -988,7 +1508,7 @@ namespace Viry3D
 	{
 		float angle = Mathf::Clamp(shape.angle, 1.0f, 89.0f);
 		Vector3 origin = Vector3(0, 0, -shape.radius / tanf(angle * Mathf::Deg2Rad));
-		float arc = Mathf::RandomRange(0.0f, shape.arc);
+		float arc = random_range(0.0f, shape.arc);
 		float z = 0;
 		float radius = 0;
 
@@ -997,14 +1517,14 @@ namespace Viry3D
 			case ParticleSystemShapeType::Cone:
 			{
 				z = 0;
-				radius = Mathf::RandomRange(shape.radius * (1.0f - shape.radius_thickness), shape.radius);
+				radius = random_range(shape.radius * (1.0f - shape.radius_thickness), shape.radius);
 				break;
 			}
 			case ParticleSystemShapeType::ConeVolume:
 			{
-				z = Mathf::RandomRange(0.0f, shape.length);
+				z = random_range(0.0f, shape.length);
 				radius = tanf(angle * Mathf::Deg2Rad) / (fabsf(origin.z) + z);
-				radius = Mathf::RandomRange(radius * (1.0f - shape.radius_thickness), radius);
+				radius = random_range(radius * (1.0f - shape.radius_thickness), radius);
 				break;
 			}
             default:
@@ -1019,7 +1539,7 @@ namespace Viry3D
 		if (shape.random_direction_amount > 0)
 		{
 			Vector3 dir;
-			float r = Mathf::RandomRange(0.0f, shape.radius);
+			float r = random_range(0.0f, shape.radius);
 			Vector3 pos = Vector3(r * cosf(arc * Mathf::Deg2Rad), r * sinf(arc * Mathf::Deg2Rad), 0);
 			dir = pos - origin;
 
@@ -1038,9 +1558,9 @@ namespace Viry3D
 
 	void ParticleSystem::EmitShapeBox(Vector3& position, Vector3& velocity)
 	{
-		float x = Mathf::RandomRange(-0.5f, 0.5f) * shape.scale.x;
-		float y = Mathf::RandomRange(-0.5f, 0.5f) * shape.scale.y;
-		float z = Mathf::RandomRange(-0.5f, 0.5f) * shape.scale.z;
+		float x = random_range(-0.5f, 0.5f) * shape.scale.x;
+		float y = random_range(-0.5f, 0.5f) * shape.scale.y;
+		float z = random_range(-0.5f, 0.5f) * shape.scale.z;
 
 		switch (shape.shape_type)
 		{
@@ -1053,7 +1573,7 @@ namespace Viry3D
 			}
 			case ParticleSystemShapeType::BoxShell:
 			{
-				int side = Mathf::RandomRange(0, 6);
+				int side = random_range(0, 6);
 				switch (side)
 				{
 					case 0:
@@ -1091,7 +1611,7 @@ namespace Viry3D
 			}
 			case ParticleSystemShapeType::BoxEdge:
 			{
-				int edge = Mathf::RandomRange(0, 12);
+				int edge = random_range(0, 12);
 				switch (edge)
 				{
 					case 0:
@@ -1166,9 +1686,9 @@ namespace Viry3D
 			Vector3 dir;
 			do
 			{
-				dir.x = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.y = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.z = Mathf::RandomRange(-0.5f, 0.5f);
+				dir.x = random_range(-0.5f, 0.5f);
+				dir.y = random_range(-0.5f, 0.5f);
+				dir.z = random_range(-0.5f, 0.5f);
 			} while (Mathf::FloatEqual(dir.SqrMagnitude(), 0));
 
 			velocity = Vector3::Lerp(velocity, Vector3::Normalize(dir), shape.random_direction_amount);
@@ -1186,8 +1706,8 @@ namespace Viry3D
 
 	void ParticleSystem::EmitShapeCircle(Vector3& position, Vector3& velocity)
 	{
-		float arc = Mathf::RandomRange(0.0f, shape.arc);
-		float radius = Mathf::RandomRange(shape.radius * (1.0f - shape.radius_thickness), shape.radius);
+		float arc = random_range(0.0f, shape.arc);
+		float radius = random_range(shape.radius * (1.0f - shape.radius_thickness), shape.radius);
 
 		float x = radius * cosf(arc * Mathf::Deg2Rad);
 		float y = radius * sinf(arc * Mathf::Deg2Rad);
@@ -1199,8 +1719,8 @@ namespace Viry3D
 			Vector3 dir;
 			do
 			{
-				dir.x = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.y = Mathf::RandomRange(-0.5f, 0.5f);
+				dir.x = random_range(-0.5f, 0.5f);
+				dir.y = random_range(-0.5f, 0.5f);
 				dir.z = 0;
 			} while (Mathf::FloatEqual(dir.SqrMagnitude(), 0));
 
@@ -1211,7 +1731,7 @@ namespace Viry3D
 
 	void ParticleSystem::EmitShapeEdge(Vector3& position, Vector3& velocity)
 	{
-		float x = Mathf::RandomRange(-1.0f, 1.0f) * shape.radius;
+		float x = random_range(-1.0f, 1.0f) * shape.radius;
 
 		position = Vector3(x, 0, 0);
 		velocity = Vector3(0, 1, 0);
@@ -1221,9 +1741,9 @@ namespace Viry3D
 			Vector3 dir;
 			do
 			{
-				dir.x = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.y = Mathf::RandomRange(-0.5f, 0.5f);
-				dir.z = Mathf::RandomRange(-0.5f, 0.5f);
+				dir.x = random_range(-0.5f, 0.5f);
+				dir.y = random_range(-0.5f, 0.5f);
+				dir.z = random_range(-0.5f, 0.5f);
 			} while (Mathf::FloatEqual(dir.SqrMagnitude(), 0));
 
 			velocity = Vector3::Lerp(velocity, Vector3::Normalize(dir), shape.random_direction_amount);
@@ -1239,10 +1759,56 @@ namespace Viry3D
 		}
 	}
 
+	void ParticleSystem::MinMaxCurve::Bake(int resolution)
+	{
+		m_baked_min.Clear();
+		m_baked_max.Clear();
+
+		if (resolution < 2)
+		{
+			return;
+		}
+
+		if (mode == ParticleSystemCurveMode::Curve)
+		{
+			m_baked_min.Resize(resolution);
+			for (int i = 0; i < resolution; i++)
+			{
+				m_baked_min[i] = curve.EvaluateKeys(i / (float) (resolution - 1)) * curve_multiplier;
+			}
+		}
+		else if (mode == ParticleSystemCurveMode::TwoCurves)
+		{
+			m_baked_min.Resize(resolution);
+			m_baked_max.Resize(resolution);
+			for (int i = 0; i < resolution; i++)
+			{
+				m_baked_min[i] = curve_min.EvaluateKeys(i / (float) (resolution - 1)) * curve_multiplier;
+				m_baked_max[i] = curve_max.EvaluateKeys(i / (float) (resolution - 1)) * curve_multiplier;
+			}
+		}
+	}
+
 	float ParticleSystem::MinMaxCurve::Evaluate(float time, float lerp)
 	{
 		time = Mathf::Clamp01(time);
 
+		if (!m_baked_min.Empty())
+		{
+			float x = time * (m_baked_min.Size() - 1);
+			int i = Mathf::Min((int) x, m_baked_min.Size() - 2);
+			float t = x - i;
+			float min = m_baked_min[i] + (m_baked_min[i + 1] - m_baked_min[i]) * t;
+
+			if (m_baked_max.Empty())
+			{
+				return min;
+			}
+
+			float max = m_baked_max[i] + (m_baked_max[i + 1] - m_baked_max[i]) * t;
+			return min + (max - min) * lerp;
+		}
+
 		if (mode == ParticleSystemCurveMode::Constant)
 		{
 			return constant;
@@ -1263,29 +1829,65 @@ namespace Viry3D
 		return 0;
 	}
 
+	void Gradient::Bake(int resolution)
+	{
+		m_baked.Clear();
+
+		if (mode != GradientMode::Blend || resolution < 2 || r.GetKeys().Empty() || a.GetKeys().Empty())
+		{
+			return;
+		}
+
+		m_baked.Resize(resolution);
+		for (int i = 0; i < resolution; i++)
+		{
+			m_baked[i] = this->EvaluateKeys(i / (float) (resolution - 1));
+		}
+	}
+
 	Color Gradient::Evaluate(float time)
+	{
+		if (!m_baked.Empty())
+		{
+			float x = Mathf::Clamp01(time) * (m_baked.Size() - 1);
+			int i = Mathf::Min((int) x, m_baked.Size() - 2);
+			float t = x - i;
+			const Color& c0 = m_baked[i];
+			const Color& c1 = m_baked[i + 1];
+
+			return Color(
+				c0.r + (c1.r - c0.r) * t,
+				c0.g + (c1.g - c0.g) * t,
+				c0.b + (c1.b - c0.b) * t,
+				c0.a + (c1.a - c0.a) * t);
+		}
+
+		return this->EvaluateKeys(time);
+	}
+
+	Color Gradient::EvaluateKeys(float time)
 	{
 		Color c;
 
-		if (time <= r.keys[0].time)
+		if (time <= r.GetKey(0).time)
 		{
-			c.r = r.keys[0].value;
-			c.g = g.keys[0].value;
-			c.b = b.keys[0].value;
+			c.r = r.GetKey(0).value;
+			c.g = g.GetKey(0).value;
+			c.b = b.GetKey(0).value;
 		}
-		else if (time >= r.keys[r.keys.Size() - 1].time)
+		else if (time >= r.GetKey(r.GetKeyCount() - 1).time)
 		{
-			c.r = r.keys[r.keys.Size() - 1].value;
-			c.g = g.keys[r.keys.Size() - 1].value;
-			c.b = b.keys[r.keys.Size() - 1].value;
+			c.r = r.GetKey(r.GetKeyCount() - 1).value;
+			c.g = g.GetKey(r.GetKeyCount() - 1).value;
+			c.b = b.GetKey(r.GetKeyCount() - 1).value;
 		}
 		else
 		{
 			int index;
 
-			for (int i = 0; i < r.keys.Size() - 1; i++)
+			for (int i = 0; i < r.GetKeyCount() - 1; i++)
 			{
-				if (time > r.keys[i].time && time <= r.keys[i + 1].time)
+				if (time > r.GetKey(i).time && time <= r.GetKey(i + 1).time)
 				{
 					index = i;
 					break;
@@ -1294,34 +1896,34 @@ namespace Viry3D
 
 			if (mode == GradientMode::Blend)
 			{
-				float t = (time - r.keys[index].time) / (r.keys[index + 1].time - r.keys[index].time);
-				c.r = Mathf::Lerp(r.keys[index].value, r.keys[index + 1].value, t);
-				c.g = Mathf::Lerp(g.keys[index].value, g.keys[index + 1].value, t);
-				c.b = Mathf::Lerp(b.keys[index].value, b.keys[index + 1].value, t);
+				float t = (time - r.GetKey(index).time) / (r.GetKey(index + 1).time - r.GetKey(index).time);
+				c.r = Mathf::Lerp(r.GetKey(index).value, r.GetKey(index + 1).value, t);
+				c.g = Mathf::Lerp(g.GetKey(index).value, g.GetKey(index + 1).value, t);
+				c.b = Mathf::Lerp(b.GetKey(index).value, b.GetKey(index + 1).value, t);
 			}
 			else if (mode == GradientMode::Fixed)
 			{
-				c.r = r.keys[index + 1].value;
-				c.g = g.keys[index + 1].value;
-				c.b = b.keys[index + 1].value;
+				c.r = r.GetKey(index + 1).value;
+				c.g = g.GetKey(index + 1).value;
+				c.b = b.GetKey(index + 1).value;
 			}
 		}
 
-		if (time <= a.keys[0].time)
+		if (time <= a.GetKey(0).time)
 		{
-			c.a = a.keys[0].value;
+			c.a = a.GetKey(0).value;
 		}
-		else if (time >= a.keys[a.keys.Size() - 1].time)
+		else if (time >= a.GetKey(a.GetKeyCount() - 1).time)
 		{
-			c.a = a.keys[a.keys.Size() - 1].value;
+			c.a = a.GetKey(a.GetKeyCount() - 1).value;
 		}
 		else
 		{
 			int index;
 
-			for (int i = 0; i < a.keys.Size() - 1; i++)
+			for (int i = 0; i < a.GetKeyCount() - 1; i++)
 			{
-				if (time > a.keys[i].time && time <= a.keys[i + 1].time)
+				if (time > a.GetKey(i).time && time <= a.GetKey(i + 1).time)
 				{
 					index = i;
 					break;
@@ -1330,18 +1932,31 @@ namespace Viry3D
 
 			if (mode == GradientMode::Blend)
 			{
-				float t = (time - a.keys[index].time) / (a.keys[index + 1].time - a.keys[index].time);
-				c.a = Mathf::Lerp(a.keys[index].value, a.keys[index + 1].value, t);
+				float t = (time - a.GetKey(index).time) / (a.GetKey(index + 1).time - a.GetKey(index).time);
+				c.a = Mathf::Lerp(a.GetKey(index).value, a.GetKey(index + 1).value, t);
 			}
 			else if (mode == GradientMode::Fixed)
 			{
-				c.a = a.keys[index + 1].value;
+				c.a = a.GetKey(index + 1).value;
 			}
 		}
 
 		return c;
 	}
 
+	void ParticleSystem::MinMaxGradient::Bake(int resolution)
+	{
+		if (mode == ParticleSystemGradientMode::Gradient || mode == ParticleSystemGradientMode::RandomColor)
+		{
+			gradient.Bake(resolution);
+		}
+		else if (mode == ParticleSystemGradientMode::TwoGradients)
+		{
+			gradient_min.Bake(resolution);
+			gradient_max.Bake(resolution);
+		}
+	}
+
 	Color ParticleSystem::MinMaxGradient::Evaluate(float time, float lerp)
 	{
 		time = Mathf::Clamp01(time);
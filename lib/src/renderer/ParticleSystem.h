@@ -26,10 +26,16 @@
 #include "math/Vector3.h"
 #include "math/Matrix4x4.h"
 #include "container/Vector.h"
-#include "container/FastList.h"
+#include "container/List.h"
+#include "thread/Thread.h"
+#include <functional>
 
 namespace Viry3D
 {
+	class Renderer;
+	struct Vertex;
+	struct ParticleInstance;
+
 	enum class ParticleSystemCurveMode
 	{
 		None = -1,
@@ -116,6 +122,15 @@ namespace Viry3D
 
 		Gradient(): mode(GradientMode::None) { }
 		Color Evaluate(float time);
+		Color EvaluateKeys(float time);
+		//
+		//	blend mode sampled into a lookup table over time 0 to 1,
+		//	fixed mode keeps the key search, bake again after keys changed
+		//
+		void Bake(int resolution = AnimationCurve::BakeResolution);
+
+	private:
+		Vector<Color> m_baked;
 	};
 
 	class ParticleSystemRenderer;
@@ -139,6 +154,15 @@ namespace Viry3D
 
 			MinMaxCurve(): mode(ParticleSystemCurveMode::None) { }
 			float Evaluate(float time, float lerp);
+			//
+			//	curve modes sampled into lookup tables over time 0 to 1 with multiplier applied,
+			//	bake again after curves changed
+			//
+			void Bake(int resolution = AnimationCurve::BakeResolution);
+
+		private:
+			Vector<float> m_baked_min;
+			Vector<float> m_baked_max;
 		};
 
 		struct MinMaxGradient
@@ -153,6 +177,7 @@ namespace Viry3D
 
 			MinMaxGradient(): mode(ParticleSystemGradientMode::None) { }
 			Color Evaluate(float time, float lerp);
+			void Bake(int resolution = AnimationCurve::BakeResolution);
 		};
 
 		struct MainModule
@@ -348,62 +373,153 @@ namespace Viry3D
 			int uv_channel_mask;
 		};
 
+		//
+		//	start state of one particle, filled by emission
+		//
 		struct Particle
 		{
 			float start_lifetime;
-			float remaining_lifetime;
+			float emit_time;
 			Vector3 start_size;
 			Color start_color;
-			Vector3 start_velocity;
-			Vector3 force_velocity;
 			Vector3 velocity;
-			Vector3 angular_velocity;
-			Color color;
-			Vector3 size;
 			Vector3 position;
 			Vector3 rotation;
+			int texture_sheet_animation_row;
 
-			float velocity_over_lifetime_x_lerp = -1;
-			float velocity_over_lifetime_y_lerp = -1;
-			float velocity_over_lifetime_z_lerp = -1;
-			float force_over_lifetime_x_lerp = -1;
-			float force_over_lifetime_y_lerp = -1;
-			float force_over_lifetime_z_lerp = -1;
-			float limit_velocity_over_lifetime_limit_x_lerp = -1;
-			float limit_velocity_over_lifetime_limit_y_lerp = -1;
-			float limit_velocity_over_lifetime_limit_z_lerp = -1;
-			float limit_velocity_over_lifetime_limit_lerp = -1;
-			float rotation_over_lifetime_x_lerp = -1;
-			float rotation_over_lifetime_y_lerp = -1;
-			float rotation_over_lifetime_z_lerp = -1;
-			float rotation_by_speed_x_lerp = -1;
-			float rotation_by_speed_y_lerp = -1;
-			float rotation_by_speed_z_lerp = -1;
-			float color_over_lifetime_color_lerp = -1;
-			float color_by_speed_color_lerp = -1;
-			float size_over_lifetime_x_lerp = -1;
-			float size_over_lifetime_y_lerp = -1;
-			float size_over_lifetime_z_lerp = -1;
-			float size_over_lifetime_size_lerp = -1;
-			float size_by_speed_x_lerp = -1;
-			float size_by_speed_y_lerp = -1;
-			float size_by_speed_z_lerp = -1;
-			float size_by_speed_size_lerp = -1;
-			float texture_sheet_animation_start_frame_lerp = -1;
-			float texture_sheet_animation_frame_over_time_lerp = -1;
+			Particle(): start_lifetime(0), emit_time(0), texture_sheet_animation_row(0) { }
+		};
 
-			float emit_time;
-			Vector4 uv_scale_offset;
-			int texture_sheet_animation_row;
+		//
+		//	random lerp of each MinMaxCurve / MinMaxGradient per particle,
+		//	index into Particles::lerps
+		//
+		enum ParticleLerp
+		{
+			VelocityOverLifetimeX,
+			VelocityOverLifetimeY,
+			VelocityOverLifetimeZ,
+			ForceOverLifetimeX,
+			ForceOverLifetimeY,
+			ForceOverLifetimeZ,
+			LimitVelocityOverLifetimeX,
+			LimitVelocityOverLifetimeY,
+			LimitVelocityOverLifetimeZ,
+			LimitVelocityOverLifetime,
+			RotationOverLifetimeX,
+			RotationOverLifetimeY,
+			RotationOverLifetimeZ,
+			RotationBySpeedX,
+			RotationBySpeedY,
+			RotationBySpeedZ,
+			ColorOverLifetime,
+			ColorBySpeed,
+			SizeOverLifetimeX,
+			SizeOverLifetimeY,
+			SizeOverLifetimeZ,
+			SizeOverLifetime,
+			SizeBySpeedX,
+			SizeBySpeedY,
+			SizeBySpeedZ,
+			SizeBySpeed,
+			TextureSheetAnimationStartFrame,
+			TextureSheetAnimationFrameOverTime,
+
+			ParticleLerpCount
+		};
 
-			Particle(): start_lifetime(0), remaining_lifetime(0) { }
+		//
+		//	live particles as one array per attribute, packed in [0, count),
+		//	capacity grows to main.max_particles and never shrinks,
+		//	dead particles are swap removed
+		//
+		struct Particles
+		{
+			int count;
+			int capacity;
+			Vector<float> start_lifetime;
+			Vector<float> remaining_lifetime;
+			Vector<float> emit_time;
+			Vector<Vector3> start_size;
+			Vector<Color> start_color;
+			Vector<Vector3> start_velocity;
+			Vector<Vector3> force_velocity;
+			Vector<Vector3> velocity;
+			Vector<Vector3> angular_velocity;
+			Vector<Color> color;
+			Vector<Vector3> size;
+			Vector<Vector3> position;
+			Vector<Vector3> rotation;
+			Vector<Vector4> uv_scale_offset;
+			Vector<int> texture_sheet_animation_row;
+			Vector<float> lerps[ParticleLerpCount];
+
+			// per update scratch, not swapped
+			Vector<float> lifetime_t;
+			Vector<float> speed_t;
+			Vector<Color> colors;
+
+			Particles(): count(0), capacity(0) { }
+			void Reserve(int size);
+			void Remove(int index);
+		};
+
+		struct Stats
+		{
+			long long update_count;
+			long long particle_count;
+			double update_time;
+		};
+
+		struct Job
+		{
+			ParticleSystem* system;
+			int start;
+			int end;
+		};
+
+		//
+		//	camera and transform state read by vertex fill jobs
+		//
+		struct FillParam
+		{
+			Matrix4x4 camera_to_world;
+			Matrix4x4 world_to_camera;
+			Matrix4x4 to_world;
+			Vector3 camera_forward;
+			Vector3 camera_euler;
 		};
 
 	public:
+		//
+		//	systems with more particles are split into jobs of this size
+		//
+		static const int JobParticleCount = 2048;
+
+		static void Deinit();
+		//
+		//	simulate all systems queued by Update this frame as jobs,
+		//	called once by World after all updates, returns after all jobs done
+		//
+		static void UpdateAll();
+		//
+		//	fill vertex buffers of visible particle renderers for current camera as jobs,
+		//	each system writes its own mapped buffer, returns after all jobs done
+		//
+		static void FillAll(const List<Renderer*>& renderers);
+		//
+		//	totals since start of all systems, update_time in seconds
+		//
+		static const Stats& GetStats() { return m_stats; }
 		virtual ~ParticleSystem();
+		//
+		//	bake lookup tables of all module curves and gradients,
+		//	done on start, call again after editing them at runtime
+		//
+		void BakeCurves();
 		int GetParticleCount() const;
-		const Ref<VertexBuffer>& GetVertexBuffer() const { return m_vertex_buffer; }
-		const Ref<IndexBuffer>& GetIndexBuffer() const { return m_index_buffer; }
+		const Ref<VertexBuffer>& GetVertexBuffer() const;
+		const Ref<IndexBuffer>& GetIndexBuffer() const;
 		void GetIndexRange(int submesh_index, int& start, int& count);
 
 	public:
@@ -426,10 +542,15 @@ namespace Viry3D
 	protected:
 		virtual void Start();
 		virtual void Update();
+		//
+		//	simulation touches only own particles, shared queue and stats are locked
+		//
+		virtual bool IsThreadSafeUpdate() const { return true; }
 
 	private:
-		static void FillVertexBuffer(void* param, const ByteBuffer& buffer);
 		static void FillIndexBuffer(void* param, const ByteBuffer& buffer);
+		static void AddJobs(ParticleSystem* system, int count);
+		static void RunJobs(const std::function<void(const Job&)>& run);
 
 		ParticleSystem();
 
@@ -438,29 +559,64 @@ namespace Viry3D
 		void EmitShapeBox(Vector3 &position, Vector3 &velocity);
 		void EmitShapeCircle(Vector3 &position, Vector3 &velocity);
 		void EmitShapeEdge(Vector3 &position, Vector3 &velocity);
-		void Emit(Particle& p);
-
-		void UpdateParticleVelocity(Particle& p);
-		void UpdateParticleAngularVelocity(Particle& p);
-		void UpdateParticleColor(Particle& p);
-		void UpdateParticleSize(Particle& p);
-		void UpdateParticleUV(Particle& p);
-		void UpdateParticlePosition(Particle& p);
-		void UpdateParticleRotation(Particle& p);
-		void UpdateParticleLifetime(Particle& p);
+		void Emit(const Particle& p);
+
+		//
+		//	each pass runs one module over particles from start to end,
+		//	only reading transform state saved by BeginUpdateParticles
+		//
+		void UpdateParticleLifetime();
+		void UpdateParticleVelocity(int start, int end);
+		void UpdateParticleAngularVelocity(int start, int end);
+		void UpdateParticleColor(int start, int end);
+		void UpdateParticleSize(int start, int end);
+		void UpdateParticleUV(int start, int end);
+		void UpdateParticlePosition(int start, int end);
+		void UpdateParticleRotation(int start, int end);
+		void UpdateParticleSpeed(const Vector2& range, int start, int end);
 
 		bool CheckTime();
 		void UpdateEmission();
-		void UpdateParticles();
-		void UpdateBuffer();
+		//
+		//	remove dead particles and save transform state on main thread
+		//
+		void BeginUpdateParticles();
+		void UpdateParticles(int start, int end);
+		//
+		//	resize buffers and save fill state on render thread,
+		//	return false if nothing to fill
+		//
+		bool BeginFillBuffer();
+		void FillVertices(int start, int end) const;
+		void FillInstances(int start, int end) const;
+		bool IsInstancing() const;
+		//
+		//	rotation on other axes than z, not supported by instanced shaders
+		//
+		bool IsRotation3D() const;
 
 	private:
-		FastList<Particle> m_particles;
+		static Stats m_stats;
+		static Vector<ParticleSystem*> m_update_queue;
+		static Mutex m_update_mutex;
+		static Vector<Job> m_jobs;
+		static Ref<VertexBuffer> m_quad_vertex_buffer;
+		static Ref<IndexBuffer> m_quad_index_buffer;
+		Particles m_particles;
 		float m_time_start;
 		float m_start_delay;
 		float m_time;
 		float m_time_emit;
+		float m_delta_time;
+		Matrix4x4 m_local_to_world;
+		Matrix4x4 m_world_to_local;
+		Vector3 m_world_scale;
+		Vector3 m_local_scale;
+		FillParam m_fill;
+		Vertex* m_vertices;
+		ParticleInstance* m_instances;
 		Ref<VertexBuffer> m_vertex_buffer;
+		Ref<VertexBuffer> m_instance_buffer;
 		Ref<IndexBuffer> m_index_buffer;
 		Ref<ParticleSystemRenderer> m_renderer;
 	};
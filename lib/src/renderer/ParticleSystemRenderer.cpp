@@ -18,12 +18,20 @@
 #include "ParticleSystemRenderer.h"
 #include "ParticleSystem.h"
 #include "GameObject.h"
+#include "graphics/Camera.h"
+#include "graphics/Material.h"
+#include "graphics/Shader.h"
 
 namespace Viry3D
 {
 	DEFINE_COM_CLASS(ParticleSystemRenderer);
 
-	ParticleSystemRenderer::ParticleSystemRenderer()
+	ParticleSystemRenderer::ParticleSystemRenderer():
+		enable_gpu_instancing(true),
+		m_instancing(false),
+		m_setup_render_mode(ParticleSystemRenderMode::None),
+		m_setup_rotation_3d(false),
+		m_setup_gpu_instancing(false)
 	{
 	}
 
@@ -32,6 +40,11 @@ namespace Viry3D
 		Renderer::DeepCopy(source);
 
 		auto src = RefCast<ParticleSystemRenderer>(source);
+		if (src->m_instancing)
+		{
+			// clone sets up its own instanced copies on start
+			this->SetSharedMaterials(src->m_source_materials);
+		}
 		this->render_mode = src->render_mode;
 		this->camera_velocity_scale = src->camera_velocity_scale;
 		this->velocity_scale = src->velocity_scale;
@@ -44,6 +57,7 @@ namespace Viry3D
 		this->max_particle_size = src->max_particle_size;
 		this->alignment = src->alignment;
 		this->pivot = src->pivot;
+		this->enable_gpu_instancing = src->enable_gpu_instancing;
 	}
 
 	const VertexBuffer* ParticleSystemRenderer::GetVertexBuffer() const
@@ -61,18 +75,110 @@ namespace Viry3D
 		m_particle_system.lock()->GetIndexRange(material_index, start, count);
 	}
 
+	const VertexBuffer* ParticleSystemRenderer::GetInstanceVertexBuffer(int& count) const
+	{
+		if (!m_instancing)
+		{
+			return NULL;
+		}
+
+		auto system = m_particle_system.lock();
+		count = system->GetParticleCount();
+		return system->m_instance_buffer.get();
+	}
+
 	void ParticleSystemRenderer::Start()
 	{
+		m_particle_system = this->GetGameObject()->GetComponent<ParticleSystem>();
+
+		this->SetupInstancing();
+
 		Renderer::Start();
+	}
 
-		m_particle_system = this->GetGameObject()->GetComponent<ParticleSystem>();
+	void ParticleSystemRenderer::UpdateInstancing()
+	{
+		auto system = m_particle_system.lock();
+		if (!system)
+		{
+			return;
+		}
+
+		if (render_mode != m_setup_render_mode ||
+			system->IsRotation3D() != m_setup_rotation_3d ||
+			enable_gpu_instancing != m_setup_gpu_instancing)
+		{
+			this->SetupInstancing();
+		}
+	}
+
+	void ParticleSystemRenderer::SetupInstancing()
+	{
+		auto system = m_particle_system.lock();
+
+		if (m_instancing)
+		{
+			this->SetSharedMaterials(m_source_materials);
+			m_source_materials.Clear();
+			m_instancing = false;
+		}
+
+		m_setup_render_mode = render_mode;
+		m_setup_rotation_3d = system && system->IsRotation3D();
+		m_setup_gpu_instancing = enable_gpu_instancing;
+
+		if (!enable_gpu_instancing || !system || system->IsRotation3D())
+		{
+			return;
+		}
+
+		if (render_mode != ParticleSystemRenderMode::Billboard && render_mode != ParticleSystemRenderMode::Stretch)
+		{
+			return;
+		}
+
+		const auto& mats = this->GetSharedMaterials();
+		if (mats.Empty())
+		{
+			return;
+		}
+
+		// own copies with the instanced shader, so other renderers of the material keep it
+		Vector<Ref<Material>> instanced_mats;
+		for (const auto& i : mats)
+		{
+			if (!i || !i->GetShader()->GetName().StartsWith("Particles/"))
+			{
+				return;
+			}
+
+			String shader_name = i->GetShader()->GetName() + " Instanced";
+			auto mat = Material::Create(shader_name);
+			if (mat->GetShader()->GetName() != shader_name)
+			{
+				return;
+			}
+			mat->DeepCopy(i);
+			instanced_mats.Add(mat);
+		}
+
+		m_source_materials = mats;
+		this->SetSharedMaterials(instanced_mats);
+		m_instancing = true;
 	}
 
-	void ParticleSystemRenderer::PreRenderByRenderer(int material_index)
+	void ParticleSystemRenderer::PreRenderByMaterial(int material_index)
 	{
-		Renderer::PreRenderByRenderer(material_index);
+		Renderer::PreRenderByMaterial(material_index);
 
-		m_particle_system.lock()->UpdateBuffer();
+		if (m_instancing)
+		{
+			const auto& mat = this->GetSharedMaterials()[material_index];
+			const auto& camera = Camera::Current()->GetTransform();
+			mat->SetVector("_CameraRight", camera->GetRight());
+			mat->SetVector("_CameraUp", camera->GetUp());
+			mat->SetVector("_CameraForward", camera->GetForward());
+		}
 	}
 
 	Matrix4x4 ParticleSystemRenderer::GetWorldMatrix()
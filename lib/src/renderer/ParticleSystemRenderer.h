@@ -54,9 +54,13 @@ namespace Viry3D
 	{
 		DECLARE_COM_CLASS(ParticleSystemRenderer, Renderer);
 	public:
+		friend class ParticleSystem;
+
 		virtual const VertexBuffer* GetVertexBuffer() const;
 		virtual const IndexBuffer* GetIndexBuffer() const;
 		virtual void GetIndexRange(int material_index, int& start, int& count) const;
+		virtual const VertexBuffer* GetInstanceVertexBuffer(int& count) const;
+		bool IsInstancing() const { return m_instancing; }
 
 	public:
 		ParticleSystemRenderMode render_mode;
@@ -71,16 +75,29 @@ namespace Viry3D
 		float max_particle_size;
 		ParticleSystemRenderSpace alignment;
 		Vector3 pivot;
+		//
+		//	billboard and stretch particles expanded in vertex shader from one instance each,
+		//	needs an instanced variant of each material shader,
+		//	checked on start and again when render mode or 3d rotation changes
+		//
+		bool enable_gpu_instancing;
 
 	protected:
 		virtual void Start();
-		virtual void PreRenderByRenderer(int material_index);
+		virtual void PreRenderByMaterial(int material_index);
 		virtual Matrix4x4 GetWorldMatrix();
 
 	private:
 		ParticleSystemRenderer();
+		void SetupInstancing();
+		void UpdateInstancing();
 
 	private:
 		WeakRef<ParticleSystem> m_particle_system;
+		bool m_instancing;
+		Vector<Ref<Material>> m_source_materials;
+		ParticleSystemRenderMode m_setup_render_mode;
+		bool m_setup_rotation_3d;
+		bool m_setup_gpu_instancing;
 	};
 }
@@ -24,14 +24,18 @@
 #include "graphics/Light.h"
 #include "graphics/RenderPass.h"
 #include "graphics/RenderQueue.h"
+#include "graphics/TextureStreaming.h"
 #include "ui/UICanvasRenderer.h"
 #include "io/MemoryStream.h"
 #include "time/Time.h"
 #include "MeshRenderer.h"
+#include "DynamicBatch.h"
+#include "ParticleSystem.h"
 #include "GameObject.h"
 #include "World.h"
 #include "Profiler.h"
 #include "Debug.h"
+#include <algorithm>
 
 namespace Viry3D
 {
@@ -43,9 +47,14 @@ namespace Viry3D
 	Mutex Renderer::m_mutex;
 	Ref<VertexBuffer> Renderer::m_static_vertex_buffer;
 	Ref<IndexBuffer> Renderer::m_static_index_buffer;
-	bool Renderer::m_static_buffers_binding = false;
-	int Renderer::m_batching_start = -1;
-	int Renderer::m_batching_count = -1;
+	thread_local bool Renderer::m_static_buffers_binding = false;
+	thread_local int Renderer::m_batching_start = -1;
+	thread_local int Renderer::m_batching_count = -1;
+	BoundsTree Renderer::m_renderer_tree;
+	int Renderer::m_renderer_tree_version = 0;
+	Vector<Renderer*> Renderer::m_unbounded_renderers;
+	int Renderer::m_renderers_version = 0;
+	int Renderer::m_pass_stamp = 0;
 
 	void Renderer::Init()
 	{
@@ -61,6 +70,11 @@ namespace Viry3D
 		m_static_buffers_binding = false;
 		m_batching_start = -1;
 		m_batching_count = -1;
+		m_renderer_tree.Clear();
+		m_renderer_tree_version++;
+		m_unbounded_renderers.Clear();
+		m_renderers_version++;
+		DynamicBatch::Deinit();
 	}
 
 	void Renderer::OnResize(int width, int height)
@@ -133,7 +147,7 @@ namespace Viry3D
 		return GetTransform()->GetLocalToWorldMatrix();
 	}
 
-	void Renderer::Render(int material_index, int pass_index)
+	void Renderer::Render(int material_index, int pass_index, int instance_count)
 	{
 		auto& mat = this->GetSharedMaterials()[material_index];
 		auto shader = mat->GetShader();
@@ -158,6 +172,14 @@ namespace Viry3D
 				Graphics::GetDisplay()->BindVertexArray();
 				Graphics::GetDisplay()->BindVertexBuffer(this->GetVertexBuffer());
 				Graphics::GetDisplay()->BindIndexBuffer(this->GetIndexBuffer(), index_type);
+
+				int instance_vertex_count = 0;
+				auto instance_vertex_buffer = this->GetInstanceVertexBuffer(instance_vertex_count);
+				if (instance_vertex_buffer)
+				{
+					Graphics::GetDisplay()->BindInstanceBuffer(instance_vertex_buffer);
+					instance_count = instance_vertex_count;
+				}
 			}
 			else
 			{
@@ -195,7 +217,7 @@ namespace Viry3D
 			}
 			else
 			{
-				Graphics::GetDisplay()->DrawIndexed(start, count, index_type);
+				Graphics::GetDisplay()->DrawIndexed(start, count, index_type, instance_count);
 				Graphics::GetDisplay()->DisableVertexArray(shader, pass_index);
 			}
 		}
@@ -218,7 +240,14 @@ namespace Viry3D
 			int old_lightmap_index = -1;
 			for (auto& i : pass)
 			{
+				if (i.instance_count == 0)
+				{
+					continue;
+				}
+
 				auto& mat = i.renderer->GetSharedMaterials()[i.material_index];
+				const Ref<DescriptorSet>& descriptor_set = i.instance_buffer ? i.instance_buffer->descriptor_set : i.renderer->m_descriptor_set;
+				Ref<UniformBuffer>& descriptor_set_buffer = i.instance_buffer ? i.instance_buffer->descriptor_set_buffer : i.renderer->m_descriptor_set_buffer;
 				bool bind_shared_mat = false;
 				bool bind_lightmap = false;
 				bool static_batch = i.renderer->m_batch_indices.Size() > 0;
@@ -286,11 +315,18 @@ namespace Viry3D
 				// Ǿ̬һ
 				if (!static_batch || !batching)
 				{
-					shader->BindMaterial(0, mat, i.renderer->m_descriptor_set);
-					shader->BindRendererDescriptorSet(0, i.renderer->m_descriptor_set_buffer, i.renderer->m_lightmap_index);
+					shader->BindMaterial(0, mat, descriptor_set);
+					shader->BindRendererDescriptorSet(0, descriptor_set_buffer, i.renderer->m_lightmap_index);
 				}
 
-				i.renderer->Render(i.material_index, 0);
+				if (i.dynamic_batch >= 0)
+				{
+					Renderer::RenderDynamicBatch(i.dynamic_batch, shader, 0);
+				}
+				else
+				{
+					i.renderer->Render(i.material_index, 0, Mathf::Max(i.instance_count, 1));
+				}
 			}
 
 			// passɣύʣ
@@ -310,6 +346,9 @@ namespace Viry3D
 			assert(pass.Size() == 1);
 
 			auto& i = first;
+			const Ref<DescriptorSet>& descriptor_set = i.instance_buffer ? i.instance_buffer->descriptor_set : i.renderer->m_descriptor_set;
+			Ref<UniformBuffer>& descriptor_set_buffer = i.instance_buffer ? i.instance_buffer->descriptor_set_buffer : i.renderer->m_descriptor_set_buffer;
+
 			for (int j = 0; j < i.shader_pass_count; j++)
 			{
 				int pass_index = j;
@@ -322,8 +361,8 @@ namespace Viry3D
 
 				auto& mat = i.renderer->GetSharedMaterials()[i.material_index];
 				shader->BindSharedMaterial(pass_index, mat);
-				shader->BindMaterial(pass_index, mat, i.renderer->m_descriptor_set);
-				shader->BindRendererDescriptorSet(pass_index, i.renderer->m_descriptor_set_buffer, i.renderer->m_lightmap_index);
+				shader->BindMaterial(pass_index, mat, descriptor_set);
+				shader->BindRendererDescriptorSet(pass_index, descriptor_set_buffer, i.renderer->m_lightmap_index);
 
 				i.renderer->Render(i.material_index, pass_index);
 
@@ -341,6 +380,23 @@ namespace Viry3D
 			shader = Shader::ReplaceToShadowMapShader(shader);
 		}
 
+		for (auto& i : pass)
+		{
+			i.instance_count = -1;
+			i.instance_buffer = NULL;
+			i.dynamic_batch = -1;
+		}
+
+		if (shader->IsInstancing())
+		{
+			Renderer::PrepareInstances(pass, shader);
+		}
+
+		if (first.shader_pass_count == 1 && !first.ui && DynamicBatch::GetVertexCountMax() > 0)
+		{
+			Renderer::PrepareDynamicBatches(pass, shader);
+		}
+
 		if (first.shader_pass_count == 1)
 		{
 			shader->PreparePass(0);
@@ -351,7 +407,10 @@ namespace Viry3D
 				auto& mat = i.renderer->GetSharedMaterials()[i.material_index];
 				int mat_id = mat->GetId();
 
-				i.renderer->PreRenderByRenderer(i.material_index);
+				if (i.instance_count < 0)
+				{
+					i.renderer->PreRenderByRenderer(i.material_index);
+				}
 
 				if (old_id == -1 || old_id != mat_id)
 				{
@@ -365,7 +424,10 @@ namespace Viry3D
 		else
 		{
 			auto& mat = first.renderer->GetSharedMaterials()[first.material_index];
-			first.renderer->PreRenderByRenderer(first.material_index);
+			if (first.instance_count < 0)
+			{
+				first.renderer->PreRenderByRenderer(first.material_index);
+			}
 			first.renderer->PreRenderByMaterial(first.material_index);
 
 			for (int i = 0; i < first.shader_pass_count; i++)
@@ -382,6 +444,214 @@ namespace Viry3D
 		}
 	}
 
+	//
+	//	opaque passes with same material, lightmap and mesh are drawn by the first one as instances,
+	//	others get instance count 0 and are skipped in CommitPass
+	//
+	void Renderer::PrepareInstances(List<MaterialPass>& pass, const Ref<Shader>& shader)
+	{
+		struct InstanceRun
+		{
+			MaterialPass* head;
+			const IndexBuffer* ib;
+			int start;
+			int count;
+			Vector<InstanceData> instances;
+		};
+
+		Vector<InstanceRun> runs;
+		Map<const VertexBuffer*, int> span_runs;
+		int old_id = -1;
+		int old_lightmap_index = -2;
+
+		for (auto& i : pass)
+		{
+			int mat_id = i.renderer->GetSharedMaterials()[i.material_index]->GetId();
+			int lightmap_index = i.renderer->m_lightmap_index;
+			bool static_batch = i.renderer->m_batch_indices.Size() > 0;
+
+			if (mat_id != old_id || lightmap_index != old_lightmap_index)
+			{
+				span_runs.Clear();
+			}
+			old_id = mat_id;
+			old_lightmap_index = lightmap_index;
+
+			InstanceData data;
+			if (static_batch)
+			{
+				data.world_matrix = Matrix4x4::Identity();
+				data.lightmap_scale_offset = Vector4(1, 1, 0, 0);
+			}
+			else
+			{
+				data.world_matrix = i.renderer->GetWorldMatrix();
+				if (lightmap_index >= 0)
+				{
+					data.lightmap_scale_offset = i.renderer->GetLightmapScaleOffset();
+				}
+				else
+				{
+					data.lightmap_scale_offset = Vector4(1, 1, 0, 0);
+				}
+			}
+
+			const VertexBuffer* vb = NULL;
+			const IndexBuffer* ib = NULL;
+			int start = 0;
+			int count = 0;
+			int* run_index = NULL;
+
+			if (!static_batch && i.queue < (int) RenderQueue::Transparent)
+			{
+				vb = i.renderer->GetVertexBuffer();
+				ib = i.renderer->GetIndexBuffer();
+				i.renderer->GetIndexRange(i.material_index, start, count);
+
+				if (vb != NULL && span_runs.TryGet(vb, &run_index))
+				{
+					const auto& run = runs[*run_index];
+					if (run.ib != ib ||
+						run.start != start ||
+						run.count != count ||
+						run.instances.Size() >= Graphics::InstanceCountMax)
+					{
+						run_index = NULL;
+					}
+				}
+				else
+				{
+					run_index = NULL;
+				}
+			}
+
+			if (run_index != NULL)
+			{
+				runs[*run_index].instances.Add(data);
+				i.instance_count = 0;
+				i.instance_buffer = NULL;
+			}
+			else
+			{
+				InstanceRun run;
+				run.head = &i;
+				run.ib = ib;
+				run.start = start;
+				run.count = count;
+				run.instances.Add(data);
+				runs.Add(run);
+
+				if (vb != NULL)
+				{
+					span_runs[vb] = runs.Size() - 1;
+				}
+			}
+		}
+
+		for (auto& i : runs)
+		{
+			i.head->instance_count = i.instances.Size();
+			i.head->instance_buffer = Graphics::GetInstanceBuffer(shader, &i.instances[0], i.instances.Size(), i.head->renderer->m_lightmap_index);
+		}
+	}
+
+	//
+	//	consecutive small mesh passes with same material and lightmap are merged into one DynamicBatch,
+	//	the first one draws it with identity world matrix, others get instance count 0
+	//
+	void Renderer::PrepareDynamicBatches(List<MaterialPass>& pass, const Ref<Shader>& shader)
+	{
+		Vector<MaterialPass*> span;
+
+		auto end_span = [&]() {
+			if (span.Size() >= 2)
+			{
+				auto first = span[0];
+				int batch = DynamicBatch::BeginBatch();
+
+				for (auto i : span)
+				{
+					auto r = (MeshRenderer*) i->renderer;
+
+					Vector4 lightmap_scale_offset(1, 1, 0, 0);
+					if (r->m_lightmap_index >= 0)
+					{
+						lightmap_scale_offset = r->GetLightmapScaleOffset();
+					}
+
+					DynamicBatch::Add(r->GetSharedMesh().get(), i->material_index, r->GetWorldMatrix(), lightmap_scale_offset);
+
+					i->instance_count = 0;
+					i->instance_buffer = NULL;
+				}
+
+				InstanceData data;
+				data.world_matrix = Matrix4x4::Identity();
+				data.lightmap_scale_offset = Vector4(1, 1, 0, 0);
+
+				first->instance_count = 1;
+				first->instance_buffer = Graphics::GetInstanceBuffer(shader, &data, 1, first->renderer->m_lightmap_index);
+				first->dynamic_batch = batch;
+
+				Graphics::dynamic_batched_draw_call += span.Size() - 1;
+			}
+
+			span.Clear();
+		};
+
+		int old_id = -1;
+		int old_lightmap_index = -2;
+
+		for (auto& i : pass)
+		{
+			// drawn by instancing, not break batch
+			if (i.instance_count == 0)
+			{
+				continue;
+			}
+
+			int mat_id = i.renderer->GetSharedMaterials()[i.material_index]->GetId();
+			int lightmap_index = i.renderer->m_lightmap_index;
+
+			bool batchable = false;
+			if (i.instance_count <= 1 && i.renderer->m_batch_indices.Empty())
+			{
+				auto r = dynamic_cast<MeshRenderer*>(i.renderer);
+				batchable = r != NULL && DynamicBatch::IsBatchable(r->GetSharedMesh().get());
+			}
+
+			if (!batchable || mat_id != old_id || lightmap_index != old_lightmap_index)
+			{
+				end_span();
+			}
+			old_id = mat_id;
+			old_lightmap_index = lightmap_index;
+
+			if (batchable)
+			{
+				span.Add(&i);
+			}
+		}
+
+		end_span();
+	}
+
+	void Renderer::RenderDynamicBatch(int batch, const Ref<Shader>& shader, int pass_index)
+	{
+		auto display = Graphics::GetDisplay();
+		int start;
+		int count;
+		DynamicBatch::GetBatchRange(batch, start, count);
+
+		m_static_buffers_binding = false;
+		display->BindVertexArray();
+		display->BindVertexBuffer(DynamicBatch::GetVertexBuffer());
+		display->BindIndexBuffer(DynamicBatch::GetIndexBuffer(), IndexType::UnsignedInt);
+		display->BindVertexAttribArray(shader, pass_index);
+		display->DrawIndexed(start, count, IndexType::UnsignedInt);
+		display->DisableVertexArray(shader, pass_index);
+	}
+
 	bool Renderer::IsRenderersDirty()
 	{
 		bool dirty;
@@ -411,33 +681,101 @@ namespace Viry3D
 		}
 	}
 
-    void Renderer::SetRendererDirty(Renderer* renderer)
-    {
-        for (auto& i : m_passes)
-        {
-            bool has_renderer = false;
+	void Renderer::SetRendererDirty(Renderer* renderer)
+	{
+		// kept passes of old version dropped and added again by incremental build
+		renderer->m_passes_version++;
 
-            for (auto j : i.second.culled_renderers)
-            {
-                if (j == renderer)
-                {
-                    has_renderer = true;
-                    break;
-                }
-            }
+		// not started renderers are in no culling result
+		if (!renderer->IsStarted())
+		{
+			return;
+		}
 
-            if (has_renderer)
-            {
-                i.second.passes_dirty = true;
-            }
-        }
-    }
+		for (auto& i : m_passes)
+		{
+			i.second.passes_dirty = true;
+		}
+	}
 
 	List<Renderer*>& Renderer::GetRenderers()
 	{
 		return m_renderers;
 	}
 
+	void Renderer::OnRenderersChanged()
+	{
+		// old indices become invalid by version
+		m_renderers_version++;
+		m_unbounded_renderers.Clear();
+
+		int index = 0;
+		for (auto i : m_renderers)
+		{
+			i->m_renderers_index = index++;
+			i->m_renderers_index_version = m_renderers_version;
+
+			if (i->m_tree_proxy < 0)
+			{
+				m_unbounded_renderers.Add(i);
+			}
+		}
+	}
+
+	void Renderer::QueryRenderers(const Bounds& bounds, List<Renderer*>& result)
+	{
+		Vector<void*> hits;
+		m_renderer_tree.Query(bounds, hits);
+
+		for (auto i : hits)
+		{
+			result.AddLast((Renderer*) i);
+		}
+	}
+
+	void Renderer::RaycastRenderers(const Ray& ray, float max_distance, List<Renderer*>& result)
+	{
+		Vector<void*> hits;
+		m_renderer_tree.Raycast(ray, max_distance, hits);
+
+		for (auto i : hits)
+		{
+			result.AddLast((Renderer*) i);
+		}
+	}
+
+	bool Renderer::IsUnbounded(const Bounds& bounds)
+	{
+		const float limit = 1e30f;
+		const auto& min = bounds.Min();
+		const auto& max = bounds.Max();
+
+		return min.x < -limit || min.y < -limit || min.z < -limit ||
+			max.x > limit || max.y > limit || max.z > limit;
+	}
+
+	void Renderer::AddToTree()
+	{
+		if (m_tree_proxy < 0 && !IsUnbounded(m_bounds))
+		{
+			m_tree_proxy = m_renderer_tree.Insert(m_bounds, this);
+			m_tree_version = m_renderer_tree_version;
+		}
+	}
+
+	void Renderer::RemoveFromTree()
+	{
+		if (m_tree_proxy >= 0)
+		{
+			// tree cleared by Deinit if version changed
+			if (m_tree_version == m_renderer_tree_version)
+			{
+				m_renderer_tree.Remove(m_tree_proxy);
+			}
+			m_tree_proxy = -1;
+		}
+	}
+
 	void Renderer::HandleUIEvent()
 	{
 		List<UICanvasRenderer*> canvas_list;
@@ -497,29 +835,81 @@ namespace Viry3D
 			auto& culled_renderers = m_passes[cam].culled_renderers;
 			bool diff = false;
 
-			// TODO: m_renderers in octree
+			// shadow map only rasterizes casters inside its orthographic volume, cull them too
+			bool frustum_culling = cam->IsFrustumCulling() &&
+				(!cam->IsOrthographic() || cam->GetRenderMode() == CameraRenderMode::ShadowMap);
 
-			for (auto i : m_renderers)
+			if (!frustum_culling)
 			{
-				if (!i->GetGameObject()->IsActiveInHierarchy() ||
-					!i->IsEnable() ||
-					cam->IsCulling(i->GetGameObject()))
+				for (auto i : m_renderers)
 				{
-					continue;
+					if (!i->GetGameObject()->IsActiveInHierarchy() ||
+						!i->IsEnable() ||
+						cam->IsCulling(i->GetGameObject()))
+					{
+						continue;
+					}
+
+					renderers.AddLast(i);
 				}
+			}
+			else
+			{
+				const auto& frustum = cam->GetFrustum();
+
+				Vector<void*> hits;
+				m_renderer_tree.Query(frustum, hits);
 
-				if (cam->IsOrthographic() || cam->IsFrustumCulling() == false)
+				Vector<Renderer*> visible;
+				for (auto i : hits)
 				{
-					renderers.AddLast(i);
+					auto r = (Renderer*) i;
+					if (r->m_renderers_index_version == m_renderers_version)
+					{
+						visible.Add(r);
+					}
 				}
-				else
+
+				int unbounded_count = m_unbounded_renderers.Size();
+				if (unbounded_count > 0)
+				{
+					Vector<Vector3> mins(unbounded_count);
+					Vector<Vector3> maxs(unbounded_count);
+					Vector<byte> results(unbounded_count);
+
+					for (int i = 0; i < unbounded_count; i++)
+					{
+						auto& bounds = m_unbounded_renderers[i]->GetBounds();
+						mins[i] = bounds.Min();
+						maxs[i] = bounds.Max();
+					}
+
+					frustum.CullBounds(&mins[0].x, &maxs[0].x, unbounded_count, &results[0]);
+
+					for (int i = 0; i < unbounded_count; i++)
+					{
+						if (results[i] != (byte) ContainsResult::Out)
+						{
+							visible.Add(m_unbounded_renderers[i]);
+						}
+					}
+				}
+
+				// keep renderers list order, passes sort depends on it
+				std::sort(visible.begin(), visible.end(), [](Renderer* a, Renderer* b) {
+					return a->m_renderers_index < b->m_renderers_index;
+				});
+
+				for (auto i : visible)
 				{
-					auto& bounds = i->GetBounds();
-					auto ret = cam->GetFrustum().ContainsBounds(bounds.Min(), bounds.Max());
-					if (ret == ContainsResult::Cross || ret == ContainsResult::In)
+					if (!i->GetGameObject()->IsActiveInHierarchy() ||
+						!i->IsEnable() ||
+						cam->IsCulling(i->GetGameObject()))
 					{
-						renderers.AddLast(i);
+						continue;
 					}
+
+					renderers.AddLast(i);
 				}
 			}
 
@@ -555,106 +945,196 @@ namespace Viry3D
 		}
 	}
 
-	void Renderer::BuildPasses(const List<Renderer*>& renderers, List<List<MaterialPass>>& passes)
+	void Renderer::AddMaterialPasses(Renderer* renderer, Vector<MaterialPass>& passes)
 	{
-		List<Renderer::MaterialPass> mat_passes;
+		auto& mats = renderer->GetSharedMaterials();
+		bool ui = dynamic_cast<UICanvasRenderer*>(renderer) != NULL;
 
-		for (auto i : renderers)
+		for (int j = 0; j < mats.Size(); j++)
 		{
-			auto& mats = i->GetSharedMaterials();
+			auto& mat = mats[j];
 
-			for (int j = 0; j < mats.Size(); j++)
+			if (!mat || !renderer->IsValidPass(j))
 			{
-				auto& mat = mats[j];
+				continue;
+			}
 
-				if (!mat || !i->IsValidPass(j))
-				{
-					continue;
-				}
+			auto shader = mat->GetShader();
+			int pass_count = shader->GetPassCount();
+
+			assert(pass_count >= 1);
+
+			MaterialPass pass;
+			pass.queue = shader->GetQueue();
+			pass.shader_pass_count = pass_count;
+			pass.renderer = renderer;
+			pass.material_index = j;
+			pass.shader_id = shader->GetId();
+			pass.material_id = mat->GetId();
+			pass.renderer_id = renderer->GetId();
+			pass.renderer_version = renderer->m_passes_version;
+			pass.ui = ui;
+			pass.sort_key = 0;
+			pass.instance_count = -1;
+			pass.instance_buffer = NULL;
+			pass.dynamic_batch = -1;
+
+			passes.Add(pass);
+		}
+	}
 
-				auto shader = mat->GetShader();
-				int pass_count = shader->GetPassCount();
+	void Renderer::BuildSortRanks(const Vector<MaterialPass>& passes, Map<int, int>& shader_ranks, Map<int, int>& material_ranks)
+	{
+		shader_ranks.Clear();
+		material_ranks.Clear();
 
-				assert(pass_count >= 1);
+		for (const auto& i : passes)
+		{
+			shader_ranks[i.shader_id] = 0;
+			material_ranks[i.material_id] = 0;
+		}
 
-				MaterialPass pass;
-				pass.queue = shader->GetQueue();
-				pass.shader_pass_count = pass_count;
-				pass.renderer = i;
-				pass.material_index = j;
-				pass.shader_id = shader->GetId();
-				pass.material_id = mat->GetId();
+		// ranks keep id order
+		int rank = 0;
+		for (auto& i : shader_ranks)
+		{
+			i.second = rank++;
+		}
 
-				mat_passes.AddLast(pass);
-			}
+		rank = 0;
+		for (auto& i : material_ranks)
+		{
+			i.second = rank++;
 		}
+	}
 
-		mat_passes.Sort(
-			[](const MaterialPass& a, const MaterialPass& b)->bool {
-			if (dynamic_cast<UICanvasRenderer*>(a.renderer) || dynamic_cast<UICanvasRenderer*>(b.renderer))
+	bool Renderer::SetSortKeys(Vector<MaterialPass>& passes, const Map<int, int>& shader_ranks, const Map<int, int>& material_ranks)
+	{
+		for (auto& i : passes)
+		{
+			uint64_t queue = (uint64_t) Mathf::Clamp(i.queue, 0, 0x3fff);
+
+			if (i.ui)
+			{
+				// ui passes only sorted by queue here, sorting order applied when render
+				i.sort_key = queue << 50;
+				continue;
+			}
+
+			const int* shader_rank;
+			const int* material_rank;
+			if (!shader_ranks.TryGet(i.shader_id, &shader_rank) ||
+				!material_ranks.TryGet(i.material_id, &material_rank))
 			{
 				return false;
 			}
 
-			if (a.queue == b.queue)
+			uint64_t dynamic = i.renderer->GetGameObject()->IsStatic() ? 0 : 1;
+			uint64_t pass_count = (uint64_t) Mathf::Min(i.shader_pass_count, 7);
+			uint64_t shader = (uint64_t) Mathf::Min(*shader_rank, 0xfff);
+			uint64_t material = (uint64_t) Mathf::Min(*material_rank, 0x3fffff);
+			uint64_t lightmap = (uint64_t) Mathf::Clamp(i.renderer->m_lightmap_index + 1, 0, 0xfff);
+
+			// multi pass shaders are not batched, only ordered by pass count
+			if (pass_count > 1)
 			{
-				int static_a = a.renderer->GetGameObject()->IsStatic() ? 0 : 1;
-				int static_b = b.renderer->GetGameObject()->IsStatic() ? 0 : 1;
+				shader = 0;
+				material = 0;
+				lightmap = 0;
+			}
 
-				if (static_a == static_b)
-				{
-					if (a.shader_pass_count == 1 && b.shader_pass_count == 1)
-					{
-						if (a.shader_id == b.shader_id)
-						{
-							if (a.material_id == b.material_id)
-							{
-								if (a.renderer->m_lightmap_index == b.renderer->m_lightmap_index)
-								{
-									if (a.renderer->GetId() == b.renderer->GetId())
-									{
-										return a.material_index < b.material_index;
-									}
-									else
-									{
-										return a.renderer->GetId() < b.renderer->GetId();
-									}
-								}
-								else
-								{
-									return a.renderer->m_lightmap_index < b.renderer->m_lightmap_index;
-								}
-							}
-							else
-							{
-								return a.material_id < b.material_id;
-							}
-						}
-						else
-						{
-							return a.shader_id < b.shader_id;
-						}
-					}
-					else
-					{
-						return a.shader_pass_count < b.shader_pass_count;
-					}
-				}
-				else
-				{
-					return static_a < static_b;
-				}
+			i.sort_key = (queue << 50) | (dynamic << 49) | (pass_count << 46) | (shader << 34) | (material << 12) | lightmap;
+		}
+
+		return true;
+	}
+
+	//
+	//	lsd radix sort by renderer id then sort key, 8 bits per digit,
+	//	digits same in all passes are skipped, stable so material index order kept
+	//
+	void Renderer::SortPasses(Vector<MaterialPass>& passes)
+	{
+		int count = passes.Size();
+		if (count <= 1)
+		{
+			return;
+		}
+
+		Vector<MaterialPass> temp(count);
+		Vector<MaterialPass>* src = &passes;
+		Vector<MaterialPass>* dst = &temp;
+
+		auto digit = [](const MaterialPass& pass, int d) {
+			if (d < 4)
+			{
+				return (int) ((((uint32_t) pass.renderer_id) >> (d * 8)) & 0xff);
 			}
 			else
 			{
-				return a.queue < b.queue;
+				return (int) ((pass.sort_key >> ((d - 4) * 8)) & 0xff);
 			}
-		});
+		};
 
+		for (int d = 0; d < 12; d++)
+		{
+			int counts[256] = { 0 };
+			for (int i = 0; i < count; i++)
+			{
+				counts[digit((*src)[i], d)]++;
+			}
+
+			if (counts[digit((*src)[0], d)] == count)
+			{
+				continue;
+			}
+
+			int offset = 0;
+			for (int i = 0; i < 256; i++)
+			{
+				int c = counts[i];
+				counts[i] = offset;
+				offset += c;
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				const auto& pass = (*src)[i];
+				(*dst)[counts[digit(pass, d)]++] = pass;
+			}
+
+			auto t = src;
+			src = dst;
+			dst = t;
+		}
+
+		if (src != &passes)
+		{
+			passes = *src;
+		}
+	}
+
+	bool Renderer::PassLess(const MaterialPass& a, const MaterialPass& b)
+	{
+		if (a.sort_key != b.sort_key)
+		{
+			return a.sort_key < b.sort_key;
+		}
+
+		if (a.renderer_id != b.renderer_id)
+		{
+			return (uint32_t) a.renderer_id < (uint32_t) b.renderer_id;
+		}
+
+		return a.material_index < b.material_index;
+	}
+
+	void Renderer::GroupPasses(const Vector<MaterialPass>& sorted, List<List<MaterialPass>>& passes)
+	{
 		passes.Clear();
 
 		List<MaterialPass> pass;
-		for (auto& i : mat_passes)
+		for (auto& i : sorted)
 		{
 			if (pass.Empty())
 			{
@@ -663,7 +1143,7 @@ namespace Viry3D
 			else
 			{
 				const auto& last = pass.Last();
-				if (dynamic_cast<UICanvasRenderer*>(i.renderer) == NULL &&
+				if (!i.ui &&
 					i.queue == last.queue &&
 					i.shader_pass_count == 1 && last.shader_pass_count == 1 &&
 					i.shader_id == last.shader_id)
@@ -686,29 +1166,128 @@ namespace Viry3D
 		}
 	}
 
+	void Renderer::BuildPasses(const List<Renderer*>& renderers, List<List<MaterialPass>>& passes)
+	{
+		Vector<MaterialPass> mat_passes;
+		for (auto i : renderers)
+		{
+			AddMaterialPasses(i, mat_passes);
+		}
+
+		Map<int, int> shader_ranks;
+		Map<int, int> material_ranks;
+		BuildSortRanks(mat_passes, shader_ranks, material_ranks);
+		SetSortKeys(mat_passes, shader_ranks, material_ranks);
+		SortPasses(mat_passes);
+
+		GroupPasses(mat_passes, passes);
+	}
+
 	void Renderer::BuildPasses()
 	{
 		auto cam = Camera::Current();
+		auto& cam_passes = m_passes[cam];
 
-		if (m_passes[cam].passes_dirty)
+		if (cam_passes.passes_dirty)
 		{
-			m_passes[cam].passes_dirty = false;
+			cam_passes.passes_dirty = false;
+
+			const auto& renderers = cam_passes.culled_renderers;
+			auto& sorted = cam_passes.sorted;
+			bool incremental = !cam_passes.sorted_dirty;
+
+			if (incremental)
+			{
+				// keep sorted passes of renderers still visible, sort and merge only new ones
+				int in_stamp = ++m_pass_stamp;
+				for (auto i : renderers)
+				{
+					i->m_pass_mark = in_stamp;
+				}
+
+				Vector<MaterialPass> kept;
+				for (const auto& i : sorted)
+				{
+					if (i.renderer->m_pass_mark == in_stamp && i.renderer_version == i.renderer->m_passes_version)
+					{
+						kept.Add(i);
+					}
+				}
+
+				int kept_stamp = ++m_pass_stamp;
+				for (const auto& i : kept)
+				{
+					i.renderer->m_pass_mark = kept_stamp;
+				}
 
-			BuildPasses(m_passes[cam].culled_renderers, m_passes[cam].list);
+				Vector<MaterialPass> added;
+				for (auto i : renderers)
+				{
+					if (i->m_pass_mark != kept_stamp)
+					{
+						AddMaterialPasses(i, added);
+					}
+				}
+
+				if (SetSortKeys(added, cam_passes.shader_ranks, cam_passes.material_ranks))
+				{
+					SortPasses(added);
+
+					sorted.Clear();
+					sorted.Resize(kept.Size() + added.Size());
+					std::merge(kept.begin(), kept.end(), added.begin(), added.end(), sorted.begin(), PassLess);
+				}
+				else
+				{
+					// new shader or material, ranks must be rebuilt
+					incremental = false;
+				}
+			}
+
+			if (!incremental)
+			{
+				cam_passes.sorted_dirty = false;
+
+				sorted.Clear();
+				for (auto i : renderers)
+				{
+					AddMaterialPasses(i, sorted);
+				}
+
+				BuildSortRanks(sorted, cam_passes.shader_ranks, cam_passes.material_ranks);
+				SetSortKeys(sorted, cam_passes.shader_ranks, cam_passes.material_ranks);
+				SortPasses(sorted);
+			}
+
+			GroupPasses(sorted, cam_passes.list);
 		}
 	}
 
 	void Renderer::PrepareAllPass()
 	{
+		VR_PROFILE_SCOPE("Renderer::PrepareAllPass");
+
 		CheckPasses();
 		CameraCulling();
 		BuildPasses();
 
-		auto& passes = m_passes[Camera::Current()].list;
+		auto cam = Camera::Current();
+		if (cam->GetRenderMode() != CameraRenderMode::ShadowMap)
+		{
+			TextureStreaming::RequestLevels(cam, m_passes[cam].culled_renderers);
+		}
+
+		Graphics::ResetInstanceBuffers();
+		DynamicBatch::Begin();
+		ParticleSystem::FillAll(m_passes[cam].culled_renderers);
+
+		auto& passes = m_passes[cam].list;
 		for (auto& i : passes)
 		{
 			Renderer::PreparePass(i);
 		}
+
+		DynamicBatch::End();
 	}
 
 	void Renderer::BindStaticBuffers()
@@ -720,78 +1299,202 @@ namespace Viry3D
 		}
 	}
 
-	void Renderer::RenderAllPass()
+	void Renderer::CommitPasses(const Vector<List<MaterialPass>*>& passes, int start, int count)
 	{
 		BindStaticBuffers();
 		m_static_buffers_binding = true;
 		m_batching_start = -1;
 		m_batching_count = -1;
 
+		for (int i = start; i < start + count; i++)
+		{
+			Renderer::CommitPass(*passes[i]);
+		}
+	}
+
+	void Renderer::RenderAllPass()
+	{
+		VR_PROFILE_SCOPE("Renderer::RenderAllPass");
+
 		auto cam = Camera::Current();
 		auto& passes = m_passes[cam].list;
-		List<List<MaterialPass>> passes_transparent;
-		List<List<MaterialPass>> passes_ui;
+		Vector<List<MaterialPass>*> passes_ordered;
+		Vector<List<MaterialPass>*> passes_transparent;
+		List<List<MaterialPass>*> passes_ui;
 
 		for (auto& i : passes)
 		{
 			if (i.First().queue < (int) RenderQueue::Transparent)
 			{
-				Renderer::CommitPass(i);
+				passes_ordered.Add(&i);
 			}
 			else
 			{
-				auto ui = dynamic_cast<UICanvasRenderer*>(i.First().renderer);
-				if (ui)
+				if (i.First().ui)
 				{
-					passes_ui.AddLast(i);
+					passes_ui.AddLast(&i);
 				}
 				else
 				{
-					passes_transparent.AddLast(i);
+					passes_transparent.Add(&i);
 				}
 			}
 		}
 
-		for (auto& i : passes_transparent)
-		{
-			Renderer::CommitPass(i);
-		}
-
-		passes_ui.Sort([](const List<MaterialPass>& a, const List<MaterialPass>& b) {
-			if (a.First().queue == b.First().queue)
+		passes_ui.Sort([](const List<MaterialPass>* a, const List<MaterialPass>* b) {
+			if (a->First().queue == b->First().queue)
 			{
-				return a.First().renderer->GetSortingOrder() < b.First().renderer->GetSortingOrder();
+				return a->First().renderer->GetSortingOrder() < b->First().renderer->GetSortingOrder();
 			}
 			else
 			{
-				return a.First().queue < b.First().queue;
+				return a->First().queue < b->First().queue;
 			}
 		});
 
-		for (auto& i : passes_ui)
+		for (auto i : passes_transparent)
+		{
+			passes_ordered.Add(i);
+		}
+		for (auto i : passes_ui)
 		{
-			Renderer::CommitPass(i);
+			passes_ordered.Add(i);
 		}
+
+#if VR_VULKAN
+		auto display = Graphics::GetDisplay();
+		if (display->IsParallelRecording())
+		{
+			// split passes into jobs with about the same draw count, keep order
+			int total = 0;
+			for (auto i : passes_ordered)
+			{
+				total += i->Size();
+			}
+
+			int job_count = Mathf::Min(display->GetRecordingThreadCount(), passes_ordered.Size());
+			int job_size = job_count > 0 ? (total + job_count - 1) / job_count : 0;
+
+			Vector<Action> jobs;
+			int start = 0;
+			int size = 0;
+			for (int i = 0; i < passes_ordered.Size(); i++)
+			{
+				size += passes_ordered[i]->Size();
+
+				if (size >= job_size || i == passes_ordered.Size() - 1)
+				{
+					int count = i - start + 1;
+					jobs.Add([&passes_ordered, start, count]() {
+						CommitPasses(passes_ordered, start, count);
+					});
+
+					start = i + 1;
+					size = 0;
+				}
+			}
+
+			auto render_pass = RenderPass::GetRenderPassBinding();
+			display->RecordSecondaryCommandBuffers(jobs, render_pass->GetVkRenderPass(), render_pass->GetVkFramebuffer());
+			return;
+		}
+#endif
+
+		CommitPasses(passes_ordered, 0, passes_ordered.Size());
 	}
 
 	Renderer::Renderer():
 		m_sorting_order(0),
 		m_lightmap_index(-1),
 		m_lightmap_scale_offset(),
-		m_bounds(Vector3::One() * Mathf::MinFloatValue, Vector3::One() * Mathf::MaxFloatValue)
+		m_bounds(Vector3::One() * Mathf::MinFloatValue, Vector3::One() * Mathf::MaxFloatValue),
+		m_tree_proxy(-1),
+		m_tree_version(-1),
+		m_renderers_index(-1),
+		m_renderers_index_version(-1),
+		m_pass_mark(0),
+		m_passes_version(0)
 	{
 	}
 
 	Renderer::~Renderer()
 	{
+		RemoveFromTree();
 		SetRenderersDirty(true);
 	}
 
 	void Renderer::Start()
 	{
+		UpdateBounds();
+		AddToTree();
 		SetRenderersDirty(true);
 	}
 
+	void Renderer::OnTranformChanged()
+	{
+		UpdateBounds();
+	}
+
+	void Renderer::UpdateBounds()
+	{
+		auto transform = this->GetTransform();
+		Bounds local(Vector3::Zero(), Vector3::Zero());
+		if (!transform || !this->GetLocalBounds(local))
+		{
+			return;
+		}
+
+		const auto& mat = transform->GetLocalToWorldMatrix();
+		const auto& min = local.Min();
+		const auto& max = local.Max();
+
+		Vector3 world_min = mat.MultiplyPoint3x4(min);
+		Vector3 world_max = world_min;
+		for (int i = 1; i < 8; i++)
+		{
+			Vector3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+			Vector3 p = mat.MultiplyPoint3x4(corner);
+			world_min = Vector3::Min(world_min, p);
+			world_max = Vector3::Max(world_max, p);
+		}
+
+		this->SetBounds(Bounds(world_min, world_max));
+	}
+
+	void Renderer::SetBounds(const Bounds& bounds)
+	{
+		m_bounds = bounds;
+
+		// only started renderers in tree, could be set on loader thread before start
+		if (!this->IsStarted())
+		{
+			return;
+		}
+
+		if (m_tree_proxy >= 0)
+		{
+			if (IsUnbounded(m_bounds))
+			{
+				RemoveFromTree();
+				SetRenderersDirty(true);
+			}
+			else
+			{
+				m_renderer_tree.Move(m_tree_proxy, m_bounds);
+			}
+		}
+		else if (!IsUnbounded(m_bounds))
+		{
+			AddToTree();
+			SetRenderersDirty(true);
+		}
+
+		for (auto& i : m_passes)
+		{
+			i.second.culling_dirty = true;
+		}
+	}
+
 	void Renderer::OnEnable()
 	{
 		SetRenderersDirty(true);
@@ -823,12 +1526,30 @@ namespace Viry3D
 		this->SetSharedMaterials(mats);
 	}
 
+	void Renderer::SetSharedMaterials(const Vector<Ref<Material>>& mats)
+	{
+		m_shared_materials = mats;
+
+		SetRendererDirty(this);
+	}
+
+	void Renderer::SetLightmapIndex(int index)
+	{
+		if (m_lightmap_index != index)
+		{
+			m_lightmap_index = index;
+
+			SetRendererDirty(this);
+		}
+	}
+
 	void Renderer::DeepCopy(const Ref<Object>& source)
 	{
 		Component::DeepCopy(source);
 
 		auto src = RefCast<Renderer>(source);
 		this->SetSharedMaterials(src->GetSharedMaterials());
+		this->SetBounds(src->GetBounds());
 	}
 
 	void Renderer::BuildStaticBatch(const Ref<GameObject>& obj)
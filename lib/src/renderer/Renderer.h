@@ -25,8 +25,11 @@
 #include "graphics/IndexBuffer.h"
 #include "math/Vector4.h"
 #include "math/Bounds.h"
+#include "math/BoundsTree.h"
 #include "math/Matrix4x4.h"
 #include "thread/Thread.h"
+#include "container/Map.h"
+#include <stdint.h>
 
 namespace Viry3D
 {
@@ -34,6 +37,8 @@ namespace Viry3D
 	class Camera;
 	class DescriptorSet;
 	class UniformBuffer;
+	class Shader;
+	struct InstanceBuffer;
 
 	class Renderer: public Component
 	{
@@ -47,8 +52,20 @@ namespace Viry3D
 		static void SetRenderersDirty(bool dirty);
 		static void ClearPasses();
 		static void SetCullingDirty(Camera* cam);
-        static void SetRendererDirty(Renderer* renderer);
+		//
+		//	passes of renderer rebuilt, call when anything in its passes or sort keys changed
+		//
+		static void SetRendererDirty(Renderer* renderer);
 		static List<Renderer*>& GetRenderers();
+		//
+		//	call after renderers list rebuilt, culling results keep the list order
+		//
+		static void OnRenderersChanged();
+		//
+		//	started renderers whose bounds overlap or hit, unbounded renderers not included
+		//
+		static void QueryRenderers(const Bounds& bounds, List<Renderer*>& result);
+		static void RaycastRenderers(const Ray& ray, float max_distance, List<Renderer*>& result);
 		static void PrepareAllPass();
 		static void RenderAllPass();
 		static void HandleUIEvent();
@@ -60,28 +77,43 @@ namespace Viry3D
 		virtual const VertexBuffer* GetVertexBuffer() const = 0;
 		virtual const IndexBuffer* GetIndexBuffer() const = 0;
 		virtual void GetIndexRange(int material_index, int& start, int& count) const = 0;
+		//
+		//	per instance attributes, index range drawn once for each of count elements,
+		//	NULL if shaders have no per instance attributes
+		//
+		virtual const VertexBuffer* GetInstanceVertexBuffer(int& count) const { return NULL; }
 		virtual bool IsValidPass(int material_index) const { return true; }
 		virtual IndexType GetIndexType() const { return IndexType::UnsignedShort; }
 		const Vector<Ref<Material>>& GetSharedMaterials() const { return m_shared_materials; }
-		void SetSharedMaterials(const Vector<Ref<Material>>& mats) { m_shared_materials = mats; }
+		void SetSharedMaterials(const Vector<Ref<Material>>& mats);
 		int GetSortingOrder() const { return m_sorting_order; }
 		void SetSortingOrder(int order) { m_sorting_order = order; }
 		int GetLightmapIndex() const { return m_lightmap_index; }
-		void SetLightmapIndex(int index) { m_lightmap_index = index; }
+		void SetLightmapIndex(int index);
 		const Vector4& GetLightmapScaleOffset() const { return m_lightmap_scale_offset; }
 		void SetLightmapScaleOffset(const Vector4& scale_offset) { m_lightmap_scale_offset = scale_offset; }
-		void SetBounds(const Bounds& bounds) { m_bounds = bounds; }
+		//
+		//	world bounds, kept from local bounds and transform if renderer has local bounds
+		//
+		void SetBounds(const Bounds& bounds);
 		const Bounds& GetBounds() const { return m_bounds; }
+		virtual bool GetLocalBounds(Bounds& bounds) const { return false; }
+		void UpdateBounds();
+		//
+		//	bounds reaching past 1e30, such renderers are culled without the tree
+		//
+		static bool IsUnbounded(const Bounds& bounds);
 
 	protected:
 		Renderer();
 		virtual void Start();
 		virtual void OnEnable();
 		virtual void OnDisable();
+		virtual void OnTranformChanged();
 		virtual void PreRenderByMaterial(int material_index);
 		virtual void PreRenderByRenderer(int material_index);
 		virtual Matrix4x4 GetWorldMatrix();
-		void Render(int material_index, int pass_index);
+		void Render(int material_index, int pass_index, int instance_count = 1);
 
 	private:
 		struct MaterialPass
@@ -92,16 +124,36 @@ namespace Viry3D
 			int material_index;
 			int shader_id;
 			int material_id;
+			int renderer_id;
+			// passes kept only while renderer passes version not changed
+			int renderer_version;
+			bool ui;
+			//
+			//	queue 14 | dynamic 1 | pass count 3 | shader rank 12 | material rank 22 | lightmap 12,
+			//	ties ordered by renderer id then material index
+			//
+			uint64_t sort_key;
+			//
+			//	-1 not instancing, 0 drawn by other pass, > 0 draw instance_buffer instances
+			//
+			int instance_count;
+			InstanceBuffer* instance_buffer;
+			// DynamicBatch batch drawn by this pass, -1 none
+			int dynamic_batch;
 		};
 
 		struct Passes
 		{
 			List<List<MaterialPass>> list;
 			List<Renderer*> culled_renderers;
+			Vector<MaterialPass> sorted;
+			Map<int, int> shader_ranks;
+			Map<int, int> material_ranks;
 			bool passes_dirty;
 			bool culling_dirty;
+			bool sorted_dirty;
 
-			Passes(): passes_dirty(true), culling_dirty(true) { }
+			Passes(): passes_dirty(true), culling_dirty(true), sorted_dirty(true) { }
 		};
 
 		struct RenderBuffer
@@ -130,9 +182,21 @@ namespace Viry3D
 		static void CameraCulling();
 		static void BuildPasses(const List<Renderer*>& renderers, List<List<MaterialPass>>& passes);
 		static void BuildPasses();
+		static void AddMaterialPasses(Renderer* renderer, Vector<MaterialPass>& passes);
+		static void BuildSortRanks(const Vector<MaterialPass>& passes, Map<int, int>& shader_ranks, Map<int, int>& material_ranks);
+		static bool SetSortKeys(Vector<MaterialPass>& passes, const Map<int, int>& shader_ranks, const Map<int, int>& material_ranks);
+		static void SortPasses(Vector<MaterialPass>& passes);
+		static bool PassLess(const MaterialPass& a, const MaterialPass& b);
+		static void GroupPasses(const Vector<MaterialPass>& sorted, List<List<MaterialPass>>& passes);
 		static void PreparePass(List<MaterialPass>& pass);
+		static void PrepareInstances(List<MaterialPass>& pass, const Ref<Shader>& shader);
+		static void PrepareDynamicBatches(List<MaterialPass>& pass, const Ref<Shader>& shader);
+		static void RenderDynamicBatch(int batch, const Ref<Shader>& shader, int pass_index);
 		static void CommitPass(List<MaterialPass>& pass);
+		static void CommitPasses(const Vector<List<MaterialPass>*>& passes, int start, int count);
 		static void BindStaticBuffers();
+		void AddToTree();
+		void RemoveFromTree();
 
 		static List<Renderer*> m_renderers;
 		static Map<Camera*, Passes> m_passes;
@@ -140,9 +204,15 @@ namespace Viry3D
 		static Mutex m_mutex;
 		static Ref<VertexBuffer> m_static_vertex_buffer;
 		static Ref<IndexBuffer> m_static_index_buffer;
-		static bool m_static_buffers_binding;
-		static int m_batching_start;
-		static int m_batching_count;
+		// per recording thread
+		static thread_local bool m_static_buffers_binding;
+		static thread_local int m_batching_start;
+		static thread_local int m_batching_count;
+		static BoundsTree m_renderer_tree;
+		static int m_renderer_tree_version;
+		static Vector<Renderer*> m_unbounded_renderers;
+		static int m_renderers_version;
+		static int m_pass_stamp;
 
 	protected:
 		Vector<Ref<Material>> m_shared_materials;
@@ -153,5 +223,13 @@ namespace Viry3D
 		Vector<BatchInfo> m_batch_indices;
 		Ref<DescriptorSet> m_descriptor_set;
 		Ref<UniformBuffer> m_descriptor_set_buffer;
+
+	private:
+		int m_tree_proxy;
+		int m_tree_version;
+		int m_renderers_index;
+		int m_renderers_index_version;
+		int m_pass_mark;
+		int m_passes_version;
 	};
 }
@@ -48,6 +48,11 @@ namespace Viry3D
 		return GetSharedMesh()->GetIndexBuffer().get();
 	}
 
+	IndexType SkinnedMeshRenderer::GetIndexType() const
+	{
+		return GetSharedMesh()->GetIndexType();
+	}
+
 	void SkinnedMeshRenderer::GetIndexRange(int material_index, int& start, int& count) const
 	{
 		GetSharedMesh()->GetIndexRange(material_index, start, count);
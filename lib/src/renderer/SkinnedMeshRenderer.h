@@ -30,6 +30,7 @@ namespace Viry3D
 	public:
 		virtual const VertexBuffer* GetVertexBuffer() const;
 		virtual const IndexBuffer* GetIndexBuffer() const;
+		virtual IndexType GetIndexType() const;
 		virtual void GetIndexRange(int material_index, int& start, int& count) const;
 		virtual bool IsValidPass(int material_index) const;
 		const Ref<Mesh>& GetSharedMesh() const { return m_mesh; }
@@ -0,0 +1,60 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "StringPool.h"
+#include <string.h>
+
+namespace Viry3D
+{
+	const String& StringPool::Intern(const char* str, int size)
+	{
+		// fnv-1a 64
+		unsigned long long hash = 14695981039346656037ULL;
+		for (int i = 0; i < size; i++)
+		{
+			hash ^= (byte) str[i];
+			hash *= 1099511628211ULL;
+		}
+
+		List<String>* strings;
+		if (!m_strings.TryGet(hash, &strings))
+		{
+			m_strings.Add(hash, List<String>());
+			strings = &m_strings[hash];
+		}
+
+		for (const auto& i : *strings)
+		{
+			if (i.Size() == size && memcmp(i.CString(), str, size) == 0)
+			{
+				return i;
+			}
+		}
+
+		strings->AddLast(String(str, size));
+		m_count++;
+
+		return strings->Last();
+	}
+
+	void StringPool::Clear()
+	{
+		m_strings.Clear();
+		m_count = 0;
+	}
+}
@@ -0,0 +1,44 @@
+/*
+* Viry3D
+* Copyright 2014-2018 by Stack - stackos@qq.com
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include "String.h"
+#include "container/List.h"
+#include "container/Map.h"
+
+namespace Viry3D
+{
+	//
+	//	interned strings, one copy of each content,
+	//	returned references stay valid until pool cleared or destroyed,
+	//	not thread safe, use one pool per thread
+	//
+	class StringPool
+	{
+	public:
+		StringPool(): m_count(0) { }
+		const String& Intern(const char* str, int size);
+		int Size() const { return m_count; }
+		void Clear();
+
+	private:
+		Map<unsigned long long, List<String>> m_strings;
+		int m_count;
+	};
+}
@@ -17,9 +17,18 @@
 
 #include "Thread.h"
 #include "Application.h"
+#include "Profiler.h"
+#include "math/Mathf.h"
+#include <atomic>
 
 namespace Viry3D
 {
+	Ref<ThreadPool> ThreadPool::m_shared;
+	Mutex ThreadPool::m_shared_mutex;
+
+	// set on threads running a ParallelFor, nested calls run inline
+	static thread_local bool s_in_parallel_for = false;
+
 	void Thread::Sleep(int ms)
 	{
 		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
@@ -66,6 +75,8 @@ namespace Viry3D
 
 	void Thread::Run()
 	{
+		Profiler::SetThreadName(String::Format("Worker %d", m_id));
+
 		if (m_info.init)
 		{
 			m_info.init();
@@ -92,7 +103,11 @@ namespace Viry3D
 
 			if (task.job)
 			{
-				auto any = task.job();
+				Ref<Any> any;
+				{
+					VR_PROFILE_SCOPE("Thread::Task");
+					any = task.job();
+				}
 
 				if (task.done)
 				{
@@ -100,7 +115,10 @@ namespace Viry3D
 						RunLoop::Task(
 							[any, task]() {
 						task.done(any);
-					}
+					},
+							true,
+							(RunLoop::Priority) task.done_priority,
+							task.done_deadline_ms
 						)
 					);
 				}
@@ -182,4 +200,77 @@ namespace Viry3D
 			i->Wait();
 		}
 	}
+
+	int ThreadPool::GetSharedThreadCount()
+	{
+		return Mathf::Max((int) std::thread::hardware_concurrency() - 1, 1);
+	}
+
+	void ThreadPool::ParallelFor(int count, const ParallelJob& job, int max_workers)
+	{
+		if (count <= 0)
+		{
+			return;
+		}
+
+		int worker_count = GetSharedThreadCount();
+		if (max_workers > 0)
+		{
+			worker_count = Mathf::Min(worker_count, max_workers);
+		}
+		worker_count = Mathf::Min(worker_count, count - 1);
+
+		if (worker_count <= 0 || s_in_parallel_for)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				job(i, 0);
+			}
+			return;
+		}
+
+		// one parallel for at a time, it waits the whole pool
+		std::lock_guard<Mutex> lock(m_shared_mutex);
+
+		if (!m_shared)
+		{
+			m_shared = RefMake<ThreadPool>(GetSharedThreadCount());
+		}
+
+		std::atomic<int> next(0);
+
+		// each thread keeps taking the next index until all done,
+		// so a slow job does not hold the other threads
+		auto run = [&](int thread_index) {
+			s_in_parallel_for = true;
+
+			int index;
+			while ((index = next.fetch_add(1)) < count)
+			{
+				job(index, thread_index);
+			}
+
+			s_in_parallel_for = false;
+		};
+
+		for (int i = 0; i < worker_count; i++)
+		{
+			Thread::Task task;
+			task.job = [&run, i]() {
+				run(i);
+				return Ref<Any>();
+			};
+			m_shared->AddTask(task, i);
+		}
+
+		run(worker_count);
+
+		m_shared->Wait();
+	}
+
+	void ThreadPool::ReleaseShared()
+	{
+		std::lock_guard<Mutex> lock(m_shared_mutex);
+		m_shared.reset();
+	}
 }
@@ -41,10 +41,24 @@ namespace Viry3D
 	public:
 		typedef std::function<Ref<Any>()> Job;
 		typedef std::function<void(Ref<Any>)> DoneCallback;
+		//
+		//	done runs in pre loop with done_priority (RunLoop::Priority) and done_deadline_ms,
+		//	zero means normal priority without deadline
+		//
 		struct Task
 		{
 			Job job;
 			DoneCallback done;
+			int done_priority;
+			int done_deadline_ms;
+
+			Task(Job job = Job(), DoneCallback done = DoneCallback(), int done_priority = 0, int done_deadline_ms = 0):
+				job(job),
+				done(done),
+				done_priority(done_priority),
+				done_deadline_ms(done_deadline_ms)
+			{
+			}
 		};
 
 		static void Sleep(int ms);
@@ -81,8 +95,21 @@ namespace Viry3D
 		//
 		void AddTask(Thread::Task task, int thread_index = -1);
 
+		typedef std::function<void(int index, int thread_index)> ParallelJob;
+		//
+		//	run job for each index in [0, count) on the shared pool and calling thread, return when all done,
+		//	thread_index of a worker is below the used worker count, the calling thread takes the used worker count,
+		//	max_workers <= 0 means use all shared pool threads
+		//
+		static void ParallelFor(int count, const ParallelJob& job, int max_workers = -1);
+		static int GetSharedThreadCount();
+		static void ReleaseShared();
+
 	private:
 		Vector<ThreadInfo> m_info;
 		Vector<Ref<Thread>> m_threads;
+
+		static Ref<ThreadPool> m_shared;
+		static Mutex m_shared_mutex;
 	};
 }
@@ -28,6 +28,7 @@ namespace Viry3D
 		duration(1.0f),
 		delay(0),
 		play_style(TweenerPlayStyle::Once),
+		bake_curve(false),
 		m_time_start(Time::GetTime()),
 		m_time(0),
 		m_reverse(false),
@@ -48,6 +49,7 @@ namespace Viry3D
 		this->curve = src->curve;
 		this->duration = src->duration;
 		this->play_style = src->play_style;
+		this->bake_curve = src->bake_curve;
 		this->m_time_start = src->m_time_start;
 		this->m_time = src->m_time;
 		this->m_reverse = src->m_reverse;
@@ -90,15 +92,24 @@ namespace Viry3D
 		{
 			m_time = t;
 
+			if (m_reverse)
+			{
+				t = 1 - t;
+			}
+
 			float value;
 
-			if (m_reverse)
+			if (bake_curve)
 			{
-				value = curve.Evaluate(1 - t);
+				if (!curve.IsBaked())
+				{
+					curve.Bake();
+				}
+				value = curve.Evaluate(t);
 			}
 			else
 			{
-				value = curve.Evaluate(t);
+				value = curve.EvaluateKeys(t);
 			}
 
 			OnSetValue(value);
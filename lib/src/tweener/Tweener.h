@@ -45,6 +45,10 @@ namespace Viry3D
 		float duration;
 		float delay;
 		TweenerPlayStyle play_style;
+		//
+		//	evaluate curve from a baked table instead of keys, off by default
+		//
+		bool bake_curve;
 		Action on_finish;
 
 	protected:
@@ -50,12 +50,16 @@ namespace Viry3D
 
 		if (File::Exist(file))
 		{
+			// face reads from memory, so fonts in archive load the same way
+			auto data = File::MapAllBytes(file);
+
 			FT_Face face;
-			auto err = FT_New_Face(g_ft_lib, file.CString(), 0, &face);
+			auto err = FT_New_Memory_Face(g_ft_lib, data.Bytes(), data.Size(), 0, &face);
 			if (!err)
 			{
 				font = Ref<Font>(new Font());
 				font->m_font = (void*) face;
+				font->m_font_data = data;
 			}
 		}
 
@@ -58,6 +58,7 @@ namespace Viry3D
 		Font();
 
 		void* m_font;
+		ByteBuffer m_font_data;
 		Map<char32_t, Map<int, GlyphInfo>> m_glyphs;
 		Ref<Texture2D> m_texture;
 		int m_texture_x;
@@ -236,7 +236,7 @@ namespace Viry3D
 			Vector<Vector3> vertices;
 			Vector<Vector2> uv;
 			Vector<Color> colors;
-			Vector<unsigned short> indices;
+			Vector<unsigned int> indices;
 
 			for (auto& i : m_views)
 			{
@@ -298,6 +298,16 @@ namespace Viry3D
 		return NULL;
 	}
 
+	IndexType UICanvasRenderer::GetIndexType() const
+	{
+		if (m_mesh)
+		{
+			return m_mesh->GetIndexType();
+		}
+
+		return IndexType::UnsignedShort;
+	}
+
 	void UICanvasRenderer::GetIndexRange(int material_index, int& start, int& count) const
 	{
 		if (m_mesh)
@@ -47,6 +47,7 @@ namespace Viry3D
 		virtual ~UICanvasRenderer();
 		virtual const VertexBuffer* GetVertexBuffer() const;
 		virtual const IndexBuffer* GetIndexBuffer() const;
+		virtual IndexType GetIndexType() const;
 		virtual void GetIndexRange(int material_index, int& start, int& count) const;
 		void MarkDirty();
 		const Vector<Ref<UIView>>& GetViews() const { return m_views; }
@@ -675,7 +675,7 @@ namespace Viry3D
 		}
 	}
 
-	void UILabel::FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices)
+	void UILabel::FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices)
 	{
 		if (!m_font)
 		{
@@ -63,7 +63,7 @@ namespace Viry3D
 		Vector<Vector2> vertices;
 		Vector<Vector2> uv;
 		Vector<Color> colors;
-		Vector<unsigned short> indices;
+		Vector<unsigned int> indices;
 		Vector<char32_t> chars;
 		Vector<Bounds> char_bounds;
 
@@ -106,7 +106,7 @@ namespace Viry3D
         void SetVerticalOverflow(VerticalWrapMode mode);
 		const Vector<LabelLine>& GetLines() const { return m_lines; }
 
-		virtual void FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices);
+		virtual void FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices);
 		virtual void FillMaterial(Ref<Material>& mat);
 
 	protected:
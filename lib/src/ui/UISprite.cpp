@@ -120,7 +120,7 @@ namespace Viry3D
 		}
 	}
 
-	void UISprite::FillVerticesSimple(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices)
+	void UISprite::FillVerticesSimple(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices)
 	{
 		GetBoundsVertices(vertices);
 
@@ -159,7 +159,7 @@ namespace Viry3D
 		indices.Add(index_begin + 3);
 	}
 
-	void UISprite::FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices)
+	void UISprite::FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices)
 	{
 		switch (m_sprite_type)
 		{
@@ -93,12 +93,12 @@ namespace Viry3D
 		int GetFillOrigin() const { return m_fill_origin; }
 		float GetFillAmount() const { return m_fill_amount; }
 		bool GetFillClockWise() const { return m_fill_clock_wise; }
-		virtual void FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices);
+		virtual void FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices);
 		virtual void FillMaterial(Ref<Material>& mat);
 
 	protected:
 		UISprite();
-		void FillVerticesSimple(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices);
+		void FillVerticesSimple(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices);
 
 		Ref<Atlas> m_atlas;
 		String m_sprite_name;
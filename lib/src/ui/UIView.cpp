@@ -141,7 +141,7 @@ namespace Viry3D
 		}
 	}
 
-	void UIView::FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices)
+	void UIView::FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices)
 	{
 		GetBoundsVertices(vertices);
 
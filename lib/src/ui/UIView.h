@@ -39,7 +39,7 @@ namespace Viry3D
 		virtual void SetAnchors(const Vector2& min, const Vector2& max);
 		virtual void SetOffsets(const Vector2& min, const Vector2& max);
 		virtual void SetPivot(const Vector2& pivot);
-		virtual void FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned short>& indices);
+		virtual void FillVertices(Vector<Vector3>& vertices, Vector<Vector2>& uv, Vector<Color>& colors, Vector<unsigned int>& indices);
 		virtual void FillMaterial(Ref<Material>& mat);
 		void SetColor(const Color& color);
 		const Color& GetColor() const { return m_color; }
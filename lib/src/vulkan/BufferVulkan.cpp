@@ -26,7 +26,8 @@ namespace Viry3D
 		m_size(0),
 		m_type(BufferType::None),
 		m_buffer(VK_NULL_HANDLE),
-		m_memory(VK_NULL_HANDLE)
+		m_memory(VK_NULL_HANDLE),
+		m_use_serial(0)
 	{
 	}
 
@@ -112,9 +113,19 @@ namespace Viry3D
 		}
 	}
 
+	void BufferVulkan::WaitUse() const
+	{
+		int serial = m_use_serial;
+		if (serial > 0)
+		{
+			((DisplayVulkan*) Graphics::GetDisplay())->WaitSerial(serial);
+		}
+	}
+
 	void BufferVulkan::Fill(void* param, FillFunc fill)
 	{
 		auto device = ((DisplayVulkan*) Graphics::GetDisplay())->GetDevice();
+		WaitUse();
 
 		void* data;
 		VkResult err = vkMapMemory(device, m_memory, 0, (uint32_t) m_size, 0, &data);
@@ -126,9 +137,29 @@ namespace Viry3D
 		vkUnmapMemory(device, m_memory);
 	}
 
+	ByteBuffer BufferVulkan::Map()
+	{
+		auto device = ((DisplayVulkan*) Graphics::GetDisplay())->GetDevice();
+		WaitUse();
+
+		void* data;
+		VkResult err = vkMapMemory(device, m_memory, 0, (uint32_t) m_size, 0, &data);
+		assert(!err);
+
+		return ByteBuffer((byte*) data, m_size);
+	}
+
+	void BufferVulkan::Unmap()
+	{
+		auto device = ((DisplayVulkan*) Graphics::GetDisplay())->GetDevice();
+
+		vkUnmapMemory(device, m_memory);
+	}
+
 	void BufferVulkan::UpdateRange(int offset, int size, const void* data)
 	{
 		auto device = ((DisplayVulkan*) Graphics::GetDisplay())->GetDevice();
+		WaitUse();
 
 		void* mapped;
 		VkResult err = vkMapMemory(device, m_memory, (uint32_t) offset, (uint32_t) size, 0, &mapped);
@@ -21,6 +21,7 @@
 #include "graphics/BufferType.h"
 #include "memory/ByteBuffer.h"
 #include <functional>
+#include <atomic>
 
 namespace Viry3D
 {
@@ -35,10 +36,22 @@ namespace Viry3D
 		typedef std::function<void(void* param, const ByteBuffer& buffer)> FillFunc;
 		void Fill(void* param, FillFunc fill);
 		void UpdateRange(int offset, int size, const void* data);
+		//
+		//	whole buffer mapped for writing, could be filled on any thread,
+		//	Unmap on render thread after all writes done
+		//
+		ByteBuffer Map();
+		void Unmap();
+		//
+		//	serial of the submit reading this buffer, set when bound for drawing,
+		//	writes wait for that submit first
+		//
+		void SetUseSerial(int serial) const { m_use_serial = serial; }
 
 	protected:
 		BufferVulkan();
 		void CreateInternal(BufferType type, bool dynamic = false);
+		void WaitUse() const;
 
 		int m_size;
 
@@ -46,5 +59,6 @@ namespace Viry3D
 		BufferType m_type;
 		VkBuffer m_buffer;
 		VkDeviceMemory m_memory;
+		mutable std::atomic<int> m_use_serial;
 	};
 }
@@ -19,12 +19,21 @@
 
 #include "vulkan_include.h"
 #include "graphics/DescriptorSet.h"
+#include <atomic>
 
 namespace Viry3D
 {
 	class DescriptorSetVulkan: public DescriptorSet
 	{
 	public:
+		DescriptorSetVulkan():
+			set(VK_NULL_HANDLE),
+			use_serial(0)
+		{
+		}
+
 		VkDescriptorSet set;
+		// serial of the submit binding this set, set and its uniform buffer written after that submit done
+		std::atomic<int> use_serial;
 	};
 }
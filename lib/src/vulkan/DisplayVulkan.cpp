@@ -37,6 +37,10 @@
 
 namespace Viry3D
 {
+	// secondary command buffer and draw call counter of the recording thread
+	static thread_local VkCommandBuffer s_record_cmd = VK_NULL_HANDLE;
+	static thread_local int* s_record_draw_call = NULL;
+
 	DisplayVulkan::DisplayVulkan():
 		m_instance(NULL),
 		m_debug_callback(VK_NULL_HANDLE),
@@ -48,6 +52,10 @@ namespace Viry3D
 		m_swap_buffer_index(0),
 		m_image_acquired_semaphore(VK_NULL_HANDLE),
 		m_current_draw_cmd(NULL),
+		m_submit_serial(0),
+		m_complete_serial(0),
+		m_parallel_recording(false),
+		m_record_thread_count(0),
 		m_swapchain(VK_NULL_HANDLE),
 		m_cmd_pool(VK_NULL_HANDLE),
 		m_image_cmd_pool(VK_NULL_HANDLE),
@@ -60,6 +68,24 @@ namespace Viry3D
 
 	void DisplayVulkan::Deinit()
 	{
+		vkDeviceWaitIdle(m_device);
+
+		DestroyDeferredImages(true);
+
+		DestroyThreadData();
+		m_parallel_recording = false;
+
+		for (auto i : m_fences_free)
+		{
+			vkDestroyFence(m_device, i, NULL);
+		}
+		for (auto& i : m_fences_pending)
+		{
+			vkDestroyFence(m_device, i.fence, NULL);
+		}
+		m_fences_free.Clear();
+		m_fences_pending.Clear();
+
 		DestroySizeDependentResources();
 
 		if (m_image_acquired_semaphore != VK_NULL_HANDLE)
@@ -89,6 +115,7 @@ namespace Viry3D
 			vkDestroyImageView(m_device, m_swapchain_buffers[i].image_view, NULL);
 		}
 		m_swapchain_buffers.Clear();
+		DestroyFrameSemaphores();
 		vkFreeCommandBuffers(m_device, m_image_cmd_pool, 1, &m_image_cmd_buffer);
 		vkDestroyCommandPool(m_device, m_image_cmd_pool, NULL);
 		vkDestroyCommandPool(m_device, m_cmd_pool, NULL);
@@ -508,6 +535,30 @@ namespace Viry3D
 		}
 
 		Memory::Free(images);
+
+		m_frames.Resize(m_swapchain_buffers.Size());
+		for (auto& i : m_frames)
+		{
+			i.image_acquired_semaphore = VK_NULL_HANDLE;
+			i.draw_complete_semaphores.Clear();
+			i.submit_serial = 0;
+		}
+	}
+
+	void DisplayVulkan::DestroyFrameSemaphores()
+	{
+		for (auto& i : m_frames)
+		{
+			if (i.image_acquired_semaphore != VK_NULL_HANDLE)
+			{
+				vkDestroySemaphore(m_device, i.image_acquired_semaphore, NULL);
+			}
+			for (auto j : i.draw_complete_semaphores)
+			{
+				vkDestroySemaphore(m_device, j, NULL);
+			}
+		}
+		m_frames.Clear();
 	}
 
 	void DisplayVulkan::CreateCommandPool()
@@ -708,16 +759,6 @@ namespace Viry3D
 
 		m_mutex.lock();
 
-		if (m_image_acquired_semaphore != VK_NULL_HANDLE)
-		{
-			vkDestroySemaphore(m_device, m_image_acquired_semaphore, NULL);
-		}
-		for (auto i : m_draw_complete_semaphores)
-		{
-			vkDestroySemaphore(m_device, i, NULL);
-		}
-		m_draw_complete_semaphores.Clear();
-
 		VkSemaphoreCreateInfo semaphore = {
 			VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
 			NULL,
@@ -734,6 +775,23 @@ namespace Viry3D
 		assert(!err);
 		assert(m_swap_buffer_index == swap_buffer_index);
 
+		// last frame on this image done, its semaphores not in use any more
+		auto& frame = m_frames[swap_buffer_index];
+		WaitSerial(frame.submit_serial);
+
+		if (frame.image_acquired_semaphore != VK_NULL_HANDLE)
+		{
+			vkDestroySemaphore(m_device, frame.image_acquired_semaphore, NULL);
+			frame.image_acquired_semaphore = VK_NULL_HANDLE;
+		}
+		for (auto i : frame.draw_complete_semaphores)
+		{
+			vkDestroySemaphore(m_device, i, NULL);
+		}
+		frame.draw_complete_semaphores.Clear();
+
+		DestroyDeferredImages(false);
+
 		m_mutex.unlock();
 
 		Profiler::SampleEnd();
@@ -760,11 +818,17 @@ namespace Viry3D
 		err = fpQueuePresentKHR(m_queue, &present);
 		assert(!err);
 
-		err = vkQueueWaitIdle(m_queue);
-		assert(!err);
+		// not wait here, semaphores kept until this image acquired again
+		auto& frame = m_frames[m_swap_buffer_index];
+		frame.image_acquired_semaphore = m_image_acquired_semaphore;
+		frame.draw_complete_semaphores = m_draw_complete_semaphores;
+		frame.submit_serial = m_submit_serial;
+		m_image_acquired_semaphore = VK_NULL_HANDLE;
+		m_draw_complete_semaphores.Clear();
 
-		err = vkDeviceWaitIdle(m_device);
-		assert(!err);
+		m_fence_mutex.lock();
+		PollFences();
+		m_fence_mutex.unlock();
 
 		m_swap_buffer_index++;
 		if (m_swap_buffer_index == m_swapchain_buffers.Size())
@@ -777,9 +841,115 @@ namespace Viry3D
 		Profiler::SampleEnd();
 	}
 
+	//
+	//	wait all submitted command buffers,
+	//	only for resources not tracked by submit serial
+	//
 	void DisplayVulkan::WaitQueueIdle()
 	{
-		vkQueueWaitIdle(m_queue);
+		WaitSerial(m_submit_serial);
+	}
+
+	void DisplayVulkan::WaitSerial(int serial)
+	{
+		m_fence_mutex.lock();
+
+		if (serial > m_complete_serial)
+		{
+			Vector<VkFence> fences;
+			for (const auto& i : m_fences_pending)
+			{
+				if (i.serial > serial)
+				{
+					break;
+				}
+				fences.Add(i.fence);
+			}
+
+			if (!fences.Empty())
+			{
+				VkResult err = vkWaitForFences(m_device, fences.Size(), &fences[0], VK_TRUE, UINT64_MAX);
+				assert(!err);
+			}
+
+			while (!m_fences_pending.Empty() && m_fences_pending.First().serial <= serial)
+			{
+				m_fences_free.Add(m_fences_pending.First().fence);
+				m_complete_serial = m_fences_pending.First().serial;
+				m_fences_pending.RemoveFirst();
+			}
+		}
+
+		m_fence_mutex.unlock();
+	}
+
+	bool DisplayVulkan::IsSerialComplete(int serial)
+	{
+		m_fence_mutex.lock();
+		PollFences();
+		bool complete = serial <= m_complete_serial;
+		m_fence_mutex.unlock();
+
+		return complete;
+	}
+
+	void DisplayVulkan::DestroyImageDeferred(VkImage image, VkImageView image_view, VkDeviceMemory memory, VkSampler sampler)
+	{
+		DeferredImage deferred;
+		deferred.image = image;
+		deferred.image_view = image_view;
+		deferred.memory = memory;
+		deferred.sampler = sampler;
+
+		m_fence_mutex.lock();
+		deferred.serial = m_submit_serial + 1;
+		m_deferred_images.AddLast(deferred);
+		m_fence_mutex.unlock();
+	}
+
+	void DisplayVulkan::DestroyDeferredImages(bool all)
+	{
+		List<DeferredImage> complete;
+
+		m_fence_mutex.lock();
+		PollFences();
+		while (!m_deferred_images.Empty() && (all || m_deferred_images.First().serial <= m_complete_serial))
+		{
+			complete.AddLast(m_deferred_images.First());
+			m_deferred_images.RemoveFirst();
+		}
+		m_fence_mutex.unlock();
+
+		for (const auto& i : complete)
+		{
+			if (i.sampler)
+			{
+				vkDestroySampler(m_device, i.sampler, NULL);
+			}
+			vkDestroyImageView(m_device, i.image_view, NULL);
+			vkFreeMemory(m_device, i.memory, NULL);
+			vkDestroyImage(m_device, i.image, NULL);
+		}
+	}
+
+	void DisplayVulkan::PollFences()
+	{
+		while (!m_fences_pending.Empty() && vkGetFenceStatus(m_device, m_fences_pending.First().fence) == VK_SUCCESS)
+		{
+			m_fences_free.Add(m_fences_pending.First().fence);
+			m_complete_serial = m_fences_pending.First().serial;
+			m_fences_pending.RemoveFirst();
+		}
+	}
+
+	VkCommandBuffer DisplayVulkan::GetCurrentDrawCommand() const
+	{
+		if (s_record_cmd != VK_NULL_HANDLE)
+		{
+			return s_record_cmd;
+		}
+
+		return m_current_draw_cmd;
 	}
 
 	void DisplayVulkan::BeginPrimaryCommandBuffer(VkCommandBuffer cmd)
@@ -840,15 +1010,40 @@ namespace Viry3D
 		submit_info.signalSemaphoreCount = 1;
 		submit_info.pSignalSemaphores = &draw_complete_semaphore;
 
-		err = vkQueueSubmit(m_queue, 1, &submit_info, VK_NULL_HANDLE);
-		assert(!err);
+		m_fence_mutex.lock();
 
-		err = vkQueueWaitIdle(m_queue);
-		assert(!err);
+		VkFence fence;
+		if (m_fences_free.Empty())
+		{
+			VkFenceCreateInfo fence_info;
+			Memory::Zero(&fence_info, sizeof(fence_info));
+			fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
-		err = vkDeviceWaitIdle(m_device);
+			err = vkCreateFence(m_device, &fence_info, NULL, &fence);
+			assert(!err);
+		}
+		else
+		{
+			fence = m_fences_free[m_fences_free.Size() - 1];
+			m_fences_free.Remove(m_fences_free.Size() - 1);
+
+			err = vkResetFences(m_device, 1, &fence);
+			assert(!err);
+		}
+
+		// not wait here, resources read by this submit wait its serial before written again
+		err = vkQueueSubmit(m_queue, 1, &submit_info, fence);
 		assert(!err);
 
+		m_submit_serial++;
+
+		SubmitFence submit_fence;
+		submit_fence.fence = fence;
+		submit_fence.serial = m_submit_serial;
+		m_fences_pending.AddLast(submit_fence);
+
+		m_fence_mutex.unlock();
+
 		m_draw_complete_semaphores.Add(draw_complete_semaphore);
 
 		m_mutex.unlock();
@@ -861,6 +1056,17 @@ namespace Viry3D
 		VkCommandBuffer cmd = GetCurrentDrawCommand();
 
 		vkCmdBindVertexBuffers(cmd, 0, 1, &buf, offsets);
+		buffer->SetUseSerial(GetRecordingSerial());
+	}
+
+	void DisplayVulkan::BindInstanceBuffer(const VertexBuffer* buffer)
+	{
+		VkBuffer buf = buffer->GetBuffer();
+		VkDeviceSize offsets[1] = { 0 };
+		VkCommandBuffer cmd = GetCurrentDrawCommand();
+
+		vkCmdBindVertexBuffers(cmd, 1, 1, &buf, offsets);
+		buffer->SetUseSerial(GetRecordingSerial());
 	}
 
 	void DisplayVulkan::BindIndexBuffer(const IndexBuffer* buffer, IndexType index_type)
@@ -878,15 +1084,187 @@ namespace Viry3D
 		}
 
 		vkCmdBindIndexBuffer(cmd, buffer->GetBuffer(), 0, type);
+		buffer->SetUseSerial(GetRecordingSerial());
 	}
 
-	void DisplayVulkan::DrawIndexed(int start, int count, IndexType index_type)
+	void DisplayVulkan::DrawIndexed(int start, int count, IndexType index_type, int instance_count)
 	{
 		VkCommandBuffer cmd = GetCurrentDrawCommand();
 
-		vkCmdDrawIndexed(cmd, count, 1, start, 0, 0);
+		vkCmdDrawIndexed(cmd, count, instance_count, start, 0, 0);
+
+		if (s_record_draw_call)
+		{
+			(*s_record_draw_call)++;
+		}
+		else
+		{
+			Graphics::draw_call++;
+		}
+	}
+
+	void DisplayVulkan::SetParallelRecording(bool enable, int thread_count)
+	{
+		if (enable)
+		{
+			int max_count = ThreadPool::GetSharedThreadCount();
+			if (thread_count <= 0 || thread_count > max_count)
+			{
+				thread_count = max_count;
+			}
+
+			if (m_record_thread_count != thread_count)
+			{
+				DestroyThreadData();
+				m_record_thread_count = thread_count;
+			}
+		}
+		else
+		{
+			DestroyThreadData();
+		}
+
+		m_parallel_recording = enable;
+	}
+
+	DisplayVulkan::RecordData& DisplayVulkan::GetRecordData()
+	{
+		// reuse pools of a completed recording, otherwise one more set for this recording
+		for (auto& i : m_record_data)
+		{
+			if (IsSerialComplete(i.submit_serial))
+			{
+				return i;
+			}
+		}
+
+		RecordData data;
+		data.submit_serial = 0;
+
+		// one more for main thread
+		data.thread_data.Resize(m_record_thread_count + 1);
+		for (int i = 0; i < data.thread_data.Size(); i++)
+		{
+			VkCommandPoolCreateInfo cmd_pool_info = {
+				VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+				NULL,
+				VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+				m_graphics_queue_index,
+			};
+			VkResult err = vkCreateCommandPool(m_device, &cmd_pool_info, NULL, &data.thread_data[i].cmd_pool);
+			assert(!err);
+
+			data.thread_data[i].cmd_used = 0;
+		}
+
+		m_record_data.Add(data);
+
+		return m_record_data[m_record_data.Size() - 1];
+	}
+
+	void DisplayVulkan::DestroyThreadData()
+	{
+		m_record_thread_count = 0;
+
+		if (m_record_data.Empty())
+		{
+			return;
+		}
+
+		vkDeviceWaitIdle(m_device);
+
+		for (auto& i : m_record_data)
+		{
+			for (auto& j : i.thread_data)
+			{
+				// command buffers freed with pool
+				vkDestroyCommandPool(m_device, j.cmd_pool, NULL);
+			}
+		}
+		m_record_data.Clear();
+	}
+
+	void DisplayVulkan::RecordSecondaryCommandBuffers(const Vector<Action>& jobs, VkRenderPass render_pass, VkFramebuffer framebuffer)
+	{
+		int job_count = jobs.Size();
+		if (job_count == 0 || m_record_thread_count == 0)
+		{
+			return;
+		}
+
+		auto& record_data = GetRecordData();
+		record_data.submit_serial = GetRecordingSerial();
+
+		// secondary buffers of the recording using these pools not in flight
+		auto& thread_data = record_data.thread_data;
+		for (auto& i : thread_data)
+		{
+			VkResult err = vkResetCommandPool(m_device, i.cmd_pool, 0);
+			assert(!err);
+			i.cmd_used = 0;
+		}
+
+		Vector<VkCommandBuffer> cmds(job_count);
+		Vector<int> draw_calls(job_count, 0);
+
+		// each thread records into command buffers from its own pool
+		ThreadPool::ParallelFor(job_count, [&](int job, int thread_index) {
+			auto& data = thread_data[thread_index];
+
+			if (data.cmd_used == data.cmd.Size())
+			{
+				VkCommandBufferAllocateInfo cmd_info = {
+					VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+					NULL,
+					data.cmd_pool,
+					VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+					1,
+				};
+				VkCommandBuffer cmd;
+				VkResult err = vkAllocateCommandBuffers(m_device, &cmd_info, &cmd);
+				assert(!err);
+
+				data.cmd.Add(cmd);
+			}
+
+			VkCommandBuffer cmd = data.cmd[data.cmd_used++];
+
+			VkCommandBufferInheritanceInfo inheritance_info;
+			Memory::Zero(&inheritance_info, sizeof(inheritance_info));
+			inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+			inheritance_info.renderPass = render_pass;
+			inheritance_info.subpass = 0;
+			inheritance_info.framebuffer = framebuffer;
 
-		Graphics::draw_call++;
+			VkCommandBufferBeginInfo cmd_buf_info;
+			Memory::Zero(&cmd_buf_info, sizeof(cmd_buf_info));
+			cmd_buf_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			cmd_buf_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			cmd_buf_info.pInheritanceInfo = &inheritance_info;
+
+			VkResult err = vkBeginCommandBuffer(cmd, &cmd_buf_info);
+			assert(!err);
+
+			s_record_cmd = cmd;
+			s_record_draw_call = &draw_calls[job];
+
+			jobs[job]();
+
+			s_record_cmd = VK_NULL_HANDLE;
+			s_record_draw_call = NULL;
+
+			err = vkEndCommandBuffer(cmd);
+			assert(!err);
+
+			cmds[job] = cmd;
+		}, m_record_thread_count);
+
+		vkCmdExecuteCommands(m_current_draw_cmd, (uint32_t) job_count, &cmds[0]);
+
+		for (auto i : draw_calls)
+		{
+			Graphics::draw_call += i;
+		}
 	}
 }
 
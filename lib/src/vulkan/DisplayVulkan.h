@@ -25,9 +25,11 @@
 
 #include "vulkan_include.h"
 #include "container/Vector.h"
+#include "container/List.h"
 #include "graphics/RenderTexture.h"
 #include "graphics/IndexBuffer.h"
 #include "thread/Thread.h"
+#include "Action.h"
 
 namespace Viry3D
 {
@@ -53,15 +55,43 @@ namespace Viry3D
 		void BeginFrame();
 		void EndFrame();
 		void WaitQueueIdle();
+		//
+		//	queue submits are numbered in order, a resource keeps the number of the last submit reading it
+		//	and waits only for that submit's fence before it is written or reused
+		//
+		int GetRecordingSerial() const { return m_submit_serial + 1; }
+		void WaitSerial(int serial);
+		bool IsSerialComplete(int serial);
+		//
+		//	image objects replaced while submits up to current recording may still read them,
+		//	destroyed on a later frame once that serial completed
+		//
+		void DestroyImageDeferred(VkImage image, VkImageView image_view, VkDeviceMemory memory, VkSampler sampler);
 		void BeginPrimaryCommandBuffer(VkCommandBuffer cmd);
 		void EndPrimaryCommandBuffer();
 		void BindVertexArray() { }
 		void BindVertexBuffer(const VertexBuffer* buffer);
+		//
+		//	source of per instance attributes for next draws
+		//
+		void BindInstanceBuffer(const VertexBuffer* buffer);
 		void BindIndexBuffer(const IndexBuffer* buffer, IndexType index_type);
 		void BindVertexAttribArray(const Ref<Shader>& shader, int pass_index) { }
-		void DrawIndexed(int start, int count, IndexType index_type);
+		void DrawIndexed(int start, int count, IndexType index_type, int instance_count = 1);
 		void DisableVertexArray(const Ref<Shader>& shader, int pass_index) { }
 		void SubmitQueue(VkCommandBuffer cmd);
+		//
+		//	record render passes into secondary command buffers on worker threads,
+		//	camera render passes then begin with secondary contents
+		//
+		void SetParallelRecording(bool enable, int thread_count = -1);
+		bool IsParallelRecording() const { return m_parallel_recording; }
+		int GetRecordingThreadCount() const { return m_record_thread_count > 0 ? m_record_thread_count + 1 : 0; }
+		//
+		//	each job recorded into one secondary command buffer, on workers and main thread,
+		//	then all executed in job order in current render pass
+		//
+		void RecordSecondaryCommandBuffers(const Vector<Action>& jobs, VkRenderPass render_pass, VkFramebuffer framebuffer);
 
 		void CreateSharedContext() { }
 		void DestroySharedContext() { }
@@ -69,12 +99,13 @@ namespace Viry3D
 		void SwapBuffers() { }
 
 		VkDevice GetDevice() const { return m_device; }
+		VkPhysicalDevice GetPhysicalDevice() const { return m_gpu; }
 		VkFormat GetSurfaceFormat() const { return m_surface_format.format; }
 		const Ref<RenderTexture>& GetDepthTexture() const { return m_depth_texture; }
 		VkImage GetSwapchainBufferImage(int index) const { return m_swapchain_buffers[index].image; }
 		VkImageView GetSwapchainBufferImageView(int index) const { return m_swapchain_buffers[index].image_view; }
 		VkCommandPool GetCommandPool() const { return m_cmd_pool; }
-		VkCommandBuffer GetCurrentDrawCommand() const { return m_current_draw_cmd; }
+		VkCommandBuffer GetCurrentDrawCommand() const;
 		int GetSwapchainBufferCount() const { return m_swapchain_buffers.Size(); }
 		int GetSwapBufferIndex() const { return m_swap_buffer_index; }
 		VkPipelineCache GetPipelineCache() const { return m_pipeline_cache; }
@@ -106,6 +137,10 @@ namespace Viry3D
 		void CreateCommandPool();
 		void CreateImageCommandBuffer();
 		void CreatePipelineCache();
+		void DestroyThreadData();
+		void PollFences();
+		void DestroyFrameSemaphores();
+		void DestroyDeferredImages(bool all);
 
 		VkShaderModule CreateShaderModule(void *spv_bytes, int size);
 
@@ -119,8 +154,41 @@ namespace Viry3D
 		{
 			VkCommandPool cmd_pool;
 			Vector<VkCommandBuffer> cmd;
+			int cmd_used;
 		};
 
+		// per thread pools of one recording, reset when the submit using it completed
+		struct RecordData
+		{
+			Vector<ThreadData> thread_data;
+			int submit_serial;
+		};
+
+		struct SubmitFence
+		{
+			VkFence fence;
+			int serial;
+		};
+
+		struct DeferredImage
+		{
+			VkImage image;
+			VkImageView image_view;
+			VkDeviceMemory memory;
+			VkSampler sampler;
+			int serial;
+		};
+
+		// semaphores of a presented frame, destroyed when its swapchain image comes back
+		struct FrameData
+		{
+			VkSemaphore image_acquired_semaphore;
+			Vector<VkSemaphore> draw_complete_semaphores;
+			int submit_serial;
+		};
+
+		RecordData& GetRecordData();
+
 		VkInstance m_instance;
 		VkDebugReportCallbackEXT m_debug_callback;
 		VkPhysicalDevice m_gpu;
@@ -138,10 +206,20 @@ namespace Viry3D
 		Vector<VkSemaphore> m_draw_complete_semaphores;
 		VkCommandBuffer m_current_draw_cmd;
 		String m_device_name;
+		Vector<VkFence> m_fences_free;
+		List<SubmitFence> m_fences_pending;
+		List<DeferredImage> m_deferred_images;
+		Mutex m_fence_mutex;
+		int m_submit_serial;
+		int m_complete_serial;
+		bool m_parallel_recording;
+		Vector<RecordData> m_record_data;
+		int m_record_thread_count;
 
 		// resources need recreate when window resize
 		VkSwapchainKHR m_swapchain;
 		Vector<SwapchainBuffer> m_swapchain_buffers;
+		Vector<FrameData> m_frames;
 		VkCommandPool m_cmd_pool;
 		VkCommandPool m_image_cmd_pool;
 		VkCommandBuffer m_image_cmd_buffer;
@@ -203,6 +203,10 @@ namespace Viry3D
 
 				m_uniform_buffers_shadowmap[pass_index] = shader->CreateUniformBuffer(pass_index);
 			}
+
+			// set and uniform buffer may be read by a submit in flight
+			auto display = (DisplayVulkan*) Graphics::GetDisplay();
+			display->WaitSerial(RefCast<DescriptorSetVulkan>(m_descriptor_sets_shadowmap[pass_index])->use_serial);
 		}
 		else
 		{
@@ -220,6 +224,9 @@ namespace Viry3D
 
 				m_uniform_buffers[pass_index] = shader->CreateUniformBuffer(pass_index);
 			}
+
+			auto display = (DisplayVulkan*) Graphics::GetDisplay();
+			display->WaitSerial(RefCast<DescriptorSetVulkan>(m_descriptor_sets[pass_index])->use_serial);
 		}
 
 		for (int i = 0; i < writes.Size(); i++)
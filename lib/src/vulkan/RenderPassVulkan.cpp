@@ -277,6 +277,9 @@ namespace Viry3D
 			};
 			err = vkAllocateCommandBuffers(device, &cmd_info, &m_framebuffers[i].cmd_buffer);
 			assert(!err);
+
+			m_framebuffers[i].draw_call = 0;
+			m_framebuffers[i].submit_serial = 0;
 		}
 	}
 
@@ -293,7 +296,20 @@ namespace Viry3D
 		return m_framebuffers[swap_index].cmd_buffer;
 	}
 
-	void RenderPassVulkan::Begin(const Color& clear_color)
+	VkFramebuffer RenderPassVulkan::GetVkFramebuffer() const
+	{
+		auto display = Graphics::GetDisplay();
+		auto pass = (RenderPass*) this;
+		bool is_default = !pass->HasFrameBuffer();
+		int swap_index = display->GetSwapBufferIndex();
+		if (!is_default)
+		{
+			swap_index = 0;
+		}
+		return m_framebuffers[swap_index].frame_buffer;
+	}
+
+	void RenderPassVulkan::Begin(const Color& clear_color, bool secondary_contents)
 	{
 		int width;
 		int height;
@@ -330,6 +346,9 @@ namespace Viry3D
 		inheritance_info.renderPass = m_render_pass;
 		inheritance_info.framebuffer = framebuffer;
 
+		// command buffer may be in flight from its last submit
+		display->WaitSerial(m_framebuffers[swap_index].submit_serial);
+		m_framebuffers[swap_index].submit_serial = display->GetRecordingSerial();
 		display->BeginPrimaryCommandBuffer(cmd);
 
 		Vector<VkClearValue> clear_values(1);
@@ -358,7 +377,7 @@ namespace Viry3D
 		rp_begin.clearValueCount = clear_values.Size();
 		rp_begin.pClearValues = &clear_values[0];
 
-		vkCmdBeginRenderPass(cmd, &rp_begin, VK_SUBPASS_CONTENTS_INLINE);
+		vkCmdBeginRenderPass(cmd, &rp_begin, secondary_contents ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 
 		m_framebuffers[swap_index].draw_call = Graphics::draw_call;
 	}
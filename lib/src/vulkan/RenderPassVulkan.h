@@ -28,9 +28,10 @@ namespace Viry3D
 	{
 	public:
 		virtual ~RenderPassVulkan();
-		void Begin(const Color& clear_color);
+		void Begin(const Color& clear_color, bool secondary_contents);
 		void End();
 		VkRenderPass GetVkRenderPass() const { return m_render_pass; }
+		VkFramebuffer GetVkFramebuffer() const;
 		VkCommandBuffer GetCommandBuffer() const;
 
 	protected:
@@ -43,6 +44,7 @@ namespace Viry3D
 			VkFramebuffer frame_buffer;
 			VkCommandBuffer cmd_buffer;
 			int draw_call;
+			int submit_serial;
 		};
 
 		VkRenderPass m_render_pass;
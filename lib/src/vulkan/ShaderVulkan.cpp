@@ -434,12 +434,14 @@ namespace Viry3D
 
 		Vector<VkVertexInputAttributeDescription>& vi_attrs = shader_pass.vi_attrs;
 		int stride = 0;
+		int instance_stride = 0;
 
 		for (auto& i : xml.vss)
 		{
 			if (pass.vs == i.name)
 			{
 				stride = i.stride;
+				instance_stride = i.instance_stride;
 
 				const int values[] = {
 					VK_FORMAT_R32G32B32_SFLOAT,
@@ -450,12 +452,17 @@ namespace Viry3D
 					VK_FORMAT_R32G32B32A32_SFLOAT,
 					VK_FORMAT_R32G32B32A32_SFLOAT,
 					VK_FORMAT_R32G32B32A32_SFLOAT,
+					VK_FORMAT_R32G32B32A32_SFLOAT,
+					VK_FORMAT_R32G32B32A32_SFLOAT,
+					VK_FORMAT_R32G32_SFLOAT,
+					VK_FORMAT_R32G32B32A32_SFLOAT,
+					VK_FORMAT_R32G32B32A32_SFLOAT,
 				};
 
 				for (auto& j : i.attrs)
 				{
 					VkVertexInputAttributeDescription attr;
-					attr.binding = 0;
+					attr.binding = j.instance ? 1 : 0;
 					attr.location = j.location;
 					attr.offset = j.offset;
 
@@ -489,11 +496,14 @@ namespace Viry3D
 		vi_bindings[0].binding = 0;
 		vi_bindings[0].stride = stride;
 		vi_bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		vi_bindings[1].binding = 1;
+		vi_bindings[1].stride = instance_stride;
+		vi_bindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
 		Memory::Zero(&vi, sizeof(vi));
 		vi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 		vi.pNext = NULL;
-		vi.vertexBindingDescriptionCount = 1;
+		vi.vertexBindingDescriptionCount = instance_stride > 0 ? 2 : 1;
 		vi.pVertexBindingDescriptions = vi_bindings;
 		vi.vertexAttributeDescriptionCount = vi_attrs.Size();
 		vi.pVertexAttributeDescriptions = &vi_attrs[0];
@@ -851,11 +861,17 @@ namespace Viry3D
 		"#define VR_VULKAN 1\n"
 		"#define UniformBuffer(set_index, binding_index) layout(std140, set = set_index, binding = binding_index)\n"
 		"#define UniformTexture(set_index, binding_index) layout(set = set_index, binding = binding_index)\n"
-		"#define Varying(location_index) layout(location = location_index)\n";
+		"#define Varying(location_index) layout(location = location_index)\n"
+		"#define VR_INSTANCE_ID gl_InstanceIndex\n";
 
-	static String combine_shader_src(const Vector<String>& includes, const String& src)
+	static String combine_shader_src(const Vector<String>& includes, const String& src, bool instancing)
 	{
 		String source = g_shader_header;
+		if (instancing)
+		{
+			source += "#define VR_INSTANCING 1\n";
+			source += "#define VR_INSTANCE_MAX " + String::ToString(Graphics::InstanceCountMax) + "\n";
+		}
 		for (const auto& i : includes)
 		{
 			auto include_path = Application::DataPath() + "/shader/Include/" + i;
@@ -877,7 +893,7 @@ namespace Viry3D
 
 		for (const auto& i : xml.vss)
 		{
-			auto source = combine_shader_src(i.includes, i.src);
+			auto source = combine_shader_src(i.includes, i.src, xml.instancing);
 
 			Vector<unsigned int> spirv;
 			compile_with_cache(spirv, source, VK_SHADER_STAGE_VERTEX_BIT);
@@ -889,7 +905,7 @@ namespace Viry3D
 
 		for (const auto& i : xml.pss)
 		{
-			auto source = combine_shader_src(i.includes, i.src);
+			auto source = combine_shader_src(i.includes, i.src, false);
 
 			Vector<unsigned int> spirv;
 			compile_with_cache(spirv, source, VK_SHADER_STAGE_FRAGMENT_BIT);
@@ -965,6 +981,11 @@ namespace Viry3D
 			renderer_descriptor_set = set;
 			update = true;
 		}
+		else
+		{
+			// set and buffer may be read by a submit in flight
+			display->WaitSerial(RefCast<DescriptorSetVulkan>(renderer_descriptor_set)->use_serial);
+		}
 
 		if (!descriptor_set_buffer)
 		{
@@ -1036,6 +1057,10 @@ namespace Viry3D
 		ds[0] = RefCast<DescriptorSetVulkan>(descriptor_set)->set;
 		ds[1] = RefCast<DescriptorSetVulkan>(renderer_descriptor_set)->set;
 
+		int serial = display->GetRecordingSerial();
+		RefCast<DescriptorSetVulkan>(descriptor_set)->use_serial = serial;
+		RefCast<DescriptorSetVulkan>(renderer_descriptor_set)->use_serial = serial;
+
 		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
 			pass.pipeline_layout, 0, 2, &ds[0], 0, NULL);
 	}
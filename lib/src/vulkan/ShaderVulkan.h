@@ -47,7 +47,8 @@ namespace Viry3D
 		VkPipelineViewportStateCreateInfo vp;
 		VkPipelineMultisampleStateCreateInfo ms;
 		VkPipelineShaderStageCreateInfo shader_stages[2];
-		VkVertexInputBindingDescription vi_bindings[1];
+		// per vertex and per instance
+		VkVertexInputBindingDescription vi_bindings[2];
 		Vector<VkVertexInputAttributeDescription> vi_attrs;
 		VkPipelineColorBlendAttachmentState att_state[1];
 
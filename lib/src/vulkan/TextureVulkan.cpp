@@ -23,11 +23,45 @@
 #include "graphics/Texture2D.h"
 #include "graphics/Cubemap.h"
 #include "graphics/ImageBuffer.h"
+#include "graphics/TextureTranscoder.h"
 
 #if VR_VULKAN
 
 namespace Viry3D
 {
+	static VkFormat compressed_vk_format(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::ETC2_RGB8:
+				return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+			case TextureFormat::ETC2_RGBA8:
+				return VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+			case TextureFormat::ASTC_4x4:
+				return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+			case TextureFormat::BC7:
+				return VK_FORMAT_BC7_UNORM_BLOCK;
+			default:
+				return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	bool TextureVulkan::IsFormatSupported(TextureFormat format)
+	{
+		VkFormat vk_format = compressed_vk_format(format);
+		if (vk_format == VK_FORMAT_UNDEFINED)
+		{
+			return true;
+		}
+
+		auto display = (DisplayVulkan*) Graphics::GetDisplay();
+
+		VkFormatProperties props;
+		vkGetPhysicalDeviceFormatProperties(display->GetPhysicalDevice(), vk_format, &props);
+
+		return (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+	}
+
 	TextureVulkan::TextureVulkan():
 		m_format(VK_FORMAT_UNDEFINED),
 		m_image(VK_NULL_HANDLE),
@@ -40,6 +74,11 @@ namespace Viry3D
 	}
 
 	TextureVulkan::~TextureVulkan()
+	{
+		this->Release();
+	}
+
+	void TextureVulkan::Release()
 	{
 		auto display = (DisplayVulkan*) Graphics::GetDisplay();
 		auto device = display->GetDevice();
@@ -47,10 +86,15 @@ namespace Viry3D
 		if (m_sampler)
 		{
 			vkDestroySampler(device, m_sampler, NULL);
+			m_sampler = VK_NULL_HANDLE;
 		}
 		vkDestroyImageView(device, m_image_view, NULL);
 		vkFreeMemory(device, m_memory, NULL);
 		vkDestroyImage(device, m_image, NULL);
+		m_image_view = VK_NULL_HANDLE;
+		m_memory = VK_NULL_HANDLE;
+		m_image = VK_NULL_HANDLE;
+		m_image_buffers.Clear();
 	}
 
 	void TextureVulkan::CreateColorRenderTexture()
@@ -134,11 +178,25 @@ namespace Viry3D
 
 	void TextureVulkan::CreateTexture2D()
 	{
+		// recreated when resident levels of a streamed texture change,
+		// old image may be in use by submitted frames, destroyed after they complete
+		if (m_image)
+		{
+			auto display = (DisplayVulkan*) Graphics::GetDisplay();
+			display->DestroyImageDeferred(m_image, m_image_view, m_memory, m_sampler);
+			m_image = VK_NULL_HANDLE;
+			m_image_view = VK_NULL_HANDLE;
+			m_memory = VK_NULL_HANDLE;
+			m_sampler = VK_NULL_HANDLE;
+			m_image_buffers.Clear();
+		}
+
 		auto texture = (Texture2D*) this;
 		int width = texture->GetWidth();
 		int height = texture->GetHeight();
 		auto format = texture->GetFormat();
 		auto colors = texture->GetColors();
+		const auto& levels = texture->GetLevels();
 		int buffer_size;
 
 		if (format == TextureFormat::RGBA32)
@@ -167,12 +225,44 @@ namespace Viry3D
 			m_format = VK_FORMAT_R8_UNORM;
 			buffer_size = width * height;
 		}
+		else if (compressed_vk_format(format) != VK_FORMAT_UNDEFINED)
+		{
+			m_format = compressed_vk_format(format);
+			buffer_size = TextureTranscoder::GetLevelSize(format, width, height);
+		}
 		else
 		{
 			assert(!"texture format not implement");
 		}
 
-		m_image_buffers.Add(ImageBuffer::Create(buffer_size));
+		//	prebuilt mip chain, one staging buffer per level
+		Vector<ByteBuffer> uploads;
+		if (levels.Size() > 0)
+		{
+			for (int i = 0; i < levels.Size(); i++)
+			{
+				int w = Mathf::Max(width >> i, 1);
+				int h = Mathf::Max(height >> i, 1);
+
+				if (format == TextureFormat::RGB24)
+				{
+					uploads.Add(TextureTranscoder::ToRGBA32(format, w, h, levels[i]));
+				}
+				else
+				{
+					uploads.Add(levels[i]);
+				}
+			}
+		}
+		else
+		{
+			uploads.Add(colors);
+		}
+
+		for (int i = 0; i < uploads.Size(); i++)
+		{
+			m_image_buffers.Add(ImageBuffer::Create(i == 0 ? buffer_size : uploads[i].Size()));
+		}
 
         this->Create(VK_IMAGE_TILING_OPTIMAL,
 			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
@@ -186,12 +276,18 @@ namespace Viry3D
 
 		this->CreateSampler();
 
-		this->FillImageBuffer(colors, m_image_buffers[0], 0, buffer_size);
 		this->CopyBufferImageBegin();
-		this->CopyBufferImage(m_image_buffers[0], 0, 0, width, height);
+		for (int i = 0; i < uploads.Size(); i++)
+		{
+			this->FillImageBuffer(uploads[i], m_image_buffers[i], 0, uploads[i].Size());
+			this->CopyBufferImage(m_image_buffers[i], 0, 0, Mathf::Max(width >> i, 1), Mathf::Max(height >> i, 1), false, 0, i);
+		}
 		this->CopyBufferImageEnd();
 
-		this->GenerateMipmap();
+		if (uploads.Size() == 1)
+		{
+			this->GenerateMipmap();
+		}
 	}
 
 	void TextureVulkan::UpdateTexture2D(int x, int y, int w, int h, const ByteBuffer& colors)
@@ -19,6 +19,7 @@
 
 #include "vulkan_include.h"
 #include "Object.h"
+#include "graphics/TextureFormat.h"
 
 namespace Viry3D
 {
@@ -34,6 +35,7 @@ namespace Viry3D
 		VkImage GetImage() const { return m_image; }
 		VkSampler GetSampler() const { return m_sampler; }
 		void UpdateSampler();
+		static bool IsFormatSupported(TextureFormat format);
 
 	protected:
 		TextureVulkan();
@@ -60,6 +62,7 @@ namespace Viry3D
 		void CopyBufferImage(const Ref<ImageBuffer>& image_buffer, int x, int y, int w, int h, bool cubemap = false, int face = 0, int level = 0);
 		void CopyBufferImageEnd(bool cubemap = false);
 		void CreateSampler();
+		void Release();
 
 		VkFormat m_format;
 		VkImage m_image;
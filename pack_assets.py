@@ -0,0 +1,95 @@
+import os
+import sys
+import struct
+import zlib
+
+ALIGNMENT = 4096
+VERSION = 1
+COMPRESSION_NONE = 0
+COMPRESSION_ZLIB = 1
+# already compressed, zlib gains nothing
+STORE_EXTS = ['.png', '.jpg', '.jpeg', '.ogg', '.mp3', '.mp4', '.ktx', '.ktx2']
+
+def get_files(dir):
+    files = []
+    dirs = []
+    names = os.listdir(dir)
+    for i in range(0, len(names)):
+        name = (dir + '/' + names[i]).replace('\\', '/')
+        if os.path.isfile(name):
+            files.append(name)
+        elif os.path.isdir(name):
+            dirs.append(name)
+    for i in range(0, len(dirs)):
+        files = files + get_files(dirs[i])
+    return files
+
+def fnv1a64(s):
+    h = 14695981039346656037
+    for b in s:
+        h ^= b
+        h = (h * 1099511628211) & 0xffffffffffffffff
+    return h
+
+def align(n):
+    return (n + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+def pack_assets(src, dest, compress):
+    entries = []
+    files = get_files(src)
+    for i in range(0, len(files)):
+        file = files[i]
+        if file.endswith('.meta'):
+            continue
+        name = file[len(src) + 1:].encode('utf-8')
+        data = open(file, 'rb').read()
+        stored = data
+        compression = COMPRESSION_NONE
+        ext = os.path.splitext(file)[1].lower()
+        if compress and len(data) > 0 and ext not in STORE_EXTS:
+            packed = zlib.compress(data, 9)
+            # keep compressed only if it saves at least 10%
+            if len(packed) < len(data) * 9 // 10:
+                stored = packed
+                compression = COMPRESSION_ZLIB
+        entries.append([fnv1a64(name), name, data, stored, compression])
+
+    entries.sort(key=lambda e: (e[0], e[1]))
+
+    header_size = 24
+    entry_size = 32
+    name_table_offset = header_size + entry_size * len(entries)
+    names = b''
+    name_offsets = []
+    for e in entries:
+        name_offsets.append(len(names))
+        names += e[1] + b'\0'
+
+    offset = align(name_table_offset + len(names))
+    offsets = []
+    for e in entries:
+        offsets.append(offset)
+        offset = align(offset + len(e[3]))
+
+    out = open(dest, 'wb')
+    out.write(struct.pack('<4sIIIQ', b'VPAK', VERSION, len(entries), ALIGNMENT, name_table_offset))
+    for i in range(0, len(entries)):
+        e = entries[i]
+        out.write(struct.pack('<QQIIII', e[0], offsets[i], len(e[2]), len(e[3]), e[4], name_offsets[i]))
+    out.write(names)
+    for i in range(0, len(entries)):
+        out.seek(offsets[i])
+        out.write(entries[i][3])
+    out.truncate(offset if len(entries) > 0 else out.tell())
+    out.close()
+
+    stored_size = sum([len(e[3]) for e in entries])
+    raw_size = sum([len(e[2]) for e in entries])
+    print('packed %d files, %d -> %d bytes, archive %d bytes' % (len(entries), raw_size, stored_size, os.path.getsize(dest)))
+
+if __name__ == '__main__':
+    # pack_assets.py [src] [dest] [--store]
+    args = [a for a in sys.argv[1:] if not a.startswith('--')]
+    src = args[0] if len(args) > 0 else 'app/bin/Assets'
+    dest = args[1] if len(args) > 1 else src + '.vpak'
+    pack_assets(src.rstrip('/'), dest, '--store' not in sys.argv)